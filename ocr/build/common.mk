@@ -57,6 +57,18 @@ CFLAGS += -DCACHE_LINE_SZB=64
 # - Static size for deques used to contain EDTs
 # CFLAGS += -DINIT_DEQUE_CAPACITY=2048
 
+# Maximum number of EDTs a satisfy hands to the scheduler in one notify
+# CFLAGS += -DSCHED_READY_BATCH_MAX=32
+
+# Maximum number of single successors a worker runs in a row right
+# after their predecessor, bypassing the scheduler (0 disables,
+# forced with ENABLE_RESILIENCY)
+# CFLAGS += -DSCHED_INLINE_SUCCESSOR_DEPTH_MAX=16
+
+# STATIC scheduler: spread the batched EDTs that would stay on the
+# satisfying worker over the workers whose deque is empty
+# CFLAGS += -DSCHED_READY_BATCH_DISTRIBUTE
+
 # **** Registration Parameters ****
 
 # Two-steps asynchronous registration
@@ -73,6 +85,11 @@ CFLAGS += -DCACHE_LINE_SZB=64
 # Initialisation size for dynamically allocated HC event's waiter array
 # CFLAGS += -DHCEVT_WAITER_DYNAMIC_COUNT=4
 
+# Spread the count of finish scope latches over per-worker sub-counters
+# instead of a single shared counter. Each finish scope then allocates
+# one cache line per worker (ignored with ENABLE_RESILIENCY)
+# CFLAGS += -DHCEVT_FINISH_LATCH_SUB_COUNTERS
+
 # Enable MetaData Cloning for events
 # CFLAGS += -DENABLE_EVENT_MDC
 
@@ -101,17 +118,23 @@ CFLAGS += -DGUID_PROVIDER_LOCID_SIZE=10
 
 # **** Hashtable Parameters ****
 
-# - Distribute hashtable locks over cache lines
-# CFLAGS += -DHASHTABLE_LOCK_SPREAD
+# - Bucket locked hashtables: number of cache-line padded lock stripes (power of 2)
+# CFLAGS += -DHASHTABLE_LOCK_STRIPES=64
+
+# - Bucket locked hashtables: average entries per bucket before the table doubles
+# CFLAGS += -DHASHTABLE_MAX_LOAD=2
+
+# - Bucket locked hashtables: entries stored inline in a bucket
+# CFLAGS += -DHASHTABLE_BUCKET_SLOTS=3
 
 # - Activates hashtable statistics
-#   - Prints high watermark on buckets
+#   - Prints size, resizes, high watermark on buckets and probe lengths
 # CFLAGS += -DSTATS_HASHTABLE
 
-# - Keeps track of bucket's lock collision
+# - Keeps track of lock stripes collision
 # CFLAGS += -DSTATS_HASHTABLE_COLLIDE
 
-# - Print per bucket stats
+# - Print per lock stripe stats
 # CFLAGS += -DSTATS_HASHTABLE_VERB
 
 # **** Communication Platform Parameters ****
@@ -132,6 +155,13 @@ CFLAGS += -DGUID_PROVIDER_LOCID_SIZE=10
 # multiple slots
 # CFLAGS += -DOCR_MAX_MULTI_SLOT=1
 
+# Issue the RO/CONST acquires of an EDT's remote DBs without
+# waiting for each other to complete. Write acquires (RW, EW)
+# still wait for all the previous ones, in GUID order.
+# Note: a read acquire granted out of order can delay a writer
+# that itself holds a DB this EDT waits for.
+# CFLAGS += -DENABLE_DB_ACQUIRE_PIPELINE
+
 # **** Debugging parameters ****
 
 # Maximum number of characters handled by a single PRINTF
@@ -144,6 +174,18 @@ CFLAGS += -DGUID_PROVIDER_LOCID_SIZE=10
 # for the name (defaults to 32 including '\0')
 # CFLAGS += -DOCR_EDT_NAME_SIZE=32
 
+# **** Performance monitoring parameters (ENABLE_EXTENSION_PERF) ****
+
+# File the per-EDT performance statistics are loaded from at
+# start-up and saved to at shutdown. The OCR_PERF_DB environment
+# variable overrides it. Statistics are not persisted when both
+# are empty (the default)
+# CFLAGS += -DPERF_DB_FILE=\"ocrPerfDb.bin\"
+
+# Maximum number of characters of the symbol naming an EDT in
+# the performance database (defaults to 64 including '\0')
+# CFLAGS += -DPERF_DB_NAME_SIZE=64
+
 ####################################################
 # Platform specific user configurable settings
 #
@@ -227,6 +269,14 @@ endif
 # to start profiling (typically: "enter into user code")
 # CFLAGS += -DPROFILER_FOCUS=userCode
 #
+# Set this to only instrument some of the top-level directories of src/ (the
+# other profiling sites are compiled out). The output format is unchanged
+# PROFILER_MODULES := task event policy-domain
+#
+# (optional) Initial number of children slots per profiled event. Tables only
+# hold the children that actually occur and double as needed
+# CFLAGS += -DPROFILER_CHILD_SLOTS=8
+#
 # The following option is only relevant with PROFILER_FOCUS
 # Enable this if you want the profiler to stop giving details
 # after entering this many levels of profiler "stack". For example
@@ -265,6 +315,13 @@ endif
 #
 # (optional) Maximum number of scope nesting for runtime profiler
 # CFLAGS += -DMAX_PROFILER_LEVEL=512
+#
+# Enable this to sample the self counters of all threads every
+# PROFILER_SNAPSHOT_MS while the program runs. The changes are appended to
+# 'live_profiler_<location>' which rolls over to '.1' after
+# PROFILER_SNAPSHOT_MAX_BYTES. Use scripts/Profiler/liveProfile.py to view it
+# CFLAGS += -DPROFILER_SNAPSHOT
+# CFLAGS += -DPROFILER_SNAPSHOT_MS=1000 -DPROFILER_SNAPSHOT_MAX_BYTES=67108864
 
 # Enables data collection for execution timeline visualizer
 # x86 only
@@ -275,6 +332,13 @@ endif
 # (Primarily for LLNL tools inter-operability)
 # CFLAGS += -DOCR_TRACE_BINARY
 
+# Binary tracing: per-worker trace buffer of TRACE_BUFFER_PAGES pages of
+# TRACE_PAGE_SIZE bytes (multiple of 4096). When a buffer is full, records
+# are dropped (and counted) unless OCR_TRACE_BUFFER_BLOCK makes workers wait
+# Requires OCR_TRACE_BINARY
+# CFLAGS += -DTRACE_BUFFER_PAGES=16 -DTRACE_PAGE_SIZE=32768
+# CFLAGS += -DOCR_TRACE_BUFFER_BLOCK
+
 # Enable monitoring/logging of message traffic between policy domains
 # Requires Tracing (-DOCR_TRACE_BINARY)
 # CFLAGS += -DOCR_MONITOR_NETWORK -DOCR_TRACE_BINARY
@@ -523,12 +587,21 @@ ifneq (,$(findstring OCR_RUNTIME_PROFILER,$(CFLAGS)))
     PROFILER_EXTRA_OPTS :=
   endif
 
+  # Only the profiling sites of PROFILER_MODULES are instrumented; the
+  # sites in other files are compiled out with PROFILER_OFF
+  ifneq (,$(PROFILER_MODULES))
+    PROFILER_MODULE_OPTS := $(addprefix --module , $(PROFILER_MODULES))
+    PROFILER_MODULE_SRCS := $(addprefix $(OCR_ROOT)/src/, $(addsuffix /%, $(PROFILER_MODULES)))
+    PROFILER_MODULE_CFLAGS = $(if $(filter $(PROFILER_MODULE_SRCS), $<),,-DPROFILER_OFF)
+  endif
+
   ifeq ($(I), 1)
     $(info Profiler support turned on in mode $(PROFILER_MODE) with options "$(PROFILER_EXTRA_OPTS)")
   endif
 else
   PROFILER_FILE   :=
   PROFILER_FILE_C :=
+  PROFILER_MODULE_CFLAGS :=
 endif
 
 ifeq ($(I), 1)
@@ -692,9 +765,9 @@ $(INSTRUMENTATION_FILE):
 	$(AT)$(OCR_ROOT)/scripts/Profiler/generateInstrumentationFile.py -m rt -o $(OCR_BUILD)/src/instrumentationAutoGen --exclude .git --exclude profiler $(PROFILER_EXTRA_OPTS) $(OCR_ROOT)/src
 	@echo "\tDone."
 
-$(PROFILER_FILE): $(SRCSORIG) | $(OCR_BUILD)/src
+$(PROFILER_FILE): $(SRCSORIG) ../common.mk | $(OCR_BUILD)/src
 	@echo "Generating profile file..."
-	$(AT)$(OCR_ROOT)/scripts/Profiler/generateProfilerFile.py -m $(PROFILER_MODE) -o $(OCR_BUILD)/src/profilerAutoGen --exclude .git --exclude profiler $(PROFILER_EXTRA_OPTS) $(OCR_ROOT)/src
+	$(AT)$(OCR_ROOT)/scripts/Profiler/generateProfilerFile.py -m $(PROFILER_MODE) -o $(OCR_BUILD)/src/profilerAutoGen --exclude .git --exclude profiler $(PROFILER_EXTRA_OPTS) $(PROFILER_MODULE_OPTS) $(OCR_ROOT)/src
 	@echo "\tDone."
 
 $(PROFILER_FILE_C): $(PROFILER_FILE)
@@ -719,7 +792,7 @@ $(PROFILER_FILE_C): $(PROFILER_FILE)
 
 $(OBJDIR)/static/%.o: %.c Makefile ../common.mk $(PROFILER_FILE) $(INSTRUMENTATION_FILE) $(OBJDIR)/static/%.d | $(OBJDIR)/static
 	@echo "Compiling $<"
-	$(AT)$(CC) $(CFLAGS_STATIC) -MMD -c $< -o $@
+	$(AT)$(CC) $(CFLAGS_STATIC) $(PROFILER_MODULE_CFLAGS) -MMD -c $< -o $@
 	$(AT)cp -f $(@:.o=.d) $(@:.o=.d.tmp)
 	$(AT)sed -e 's/.*://' -e 's/\\$$//' < $(@:.o=.d.tmp) | fmt -1 | \
 	sed -e 's/^ *//' -e 's/$$/: /' >> $(@:.o=.d)
@@ -733,7 +806,7 @@ endif
 
 $(OBJDIR)/shared/%.o: %.c Makefile ../common.mk $(PROFILER_FILE) $(INSTRUMENTATION_FILE) $(OBJDIR)/shared/%.d | $(OBJDIR)/shared
 	@echo "Compiling $<"
-	$(AT)$(CC) $(CFLAGS_SHARED) -MMD -c $< -o $@
+	$(AT)$(CC) $(CFLAGS_SHARED) $(PROFILER_MODULE_CFLAGS) -MMD -c $< -o $@
 	$(AT)cp -f $(@:.o=.d) $(@:.o=.d.tmp)
 	$(AT)sed -e 's/.*://' -e 's/\\$$//' < $(@:.o=.d.tmp) | fmt -1 | \
 	sed -e 's/^ *//' -e 's/$$/: /' >> $(@:.o=.d)
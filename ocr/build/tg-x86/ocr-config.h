@@ -122,6 +122,8 @@
 #define ENABLE_EXTENSION_LEGACY
 #define ENABLE_EXTENSION_LABELING
 #define ENABLE_EXTENSION_RTITF
+#define ENABLE_EXTENSION_RUNTIME_QUERY
+//#define ENABLE_EXTENSION_GRAPH
 
 // Build pause/resume support
 //#define ENABLE_EXTENSION_PAUSE
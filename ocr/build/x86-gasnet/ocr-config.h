@@ -101,6 +101,7 @@
 #define ENABLE_SCHEDULER_OBJECT_DBTIME
 #define ENABLE_SCHEDULER_OBJECT_PR_WSH
 #define ENABLE_SCHEDULER_OBJECT_BIN_HEAP
+#define ENABLE_SCHEDULER_OBJECT_PR_MQ
 
 // Support for MPIlite blocking operations
 #ifndef DISABLE_EXTENSION_BLOCKING_SUPPORT
@@ -148,5 +149,11 @@
 // Runtime extension support
 #define ENABLE_EXTENSION_RTITF
 
+// Runtime counters query support
+#define ENABLE_EXTENSION_RUNTIME_QUERY
+
+// Graph capture and replay support
+// #define ENABLE_EXTENSION_GRAPH
+
 #endif /* __OCR_CONFIG_H__ */
 
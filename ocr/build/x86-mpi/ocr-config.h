@@ -101,6 +101,7 @@
 #define ENABLE_SCHEDULER_OBJECT_DBTIME
 #define ENABLE_SCHEDULER_OBJECT_PR_WSH
 #define ENABLE_SCHEDULER_OBJECT_BIN_HEAP
+#define ENABLE_SCHEDULER_OBJECT_PR_MQ
 
 // Support for MPIlite blocking operations
 #ifndef DISABLE_EXTENSION_BLOCKING_SUPPORT
@@ -149,6 +150,12 @@
 // Runtime extension support
 #define ENABLE_EXTENSION_RTITF
 
+// Runtime counters query support
+#define ENABLE_EXTENSION_RUNTIME_QUERY
+
+// Graph capture and replay support
+// #define ENABLE_EXTENSION_GRAPH
+
 // Performance monitoring
 //#define ENABLE_EXTENSION_PERF
 
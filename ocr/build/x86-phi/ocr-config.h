@@ -95,6 +95,7 @@
 #define ENABLE_SCHEDULER_OBJECT_DBTIME
 #define ENABLE_SCHEDULER_OBJECT_PR_WSH
 #define ENABLE_SCHEDULER_OBJECT_BIN_HEAP
+#define ENABLE_SCHEDULER_OBJECT_PR_MQ
 
 // Sysboot layer to use
 #define ENABLE_SYSBOOT_LINUX
@@ -129,6 +130,12 @@
 // Runtime extension support
 #define ENABLE_EXTENSION_RTITF
 
+// Runtime counters query support
+#define ENABLE_EXTENSION_RUNTIME_QUERY
+
+// Graph capture and replay support
+// #define ENABLE_EXTENSION_GRAPH
+
 // Build pause/resume support
 // #define ENABLE_EXTENSION_PAUSE
 
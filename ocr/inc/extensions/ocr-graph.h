@@ -0,0 +1,148 @@
+/**
+ * @brief Capture and replay of EDT/event sub-graphs
+ */
+/*
+ * This file is subject to the license agreement located in the file LICENSE
+ * and cannot be distributed without it. This notice cannot be
+ * removed or modified.
+ */
+
+
+#ifndef OCR_GRAPH_H_
+#define OCR_GRAPH_H_
+
+#ifdef ENABLE_EXTENSION_GRAPH
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+/**
+ * @ingroup OCRExt
+ * @{
+ */
+/**
+ * @defgroup OCRExtGraph Graph capture and replay
+ * @brief Record a sub-graph of EDTs and events once, instantiate it many times
+ *
+ * Iterative codes often build the same sub-graph at every step: same
+ * templates, same dependence shapes, only the parameters and the
+ * data-blocks change. Between ocrGraphCaptureBegin() and
+ * ocrGraphCaptureEnd(), the calling EDT builds the sub-graph normally
+ * and the runtime records the events and EDTs it creates and the
+ * dependences it adds. ocrGraphReplay() then re-creates the recorded
+ * sub-graph, with new parameters and inputs if required.
+ *
+ * The objects created by a graph are its nodes, numbered in creation
+ * order; the output event of an EDT is the node that follows the EDT.
+ * The GUIDs the sub-graph uses but did not create (data-blocks, events
+ * of the previous iteration, NULL_GUID excepted) are its inputs,
+ * numbered in the order they are first used. The parameters of the
+ * graph are the paramv of its EDTs, concatenated in creation order.
+ *
+ * Only the creation of events and EDTs and the addition of dependences
+ * are recorded; other calls (satisfy, data-block creation, etc.) take
+ * effect during the capture but are not replayed. The templates used
+ * by the graph must outlive it. A graph belongs to the policy domain
+ * it was captured in.
+ *
+ * @{
+ **/
+
+#include "ocr-types.h"
+
+/**
+ * @brief Opaque handle to a recorded sub-graph
+ **/
+typedef struct _ocrGraph_t ocrGraph_t;
+
+/**
+ * @brief Shape of a recorded sub-graph returned by ocrGraphQuery()
+ **/
+typedef struct {
+    u32 nodeCount;      /**< Events and EDTs the graph creates (output events included) */
+    u32 edtCount;       /**< EDTs the graph creates */
+    u32 eventCount;     /**< Events the graph creates (output events included) */
+    u32 inputCount;     /**< GUIDs the graph uses but does not create */
+    u32 paramCount;     /**< Parameters of all the EDTs of the graph */
+    u32 depCount;       /**< Dependences the graph adds */
+} ocrGraphInfo_t;
+
+/**
+ * @brief Starts recording the sub-graph built by the calling EDT
+ *
+ * @return 0 on success, OCR_EPERM if not called from an EDT,
+ * OCR_EBUSY if the EDT is already capturing a graph, OCR_ENOMEM
+ * if the recording could not be allocated
+ *
+ * @note A capture the EDT does not end is discarded when the EDT
+ * completes.
+ **/
+u8 ocrGraphCaptureBegin(void);
+
+/**
+ * @brief Stops recording and returns the recorded sub-graph
+ *
+ * @param[out] graph    The recorded graph, to destroy with ocrGraphDestroy()
+ *
+ * @return 0 on success, OCR_EINVAL if 'graph' is NULL, OCR_EPERM if
+ * the EDT is not capturing a graph, OCR_ENOTSUP if the sub-graph used
+ * labeled GUIDs or user-provided output events, OCR_ENOMEM if the
+ * graph could not be allocated. 'graph' is set to NULL on failure.
+ **/
+u8 ocrGraphCaptureEnd(ocrGraph_t **graph);
+
+/**
+ * @brief Describes a recorded sub-graph
+ *
+ * @param[in] graph     Graph to describe
+ * @param[out] info     Shape of the graph
+ * @param[out] inputs   If not NULL, receives the 'info->inputCount'
+ *                      GUIDs used as inputs when the graph was captured
+ *
+ * @return 0 on success, OCR_EINVAL if 'graph' or 'info' is NULL
+ **/
+u8 ocrGraphQuery(ocrGraph_t *graph, ocrGraphInfo_t *info, ocrGuid_t *inputs);
+
+/**
+ * @brief Creates a new instance of a recorded sub-graph
+ *
+ * The events and EDTs are created in the recorded order with the
+ * recorded types, properties and hints. Dependences in the default
+ * mode whose source exists when their destination EDT is created are
+ * given to the creation of the EDT; the other consecutive dependences
+ * are added with ocrAddDependences().
+ *
+ * @param[in] graph     Graph to instantiate
+ * @param[in] paramv    'paramCount' parameters to use instead of the
+ *                      recorded ones, or NULL
+ * @param[in] inputs    'inputCount' GUIDs to use instead of the
+ *                      recorded inputs, or NULL
+ * @param[out] nodes    If not NULL, receives the 'nodeCount' GUIDs of
+ *                      the created events and EDTs
+ *
+ * @return 0 on success, OCR_EINVAL if 'graph' is NULL, OCR_EPERM if not
+ * called from an EDT, or the error code of the first failed creation
+ **/
+u8 ocrGraphReplay(ocrGraph_t *graph, u64 *paramv, ocrGuid_t *inputs, ocrGuid_t *nodes);
+
+/**
+ * @brief Releases a recorded sub-graph
+ *
+ * The instances already created are not affected.
+ *
+ * @param[in] graph     Graph to release
+ *
+ * @return 0 on success, OCR_EINVAL if 'graph' is NULL
+ **/
+u8 ocrGraphDestroy(ocrGraph_t *graph);
+
+/**
+ * @}
+ * @}
+ */
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ENABLE_EXTENSION_GRAPH */
+#endif /* OCR_GRAPH_H_ */
@@ -119,6 +119,7 @@ static inline void _profilerResume(_profiler *self, u8 isFakePause) {
     }
 }
 
+#ifndef PROFILER_OFF
 /* the overhead we are not accounting for is:
   *    - overhead of _gettime
  */
@@ -152,8 +153,12 @@ static inline void _profilerResume(_profiler *self, u8 isFakePause) {
         _profiler *_tres = _profilerDestroy(&_flightweight, _tempTicks); \
         if(_tres) _profilerResume(_tres, 1);                            \
     } while(0);
+#endif /* PROFILER_OFF */
+#endif /* OCR_RUNTIME_PROFILER */
 
-#else
+/* PROFILER_OFF is defined for the files outside of the modules selected with
+ * PROFILER_MODULES; their profiling sites are compiled out */
+#if !defined(OCR_RUNTIME_PROFILER) || defined(PROFILER_OFF)
 
 #define START_PROFILE(name)
 #define PAUSE_PROFILE
@@ -161,7 +166,7 @@ static inline void _profilerResume(_profiler *self, u8 isFakePause) {
 
 #define RETURN_PROFILE(val) return val;
 #define EXIT_PROFILE
-#endif /* OCR_RUNTIME_PROFILER */
+#endif /* !OCR_RUNTIME_PROFILER || PROFILER_OFF */
 
 #endif /* __OCR_PROFILER_INTERNAL_H__ */
 
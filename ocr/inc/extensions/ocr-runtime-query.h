@@ -0,0 +1,105 @@
+/**
+ * @brief Query API for the runtime's always-on counters
+ */
+/*
+ * This file is subject to the license agreement located in the file LICENSE
+ * and cannot be distributed without it. This notice cannot be
+ * removed or modified.
+ */
+
+
+#ifndef OCR_RUNTIME_QUERY_H_
+#define OCR_RUNTIME_QUERY_H_
+
+#ifdef ENABLE_EXTENSION_RUNTIME_QUERY
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+/**
+ * @ingroup OCRExt
+ * @{
+ */
+/**
+ * @defgroup OCRExtRuntimeQuery Runtime counters
+ * @brief Sampling of cheap counters the runtime always maintains
+ *
+ * Each worker updates its own counters without synchronization;
+ * a query sums them on demand. Values are a consistent snapshot
+ * of each counter but not across counters or workers, so the
+ * counters can be sampled periodically at any point of a run.
+ *
+ * @{
+ **/
+
+#include "ocr-types.h"
+
+/**
+ * @brief Counters returned by ocrRuntimeQuery()
+ **/
+typedef enum {
+    OCR_RUNTIME_EDTS_EXECUTED,      /**< EDTs executed */
+    OCR_RUNTIME_STEALS_ATTEMPTED,   /**< Attempts to take work from another worker */
+    OCR_RUNTIME_STEALS_SUCCESSFUL,  /**< Attempts that returned work */
+    OCR_RUNTIME_DB_BYTES_LOCAL,     /**< Bytes of data-blocks acquired in the policy domain */
+    OCR_RUNTIME_DB_BYTES_REMOTE,    /**< Bytes of data-blocks acquired on behalf of another policy domain */
+    OCR_RUNTIME_ALLOC_BYTES,        /**< Bytes of data-blocks currently allocated */
+    OCR_RUNTIME_IDLE_NS,            /**< Time (in ns) workers spent without work */
+    OCR_RUNTIME_COUNTER_MAX
+} ocrRuntimeCounter_t;
+
+/**
+ * @brief Categories of the messages exchanged between policy domains
+ **/
+typedef enum {
+    OCR_RUNTIME_MSG_DB,
+    OCR_RUNTIME_MSG_MEM,
+    OCR_RUNTIME_MSG_WORK,
+    OCR_RUNTIME_MSG_EDTTEMP,
+    OCR_RUNTIME_MSG_EVT,
+    OCR_RUNTIME_MSG_GUID,
+    OCR_RUNTIME_MSG_SCHED,
+    OCR_RUNTIME_MSG_DEP,
+    OCR_RUNTIME_MSG_SAL,
+    OCR_RUNTIME_MSG_MGT,
+    OCR_RUNTIME_MSG_HINT,
+    OCR_RUNTIME_MSG_RESILIENCY,
+    OCR_RUNTIME_MSG_OTHER,          /**< Messages outside of the categories above */
+    OCR_RUNTIME_MSG_MAX
+} ocrRuntimeMsgKind_t;
+
+typedef struct {
+    u64 workerCount;                            /**< Number of workers summed */
+    u64 values[OCR_RUNTIME_COUNTER_MAX];        /**< Indexed by ocrRuntimeCounter_t */
+    u64 msgSent[OCR_RUNTIME_MSG_MAX];           /**< Indexed by ocrRuntimeMsgKind_t */
+    u64 msgReceived[OCR_RUNTIME_MSG_MAX];       /**< Indexed by ocrRuntimeMsgKind_t */
+} ocrRuntimeCounters_t;
+
+/**
+ * @brief Value of 'worker' to sum the counters of all the workers
+ **/
+#define OCR_RUNTIME_ALL_WORKERS ((s64)-1)
+
+/**
+ * @brief Reads the counters of the current policy domain
+ *
+ * @param[in] worker    Index of the worker to read or OCR_RUNTIME_ALL_WORKERS
+ * @param[out] counters Values of the counters
+ *
+ * @return 0 on success, OCR_EINVAL if 'worker' is not a valid index or
+ * 'counters' is NULL, OCR_EPERM if not called from runtime code
+ *
+ * @warning Must be called from within an EDT code.
+ **/
+u8 ocrRuntimeQuery(s64 worker, ocrRuntimeCounters_t *counters);
+
+/**
+ * @}
+ * @}
+ */
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ENABLE_EXTENSION_RUNTIME_QUERY */
+#endif /* OCR_RUNTIME_QUERY_H_ */
@@ -347,6 +347,38 @@ u8 ocrEdtDestroy(ocrGuid_t guid);
 u8 ocrAddDependence(ocrGuid_t source, ocrGuid_t destination, u32 slot,
                     ocrDbAccessMode_t mode);
 
+/**
+ * @brief A dependence to add with ocrAddDependences()
+ */
+typedef struct {
+    ocrGuid_t source;       /**< GUID of the source */
+    ocrGuid_t destination;  /**< GUID of the destination */
+    u32 slot;               /**< Index of the pre-slot on the destination */
+    ocrDbAccessMode_t mode; /**< Access mode of the destination for the data block */
+} ocrDependence_t;
+
+/**
+ * @brief Adds several dependences between OCR objects
+ *
+ * Equivalent to calling ocrAddDependence() on each element of 'deps'
+ * but the runtime processes the dependences that share a source or a
+ * destination together. Building a fan-in or a fan-out this way costs
+ * one registration per source event or destination EDT instead of one
+ * per dependence. Consecutive dependences with the same source or the
+ * same destination benefit the most.
+ *
+ * The order in which the dependences are added is unspecified.
+ *
+ * @param[in] count        Number of dependences in 'deps'
+ * @param[in] deps         Dependences to add. See ocrAddDependence() for
+ *                         the dependences that can be added.
+ *
+ * @return a status code
+ *      - 0: successful
+ *      - the status code of the first dependence that could not be added otherwise
+ */
+u8 ocrAddDependences(u32 count, ocrDependence_t *deps);
+
 /**
    @}
 **/
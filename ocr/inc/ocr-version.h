@@ -57,6 +57,10 @@
 #define OCR_VERSION_PAUSE_BIT             (1<<EXTENSION_PAUSE_BITPOS)
 // Implementation of labeled GUIDs
 #define OCR_VERSION_LABELING_BIT          (1<<EXTENSION_LABELING_BITPOS)
+// Sampling of the always-on runtime counters using ocrRuntimeQuery()
+#define OCR_VERSION_RUNTIME_QUERY_BIT     (1<<EXTENSION_RUNTIME_QUERY_BITPOS)
+// Capture and replay of EDT/event sub-graphs using ocrGraphReplay()
+#define OCR_VERSION_GRAPH_BIT             (1<<EXTENSION_GRAPH_BITPOS)
 
 /***************** Versioning internals below **************************/
 
@@ -76,6 +80,8 @@ extern u32 ocrVersionExtractPatch(u8 *verstr);
 #define EXTENSION_RTITF_BITPOS         5
 #define EXTENSION_PAUSE_BITPOS         6
 #define EXTENSION_LABELING_BITPOS      7
+#define EXTENSION_RUNTIME_QUERY_BITPOS 8
+#define EXTENSION_GRAPH_BITPOS         9
 
 // Temporary helper macro.
 // Hack to pick “affinity” for 1.0.*, “hint” for 1.1as the arg in ocr*Create()
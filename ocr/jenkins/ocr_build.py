@@ -90,6 +90,19 @@ job_ocr_build_x86_pthread_x86_perfs = {
     }
 }
 
+# Runtime configuration with the graph capture and replay extension
+job_ocr_build_x86_pthread_x86_graph = {
+    'name': 'ocr-build-x86-graph',
+    'keywords': ('percommit', ),
+    'depends': ('__alternate ocr-init',),
+    'jobtype': 'ocr-build',
+    'run-args': 'x86',
+    'sandbox': ('inherit0',),
+    'env-vars': {
+            'CFLAGS_USER': '-DENABLE_EXTENSION_GRAPH',
+    }
+}
+
 #TODO: not sure how to not hardcode MPI_ROOT here
 job_ocr_build_x86_pthread_mpi = {
     'name': 'ocr-build-x86-mpi',
@@ -33,6 +33,14 @@ job_ocr_regression_x86_pthread_x86_lockableDB = {
     'sandbox': ('inherit0',)
 }
 
+job_ocr_regression_x86_pthread_x86_graph = {
+    'name': 'ocr-regression-x86-graph',
+    'depends': ('ocr-build-x86-graph',),
+    'jobtype': 'ocr-regression',
+    'run-args': 'x86 jenkins-common-8w-regularDB.cfg regularDB -ext_graph',
+    'sandbox': ('inherit0',)
+}
+
 job_ocr_regression_x86_pthread_tg_regularDB = {
     'name': 'ocr-regression-tg-x86-regularDB',
     'depends': ('ocr-build-tg-x86',),
@@ -6,7 +6,7 @@ if [ $1 == "_params" ]; then
         exit 0
     fi
 else
-    # ARGS: OCR_TYPE CFG_FILE DB_IMPL
+    # ARGS: OCR_TYPE CFG_FILE DB_IMPL [EXTRA_TEST_OPTIONS]
     OCR_TYPE=$1
     export OCR_INSTALL=${JJOB_SHARED_HOME}/ocr/ocr/install/
     export PATH=${OCR_INSTALL}/bin:$PATH
@@ -34,6 +34,9 @@ else
         TEST_OPTIONS="-ext_rtapi -ext_params_evt -ext_counted_evt -ext_channel_evt -ext_labeling"
     fi
 
+    # Extensions the runtime of this regression was specifically built with
+    TEST_OPTIONS="${TEST_OPTIONS} $4"
+
     OCR_TYPE=${OCR_TYPE} ./ocrTests ${TEST_OPTIONS} -unstablefile unstable.${OCR_TYPE}-${DB_IMPL}
     RES=$?
 
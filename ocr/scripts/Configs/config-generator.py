@@ -20,8 +20,10 @@ parser.add_argument('--target', dest='target', default='x86', choices=['x86', 'f
                    help='target type to use (default: X86)')
 parser.add_argument('--threads', dest='threads', type=int, default=4,
                    help='number of threads available to OCR (default: 4)')
-parser.add_argument('--binding', dest='binding', default='none', choices=['none', 'seq', 'block', 'spread'],
-                   help='perform thread binding (default: no binding)')
+parser.add_argument('--binding', dest='binding', default='none', choices=['none', 'seq', 'block', 'spread', 'numa'],
+                   help='perform thread binding, numa binds the workers of a NUMA domain to the CPUs of its node (default: no binding)')
+parser.add_argument('--numadomains', dest='numadomains', type=int, default=1,
+                   help='number of NUMA domains on x86: one numa_alloc allocator per domain, workers split in blocks over the domains; needs ENABLE_MEM_PLATFORM_NUMA_ALLOC (default: 1)')
 parser.add_argument('--sysworker', dest='sysworker', action='store_true',
                    help='use 1 worker exclusively for system activities (e.g., tracing) (default: no)')
 parser.add_argument('--mtworker', dest='mtworker', action='store_true',
@@ -32,10 +34,16 @@ parser.add_argument('--alloctype', dest='alloctype', default='mallocproxy', choi
                    help='type of allocator to use (default: mallocproxy)')
 parser.add_argument('--dbtype', dest='dbtype', default='Lockable', choices=['Lockable', 'Regular'],
                    help='type of datablocks to use (default: Lockable)')
-parser.add_argument('--scheduler', dest='scheduler', default='HC', choices=['HC', 'PRIORITY', 'PLACEMENT_AFFINITY', 'LEGACY', 'ST', 'STATIC'],
-                   help='scheduler heuristic (default: HC)')
+parser.add_argument('--scheduler', dest='scheduler', default='HC', choices=['HC', 'PRIORITY', 'PRIORITY_MQ', 'PLACEMENT_AFFINITY', 'LEGACY', 'ST', 'STATIC'],
+                   help='scheduler heuristic, PRIORITY_MQ is PRIORITY over a relaxed multi-queue (default: HC)')
+parser.add_argument('--criticalpath', dest='criticalpath', action='store_true',
+                   help='with PRIORITY schedulers, prioritize EDTs without a user priority by their estimated critical path; needs ENABLE_EXTENSION_PERF (default: no)')
+parser.add_argument('--dbaffinity', dest='dbaffinity', action='store_true',
+                   help='with the HC scheduler on a single node, push ready EDTs to the worker that last wrote most of their datablock bytes (default: no)')
 parser.add_argument('--dequetype', dest='dequetype', default='WORK_STEALING_DEQUE', choices=['WORK_STEALING_DEQUE', 'LOCKED_DEQUE'],
                    help='deque type to use with LEGACY scheduler (default: WORK_STEALING_DEQUE)')
+parser.add_argument('--codec', dest='codec', default='', choices=['', 'none', 'zrle'],
+                   help='codec for resiliency checkpoints and published datablocks; none only adds checksums (default: stored raw)')
 parser.add_argument('--output', dest='output', default='default.cfg',
                    help='config output filename (default: default.cfg)')
 parser.add_argument('--remove-destination', dest='rmdest', action='store_true',
@@ -50,11 +58,20 @@ if target == 'GASNET':
     target = 'GASNet'
 threads = args.threads
 binding = args.binding
+numadomains = args.numadomains
 alloc = args.alloc
 alloctype = args.alloctype
 dbtype = args.dbtype
 scheduler = args.scheduler
+# Root scheduler object of the PRIORITY heuristic
+priorityRoot = 'PR_WSH'
+if scheduler == 'PRIORITY_MQ':
+    scheduler = 'PRIORITY'
+    priorityRoot = 'PR_MQ'
+criticalpath = args.criticalpath
+dbaffinity = args.dbaffinity
 dequetype = args.dequetype
+codec = args.codec
 outputfilename = args.output
 rmdest = args.rmdest
 sysworker = args.sysworker
@@ -64,6 +81,34 @@ if sysworker == True and platform != 'X86':
     print 'Sysworker currently supported only with platform x86'
     sys.exit(0)
 
+if numadomains < 1 or numadomains > threads:
+    print 'Number of NUMA domains must be between 1 and the number of threads'
+    sys.exit(0)
+if (numadomains > 1 or binding == 'numa') and target != 'X86':
+    print 'NUMA domains currently supported only with target x86'
+    sys.exit(0)
+if numadomains > 1 and alloctype == 'mallocproxy':
+    # mallocproxy ignores its mem-platform and would not place anything
+    print 'mallocproxy allocators do not use the NUMA mem-platforms, using tlsf instead'
+    alloctype = 'tlsf'
+
+# NUMA domain of a worker: workers are split in contiguous blocks
+def NumaDomain(worker, threads):
+    return worker * numadomains / threads
+
+# CPUs of a NUMA node, as listed by the kernel (e.g. 0-3,8-11)
+def NumaNodeCpus(node):
+    cpus = []
+    path = "/sys/devices/system/node/node%d/cpulist" % (node)
+    if not os.path.isfile(path):
+        print 'NUMA node ', node, ' not found on this machine, cannot use numa binding'
+        sys.exit(0)
+    with open(path) as cpulist:
+        for r in cpulist.read().strip().split(','):
+            bounds = r.split('-')
+            cpus.extend(range(int(bounds[0]), int(bounds[-1])+1))
+    return cpus
+
 def GenerateVersion(output):
     version = "1.1.0"
     output.write("[General]\n\tversion\t=\t%s\n\n" % (version))
@@ -81,7 +126,10 @@ def GeneratePd(output, pdtype, dbtype, threads):
     output.write("\ttype\t\t\t=\t%s\n" % (pdtype))
     output.write("\tworker\t\t\t=\t0-%d\n" % (threads-1))
     output.write("\tscheduler\t\t=\t0\n")
-    output.write("\tallocator\t\t=\t0\n")
+    if numadomains > 1:
+        output.write("\tallocator\t\t=\t0-%d\n" % (numadomains-1))
+    else:
+        output.write("\tallocator\t\t=\t0\n")
     if pdtype == 'HCDist':
         output.write("\tcommapi\t\t\t=\t0-%d\n" % (threads-1))
     else:
@@ -89,6 +137,8 @@ def GeneratePd(output, pdtype, dbtype, threads):
     output.write("\tguid\t\t\t=\t0\n")
     output.write("\tparent\t\t\t=\t0\n")
     output.write("\tlocation\t\t=\t0\n")
+    if codec != '' and pdtype in ['HC', 'HCDist']:
+        output.write("\tcodec\t\t\t=\t%s\n" % (codec))
     pdtype = "HC"
     output.write("\ttaskfactory\t\t=\t%s\n" % (pdtype))
     output.write("\ttasktemplatefactory\t=\t%s\n" % (pdtype))
@@ -103,25 +153,30 @@ def GenerateCommon(output, pdtype, dbtype):
     output.write("\n#======================================================\n")
 
 def GenerateMem(output, size, count, alloctype):
-    output.write("[MemPlatformType0]\n\tname\t=\t%s\n" % ("malloc"))
+    # One mem-platform, mem-target and allocator per NUMA domain (each of 'size')
+    ids = "0" if count == 1 else "0-%d" % (count-1)
+    memplatform = "malloc" if count == 1 else "numa_alloc"
+    output.write("[MemPlatformType0]\n\tname\t=\t%s\n" % (memplatform))
     output.write("[MemPlatformInst0]\n")
-    output.write("\tid\t=\t0\n")
-    output.write("\ttype\t=\t%s\n" % ("malloc"))
+    output.write("\tid\t=\t%s\n" % (ids))
+    output.write("\ttype\t=\t%s\n" % (memplatform))
     output.write("\tsize\t=\t%d\n" % (int(size*1.05)))
+    if count > 1:
+        output.write("\tnuma_node\t=\t%s\n" % (",".join([str(i) for i in range(0, count)])))
     output.write("\n#======================================================\n")
     output.write("[MemTargetType0]\n\tname\t=\t%s\n" % ("shared"))
     output.write("[MemTargetInst0]\n")
-    output.write("\tid\t=\t0\n")
+    output.write("\tid\t=\t%s\n" % (ids))
     output.write("\ttype\t=\t%s\n" % ("shared"))
     output.write("\tsize\t=\t%d\n" % (int(size*1.05)))
-    output.write("\tmemplatform\t=\t0\n")
+    output.write("\tmemplatform\t=\t%s\n" % (ids))
     output.write("\n#======================================================\n")
     output.write("[AllocatorType0]\n\tname\t=\t%s\n" % (alloctype))
     output.write("[AllocatorInst0]\n")
-    output.write("\tid\t=\t0\n")
+    output.write("\tid\t=\t%s\n" % (ids))
     output.write("\ttype\t=\t%s\n" % (alloctype))
     output.write("\tsize\t=\t%d\n" % (size))
-    output.write("\tmemtarget\t=\t0\n")
+    output.write("\tmemtarget\t=\t%s\n" % (ids))
     output.write("\n#======================================================\n")
 
 def GenerateComm(output, comms, pdtype, threads):
@@ -189,6 +244,14 @@ def GenerateComp(output, pdtype, threads, binding, sysworker, schedtype):
                         output.write(",")
                     else:
                         output.write("\n")
+        elif (binding == 'numa'):
+            cpus = []
+            nodeCpus = [NumaNodeCpus(d) for d in range(0, numadomains)]
+            for i in range(0, threads):
+                d = NumaDomain(i, threads)
+                first = [w for w in range(0, threads) if NumaDomain(w, threads) == d][0]
+                cpus.append(nodeCpus[d][(i - first) % len(nodeCpus[d])])
+            output.write("%s\n" % (",".join([str(c) for c in cpus])))
         else: # binding == spread
             count = 0
             for i in range(0, threads, 2):
@@ -222,6 +285,8 @@ def GenerateComp(output, pdtype, threads, binding, sysworker, schedtype):
     output.write("\ttype\t=\t%s\n" % (masterWorkerType))
     output.write("\tworkertype\t=\tmaster\n")
     output.write("\tcomptarget\t=\t0\n")
+    if numadomains > 1:
+        output.write("\tnumadomain\t=\t0\n")
     if threads > 1:
         if (pdtype == 'HCDist'): # Need a second type for distributed
             output.write("[WorkerType1]\n\tname\t=\tHC\n")
@@ -236,6 +301,9 @@ def GenerateComp(output, pdtype, threads, binding, sysworker, schedtype):
             output.write("\tcomptarget\t=\t1-%d\n" % (threads-2))
         else:
             output.write("\tcomptarget\t=\t1-%d\n" % (threads-1))
+        if numadomains > 1:
+            slaves = range(1, threads-1) if sysworker else range(1, threads)
+            output.write("\tnumadomain\t=\t%s\n" % (",".join([str(NumaDomain(i, threads)) for i in slaves])))
 
         if sysworker:
             output.write("[WorkerType2]\n\tname\t=\tSYSTEM\n")
@@ -297,16 +365,23 @@ def GenerateComp(output, pdtype, threads, binding, sysworker, schedtype):
         output.write("\tname\t=\t%s\n" % ("DBTIME"))
         output.write("[SchedulerObjectType8]\n")
         output.write("\tname\t=\t%s\n" % ("PR_WSH"))
-        if scheduler == 'PRIORITY':
+        if scheduler == 'PRIORITY' and priorityRoot == 'PR_WSH':
             output.write("\tkind\t=\t%s\n" % ("root"))
             rootObj = 'PR_WSH'
         output.write("[SchedulerObjectType9]\n")
         output.write("\tname\t=\t%s\n" % ("BIN_HEAP"))
+        output.write("[SchedulerObjectType10]\n")
+        output.write("\tname\t=\t%s\n" % ("PR_MQ"))
+        if scheduler == 'PRIORITY' and priorityRoot == 'PR_MQ':
+            output.write("\tkind\t=\t%s\n" % ("root"))
+            rootObj = 'PR_MQ'
         output.write("[SchedulerObjectInst0]\n")
         output.write("\tid\t\t=\t0\n")
         output.write("\ttype\t=\t%s\n" % (rootObj))
         if scheduler == 'STATIC':
             output.write("\tconfig\t=\t%s\n" % ("STATIC"))
+        elif scheduler == 'HC' and dbaffinity and pdtype != 'HCDist':
+            output.write("\tconfig\t=\t%s\n" % ("LOCKED"))
         output.write("\n#======================================================\n")
         if (pdtype == 'HCDist'):
             output.write("[SchedulerHeuristicType0]\n\tname\t=\t%s\n" % ("NULL"))
@@ -323,6 +398,8 @@ def GenerateComp(output, pdtype, threads, binding, sysworker, schedtype):
                     output.write("[SchedulerHeuristicInst%d]\n" % i)
                     output.write("\tid\t\t=\t%d\n" % i)
                     output.write("\ttype\t=\t%s\n" % (heuristics[i]))
+                    if heuristics[i] == 'PRIORITY' and criticalpath:
+                        output.write("\tcriticalpath\t=\tyes\n")
             elif scheduler == 'ST':
                 heuristics = ["ST", "HC_COMM_DELEGATE"]
                 for i in range(0, 2):
@@ -348,6 +425,10 @@ def GenerateComp(output, pdtype, threads, binding, sysworker, schedtype):
             output.write("[SchedulerHeuristicInst0]\n")
             output.write("\tid\t\t=\t0\n")
             output.write("\ttype\t=\t%s\n" % (scheduler))
+            if scheduler == 'PRIORITY' and criticalpath:
+                output.write("\tcriticalpath\t=\tyes\n")
+            if scheduler == 'HC' and dbaffinity:
+                output.write("\tdbaffinity\t=\tyes\n")
         output.write("\n#======================================================\n")
         output.write("[SchedulerType0]\n\tname\t=\t%s\n" % (schedtype))
         output.write("[SchedulerInst0]\n")
@@ -376,7 +457,7 @@ def GenerateConfig(filehandle, guid, platform, target, threads, binding, syswork
     if target=='X86':
         GeneratePd(filehandle, "HC", dbtype, threads)
         GenerateCommon(filehandle, "HC", dbtype)
-        GenerateMem(filehandle, alloc, 1, alloctype)
+        GenerateMem(filehandle, alloc, numadomains, alloctype)
         GenerateComm(filehandle, "null", "HC", threads)
         GenerateComp(filehandle, "HC", threads, binding, sysworker, "COMMON")
     elif (target=='FSIM'):
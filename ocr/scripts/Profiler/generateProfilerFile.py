@@ -48,6 +48,7 @@ def main(argv=None):
     opMode = MODE_UNK # Mode of operation
     topDir = None     # Top directory to search
     excludeDir = []   # List of directories to exclude
+    moduleDir = []    # Top-level directories to instrument (all if empty)
     includeExt = ['c', 'h']   # List of extensions to process
     outFile = None    # Out file
     rtFile = None     # Runtime file
@@ -58,14 +59,14 @@ def main(argv=None):
     try:
         try:
             opts, args = getopt.getopt(argv[1:], "hm:o:", ["help", "mode=", "out=", "rtfile=", "ext=", "exclude=", "quiet",
-                                                           "otherbucket"])
+                                                           "otherbucket", "module="])
         except getopt.error, err:
             raise Usage(err)
         for o, a in opts:
             if o in ('-h', '--help'):
                 raise Usage(\
 """
-    Usage: %s -m MODE -o OUT [--ext EXTENSION] [--exclude DIR] [--rtfile FILE] ROOT
+    Usage: %s -m MODE -o OUT [--ext EXTENSION] [--exclude DIR] [--module DIR] [--rtfile FILE] ROOT
 
     This script will process all files with the proper extensions contained in ROOT
     except if in the excluded sub-directories and look for START_PROFILE calls to extract
@@ -85,6 +86,9 @@ def main(argv=None):
                     multiple times
     --exclude:      Directories to exclude when looking for files. This can be specified
                     multiple times
+    --module:       Only look for profiling sites in this top-level directory of ROOT.
+                    This can be specified multiple times. The sites of the other
+                    directories must be compiled with PROFILER_OFF defined
     --rtfile:       Only when in 'app' mode: path to the base name of the generated file
                     for the runtime (generated in 'rtapp' mode). This file must already exist
                     and have properly processed the runtime source code
@@ -109,6 +113,8 @@ def main(argv=None):
                 includeExt.append(a)
             elif o in ('--exclude'):
                 excludeDir.append(a)
+            elif o in ('--module'):
+                moduleDir.append(a)
             elif o in ('--rtfile'):
                 if rtFile is not None:
                     raise Usage("Rtfile specified multiple times")
@@ -179,6 +185,8 @@ def main(argv=None):
         if not quietMode:
             print subDirs
         realRoot = os.path.abspath(root)
+        if moduleDir and os.path.relpath(realRoot, rootDir).split(os.sep)[0] not in moduleDir:
+            continue
         # Process interesting files
         for extension in includeExt:
             files = glob.glob(realRoot + '/*.' + extension)
@@ -0,0 +1,154 @@
+#!/usr/bin/env python
+
+# Live view of the runtime profiler snapshots (built with -DPROFILER_SNAPSHOT)
+#
+# Reads the 'live_profiler_<location>' file written while the program runs
+# and periodically prints the events in which the runtime spent the most
+# time during the last refresh period and since the start of the file.
+
+import argparse
+import os
+import struct
+import sys
+import time
+
+MAGIC = b'OCRPLIVE'
+TAG = 0x50414e53
+RECORD = struct.Struct('=IIIIQ')
+DELTA = struct.Struct('=IIQQ')
+
+parser = argparse.ArgumentParser(description='Show the top runtime profiler events of a running OCR program.')
+parser.add_argument('file', help='snapshot file (live_profiler_<location>)')
+parser.add_argument('-n', dest='top', type=int, default=20,
+                    help='number of events to show (default: 20)')
+parser.add_argument('-i', dest='interval', type=float, default=2.0,
+                    help='refresh period in seconds (default: 2)')
+parser.add_argument('-t', dest='threads', action='store_true',
+                    help='break the events down per thread')
+parser.add_argument('--once', dest='once', action='store_true',
+                    help='print the totals of the file and exit')
+args = parser.parse_args()
+
+
+class SnapshotReader(object):
+    "Incrementally parses a snapshot file, following roll-overs"
+    def __init__(self, name):
+        self.name = name
+        self.handle = None
+        self.inode = None
+        self.names = []
+        self.pending = b''
+
+    def _open(self):
+        try:
+            handle = open(self.name, 'rb')
+        except IOError:
+            return False
+        if self.handle:
+            self.handle.close()
+        self.handle = handle
+        self.inode = os.fstat(handle.fileno()).st_ino
+        self.pending = b''
+        self.names = []
+        return True
+
+    def _parseHeader(self):
+        if len(self.pending) < 16:
+            return False
+        if self.pending[:8] != MAGIC:
+            sys.exit('%s is not a profiler snapshot file' % self.name)
+        version, count = struct.unpack_from('=II', self.pending, 8)
+        offset = 16
+        names = []
+        for i in range(count):
+            if len(self.pending) < offset + 4:
+                return False
+            length, = struct.unpack_from('=I', self.pending, offset)
+            if len(self.pending) < offset + 4 + length:
+                return False
+            names.append(self.pending[offset+4:offset+4+length].decode())
+            offset += 4 + length
+        self.names = names
+        self.pending = self.pending[offset:]
+        return True
+
+    def read(self):
+        "Returns the list of (thread, event, count, timeNs) read since the last call"
+        try:
+            inode = os.stat(self.name).st_ino
+        except OSError:
+            inode = None
+        if self.handle is None or (inode is not None and inode != self.inode):
+            # First read or the file rolled over. Finish reading the old file first
+            deltas = self._readRecords() if self.handle else []
+            if not self._open():
+                return deltas
+            return deltas + self._readRecords()
+        return self._readRecords()
+
+    def _readRecords(self):
+        self.pending += self.handle.read()
+        if not self.names and not self._parseHeader():
+            return []
+        deltas = []
+        offset = 0
+        while len(self.pending) >= offset + RECORD.size:
+            tag, thread, count, _, stamp = RECORD.unpack_from(self.pending, offset)
+            if tag != TAG:
+                sys.exit('%s: corrupted record' % self.name)
+            end = offset + RECORD.size + count*DELTA.size
+            if len(self.pending) < end:
+                break
+            for i in range(count):
+                event, _, calls, timeNs = DELTA.unpack_from(self.pending, offset + RECORD.size + i*DELTA.size)
+                deltas.append((thread, event, calls, timeNs))
+            offset = end
+        self.pending = self.pending[offset:]
+        return deltas
+
+
+def accumulate(totals, deltas):
+    for thread, event, calls, timeNs in deltas:
+        key = (thread if args.threads else None, event)
+        entry = totals.setdefault(key, [0, 0])
+        entry[0] += calls
+        entry[1] += timeNs
+
+
+def show(reader, window, totals, period):
+    windowTime = sum(v[1] for v in window.values())
+    print('%-8s %12s %8s %12s %14s %14s  %s' % ('thread' if args.threads else '', 'calls', '%time',
+                                              'self (ms)', 'avg (us)', 'total (ms)', 'event'))
+    ranked = sorted(window.items(), key=lambda kv: kv[1][1], reverse=True)[:args.top]
+    for (thread, event), (calls, timeNs) in ranked:
+        name = reader.names[event] if event < len(reader.names) else str(event)
+        print('%-8s %12d %8.2f %12.3f %14.3f %14.3f  %s' % (
+            '' if thread is None else thread, calls,
+            100.0*timeNs/windowTime if windowTime else 0.0, timeNs/1e6,
+            timeNs/1e3/calls if calls else 0.0, totals[(thread, event)][1]/1e6, name))
+    if period:
+        print('-- %.1fs window, %.3f ms of runtime time --' % (period, windowTime/1e6))
+    sys.stdout.flush()
+
+
+reader = SnapshotReader(args.file)
+totals = dict()
+if args.once:
+    accumulate(totals, reader.read())
+    show(reader, totals, totals, None)
+    sys.exit(0)
+
+try:
+    last = time.time()
+    while True:
+        time.sleep(args.interval)
+        window = dict()
+        deltas = reader.read()
+        accumulate(window, deltas)
+        accumulate(totals, deltas)
+        now = time.time()
+        print('\n=== %s ===' % time.strftime('%H:%M:%S'))
+        show(reader, window, totals, now - last)
+        last = now
+except KeyboardInterrupt:
+    pass
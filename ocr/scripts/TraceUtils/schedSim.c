@@ -0,0 +1,761 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <ctype.h>
+#include <unistd.h>
+
+#include "ocr.h"
+#include "utils/tracer/tracer.h"
+#include "traceRead.h"
+#include "traceGraph.h"
+
+/*
+ * Trace-driven scheduler simulator.
+ *
+ * The EDT graph of binary traces is replayed in virtual time on N virtual
+ * workers, under a model of one of the scheduler heuristics of the runtime.
+ * Each EDT takes the time it took in the trace and satisfies its successors
+ * at the same offset into its execution as in the trace. An EDT that becomes
+ * ready is given to the heuristic on behalf of the worker that made it ready,
+ * and idle workers ask the heuristic for work, as the runtime's workers do:
+ *  - hc:        per-worker deques; a worker pops the tail of its deque,
+ *               otherwise steals the head of the deque it last stole from,
+ *               then of the other deques in round robin order
+ *  - static:    per-worker FIFOs, without stealing
+ *  - priority:  one shared queue, highest priority first. The priority of an
+ *               EDT is its bottom level (longest chain of work from its start
+ *               to the end of the graph), or its ready order with -F
+ *  - pc:        as hc, but an EDT goes to the worker that last acquired its
+ *               largest datablock
+ *  - st:        per-worker FIFOs, without stealing; an EDT goes to the home
+ *               (first) worker of its largest datablock
+ *  - placement: EDTs stay in the PD they ran in, with hc among the N
+ *               workers of each PD
+ * The simulation is deterministic: ties are broken by worker id and order.
+ *
+ * For each heuristic, the makespan is reported with the lower bound given
+ * by the critical path and work / workers, the number of steals (EDTs
+ * executed on another worker than the one that made them ready) and the
+ * datablock locality: the share of the bytes acquired again by an EDT that
+ * were last acquired on the same worker.
+ */
+
+typedef enum {
+    SIM_HC,
+    SIM_STATIC,
+    SIM_PRIORITY,
+    SIM_PC,
+    SIM_ST,
+    SIM_PLACEMENT,
+    SIM_MAX
+} simHeuristic_t;
+
+static const char *heuristicNames[SIM_MAX] = { "hc", "static", "priority", "pc", "st", "placement" };
+
+typedef enum {
+    SIM_EVT_RELEASE,        /* A root EDT becomes ready */
+    SIM_EVT_SATISFY,        /* A dependence of an EDT is satisfied */
+    SIM_EVT_FINISH          /* A worker is done with its EDT */
+} simEventKind_t;
+
+typedef struct {
+    u64 time;
+    u64 seq;
+    u32 kind;
+    u32 edt;
+    u32 worker;
+} simEvent_t;
+
+typedef struct {
+    u32 edt;
+    u64 offset;             /* Time into the predecessor's execution */
+} simSucc_t;
+
+typedef struct {
+    u32 *items;
+    u32 head, count, size;
+} simDeque_t;
+
+typedef struct {
+    u64 db;
+    s64 last;               /* Worker that last acquired the datablock */
+    s64 home;               /* Worker that first acquired it */
+} simDb_t;
+
+/* Executed EDTs of the trace, indexed in start order */
+typedef struct {
+    traceGraph_t *graph;
+    u32 count;
+    u32 *node;              /* Graph node of each EDT */
+    u64 *work;
+    u64 *bottom;            /* Longest chain of work from the start of the EDT */
+    u32 *preds;             /* Number of incoming edges */
+    u32 *succFirst;         /* Outgoing edges of EDT i: succ[succFirst[i]..succFirst[i+1]-1] */
+    simSucc_t *succ;
+    u64 *release;           /* Ready time of the EDTs without predecessors */
+    u32 *pd;                /* Index of the PD the EDT ran in */
+    u32 pdCount;
+    u32 recordedWorkers;
+    u64 totalWork, span, recordedMakespan, ignoredEdges;
+} simGraph_t;
+
+typedef struct {
+    simHeuristic_t heuristic;
+    u32 workers;            /* Per PD */
+    u32 total;
+    u64 overhead;           /* Cost of each scheduling decision */
+    u64 stealCost;          /* Extra cost of starting an EDT made ready elsewhere */
+    u8 fifo;
+} simParams_t;
+
+typedef struct {
+    u64 makespan;
+    u64 steals;
+    u64 reuseBytes, localBytes;
+    u64 busy;
+    u32 executed;
+} simResult_t;
+
+typedef struct {
+    simGraph_t *g;
+    simParams_t *p;
+    simEvent_t *events;
+    u32 eventCount, eventSize;
+    u64 seq;
+    simDeque_t *queues;     /* Per worker, or one shared queue for priority */
+    u32 *victim;            /* Last deque stolen from */
+    u8 *busy;
+    u32 *pending;
+    s64 *readyWorker;
+    simDb_t *dbs;
+    u32 dbSize;
+} simState_t;
+
+/******************************************************/
+/* Queues                                             */
+/******************************************************/
+
+static void dequePushTail(simDeque_t *q, u32 edt){
+    if(q->count == q->size){
+        u32 size = q->size ? (q->size << 1) : 64;
+        u32 *items = malloc(size * sizeof(u32));
+        u32 i;
+        for(i = 0; i < q->count; i++) items[i] = q->items[(q->head + i) % q->size];
+        free(q->items);
+        q->items = items;
+        q->head = 0;
+        q->size = size;
+    }
+    q->items[(q->head + q->count) % q->size] = edt;
+    q->count++;
+}
+
+static u32 dequePopTail(simDeque_t *q){
+    if(q->count == 0) return NO_NODE;
+    q->count--;
+    return q->items[(q->head + q->count) % q->size];
+}
+
+static u32 dequePopHead(simDeque_t *q){
+    if(q->count == 0) return NO_NODE;
+    u32 edt = q->items[q->head];
+    q->head = (q->head + 1) % q->size;
+    q->count--;
+    return edt;
+}
+
+/* Binary heap of EDTs on the highest priority, then the lowest index */
+static u8 priorityBefore(simState_t *s, u32 a, u32 b){
+    u64 pa = s->p->fifo ? 0 : s->g->bottom[a];
+    u64 pb = s->p->fifo ? 0 : s->g->bottom[b];
+    if(pa != pb) return pa > pb;
+    return s->pending[a] < s->pending[b]; //Ready order, kept in the pending count once ready
+}
+
+static void heapPush(simState_t *s, simDeque_t *q, u32 edt){
+    dequePushTail(q, edt); //The heap is never popped from the head, so it stays at 0
+    u32 i = q->count - 1;
+    while(i && priorityBefore(s, q->items[i], q->items[(i - 1) / 2])){
+        u32 t = q->items[i];
+        q->items[i] = q->items[(i - 1) / 2];
+        q->items[(i - 1) / 2] = t;
+        i = (i - 1) / 2;
+    }
+}
+
+static u32 heapPop(simState_t *s, simDeque_t *q){
+    if(q->count == 0) return NO_NODE;
+    u32 edt = q->items[0];
+    u32 i = 0;
+    q->items[0] = q->items[--q->count];
+    while(1){
+        u32 c = 2 * i + 1;
+        if(c >= q->count) break;
+        if((c + 1 < q->count) && priorityBefore(s, q->items[c + 1], q->items[c])) c++;
+        if(!priorityBefore(s, q->items[c], q->items[i])) break;
+        u32 t = q->items[i];
+        q->items[i] = q->items[c];
+        q->items[c] = t;
+        i = c;
+    }
+    return edt;
+}
+
+/******************************************************/
+/* Events                                             */
+/******************************************************/
+
+static u8 eventBefore(simEvent_t *a, simEvent_t *b){
+    if(a->time != b->time) return a->time < b->time;
+    return a->seq < b->seq;
+}
+
+static void pushEvent(simState_t *s, u64 time, u32 kind, u32 edt, u32 worker){
+    if(s->eventCount == s->eventSize){
+        s->eventSize = s->eventSize ? (s->eventSize << 1) : 1024;
+        s->events = realloc(s->events, s->eventSize * sizeof(simEvent_t));
+    }
+    simEvent_t *e = s->events;
+    u32 i = s->eventCount++;
+    e[i].time = time;
+    e[i].seq = s->seq++;
+    e[i].kind = kind;
+    e[i].edt = edt;
+    e[i].worker = worker;
+    while(i && eventBefore(&e[i], &e[(i - 1) / 2])){
+        simEvent_t t = e[i];
+        e[i] = e[(i - 1) / 2];
+        e[(i - 1) / 2] = t;
+        i = (i - 1) / 2;
+    }
+}
+
+static simEvent_t popEvent(simState_t *s){
+    simEvent_t *e = s->events;
+    simEvent_t top = e[0];
+    u32 i = 0;
+    e[0] = e[--s->eventCount];
+    while(1){
+        u32 c = 2 * i + 1;
+        if(c >= s->eventCount) break;
+        if((c + 1 < s->eventCount) && eventBefore(&e[c + 1], &e[c])) c++;
+        if(!eventBefore(&e[c], &e[i])) break;
+        simEvent_t t = e[i];
+        e[i] = e[c];
+        e[c] = t;
+        i = c;
+    }
+    return top;
+}
+
+/******************************************************/
+/* Datablocks                                         */
+/******************************************************/
+
+static simDb_t *getDb(simDb_t *dbs, u32 size, u64 db){
+    u32 h = hashGuid(db, size);
+    while((dbs[h].db != 0) && (dbs[h].db != db)) h = (h + 1) & (size - 1);
+    if(dbs[h].db == 0){
+        dbs[h].db = db;
+        dbs[h].last = -1;
+        dbs[h].home = -1;
+    }
+    return &dbs[h];
+}
+
+static u32 dbTableSize(traceGraph_t *graph){
+    u32 size = 1024;
+    while(size < 2 * graph->acquireCount) size <<= 1;
+    return size;
+}
+
+/* Counts the bytes acquired again by an EDT running on 'worker', and the ones last acquired there */
+static void acquireDbs(traceGraph_t *graph, simDb_t *dbs, u32 size, u32 node, s64 worker,
+                       u64 *reuseBytes, u64 *localBytes){
+    u32 a;
+    for(a = graph->nodes[node].acquires; a != NO_NODE; a = graph->acquires[a].next){
+        simDb_t *db = getDb(dbs, size, graph->acquires[a].db);
+        if(db->last >= 0){
+            *reuseBytes += graph->acquires[a].size;
+            if(db->last == worker) *localBytes += graph->acquires[a].size;
+        }
+        if(db->home < 0) db->home = worker;
+        db->last = worker;
+    }
+}
+
+/* Worker holding the largest datablock of an EDT (last or home worker), -1 if none is known */
+static s64 dataWorker(simState_t *s, u32 edt, u8 home){
+    traceGraph_t *graph = s->g->graph;
+    u64 largest = 0;
+    s64 worker = -1;
+    u32 a;
+    for(a = graph->nodes[s->g->node[edt]].acquires; a != NO_NODE; a = graph->acquires[a].next){
+        simDb_t *db = getDb(s->dbs, s->dbSize, graph->acquires[a].db);
+        s64 w = home ? db->home : db->last;
+        if((w >= 0) && ((worker < 0) || (graph->acquires[a].size > largest))){
+            largest = graph->acquires[a].size;
+            worker = w;
+        }
+    }
+    return worker;
+}
+
+/******************************************************/
+/* Heuristic models                                   */
+/******************************************************/
+
+/* Hands a ready EDT to the heuristic on behalf of 'worker' */
+static void simNotifyReady(simState_t *s, u32 edt, u32 worker){
+    simParams_t *p = s->p;
+    s64 dest = worker;
+    s->readyWorker[edt] = worker;
+    switch(p->heuristic){
+        case SIM_PRIORITY:
+            s->pending[edt] = (u32)s->seq++;
+            heapPush(s, &s->queues[0], edt);
+            return;
+        case SIM_PLACEMENT:
+            //Same local worker in the PD the EDT ran in
+            dest = s->g->pd[edt] * p->workers + (worker % p->workers);
+            break;
+        case SIM_PC:
+        case SIM_ST:
+        {
+            s64 w = dataWorker(s, edt, p->heuristic == SIM_ST);
+            if(w >= 0) dest = w;
+            break;
+        }
+        default:
+            break;
+    }
+    dequePushTail(&s->queues[dest], edt);
+}
+
+/* Work for an idle worker, NO_NODE if the heuristic has none for it */
+static u32 simGetWork(simState_t *s, u32 worker){
+    simParams_t *p = s->p;
+    u32 edt, i;
+    switch(p->heuristic){
+        case SIM_PRIORITY:
+            return heapPop(s, &s->queues[0]);
+        case SIM_STATIC:
+        case SIM_ST:
+            return dequePopHead(&s->queues[worker]);
+        default:
+            break;
+    }
+    edt = dequePopTail(&s->queues[worker]);
+    if(edt != NO_NODE) return edt;
+    //Steal within the PD (all the workers except for placement)
+    u32 base = (p->heuristic == SIM_PLACEMENT) ? (worker / p->workers) * p->workers : 0;
+    u32 count = (p->heuristic == SIM_PLACEMENT) ? p->workers : p->total;
+    u32 local = worker - base;
+    edt = dequePopHead(&s->queues[base + s->victim[worker]]);
+    for(i = 1; (edt == NO_NODE) && (i < count); i++){
+        s->victim[worker] = (local + i) % count;
+        edt = dequePopHead(&s->queues[base + s->victim[worker]]);
+    }
+    return edt;
+}
+
+/******************************************************/
+/* Simulation                                         */
+/******************************************************/
+
+static void simRun(simGraph_t *g, simParams_t *p, simResult_t *r){
+    simState_t s;
+    u32 i, w;
+    memset(&s, 0, sizeof(s));
+    memset(r, 0, sizeof(simResult_t));
+    s.g = g;
+    s.p = p;
+    s.queues = calloc(p->total, sizeof(simDeque_t));
+    s.victim = malloc(p->total * sizeof(u32));
+    s.busy = calloc(p->total, sizeof(u8));
+    s.pending = malloc((g->count + 1) * sizeof(u32));
+    s.readyWorker = malloc((g->count + 1) * sizeof(s64));
+    s.dbSize = dbTableSize(g->graph);
+    s.dbs = calloc(s.dbSize, sizeof(simDb_t));
+    u32 count = (p->heuristic == SIM_PLACEMENT) ? p->workers : p->total;
+    for(w = 0; w < p->total; w++) s.victim[w] = ((w % count) + 1) % count;
+
+    //Roots are made ready by the worker that made them ready in the trace
+    for(i = 0; i < g->count; i++){
+        s.pending[i] = g->preds[i];
+        if(g->preds[i] == 0){
+            edtNode_t *node = &g->graph->nodes[g->node[i]];
+            s64 rw = (node->readyWorker >= 0) ? node->readyWorker : node->execWorker;
+            u32 worker = (rw >= 0) ? (u32)(rw % p->workers) : 0;
+            if(p->heuristic == SIM_PLACEMENT) worker += g->pd[i] * p->workers;
+            pushEvent(&s, g->release[i], SIM_EVT_RELEASE, i, worker);
+        }
+    }
+
+    u64 now = 0;
+    while(s.eventCount){
+        simEvent_t e = popEvent(&s);
+        now = e.time;
+        switch(e.kind){
+            case SIM_EVT_RELEASE:
+                simNotifyReady(&s, e.edt, e.worker);
+                break;
+            case SIM_EVT_SATISFY:
+                if(--s.pending[e.edt] == 0) simNotifyReady(&s, e.edt, e.worker);
+                break;
+            case SIM_EVT_FINISH:
+                s.busy[e.worker] = 0;
+                if(now > r->makespan) r->makespan = now;
+                break;
+        }
+        //Let the idle workers look for work
+        for(w = 0; w < p->total; w++){
+            if(s.busy[w]) continue;
+            u32 edt = simGetWork(&s, w);
+            if(edt == NO_NODE) continue;
+            u64 start = now + p->overhead;
+            if(s.readyWorker[edt] != w){
+                r->steals++;
+                start += p->stealCost;
+            }
+            acquireDbs(g->graph, s.dbs, s.dbSize, g->node[edt], w, &r->reuseBytes, &r->localBytes);
+            for(i = g->succFirst[edt]; i < g->succFirst[edt + 1]; i++)
+                pushEvent(&s, start + g->succ[i].offset, SIM_EVT_SATISFY, g->succ[i].edt, w);
+            pushEvent(&s, start + g->work[edt], SIM_EVT_FINISH, edt, w);
+            s.busy[w] = 1;
+            r->busy += (start - now) + g->work[edt];
+            r->executed++;
+        }
+    }
+
+    for(w = 0; w < p->total; w++) free(s.queues[w].items);
+    free(s.queues);
+    free(s.victim);
+    free(s.busy);
+    free(s.pending);
+    free(s.readyWorker);
+    free(s.dbs);
+    free(s.events);
+}
+
+/******************************************************/
+/* Graph preparation                                  */
+/******************************************************/
+
+static edtNode_t *sortNodes;
+
+static int compareStart(const void *a, const void *b){
+    u32 na = *(const u32 *)a, nb = *(const u32 *)b;
+    u64 sa = sortNodes[na].startTime, sb = sortNodes[nb].startTime;
+    if(sa != sb) return (sa > sb) - (sa < sb);
+    return (na > nb) - (na < nb);
+}
+
+static void prepareGraph(traceGraph_t *graph, simGraph_t *g){
+    u32 n, i, e;
+    memset(g, 0, sizeof(simGraph_t));
+    g->graph = graph;
+    g->node = malloc((graph->nodeCount + 1) * sizeof(u32));
+    for(n = 0; n < graph->nodeCount; n++)
+        if(graph->nodes[n].startTime && graph->nodes[n].endTime) g->node[g->count++] = n;
+    sortNodes = graph->nodes;
+    qsort(g->node, g->count, sizeof(u32), compareStart);
+
+    u32 *rank = malloc((graph->nodeCount + 1) * sizeof(u32));
+    for(n = 0; n < graph->nodeCount; n++) rank[n] = NO_NODE;
+    for(i = 0; i < g->count; i++) rank[g->node[i]] = i;
+
+    g->work = malloc((g->count + 1) * sizeof(u64));
+    g->bottom = calloc(g->count + 1, sizeof(u64));
+    g->preds = calloc(g->count + 1, sizeof(u32));
+    g->succFirst = calloc(g->count + 2, sizeof(u32));
+    g->release = calloc(g->count + 1, sizeof(u64));
+    g->pd = calloc(g->count + 1, sizeof(u32));
+
+    //Edges are kept from an earlier EDT, which keeps the graph acyclic
+    u64 firstStart = g->count ? graph->nodes[g->node[0]].startTime : 0, lastEnd = 0;
+    for(i = 0; i < g->count; i++){
+        edtNode_t *node = &graph->nodes[g->node[i]];
+        g->work[i] = nodeWork(node);
+        g->totalWork += g->work[i];
+        if(node->endTime > lastEnd) lastEnd = node->endTime;
+        for(e = node->edges; e != NO_NODE; e = graph->edges[e].next){
+            u32 p = rank[graph->edges[e].pred];
+            if((p == NO_NODE) || (p >= i)){
+                g->ignoredEdges++;
+                continue;
+            }
+            g->preds[i]++;
+            g->succFirst[p + 1]++;
+        }
+    }
+    g->recordedMakespan = lastEnd - firstStart;
+    for(i = 0; i < g->count; i++) g->succFirst[i + 1] += g->succFirst[i];
+    g->succ = malloc((g->succFirst[g->count] + 1) * sizeof(simSucc_t));
+    u32 *fill = malloc((g->count + 1) * sizeof(u32));
+    memcpy(fill, g->succFirst, g->count * sizeof(u32));
+    u64 *pathStart = calloc(g->count + 1, sizeof(u64));
+    for(i = 0; i < g->count; i++){
+        edtNode_t *node = &graph->nodes[g->node[i]];
+        for(e = node->edges; e != NO_NODE; e = graph->edges[e].next){
+            u32 p = rank[graph->edges[e].pred];
+            if((p == NO_NODE) || (p >= i)) continue;
+            edtNode_t *pred = &graph->nodes[g->node[p]];
+            u64 offset = (graph->edges[e].time > pred->startTime) ? (graph->edges[e].time - pred->startTime) : 0;
+            if(offset > g->work[p]) offset = g->work[p];
+            g->succ[fill[p]].edt = i;
+            g->succ[fill[p]].offset = offset;
+            fill[p]++;
+            if(pathStart[p] + offset > pathStart[i]) pathStart[i] = pathStart[p] + offset;
+        }
+        if(pathStart[i] + g->work[i] > g->span) g->span = pathStart[i] + g->work[i];
+        if(g->preds[i] == 0){
+            u64 ready = node->readyTime ? node->readyTime : (node->createTime ? node->createTime : node->startTime);
+            g->release[i] = (ready > firstStart) ? (ready - firstStart) : 0;
+        }
+    }
+    //Bottom levels, in reverse start order
+    for(i = g->count; i-- > 0;){
+        g->bottom[i] = g->work[i];
+        for(e = g->succFirst[i]; e < g->succFirst[i + 1]; e++)
+            if(g->succ[e].offset + g->bottom[g->succ[e].edt] > g->bottom[i])
+                g->bottom[i] = g->succ[e].offset + g->bottom[g->succ[e].edt];
+    }
+
+    //PDs and workers of the recorded run
+    u64 *ids = malloc((g->count + 1) * sizeof(u64));
+    u64 *pds = malloc((g->count + 1) * sizeof(u64));
+    for(i = 0; i < g->count; i++){
+        edtNode_t *node = &graph->nodes[g->node[i]];
+        ids[i] = (node->location << 16) ^ (u64)node->execWorker;
+        u32 k;
+        for(k = 0; (k < g->pdCount) && (pds[k] != node->location); k++);
+        if(k == g->pdCount) pds[g->pdCount++] = node->location;
+        g->pd[i] = k;
+    }
+    for(i = 0; i < g->count; i++){
+        u32 k;
+        for(k = 0; (k < i) && (ids[k] != ids[i]); k++);
+        g->recordedWorkers += (k == i);
+    }
+    free(ids);
+    free(pds);
+    free(pathStart);
+    free(fill);
+    free(rank);
+}
+
+/* Steals and locality of the recorded run, measured as for the simulations */
+static void recordedResult(simGraph_t *g, simResult_t *r){
+    u32 size = dbTableSize(g->graph), i;
+    simDb_t *dbs = calloc(size, sizeof(simDb_t));
+    memset(r, 0, sizeof(simResult_t));
+    r->makespan = g->recordedMakespan;
+    for(i = 0; i < g->count; i++){
+        edtNode_t *node = &g->graph->nodes[g->node[i]];
+        s64 worker = (s64)((node->location << 16) ^ (u64)node->execWorker);
+        acquireDbs(g->graph, dbs, size, g->node[i], worker, &r->reuseBytes, &r->localBytes);
+        if((node->readyWorker >= 0) && (node->readyWorker != node->execWorker)) r->steals++;
+        r->busy += g->work[i];
+        r->executed++;
+    }
+    free(dbs);
+}
+
+/******************************************************/
+/* Runtime configuration files                        */
+/******************************************************/
+
+static s32 heuristicFromName(const char *name){
+    s32 h;
+    if(!strcasecmp(name, "hc_comm_delegate")) return SIM_HC;
+    if(!strcasecmp(name, "placement_affinity")) return SIM_PLACEMENT;
+    for(h = 0; h < SIM_MAX; h++)
+        if(!strcasecmp(name, heuristicNames[h])) return h;
+    return -1;
+}
+
+/* Number of compute workers and scheduler heuristic of a runtime configuration file */
+static int readConfig(const char *fileName, u32 *workers, s32 *heuristic){
+    FILE *f = fopen(fileName, "r");
+    char line[256], section[64] = "", key[64], value[64];
+    u32 first = 0, last = 0;
+    u8 system = 0, haveId = 0;
+    if(f == NULL){
+        fprintf(stderr, "Cannot open %s\n", fileName);
+        return -1;
+    }
+    *workers = 0;
+    while(1){
+        char *l = fgets(line, sizeof(line), f);
+        //A worker section is counted once it is complete
+        if(((l == NULL) || (line[0] == '[')) && !strncasecmp(section, "WorkerInst", 10) && haveId && !system)
+            *workers += last - first + 1;
+        if(l == NULL) break;
+        if(line[0] == '['){
+            sscanf(line, "[%63[^]]", section);
+            system = 0;
+            haveId = 0;
+            continue;
+        }
+        if(sscanf(line, " %63[^= \t] = %63s", key, value) != 2) continue;
+        if(!strncasecmp(section, "WorkerInst", 10)){
+            if(!strcasecmp(key, "id")){
+                if(sscanf(value, "%u-%u", &first, &last) != 2) last = first;
+                haveId = 1;
+            } else if(!strcasecmp(key, "workertype")){
+                system = !strcasecmp(value, "system");
+            }
+        } else if(!strncasecmp(section, "SchedulerHeuristicInst", 22) && !strcasecmp(key, "type")){
+            *heuristic = heuristicFromName(value);
+            if(*heuristic < 0) fprintf(stderr, "Scheduler heuristic %s is not modeled, using all\n", value);
+        }
+    }
+    fclose(f);
+    return 0;
+}
+
+/******************************************************/
+/* Main                                               */
+/******************************************************/
+
+static double locality(simResult_t *r){
+    return r->reuseBytes ? ((double)r->localBytes / r->reuseBytes) : 0.0;
+}
+
+static void usage(const char *name){
+    printf("Usage: %s [-j] [-F] [-s heuristic[,...]] [-w workers] [-c cfg] [-o ns] [-t ns] <trace file>...\n", name);
+    printf("   -s list   heuristics to simulate among hc, static, priority, pc, st and placement (default: all)\n");
+    printf("   -w n      virtual workers per PD (default: the configuration, or the workers of the trace)\n");
+    printf("   -c cfg    take the workers and heuristic from a runtime configuration file\n");
+    printf("   -o ns     cost of each scheduling decision (default 0)\n");
+    printf("   -t ns     extra cost of starting an EDT made ready on another worker (default 0)\n");
+    printf("   -F        priority: FIFO order instead of critical path priorities\n");
+    printf("   -j        print a JSON summary only\n");
+}
+
+int main(int argc, char *argv[]){
+    traceGraph_t graph;
+    simGraph_t g;
+    simParams_t params;
+    u8 selected[SIM_MAX];
+    u32 workers = 0;
+    s32 cfgHeuristic = -1;
+    int json = 0, opt, i, h;
+    char *list = NULL;
+
+    memset(&params, 0, sizeof(params));
+    memset(selected, 0, sizeof(selected));
+    while((opt = getopt(argc, argv, "js:w:c:o:t:Fh")) != -1){
+        switch(opt){
+            case 'j': json = 1; break;
+            case 's': list = optarg; break;
+            case 'w': workers = atoi(optarg); break;
+            case 'c':
+            {
+                u32 cfgWorkers = 0;
+                if(readConfig(optarg, &cfgWorkers, &cfgHeuristic) < 0) return 1;
+                if(workers == 0) workers = cfgWorkers;
+                break;
+            }
+            case 'o': params.overhead = strtoull(optarg, NULL, 0); break;
+            case 't': params.stealCost = strtoull(optarg, NULL, 0); break;
+            case 'F': params.fifo = 1; break;
+            default: usage(argv[0]); return 1;
+        }
+    }
+    if(optind >= argc){
+        usage(argv[0]);
+        return 1;
+    }
+    if(list != NULL){
+        char *name = strtok(list, ",");
+        for(; name != NULL; name = strtok(NULL, ",")){
+            h = heuristicFromName(name);
+            if(h < 0){
+                fprintf(stderr, "Unknown heuristic %s\n", name);
+                return 1;
+            }
+            selected[h] = 1;
+        }
+    } else if(cfgHeuristic >= 0){
+        selected[cfgHeuristic] = 1;
+    } else {
+        for(h = 0; h < SIM_MAX; h++) selected[h] = 1;
+    }
+
+    memset(&graph, 0, sizeof(graph));
+    for(i = optind; i < argc; i++){
+        if(traceReadFile(argv[i], recordTrace, recordDropped, &graph) < 0)
+            return 1;
+    }
+    buildGraph(&graph);
+    prepareGraph(&graph, &g);
+    if(g.count == 0){
+        fprintf(stderr, "No EDT executions in the trace\n");
+        return 1;
+    }
+    if(workers == 0) workers = g.recordedWorkers;
+    params.workers = workers;
+
+    simResult_t recorded;
+    recordedResult(&g, &recorded);
+
+    if(!json){
+        if(graph.dropped)
+            printf("WARNING: %"PRIu64" records were dropped while tracing, the results are approximate\n\n", graph.dropped);
+        printf("== Trace ==\n");
+        printf("EDTs:                 %"PRIu32" executed in %"PRIu32" PD(s), %"PRIu32" edges (%"PRIu64" ignored)\n",
+               g.count, g.pdCount, g.succFirst[g.count], g.ignoredEdges);
+        printf("Total work:           %.3f ms\n", g.totalWork / 1e6);
+        printf("Critical path:        %.3f ms\n", g.span / 1e6);
+        printf("Recorded run:         %.3f ms on %"PRIu32" workers, %"PRIu64" steals, locality %.1f%%\n",
+               recorded.makespan / 1e6, g.recordedWorkers, recorded.steals, 100.0 * locality(&recorded));
+        printf("\n== Simulation (%"PRIu32" workers per PD, overhead %"PRIu64" ns, steal cost %"PRIu64" ns) ==\n",
+               workers, params.overhead, params.stealCost);
+        printf("%-10s %14s %10s %10s %10s %10s %10s\n", "heuristic", "makespan (ms)", "vs bound", "speedup",
+               "efficiency", "steals", "locality");
+    } else {
+        printf("{\"edts\": %"PRIu32", \"work_ns\": %"PRIu64", \"span_ns\": %"PRIu64", \"workers\": %"PRIu32", "
+               "\"recorded\": {\"makespan_ns\": %"PRIu64", \"workers\": %"PRIu32", \"steals\": %"PRIu64", \"locality\": %.3f}, "
+               "\"results\": [", g.count, g.totalWork, g.span, workers, recorded.makespan, g.recordedWorkers,
+               recorded.steals, locality(&recorded));
+    }
+
+    u8 first = 1;
+    for(h = 0; h < SIM_MAX; h++){
+        if(!selected[h]) continue;
+        simResult_t r;
+        params.heuristic = h;
+        params.total = workers * ((h == SIM_PLACEMENT) ? g.pdCount : 1);
+        simRun(&g, &params, &r);
+        u64 bound = g.totalWork / params.total;
+        if(g.span > bound) bound = g.span;
+        double efficiency = r.makespan ? ((double)g.totalWork / ((double)r.makespan * params.total)) : 0.0;
+        if(json){
+            printf("%s{\"heuristic\": \"%s\", \"workers\": %"PRIu32", \"makespan_ns\": %"PRIu64", \"bound_ns\": %"PRIu64", "
+                   "\"efficiency\": %.3f, \"steals\": %"PRIu64", \"locality\": %.3f}", first ? "" : ", ",
+                   heuristicNames[h], params.total, r.makespan, bound, efficiency, r.steals, locality(&r));
+        } else {
+            printf("%-10s %14.3f %10.2f %10.2f %10.2f %10"PRIu64" %9.1f%%\n", heuristicNames[h], r.makespan / 1e6,
+                   bound ? ((double)r.makespan / bound) : 0.0, r.makespan ? ((double)g.totalWork / r.makespan) : 0.0,
+                   efficiency, r.steals, 100.0 * locality(&r));
+        }
+        if(r.executed != g.count)
+            fprintf(stderr, "WARNING: %s: %"PRIu32" EDTs never became ready\n", heuristicNames[h], g.count - r.executed);
+        first = 0;
+    }
+    if(json) printf("]}\n");
+
+    free(g.node);
+    free(g.work);
+    free(g.bottom);
+    free(g.preds);
+    free(g.succFirst);
+    free(g.succ);
+    free(g.release);
+    free(g.pd);
+    freeGraph(&graph);
+    return 0;
+}
@@ -0,0 +1,266 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "ocr.h"
+#include "utils/tracer/tracer.h"
+#include "traceRead.h"
+#include "traceGraph.h"
+
+/*
+ * Task graph analysis of binary traces.
+ *
+ * The EDT graph is rebuilt from the CREATE, SATISFY, RUNNABLE, EXECUTE and
+ * FINISH records. An edge P -> X is recorded when EDT P creates X or
+ * satisfies one of its dependences; X cannot start before the part of P's
+ * execution that precedes the edge. Processing EDTs by start time, the
+ * longest such chain of work is the critical path (span).
+ *
+ * Scheduling latency is the time between an EDT becoming runnable (its
+ * last dependence being satisfied) and it starting to execute. An EDT is
+ * counted as stolen when it executes on another worker than the one that
+ * scheduled it.
+ */
+
+#define LATENCY_BUCKETS     48
+#define DEFAULT_BINS        20
+#define DEFAULT_TOP         10
+
+typedef struct {
+    u64 funcPtr;
+    u64 count;
+    u64 work;
+    u64 latency;
+    u64 maxLatency;
+    u64 critWork;           /* Work of the EDTs of this template on the critical path */
+    u32 critCount;
+} templateStats_t;
+
+static edtNode_t *sortNodes;
+
+static int compareStart(const void *a, const void *b){
+    u64 sa = sortNodes[*(const u32 *)a].startTime;
+    u64 sb = sortNodes[*(const u32 *)b].startTime;
+    return (sa > sb) - (sa < sb);
+}
+
+static int compareU64(const void *a, const void *b){
+    u64 va = *(const u64 *)a, vb = *(const u64 *)b;
+    return (va > vb) - (va < vb);
+}
+
+static int compareWork(const void *a, const void *b){
+    u64 wa = ((const templateStats_t *)a)->work, wb = ((const templateStats_t *)b)->work;
+    return (wa < wb) - (wa > wb);
+}
+
+static templateStats_t *getTemplate(templateStats_t *templates, u32 *count, u64 funcPtr){
+    u32 i;
+    for(i = 0; i < *count; i++)
+        if(templates[i].funcPtr == funcPtr) return &templates[i];
+    memset(&templates[i], 0, sizeof(templateStats_t));
+    templates[i].funcPtr = funcPtr;
+    (*count)++;
+    return &templates[i];
+}
+
+static u64 percentile(u64 *sorted, u32 count, u32 pct){
+    if(count == 0) return 0;
+    return sorted[((u64)(count - 1) * pct) / 100];
+}
+
+static void usage(const char *name){
+    printf("Usage: %s [-j] [-b bins] [-n top] <trace file>...\n", name);
+    printf("   -j        print a JSON summary only (for regression tracking)\n");
+    printf("   -b bins   number of time slices of the parallelism profile (default %d)\n", DEFAULT_BINS);
+    printf("   -n top    number of templates to list (default %d)\n", DEFAULT_TOP);
+}
+
+int main(int argc, char *argv[]){
+    traceGraph_t graph;
+    u32 bins = DEFAULT_BINS, top = DEFAULT_TOP;
+    int json = 0, opt, i;
+
+    while((opt = getopt(argc, argv, "jb:n:h")) != -1){
+        switch(opt){
+            case 'j': json = 1; break;
+            case 'b': bins = atoi(optarg); break;
+            case 'n': top = atoi(optarg); break;
+            default: usage(argv[0]); return 1;
+        }
+    }
+    if((optind >= argc) || (bins == 0)){
+        usage(argv[0]);
+        return 1;
+    }
+
+    memset(&graph, 0, sizeof(graph));
+    for(i = optind; i < argc; i++){
+        if(traceReadFile(argv[i], recordTrace, recordDropped, &graph) < 0)
+            return 1;
+    }
+    buildGraph(&graph);
+
+    //Keep the EDTs that executed, in start order
+    u32 *order = malloc((graph.nodeCount + 1) * sizeof(u32));
+    u32 executed = 0, n;
+    for(n = 0; n < graph.nodeCount; n++)
+        if(graph.nodes[n].startTime && graph.nodes[n].endTime) order[executed++] = n;
+    sortNodes = graph.nodes;
+    qsort(order, executed, sizeof(u32), compareStart);
+
+    //Longest chain of work, latencies, steals and per template statistics
+    u64 *latencies = malloc((executed + 1) * sizeof(u64));
+    templateStats_t *templates = malloc((executed + 1) * sizeof(templateStats_t));
+    u32 templateCount = 0, latencyCount = 0, critEnd = NO_NODE, k;
+    u64 work = 0, span = 0, firstStart = (u64)-1, lastEnd = 0, latencySum = 0;
+    u64 latencyHist[LATENCY_BUCKETS];
+    memset(latencyHist, 0, sizeof(latencyHist));
+    for(k = 0; k < executed; k++){
+        edtNode_t *node = &graph.nodes[order[k]];
+        u64 w = nodeWork(node);
+        u32 e;
+        for(e = node->edges; e != NO_NODE; e = graph.edges[e].next){
+            edtNode_t *pred = &graph.nodes[graph.edges[e].pred];
+            if(!pred->startTime || !pred->endTime || (pred->startTime > node->startTime)) continue;
+            u64 part = (graph.edges[e].time > pred->startTime) ? (graph.edges[e].time - pred->startTime) : 0;
+            if(part > nodeWork(pred)) part = nodeWork(pred);
+            if(pred->pathStart + part > node->pathStart){
+                node->pathStart = pred->pathStart + part;
+                node->critPred = graph.edges[e].pred;
+            }
+        }
+        if((node->pathStart + w > span) || (critEnd == NO_NODE)){
+            span = node->pathStart + w;
+            critEnd = order[k];
+        }
+        work += w;
+        if(node->startTime < firstStart) firstStart = node->startTime;
+        if(node->endTime > lastEnd) lastEnd = node->endTime;
+
+        templateStats_t *t = getTemplate(templates, &templateCount, node->funcPtr);
+        t->count++;
+        t->work += w;
+        u64 ready = node->readyTime ? node->readyTime : node->createTime;
+        if(ready && (ready <= node->startTime)){
+            u64 latency = node->startTime - ready;
+            latencies[latencyCount++] = latency;
+            latencySum += latency;
+            t->latency += latency;
+            if(latency > t->maxLatency) t->maxLatency = latency;
+            u32 b = 0;
+            while((b < LATENCY_BUCKETS - 1) && ((latency >> b) > 1)) b++;
+            latencyHist[b]++;
+        }
+        if((node->readyWorker >= 0) && (node->readyWorker != node->execWorker)) graph.steals++;
+    }
+
+    //Walk back the critical path
+    u32 critLength = 0;
+    for(n = critEnd; n != NO_NODE; n = graph.nodes[n].critPred){
+        templateStats_t *t = getTemplate(templates, &templateCount, graph.nodes[n].funcPtr);
+        t->critWork += nodeWork(&graph.nodes[n]);
+        t->critCount++;
+        critLength++;
+    }
+    qsort(latencies, latencyCount, sizeof(u64), compareU64);
+    qsort(templates, templateCount, sizeof(templateStats_t), compareWork);
+
+    //Number of workers that executed EDTs
+    u32 workers = 0;
+    {
+        u64 *ids = malloc((executed + 1) * sizeof(u64));
+        for(k = 0; k < executed; k++)
+            ids[k] = (graph.nodes[order[k]].location << 16) ^ (u64)graph.nodes[order[k]].execWorker;
+        qsort(ids, executed, sizeof(u64), compareU64);
+        for(k = 0; k < executed; k++) workers += (k == 0) || (ids[k] != ids[k-1]);
+        free(ids);
+    }
+    u64 makespan = (lastEnd > firstStart) ? (lastEnd - firstStart) : 0;
+    double parallelism = span ? ((double)work / span) : 0.0;
+    double efficiency = (makespan && workers) ? ((double)work / ((double)makespan * workers)) : 0.0;
+
+    if(json){
+        printf("{\"edts\": %"PRIu32", \"executed\": %"PRIu32", \"workers\": %"PRIu32", "
+               "\"work_ns\": %"PRIu64", \"span_ns\": %"PRIu64", \"makespan_ns\": %"PRIu64", "
+               "\"parallelism\": %.3f, \"efficiency\": %.3f, \"critical_path_edts\": %"PRIu32", "
+               "\"latency_ns\": {\"mean\": %"PRIu64", \"p50\": %"PRIu64", \"p90\": %"PRIu64", \"p99\": %"PRIu64", \"max\": %"PRIu64"}, "
+               "\"steals\": %"PRIu64", \"dropped_records\": %"PRIu64"}\n",
+               graph.nodeCount, executed, workers, work, span, makespan, parallelism, efficiency, critLength,
+               latencyCount ? (latencySum / latencyCount) : 0, percentile(latencies, latencyCount, 50),
+               percentile(latencies, latencyCount, 90), percentile(latencies, latencyCount, 99),
+               latencyCount ? latencies[latencyCount-1] : 0, graph.steals, graph.dropped);
+        return 0;
+    }
+
+    if(graph.dropped)
+        printf("WARNING: %"PRIu64" records were dropped while tracing, the results are approximate\n\n", graph.dropped);
+    printf("== Task graph ==\n");
+    printf("EDTs:                 %"PRIu32" (%"PRIu32" executed on %"PRIu32" workers)\n", graph.nodeCount, executed, workers);
+    printf("Edges:                %"PRIu32"\n", graph.edgeCount);
+    printf("Total work:           %.3f ms\n", work / 1e6);
+    printf("Critical path:        %.3f ms (%"PRIu32" EDTs)\n", span / 1e6, critLength);
+    printf("Parallelism:          %.2f (work / critical path)\n", parallelism);
+    printf("Makespan:             %.3f ms\n", makespan / 1e6);
+    printf("Efficiency:           %.2f (work / (makespan * workers))\n", efficiency);
+    printf("Steals:               %"PRIu64"\n", graph.steals);
+
+    printf("\n== Scheduling latency (runnable to start) ==\n");
+    printf("mean %"PRIu64" ns | p50 %"PRIu64" ns | p90 %"PRIu64" ns | p99 %"PRIu64" ns | max %"PRIu64" ns\n",
+           latencyCount ? (latencySum / latencyCount) : 0, percentile(latencies, latencyCount, 50),
+           percentile(latencies, latencyCount, 90), percentile(latencies, latencyCount, 99),
+           latencyCount ? latencies[latencyCount-1] : 0);
+    for(k = 0; k < LATENCY_BUCKETS; k++){
+        if(latencyHist[k] == 0) continue;
+        u32 bar = (u32)((latencyHist[k] * 50) / latencyCount);
+        printf("%12"PRIu64" ns  %10"PRIu64"  ", k ? (1ULL << k) : 0, latencyHist[k]);
+        while(bar--) putchar('#');
+        putchar('\n');
+    }
+
+    //Average number of running and runnable EDTs per time slice
+    printf("\n== Parallelism over time ==\n");
+    printf("%12s %10s %10s\n", "time (ms)", "running", "runnable");
+    if(makespan){
+        double *running = calloc(bins, sizeof(double));
+        double *runnable = calloc(bins, sizeof(double));
+        double width = (double)makespan / bins;
+        for(k = 0; k < executed; k++){
+            edtNode_t *node = &graph.nodes[order[k]];
+            u64 ready = node->readyTime ? node->readyTime : node->createTime;
+            u32 pass;
+            for(pass = 0; pass < 2; pass++){
+                double from = (double)((pass ? node->startTime : ready) - firstStart);
+                double to = (double)((pass ? node->endTime : node->startTime) - firstStart);
+                if(!pass && ((ready == 0) || (ready < firstStart) || (ready > node->startTime))) continue;
+                u32 b;
+                for(b = (u32)(from / width); (b < bins) && (b * width < to); b++){
+                    double lo = (from > b * width) ? from : b * width;
+                    double hi = (to < (b + 1) * width) ? to : (b + 1) * width;
+                    if(hi > lo) (pass ? running : runnable)[b] += (hi - lo) / width;
+                }
+            }
+        }
+        for(k = 0; k < bins; k++)
+            printf("%12.3f %10.2f %10.2f\n", k * width / 1e6, running[k], runnable[k]);
+        free(running);
+        free(runnable);
+    }
+
+    printf("\n== Templates (by total work) ==\n");
+    printf("%-18s %10s %12s %12s %12s %12s %10s\n", "function", "count", "work (ms)", "avg (us)",
+           "lat avg (us)", "lat max (us)", "crit (ms)");
+    for(k = 0; (k < templateCount) && (k < top); k++){
+        templateStats_t *t = &templates[k];
+        printf("0x%-16"PRIx64" %10"PRIu64" %12.3f %12.3f %12.3f %12.3f %10.3f\n", t->funcPtr, t->count,
+               t->work / 1e6, t->count ? (t->work / 1e3 / t->count) : 0.0,
+               t->count ? (t->latency / 1e3 / t->count) : 0.0, t->maxLatency / 1e3, t->critWork / 1e6);
+    }
+
+    free(latencies);
+    free(templates);
+    free(order);
+    freeGraph(&graph);
+    return 0;
+}
@@ -5,6 +5,7 @@
 
 #include "ocr.h"
 #include "utils/tracer/tracer.h"
+#include "traceRead.h"
 #include "utils/tracer/trace-events.h"
 #include "ocr-perfmon.h"
 
@@ -13,7 +14,12 @@
 #define SYS_CALL_COMMAND_LENGTH 256
 #define BIN_PATH_LENGTH 128
 
-void translateObject(ocrTraceObj_t *trace);
+void translateObject(ocrTraceObj_t *trace, void *arg);
+
+void printDropped(ocrTracePageHeader_t *header, void *arg){
+    printf("[TRACE] PD: 0x%"PRIx64" | WORKER_ID: %"PRIu64" | DROPPED: %"PRIu32"\n",
+           header->location, header->workerId, header->dropped);
+}
 
 int main(int argc, char *argv[]){
 
@@ -24,23 +30,11 @@ int main(int argc, char *argv[]){
         return 1;
     }
 
-    char *fname = argv[1];
-
-    ocrTraceObj_t *trace = malloc(sizeof(ocrTraceObj_t));
-
-    //Read each trace record, and decode
+    //Read each trace file, and decode its records
     int i;
     for(i=1; i < argc; i++){
-        FILE *f = fopen(argv[i], "r");
-        if(f == NULL){
-            printf("Error:  Unable to open provided trace binary\n");
+        if(traceReadFile(argv[i], translateObject, printDropped, NULL) < 0)
             return 1;
-        }
-
-        while(fread(trace, sizeof(ocrTraceObj_t), 1, f)){
-            translateObject(trace);
-        }
-        fclose(f);
     }
     return 0;
 }
@@ -54,7 +48,7 @@ void genericPrint(bool evtType, ocrTraceType_t ttype, ocrTraceAction_t action,
     return;
 }
 
-void translateObject(ocrTraceObj_t *trace){
+void translateObject(ocrTraceObj_t *trace, void *arg){
     ocrTraceType_t  ttype = trace->typeSwitch;
     ocrTraceAction_t action =  trace->actionSwitch;
     u64 timestamp = trace->time;
@@ -173,7 +167,7 @@ void translateObject(ocrTraceObj_t *trace){
             }
             case OCR_ACTION_FINISH:
             {
-#if !defined(OCR_ENABLE_SIMULATOR)
+#if !defined(OCR_ENABLE_SIMULATOR) && !defined(ENABLE_EXTENSION_PERF)
                 ocrGuid_t taskGuid = TRACE_FIELD(TASK, taskCreate, trace, taskGuid);
                 genericPrint(evtType, ttype, action, location, workerId, timestamp, parent);
 #else
@@ -183,6 +177,8 @@ void translateObject(ocrTraceObj_t *trace){
                 u64 hwCacheRefs = TRACE_FIELD(TASK, taskExeEnd, trace, hwCacheRefs);
                 u64 hwCacheMisses = TRACE_FIELD(TASK, taskExeEnd, trace, hwCacheMisses);
                 u64 hwFpOps = TRACE_FIELD(TASK, taskExeEnd, trace, hwFpOps);
+                u64 hwInstructions = TRACE_FIELD(TASK, taskExeEnd, trace, hwInstructions);
+                u64 hwStalledCycles = TRACE_FIELD(TASK, taskExeEnd, trace, hwStalledCycles);
                 u64 swEdtCreates = TRACE_FIELD(TASK, taskExeEnd, trace, swEdtCreates);
                 u64 swDbTotal = TRACE_FIELD(TASK, taskExeEnd, trace, swDbTotal);
                 u64 swDbCreates = TRACE_FIELD(TASK, taskExeEnd, trace, swDbCreates);
@@ -190,9 +186,9 @@ void translateObject(ocrTraceObj_t *trace){
                 u64 swEvtSats = TRACE_FIELD(TASK, taskExeEnd, trace, swEvtSats);
                 void *edt = TRACE_FIELD(TASK, taskExeEnd, trace, edt);
 
-                printf("[TRACE] U/R: %s | PD: 0x%"PRIx64" | WORKER_ID: %"PRIu64" | EDT: "GUIDF" | TIMESTAMP: %"PRIu64" | TYPE: EDT | ACTION: FINISH | GUID: "GUIDF" | FP: %p | COUNT: %"PRId64" | CYCLES: %"PRId64" | CACHE_REFS: %"PRId64" | CACHE_MISSES: %"PRId64" | FP_OPS: %"PRId64" | EDT_CREATES: %"PRId64" | DB_TOTAL: %"PRId64" | DB_CREATES: %"PRId64" | DB_DESTROYS: %"PRId64" | EVT_SATS: %"PRId64"\n",
+                printf("[TRACE] U/R: %s | PD: 0x%"PRIx64" | WORKER_ID: %"PRIu64" | EDT: "GUIDF" | TIMESTAMP: %"PRIu64" | TYPE: EDT | ACTION: FINISH | GUID: "GUIDF" | FP: %p | COUNT: %"PRId64" | CYCLES: %"PRId64" | CACHE_REFS: %"PRId64" | CACHE_MISSES: %"PRId64" | FP_OPS: %"PRId64" | INSTRUCTIONS: %"PRId64" | STALLED_CYCLES: %"PRId64" | EDT_CREATES: %"PRId64" | DB_TOTAL: %"PRId64" | DB_CREATES: %"PRId64" | DB_DESTROYS: %"PRId64" | EVT_SATS: %"PRId64"\n",
                         evt_type[evtType], location, workerId, GUIDA(parent), timestamp, GUIDA(taskGuid), edt, count, hwCycles, hwCacheRefs, hwCacheMisses, hwFpOps,
-                        swEdtCreates, swDbTotal, swDbCreates, swDbDestroys, swEvtSats);
+                        hwInstructions, hwStalledCycles, swEdtCreates, swDbTotal, swDbCreates, swDbDestroys, swEvtSats);
 #endif
                 break;
             }
@@ -0,0 +1,263 @@
+#ifndef __TRACE_GRAPH_H__
+#define __TRACE_GRAPH_H__
+
+#include "traceRead.h"
+
+/*
+ * EDT graph of binary traces shared by traceAnalyze and schedSim.
+ *
+ * The graph is rebuilt from the CREATE, SATISFY, RUNNABLE, SCHEDULED,
+ * EXECUTE, FINISH and DATA_ACQUIRE records of EDTs. An edge P -> X is
+ * recorded when EDT P creates X or satisfies one of its dependences, with
+ * the time at which it happened.
+ */
+
+#define NO_NODE             ((u32)-1)
+
+typedef struct {
+    u64 guid;
+    u64 location;
+    u64 funcPtr;
+    u64 createTime;
+    u64 readyTime;          /* RUNNABLE record, or last dependence satisfied */
+    u64 startTime;
+    u64 endTime;
+    u64 pathStart;          /* Length of the longest chain of work ending at the start of the EDT */
+    s64 readyWorker;        /* Worker that scheduled the EDT (-1 if unknown) */
+    s64 execWorker;
+    u32 edges;              /* First incoming edge */
+    u32 acquires;           /* First datablock acquired */
+    u32 critPred;           /* Predecessor on the longest chain */
+    u8 scheduled;           /* readyWorker comes from a SCHEDULED record */
+} edtNode_t;
+
+typedef struct {
+    u32 pred;
+    u32 next;
+    u64 time;
+} edtEdge_t;
+
+typedef struct {
+    u64 db;
+    u64 size;
+    u32 next;
+} dbAcquire_t;
+
+typedef struct {
+    u64 time;
+    u64 location;
+    u64 workerId;
+    u64 funcPtr;
+    u64 seq;                /* Order in the files, to keep the sort stable */
+    u64 db;                 /* Datablock and size of DATA_ACQUIRE records */
+    u64 size;
+    ocrGuid_t guid;
+    ocrGuid_t parent;
+    ocrTraceAction_t action;
+} traceRecord_t;
+
+typedef struct {
+    traceRecord_t *records;
+    u64 recordCount, recordSize;
+    edtNode_t *nodes;
+    u32 nodeCount, nodeSize;
+    u32 *index;             /* Open-addressed GUID -> node table */
+    u32 indexSize;
+    edtEdge_t *edges;
+    u32 edgeCount, edgeSize;
+    dbAcquire_t *acquires;
+    u32 acquireCount, acquireSize;
+    u64 dropped;
+    u64 steals;
+} traceGraph_t;
+
+static u32 hashGuid(u64 guid, u32 size){
+    return (u32)((guid * 0x9E3779B97F4A7C15ULL) >> 32) & (size - 1);
+}
+
+static void growIndex(traceGraph_t *g){
+    u32 size = g->indexSize ? (g->indexSize << 1) : 1024;
+    u32 *index = malloc(size * sizeof(u32));
+    u32 i;
+    memset(index, 0xff, size * sizeof(u32));
+    //Later incarnations of a recycled GUID replace the earlier ones
+    for(i = 0; i < g->nodeCount; i++){
+        u32 h = hashGuid(g->nodes[i].guid, size);
+        while((index[h] != NO_NODE) && (g->nodes[index[h]].guid != g->nodes[i].guid)) h = (h + 1) & (size - 1);
+        index[h] = i;
+    }
+    free(g->index);
+    g->index = index;
+    g->indexSize = size;
+}
+
+//Returns the current node of a GUID, creating one if there is none or if 'fresh' is set
+static u32 getNode(traceGraph_t *g, ocrGuid_t guid, u64 location, u8 fresh){
+    u64 key = (u64)GUIDA(guid);
+    if(key == 0) return NO_NODE;
+    if((g->nodeCount + 1) * 2 > g->indexSize) growIndex(g);
+    u32 h = hashGuid(key, g->indexSize);
+    while(g->index[h] != NO_NODE){
+        if(g->nodes[g->index[h]].guid == key){
+            if(!fresh) return g->index[h];
+            break;
+        }
+        h = (h + 1) & (g->indexSize - 1);
+    }
+    if(g->nodeCount == g->nodeSize){
+        g->nodeSize = g->nodeSize ? (g->nodeSize << 1) : 1024;
+        g->nodes = realloc(g->nodes, g->nodeSize * sizeof(edtNode_t));
+    }
+    edtNode_t *node = &g->nodes[g->nodeCount];
+    memset(node, 0, sizeof(edtNode_t));
+    node->guid = key;
+    node->location = location;
+    node->readyWorker = -1;
+    node->execWorker = -1;
+    node->edges = NO_NODE;
+    node->acquires = NO_NODE;
+    node->critPred = NO_NODE;
+    g->index[h] = g->nodeCount;
+    return g->nodeCount++;
+}
+
+static void addEdge(traceGraph_t *g, ocrGuid_t pred, u32 node, u64 time){
+    u32 p = getNode(g, pred, g->nodes[node].location, 0);
+    if((p == NO_NODE) || (p == node)) return;
+    if(g->edgeCount == g->edgeSize){
+        g->edgeSize = g->edgeSize ? (g->edgeSize << 1) : 4096;
+        g->edges = realloc(g->edges, g->edgeSize * sizeof(edtEdge_t));
+    }
+    edtEdge_t *e = &g->edges[g->edgeCount];
+    e->pred = p;
+    e->time = time;
+    e->next = g->nodes[node].edges;
+    g->nodes[node].edges = g->edgeCount++;
+}
+
+static void addAcquire(traceGraph_t *g, u32 node, u64 db, u64 size){
+    if(g->acquireCount == g->acquireSize){
+        g->acquireSize = g->acquireSize ? (g->acquireSize << 1) : 4096;
+        g->acquires = realloc(g->acquires, g->acquireSize * sizeof(dbAcquire_t));
+    }
+    dbAcquire_t *a = &g->acquires[g->acquireCount];
+    a->db = db;
+    a->size = size;
+    a->next = g->nodes[node].acquires;
+    g->nodes[node].acquires = g->acquireCount++;
+}
+
+//Keep the records the analysis uses; they are processed in time order once all files are read
+static void recordTrace(ocrTraceObj_t *trace, void *arg){
+    traceGraph_t *g = (traceGraph_t *)arg;
+    traceRecord_t rec;
+    if(trace->typeSwitch != OCR_TRACE_TYPE_EDT) return;
+    memset(&rec, 0, sizeof(rec));
+    switch(trace->actionSwitch){
+        case OCR_ACTION_CREATE:
+            rec.guid = TRACE_FIELD(TASK, taskCreate, trace, taskGuid);
+            break;
+        case OCR_ACTION_SATISFY:
+            rec.guid = TRACE_FIELD(TASK, taskDepSatisfy, trace, taskGuid);
+            break;
+        case OCR_ACTION_RUNNABLE:
+            rec.guid = TRACE_FIELD(TASK, taskReadyToRun, trace, taskGuid);
+            break;
+        case OCR_ACTION_SCHEDULED:
+            rec.guid = TRACE_FIELD(TASK, taskScheduled, trace, taskGuid);
+            break;
+        case OCR_ACTION_EXECUTE:
+            rec.guid = TRACE_FIELD(TASK, taskExeBegin, trace, taskGuid);
+            rec.funcPtr = (u64)TRACE_FIELD(TASK, taskExeBegin, trace, funcPtr);
+            break;
+        case OCR_ACTION_FINISH:
+            rec.guid = TRACE_FIELD(TASK, taskExeEnd, trace, taskGuid);
+            break;
+        case OCR_ACTION_DATA_ACQUIRE:
+            rec.guid = TRACE_FIELD(TASK, taskDataAcquire, trace, taskGuid);
+            rec.db = (u64)GUIDA(TRACE_FIELD(TASK, taskDataAcquire, trace, dbGuid));
+            rec.size = TRACE_FIELD(TASK, taskDataAcquire, trace, dbSize);
+            break;
+        default:
+            return;
+    }
+    rec.action = trace->actionSwitch;
+    rec.time = trace->time;
+    rec.location = trace->location;
+    rec.workerId = trace->workerId;
+    rec.parent = trace->parent;
+    rec.seq = g->recordCount;
+    if(g->recordCount == g->recordSize){
+        g->recordSize = g->recordSize ? (g->recordSize << 1) : 4096;
+        g->records = realloc(g->records, g->recordSize * sizeof(traceRecord_t));
+    }
+    g->records[g->recordCount++] = rec;
+}
+
+static int compareRecords(const void *a, const void *b){
+    const traceRecord_t *ra = (const traceRecord_t *)a, *rb = (const traceRecord_t *)b;
+    if(ra->time != rb->time) return (ra->time > rb->time) - (ra->time < rb->time);
+    return (ra->seq > rb->seq) - (ra->seq < rb->seq);
+}
+
+//GUIDs may be recycled once an EDT is destroyed, so a CREATE starts a new node
+static void buildGraph(traceGraph_t *g){
+    u64 i;
+    qsort(g->records, g->recordCount, sizeof(traceRecord_t), compareRecords);
+    for(i = 0; i < g->recordCount; i++){
+        traceRecord_t *rec = &g->records[i];
+        u32 n = getNode(g, rec->guid, rec->location, rec->action == OCR_ACTION_CREATE);
+        if(n == NO_NODE) continue;
+        edtNode_t *node = &g->nodes[n];
+        switch(rec->action){
+            case OCR_ACTION_CREATE:
+                node->createTime = rec->time;
+                addEdge(g, rec->parent, n, rec->time);
+                break;
+            case OCR_ACTION_SATISFY:
+                if(rec->time > node->readyTime) node->readyTime = rec->time;
+                addEdge(g, rec->parent, n, rec->time);
+                break;
+            case OCR_ACTION_RUNNABLE:
+                node->readyTime = rec->time;
+                if(!node->scheduled) node->readyWorker = rec->workerId;
+                break;
+            case OCR_ACTION_SCHEDULED:
+                node->readyWorker = rec->workerId;
+                node->scheduled = 1;
+                break;
+            case OCR_ACTION_EXECUTE:
+                node->startTime = rec->time;
+                node->execWorker = rec->workerId;
+                node->funcPtr = rec->funcPtr;
+                break;
+            case OCR_ACTION_FINISH:
+                node->endTime = rec->time;
+                break;
+            case OCR_ACTION_DATA_ACQUIRE:
+                addAcquire(g, n, rec->db, rec->size);
+                break;
+            default:
+                break;
+        }
+    }
+    free(g->records);
+    g->records = NULL;
+}
+
+static void recordDropped(ocrTracePageHeader_t *header, void *arg){
+    ((traceGraph_t *)arg)->dropped += header->dropped;
+}
+
+static u64 nodeWork(edtNode_t *node){
+    return (node->endTime > node->startTime) ? (node->endTime - node->startTime) : 0;
+}
+
+static void freeGraph(traceGraph_t *g){
+    free(g->nodes);
+    free(g->index);
+    free(g->edges);
+    free(g->acquires);
+}
+
+#endif /* __TRACE_GRAPH_H__ */
@@ -0,0 +1,113 @@
+#ifndef __TRACE_READ_H__
+#define __TRACE_READ_H__
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ocr.h"
+#include "utils/tracer/tracer.h"
+
+/*
+ * Reading of binary trace files shared by the trace utilities.
+ * A trace file is a sequence of per-worker pages of packed records
+ * (see src/utils/tracer/tracer.h).
+ */
+
+/* Called on each record with the trace object it decodes to */
+typedef void (*traceRecordFct)(ocrTraceObj_t *trace, void *arg);
+
+/* Called on each page that counts records dropped before it */
+typedef void (*traceDroppedFct)(ocrTracePageHeader_t *header, void *arg);
+
+//Unpack the records of a page into trace objects (see tracer.h for the format)
+static int traceDecodePage(ocrTracePageHeader_t *header, u8 *records, ocrTraceObj_t *trace,
+                           traceRecordFct recordFct, void *arg){
+    ocrTraceField_t fields[TRACE_MAX_FIELDS];
+    u64 time = header->baseTime;
+    u32 offset = 0;
+    u32 r;
+    for(r = 0; r < header->count; r++){
+        if((offset + TRACE_RECORD_HEADER_SIZE) > header->used) break;
+        u8 *record = records + offset;
+        u32 size = record[0] | (((u32)record[1]) << 8);
+        if((size < TRACE_RECORD_HEADER_SIZE) || ((offset + size) > header->used)) break;
+
+        memset(trace, 0, sizeof(ocrTraceObj_t));
+        trace->typeSwitch = (ocrTraceType_t)(record[2] + OCR_TRACE_TYPE_EDT);
+        trace->actionSwitch = (ocrTraceAction_t)record[3];
+        trace->eventType = record[4];
+        trace->location = header->location;
+        trace->workerId = header->workerId;
+
+        s64 delta;
+        u32 pos = TRACE_RECORD_HEADER_SIZE;
+        pos += traceVarintDecode(record + pos, &delta);
+        time += delta;
+        trace->time = time;
+        memcpy(&trace->parent, record + pos, sizeof(ocrGuid_t));
+        pos += sizeof(ocrGuid_t);
+
+        //Fields are unpacked in order so array counts are known before the arrays
+        u32 fieldCount = traceObjectFields(trace, fields);
+        u32 j;
+        for(j = 0; j < fieldCount; j++){
+            u32 fieldSize = traceFieldSize(&fields[j]);
+            if((pos + fieldSize) > size) break;
+            memcpy(fields[j].addr, record + pos, fieldSize);
+            pos += fieldSize;
+        }
+        if(j != fieldCount) break;
+
+        recordFct(trace, arg);
+        offset += size;
+    }
+    return (r != header->count);
+}
+
+//Decode all the records of a trace file. Returns -1 if the file cannot be
+//opened and 1 if it is malformed (records up to the error are decoded)
+static int traceReadFile(const char *name, traceRecordFct recordFct, traceDroppedFct droppedFct, void *arg){
+    FILE *f = fopen(name, "r");
+    if(f == NULL){
+        printf("Error:  Unable to open trace file %s\n", name);
+        return -1;
+    }
+
+    ocrTracePageHeader_t header;
+    ocrTraceObj_t *trace = malloc(sizeof(ocrTraceObj_t));
+    u8 *records = NULL;
+    u32 recordsSize = 0;
+    int err = 0;
+    while(fread(&header, sizeof(ocrTracePageHeader_t), 1, f)){
+        if((header.magic != TRACE_PAGE_MAGIC) || (header.pageSize < sizeof(ocrTracePageHeader_t)) ||
+           (header.used > (header.pageSize - sizeof(ocrTracePageHeader_t)))){
+            printf("Error:  Malformed trace page in %s\n", name);
+            err = 1;
+            break;
+        }
+        u32 payload = header.pageSize - sizeof(ocrTracePageHeader_t);
+        if(payload > recordsSize){
+            records = realloc(records, payload);
+            recordsSize = payload;
+        }
+        if(fread(records, 1, payload, f) != payload){
+            printf("Error:  Truncated trace page in %s\n", name);
+            err = 1;
+            break;
+        }
+        if((header.dropped != 0) && (droppedFct != NULL))
+            droppedFct(&header, arg);
+        if(traceDecodePage(&header, records, trace, recordFct, arg)){
+            printf("Error:  Malformed trace record in %s\n", name);
+            err = 1;
+            break;
+        }
+    }
+    free(records);
+    free(trace);
+    fclose(f);
+    return err;
+}
+
+#endif /* __TRACE_READ_H__ */
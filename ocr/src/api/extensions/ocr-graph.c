@@ -0,0 +1,492 @@
+/*
+ * This file is subject to the license agreement located in the file LICENSE
+ * and cannot be distributed without it. This notice cannot be
+ * removed or modified.
+ */
+
+#include "ocr-config.h"
+#include "ocr-errors.h"
+#ifdef ENABLE_EXTENSION_GRAPH
+
+#include "debug.h"
+#include "ocr-hal.h"
+#include "ocr-policy-domain.h"
+#include "ocr-task.h"
+#include "experimental/ocr-graph-runtime.h"
+#include "extensions/ocr-graph.h"
+#include "utils/hashtable.h"
+
+#include "utils/profiler/profiler.h"
+
+#define DEBUG_TYPE API
+
+// Initial number of elements of the capture arrays
+#define GRAPH_CAPTURE_CHUNK 32
+
+// Dependences a replay adds with a single ocrAddDependences call
+#define GRAPH_REPLAY_DEP_CHUNK 64
+
+// Initial number of buckets of the GUID to reference map of a capture
+#define GRAPH_REF_MAP_BUCKETS 64
+
+/******************************************************/
+/* CAPTURE                                            */
+/******************************************************/
+
+// Makes room for 'count' more elements of 'elSize' bytes in '*array'
+static bool graphReserve(ocrPolicyDomain_t *pd, ocrGraph_t *graph, void **array, u32 *max,
+                         u32 used, u32 count, u32 elSize) {
+    if (used + count <= *max)
+        return true;
+    u32 newMax = (*max == 0) ? GRAPH_CAPTURE_CHUNK : *max;
+    while (newMax < used + count)
+        newMax *= 2;
+    void *newArray = pd->fcts.pdMalloc(pd, (u64)newMax * elSize);
+    if (newArray == NULL) {
+        DPRINTF(DEBUG_LVL_WARN, "Graph capture: unable to allocate %"PRIu32" elements\n", newMax);
+        graph->failed = true;
+        return false;
+    }
+    if (*array != NULL) {
+        hal_memCopy(newArray, *array, (u64)used * elSize, false);
+        pd->fcts.pdFree(pd, *array);
+    }
+    *array = newArray;
+    *max = newMax;
+    return true;
+}
+
+// Reserves an operation and its nodes, parameters, slots and hint
+static ocrGraphOp_t * graphCaptureOp(ocrPolicyDomain_t *pd, ocrGraph_t *graph,
+                                     u32 nodes, u32 params, u32 refs, u32 hints) {
+    if (graph->failed || graph->unsupported)
+        return NULL;
+    if (!graphReserve(pd, graph, (void**)&graph->ops, &graph->opMax, graph->opCount, 1, sizeof(ocrGraphOp_t)) ||
+        !graphReserve(pd, graph, (void**)&graph->nodes, &graph->nodeMax, graph->nodeCount, nodes, sizeof(ocrGuid_t)) ||
+        !graphReserve(pd, graph, (void**)&graph->params, &graph->paramMax, graph->paramCount, params, sizeof(u64)) ||
+        !graphReserve(pd, graph, (void**)&graph->refs, &graph->refMax, graph->refCount, refs, sizeof(u32)) ||
+        !graphReserve(pd, graph, (void**)&graph->hints, &graph->hintMax, graph->hintCount, hints, sizeof(ocrHint_t)))
+        return NULL;
+    return &graph->ops[graph->opCount++];
+}
+
+static u32 graphHashGuid(void *key, u32 nbBuckets) {
+    u64 k = ((u64)key) * 0x9E3779B97F4A7C15ULL;
+    return (u32)(k >> 32) % nbBuckets;
+}
+
+static inline void * graphGuidKey(ocrGuid_t guid) {
+#if GUID_BIT_COUNT == 64
+    return (void *)guid.guid;
+#elif GUID_BIT_COUNT == 128
+    return (void *)(guid.lower ^ guid.upper);
+#else
+#error Unknown type of GUID
+#endif
+}
+
+// Maps 'guid' to 'ref', which must already be counted in the graph. The
+// map is rebuilt with more buckets when its chains get long; GUIDs are
+// put in creation order so that a reused GUID maps to its latest node.
+static void graphRefMapPut(ocrPolicyDomain_t *pd, ocrGraph_t *graph, ocrGuid_t guid, u32 ref) {
+    hashtable_t *map = graph->refMap;
+    if ((map != NULL) && ((graph->nodeCount + graph->inputCount) <= (map->nbBuckets * 2))) {
+        hashtableNonConcPut(map, graphGuidKey(guid), (void *)((u64)ref + 1));
+        return;
+    }
+    u32 nbBuckets = (map == NULL) ? GRAPH_REF_MAP_BUCKETS : (map->nbBuckets * 4);
+    if (map != NULL)
+        destructHashtable(map, NULL, NULL);
+    map = newHashtable(pd, nbBuckets, graphHashGuid);
+    u32 i;
+    for (i = 0; i < graph->inputCount; ++i)
+        hashtableNonConcPut(map, graphGuidKey(graph->inputs[i]), (void *)((u64)(GRAPH_REF_INPUT | i) + 1));
+    for (i = 0; i < graph->nodeCount; ++i)
+        hashtableNonConcPut(map, graphGuidKey(graph->nodes[i]), (void *)((u64)i + 1));
+    graph->refMap = map;
+}
+
+// Returns the reference to 'guid', making it an input if the graph did not create it
+static u32 graphCaptureRef(ocrPolicyDomain_t *pd, ocrGraph_t *graph, ocrGuid_t guid) {
+    if (ocrGuidIsNull(guid))
+        return GRAPH_REF_NULL;
+    if (ocrGuidIsUninitialized(guid))
+        return GRAPH_REF_UNINIT;
+    void *value = (graph->refMap == NULL) ? NULL : hashtableNonConcGet(graph->refMap, graphGuidKey(guid));
+    if (value != NULL) {
+        u32 ref = (u32)((u64)value - 1);
+        // 128-bit GUIDs share keys: a mismatch just adds an input
+        if (ocrGuidIsEq((ref & GRAPH_REF_INPUT) ? graph->inputs[ref & ~GRAPH_REF_INPUT] : graph->nodes[ref], guid))
+            return ref;
+    }
+    if (!graphReserve(pd, graph, (void**)&graph->inputs, &graph->inputMax, graph->inputCount, 1, sizeof(ocrGuid_t)))
+        return GRAPH_REF_NULL;
+    u32 ref = GRAPH_REF_INPUT | graph->inputCount;
+    graph->inputs[graph->inputCount++] = guid;
+    graphRefMapPut(pd, graph, guid, ref);
+    return ref;
+}
+
+void graphCaptureEvent(ocrTask_t *task, ocrGuid_t guid, ocrEventTypes_t type,
+                       u16 properties, ocrEventParams_t *params) {
+    ocrGraph_t *graph = task->graphCapture;
+    ocrPolicyDomain_t *pd = NULL;
+    getCurrentEnv(&pd, NULL, NULL, NULL);
+    if (properties & GUID_PROP_IS_LABELED) {
+        DPRINTF(DEBUG_LVL_WARN, "Graph capture: labeled events cannot be replayed\n");
+        graph->unsupported = true;
+        return;
+    }
+    ocrGraphOp_t *op = graphCaptureOp(pd, graph, 1, 0, 0, 0);
+    if (op == NULL)
+        return;
+    op->kind = GRAPH_OP_EVENT;
+    op->event.node = graph->nodeCount;
+    op->event.type = type;
+    op->event.properties = properties;
+    op->event.hasParams = (params != NULL);
+    if (params != NULL)
+        op->event.params = *params;
+    graph->nodes[graph->nodeCount++] = guid;
+    graphRefMapPut(pd, graph, guid, op->event.node);
+    graph->eventCount++;
+}
+
+void graphCaptureEdt(ocrTask_t *task, ocrGuid_t guid, ocrGuid_t templateGuid,
+                     u32 paramc, u64 *paramv, u32 depc, ocrGuid_t *depv,
+                     u16 properties, ocrHint_t *hint, ocrGuid_t *outputEvent) {
+    ocrGraph_t *graph = task->graphCapture;
+    ocrPolicyDomain_t *pd = NULL;
+    getCurrentEnv(&pd, NULL, NULL, NULL);
+    if (properties & (GUID_PROP_IS_LABELED | EDT_PROP_OEVT_VALID)) {
+        DPRINTF(DEBUG_LVL_WARN, "Graph capture: labeled EDTs and user output events cannot be replayed\n");
+        graph->unsupported = true;
+        return;
+    }
+    ocrGraphOp_t *op = graphCaptureOp(pd, graph, (outputEvent != NULL) ? 2 : 1, paramc, depc,
+                                      (hint != NULL_HINT) ? 1 : 0);
+    if (op == NULL)
+        return;
+    u32 i;
+    op->kind = GRAPH_OP_EDT;
+    op->edt.templateGuid = templateGuid;
+    op->edt.node = graph->nodeCount;
+    op->edt.paramc = paramc;
+    op->edt.paramOffset = graph->paramCount;
+    op->edt.depc = depc;
+    op->edt.depvOffset = graph->refCount;
+    op->edt.properties = properties;
+    op->edt.hasOutputEvent = (outputEvent != NULL);
+    graph->nodes[graph->nodeCount++] = guid;
+    graphRefMapPut(pd, graph, guid, op->edt.node);
+    if (outputEvent != NULL) {
+        graph->nodes[graph->nodeCount++] = *outputEvent;
+        graphRefMapPut(pd, graph, *outputEvent, op->edt.node + 1);
+        graph->eventCount++;
+    }
+    for (i = 0; i < paramc; ++i)
+        graph->params[graph->paramCount + i] = paramv[i];
+    graph->paramCount += paramc;
+    // Slots are filled in later if ocrAddDependence() targets them
+    for (i = 0; i < depc; ++i) {
+        u32 ref = (depv != NULL) ? graphCaptureRef(pd, graph, depv[i]) : GRAPH_REF_UNINIT;
+        graph->refs[graph->refCount + i] = ref;
+        graph->depCount += (ref != GRAPH_REF_UNINIT);
+    }
+    graph->refCount += depc;
+    if (hint != NULL_HINT) {
+        graph->hints[graph->hintCount] = *hint;
+        op->edt.hint = graph->hintCount++;
+    } else {
+        op->edt.hint = GRAPH_REF_NULL;
+    }
+    if (depc > graph->maxDepc)
+        graph->maxDepc = depc;
+    graph->edtCount++;
+}
+
+void graphCaptureDep(ocrTask_t *task, ocrGuid_t source, ocrGuid_t destination,
+                     u32 slot, ocrDbAccessMode_t mode) {
+    ocrGraph_t *graph = task->graphCapture;
+    ocrPolicyDomain_t *pd = NULL;
+    getCurrentEnv(&pd, NULL, NULL, NULL);
+    ocrGraphOp_t *op = graphCaptureOp(pd, graph, 0, 0, 0, 0);
+    if (op == NULL)
+        return;
+    op->kind = GRAPH_OP_DEP;
+    op->dep.source = graphCaptureRef(pd, graph, source);
+    op->dep.destination = graphCaptureRef(pd, graph, destination);
+    op->dep.slot = slot;
+    op->dep.mode = mode;
+    graph->depCount++;
+}
+
+static void graphCaptureFree(ocrPolicyDomain_t *pd, ocrGraph_t *graph) {
+    if (graph->ops != NULL) pd->fcts.pdFree(pd, graph->ops);
+    if (graph->hints != NULL) pd->fcts.pdFree(pd, graph->hints);
+    if (graph->inputs != NULL) pd->fcts.pdFree(pd, graph->inputs);
+    if (graph->params != NULL) pd->fcts.pdFree(pd, graph->params);
+    if (graph->refs != NULL) pd->fcts.pdFree(pd, graph->refs);
+    if (graph->nodes != NULL) pd->fcts.pdFree(pd, graph->nodes);
+    if (graph->refMap != NULL) destructHashtable(graph->refMap, NULL, NULL);
+    pd->fcts.pdFree(pd, graph);
+}
+
+void graphCaptureAbort(ocrTask_t *task) {
+    ocrPolicyDomain_t *pd = NULL;
+    getCurrentEnv(&pd, NULL, NULL, NULL);
+    DPRINTF(DEBUG_LVL_WARN, "EDT "GUIDF" completed without ending its graph capture\n", GUIDA(task->guid));
+    graphCaptureFree(pd, task->graphCapture);
+    task->graphCapture = NULL;
+}
+
+// Gives the default-mode dependences to the creation of their EDT when
+// their source exists by then: the EDT is created with its depv instead
+// of having its slots registered one call at a time.
+static void graphFold(ocrGraph_t *graph, u32 *nodeOps) {
+    u32 i;
+    for (i = 0; i < graph->nodeCount; ++i)
+        nodeOps[i] = GRAPH_REF_NULL;
+    for (i = 0; i < graph->opCount; ++i) {
+        ocrGraphOp_t *op = &graph->ops[i];
+        if (op->kind == GRAPH_OP_EDT) {
+            nodeOps[op->edt.node] = i;
+            continue;
+        }
+        if ((op->kind != GRAPH_OP_DEP) || (op->dep.mode != DB_DEFAULT_MODE) ||
+            (op->dep.destination & GRAPH_REF_INPUT) || (nodeOps[op->dep.destination] == GRAPH_REF_NULL) ||
+            (op->dep.source == GRAPH_REF_UNINIT))
+            continue;
+        ocrGraphOp_t *edtOp = &graph->ops[nodeOps[op->dep.destination]];
+        // Nodes are numbered in creation order
+        if ((op->dep.slot >= edtOp->edt.depc) ||
+            (((op->dep.source & GRAPH_REF_INPUT) == 0) && (op->dep.source >= edtOp->edt.node)))
+            continue;
+        u32 *slot = &graph->refs[edtOp->edt.depvOffset + op->dep.slot];
+        if (*slot != GRAPH_REF_UNINIT)
+            continue;
+        *slot = op->dep.source;
+        op->kind = GRAPH_OP_NONE;
+    }
+}
+
+u8 ocrGraphCaptureBegin(void) {
+    START_PROFILE(api_ocrGraphCaptureBegin);
+    ocrPolicyDomain_t *pd = NULL;
+    ocrTask_t *curEdt = NULL;
+    getCurrentEnv(&pd, NULL, &curEdt, NULL);
+    if ((pd == NULL) || (curEdt == NULL))
+        RETURN_PROFILE(OCR_EPERM);
+    if (curEdt->graphCapture != NULL)
+        RETURN_PROFILE(OCR_EBUSY);
+    ocrGraph_t *graph = (ocrGraph_t*)pd->fcts.pdMalloc(pd, sizeof(ocrGraph_t));
+    if (graph == NULL)
+        RETURN_PROFILE(OCR_ENOMEM);
+    ocrGraph_t empty = {0};
+    *graph = empty;
+    curEdt->graphCapture = graph;
+    DPRINTF(DEBUG_LVL_INFO, "EDT "GUIDF" starts a graph capture\n", GUIDA(curEdt->guid));
+    RETURN_PROFILE(0);
+}
+
+u8 ocrGraphCaptureEnd(ocrGraph_t **graph) {
+    START_PROFILE(api_ocrGraphCaptureEnd);
+    ocrPolicyDomain_t *pd = NULL;
+    ocrTask_t *curEdt = NULL;
+    getCurrentEnv(&pd, NULL, &curEdt, NULL);
+    if (graph == NULL)
+        RETURN_PROFILE(OCR_EINVAL);
+    *graph = NULL;
+    if ((pd == NULL) || (curEdt == NULL) || (curEdt->graphCapture == NULL))
+        RETURN_PROFILE(OCR_EPERM);
+    ocrGraph_t *capture = curEdt->graphCapture;
+    curEdt->graphCapture = NULL;
+    if (capture->unsupported || capture->failed) {
+        u8 returnCode = capture->unsupported ? OCR_ENOTSUP : OCR_ENOMEM;
+        graphCaptureFree(pd, capture);
+        RETURN_PROFILE(returnCode);
+    }
+
+    u32 *nodeOps = (capture->nodeCount == 0) ? NULL :
+        (u32*)pd->fcts.pdMalloc(pd, sizeof(u32) * capture->nodeCount);
+    if (nodeOps != NULL) {
+        graphFold(capture, nodeOps);
+        pd->fcts.pdFree(pd, nodeOps);
+    }
+    u32 i, opCount = 0;
+    for (i = 0; i < capture->opCount; ++i) {
+        if (capture->ops[i].kind != GRAPH_OP_NONE)
+            opCount++;
+    }
+    u32 folded __attribute__((unused)) = capture->opCount - opCount;
+
+    // Everything the replay needs goes in a single allocation; the
+    // arrays are laid out by decreasing alignment after the header.
+    u64 size = sizeof(ocrGraph_t) + (u64)opCount * sizeof(ocrGraphOp_t) +
+        (u64)capture->hintCount * sizeof(ocrHint_t) + (u64)capture->inputCount * sizeof(ocrGuid_t) +
+        (u64)capture->paramCount * sizeof(u64) + (u64)capture->refCount * sizeof(u32);
+    ocrGraph_t *result = (ocrGraph_t*)pd->fcts.pdMalloc(pd, size);
+    if (result == NULL) {
+        graphCaptureFree(pd, capture);
+        RETURN_PROFILE(OCR_ENOMEM);
+    }
+    *result = *capture;
+    result->ops = (ocrGraphOp_t*)&result[1];
+    result->hints = (ocrHint_t*)&result->ops[opCount];
+    result->inputs = (ocrGuid_t*)&result->hints[capture->hintCount];
+    result->params = (u64*)&result->inputs[capture->inputCount];
+    result->refs = (u32*)&result->params[capture->paramCount];
+    result->nodes = NULL;
+    result->refMap = NULL;
+    result->opCount = opCount;
+    opCount = 0;
+    for (i = 0; i < capture->opCount; ++i) {
+        if (capture->ops[i].kind != GRAPH_OP_NONE)
+            result->ops[opCount++] = capture->ops[i];
+    }
+    hal_memCopy(result->hints, capture->hints, (u64)capture->hintCount * sizeof(ocrHint_t), false);
+    hal_memCopy(result->inputs, capture->inputs, (u64)capture->inputCount * sizeof(ocrGuid_t), false);
+    hal_memCopy(result->params, capture->params, (u64)capture->paramCount * sizeof(u64), false);
+    hal_memCopy(result->refs, capture->refs, (u64)capture->refCount * sizeof(u32), false);
+    result->opMax = result->opCount;
+    result->hintMax = result->hintCount;
+    result->inputMax = result->inputCount;
+    result->paramMax = result->paramCount;
+    result->refMax = result->refCount;
+    result->nodeMax = 0;
+    graphCaptureFree(pd, capture);
+
+    DPRINTF(DEBUG_LVL_INFO, "EDT "GUIDF" captured a graph of %"PRIu32" EDTs, %"PRIu32" events, %"PRIu32" dependences "
+            "(%"PRIu32" folded) and %"PRIu32" inputs\n", GUIDA(curEdt->guid), result->edtCount, result->eventCount,
+            result->depCount, folded, result->inputCount);
+    *graph = result;
+    RETURN_PROFILE(0);
+}
+
+/******************************************************/
+/* QUERY AND REPLAY                                   */
+/******************************************************/
+
+u8 ocrGraphQuery(ocrGraph_t *graph, ocrGraphInfo_t *info, ocrGuid_t *inputs) {
+    START_PROFILE(api_ocrGraphQuery);
+    if ((graph == NULL) || (info == NULL))
+        RETURN_PROFILE(OCR_EINVAL);
+    info->nodeCount = graph->nodeCount;
+    info->edtCount = graph->edtCount;
+    info->eventCount = graph->eventCount;
+    info->inputCount = graph->inputCount;
+    info->paramCount = graph->paramCount;
+    info->depCount = graph->depCount;
+    if (inputs != NULL) {
+        u32 i;
+        for (i = 0; i < graph->inputCount; ++i)
+            inputs[i] = graph->inputs[i];
+    }
+    RETURN_PROFILE(0);
+}
+
+static inline ocrGuid_t graphResolve(u32 ref, ocrGuid_t *nodes, ocrGuid_t *inputs) {
+    if (ref == GRAPH_REF_NULL)
+        return NULL_GUID;
+    if (ref == GRAPH_REF_UNINIT)
+        return UNINITIALIZED_GUID;
+    return (ref & GRAPH_REF_INPUT) ? inputs[ref & ~GRAPH_REF_INPUT] : nodes[ref];
+}
+
+u8 ocrGraphReplay(ocrGraph_t *graph, u64 *paramv, ocrGuid_t *inputs, ocrGuid_t *nodes) {
+    START_PROFILE(api_ocrGraphReplay);
+    ocrPolicyDomain_t *pd = NULL;
+    ocrTask_t *curEdt = NULL;
+    getCurrentEnv(&pd, NULL, &curEdt, NULL);
+    if (graph == NULL)
+        RETURN_PROFILE(OCR_EINVAL);
+    if ((pd == NULL) || (curEdt == NULL))
+        RETURN_PROFILE(OCR_EPERM);
+    DPRINTF(DEBUG_LVL_INFO, "ENTER ocrGraphReplay(graph=%p, paramv=%p, inputs=%p)\n", graph, paramv, inputs);
+    // The nodes, unless the caller wants them, and the depv of the EDTs
+    // being created share a single allocation
+    u32 scratchCount = ((nodes == NULL) ? graph->nodeCount : 0) + graph->maxDepc;
+    ocrGuid_t *scratch = NULL;
+    if (scratchCount != 0) {
+        scratch = (ocrGuid_t*)pd->fcts.pdMalloc(pd, sizeof(ocrGuid_t) * scratchCount);
+        if (scratch == NULL)
+            RETURN_PROFILE(OCR_ENOMEM);
+    }
+    ocrGuid_t *guids = (nodes != NULL) ? nodes : scratch;
+    ocrGuid_t *depv = (nodes != NULL) ? scratch : &scratch[graph->nodeCount];
+    u64 *params = (paramv != NULL) ? paramv : graph->params;
+    if (inputs == NULL)
+        inputs = graph->inputs;
+
+    // Consecutive dependences are added together
+    ocrDependence_t deps[GRAPH_REPLAY_DEP_CHUNK];
+    u32 depCount = 0;
+    u8 returnCode = 0;
+    u32 i, j;
+    for (i = 0; (i < graph->opCount) && (returnCode == 0); ++i) {
+        ocrGraphOp_t *op = &graph->ops[i];
+        if ((depCount != 0) && (op->kind != GRAPH_OP_DEP)) {
+            returnCode = ocrAddDependences(depCount, deps);
+            depCount = 0;
+            if (returnCode)
+                break;
+        }
+        switch (op->kind) {
+        case GRAPH_OP_EVENT:
+#ifdef ENABLE_EXTENSION_PARAMS_EVT
+            returnCode = ocrEventCreateParams(&guids[op->event.node], op->event.type, op->event.properties,
+                                              op->event.hasParams ? &op->event.params : NULL);
+#else
+            returnCode = ocrEventCreate(&guids[op->event.node], op->event.type, op->event.properties);
+#endif
+            break;
+        case GRAPH_OP_EDT: {
+            bool hasDepv = false;
+            for (j = 0; j < op->edt.depc; ++j) {
+                u32 ref = graph->refs[op->edt.depvOffset + j];
+                hasDepv |= (ref != GRAPH_REF_UNINIT);
+                depv[j] = graphResolve(ref, guids, inputs);
+            }
+            returnCode = ocrEdtCreate(&guids[op->edt.node], op->edt.templateGuid,
+                                      op->edt.paramc, (op->edt.paramc != 0) ? &params[op->edt.paramOffset] : NULL,
+                                      op->edt.depc, hasDepv ? depv : NULL, op->edt.properties,
+                                      (op->edt.hint != GRAPH_REF_NULL) ? &graph->hints[op->edt.hint] : NULL_HINT,
+                                      op->edt.hasOutputEvent ? &guids[op->edt.node + 1] : NULL);
+            break;
+        }
+        case GRAPH_OP_DEP:
+            deps[depCount].source = graphResolve(op->dep.source, guids, inputs);
+            deps[depCount].destination = graphResolve(op->dep.destination, guids, inputs);
+            deps[depCount].slot = op->dep.slot;
+            deps[depCount].mode = op->dep.mode;
+            if (++depCount == GRAPH_REPLAY_DEP_CHUNK) {
+                returnCode = ocrAddDependences(depCount, deps);
+                depCount = 0;
+            }
+            break;
+        default:
+            ASSERT(false);
+        }
+    }
+    if ((depCount != 0) && (returnCode == 0))
+        returnCode = ocrAddDependences(depCount, deps);
+    if (scratch != NULL)
+        pd->fcts.pdFree(pd, scratch);
+    DPRINTF_COND_LVL(returnCode, DEBUG_LVL_WARN, DEBUG_LVL_INFO,
+                     "EXIT ocrGraphReplay(graph=%p) -> %"PRIu32"\n", graph, returnCode);
+    RETURN_PROFILE(returnCode);
+}
+
+u8 ocrGraphDestroy(ocrGraph_t *graph) {
+    START_PROFILE(api_ocrGraphDestroy);
+    ocrPolicyDomain_t *pd = NULL;
+    getCurrentEnv(&pd, NULL, NULL, NULL);
+    if (graph == NULL)
+        RETURN_PROFILE(OCR_EINVAL);
+    if (pd == NULL)
+        RETURN_PROFILE(OCR_EPERM);
+    pd->fcts.pdFree(pd, graph);
+    RETURN_PROFILE(0);
+}
+
+#endif /* ENABLE_EXTENSION_GRAPH */
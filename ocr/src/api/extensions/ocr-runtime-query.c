@@ -0,0 +1,70 @@
+/*
+ * This file is subject to the license agreement located in the file LICENSE
+ * and cannot be distributed without it. This notice cannot be
+ * removed or modified.
+ */
+
+#include "ocr-config.h"
+#include "ocr-errors.h"
+#ifdef ENABLE_EXTENSION_RUNTIME_QUERY
+
+#include "debug.h"
+#include "ocr-policy-domain.h"
+#include "ocr-sal.h"
+#include "ocr-worker.h"
+#include "extensions/ocr-runtime-query.h"
+
+#include "utils/profiler/profiler.h"
+
+#define DEBUG_TYPE API
+
+// The public counters are the runtime ones
+COMPILE_ASSERT((u32)OCR_RUNTIME_COUNTER_MAX == (u32)RT_COUNTER_MAX);
+COMPILE_ASSERT((u32)OCR_RUNTIME_MSG_MAX == (u32)RT_COUNTER_MSG_KINDS);
+
+static void runtimeQueryAdd(ocrWorker_t *worker, ocrRuntimeCounters_t *counters, u64 now) {
+    rtCountersData_t *data = &worker->counters.data;
+    u64 idleStart = data->idleStart;
+    u32 i;
+    for (i = 0; i < RT_COUNTER_MAX; i++)
+        counters->values[i] += data->values[i];
+    for (i = 0; i < RT_COUNTER_MSG_KINDS; i++) {
+        counters->msgSent[i] += data->msgSent[i];
+        counters->msgReceived[i] += data->msgReceived[i];
+    }
+    // Account for the idle period the worker is in, if any
+    if ((idleStart != 0) && (now > idleStart))
+        counters->values[RT_COUNTER_IDLE_NS] += now - idleStart;
+    counters->workerCount++;
+}
+
+u8 ocrRuntimeQuery(s64 worker, ocrRuntimeCounters_t *counters) {
+    START_PROFILE(api_ocrRuntimeQuery);
+    ocrPolicyDomain_t *pd = NULL;
+    u64 i, now;
+    getCurrentEnv(&pd, NULL, NULL, NULL);
+    if (pd == NULL)
+        RETURN_PROFILE(OCR_EPERM);
+    if ((counters == NULL) || (worker < OCR_RUNTIME_ALL_WORKERS) || (worker >= (s64)pd->workerCount))
+        RETURN_PROFILE(OCR_EINVAL);
+
+    counters->workerCount = 0;
+    for (i = 0; i < OCR_RUNTIME_COUNTER_MAX; i++)
+        counters->values[i] = 0;
+    for (i = 0; i < OCR_RUNTIME_MSG_MAX; i++) {
+        counters->msgSent[i] = 0;
+        counters->msgReceived[i] = 0;
+    }
+    now = salGetTime();
+    if (worker == OCR_RUNTIME_ALL_WORKERS) {
+        for (i = 0; i < pd->workerCount; i++)
+            runtimeQueryAdd(pd->workers[i], counters, now);
+    } else {
+        runtimeQueryAdd(pd->workers[worker], counters, now);
+    }
+    DPRINTF(DEBUG_LVL_VERB, "Runtime query of %"PRIu64" worker(s): %"PRIu64" EDTs executed\n",
+            counters->workerCount, counters->values[OCR_RUNTIME_EDTS_EXECUTED]);
+    RETURN_PROFILE(0);
+}
+
+#endif /* ENABLE_EXTENSION_RUNTIME_QUERY */
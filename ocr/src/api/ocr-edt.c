@@ -12,6 +12,10 @@
 #include "ocr-errors.h"
 #include "ocr-sysboot.h"
 
+#ifdef ENABLE_EXTENSION_GRAPH
+#include "experimental/ocr-graph-runtime.h"
+#endif
+
 #include "utils/profiler/profiler.h"
 
 #define DEBUG_TYPE API
@@ -80,6 +84,10 @@ u8 ocrEventCreateParams(ocrGuid_t *guid, ocrEventTypes_t eventType, u16 properti
                      "EXIT ocrEventCreateParams -> %"PRIu32"; GUID: "GUIDF"\n", returnCode, GUIDA(*guid));
     if(returnCode == 0)
         OCR_TOOL_TRACE(true, OCR_TRACE_TYPE_EVENT, OCR_ACTION_CREATE, traceEventCreate, *guid);
+#ifdef ENABLE_EXTENSION_GRAPH
+    if((returnCode == 0) && (curEdt != NULL) && (curEdt->graphCapture != NULL))
+        graphCaptureEvent(curEdt, *guid, eventType, properties, params);
+#endif
 
     RETURN_PROFILE(returnCode);
 
@@ -482,7 +490,18 @@ u8 ocrEdtCreate(ocrGuid_t* edtGuidPtr, ocrGuid_t templateGuid,
     // These should have been resolved
     paramc = PD_MSG_FIELD_IO(paramc);
     depc = PD_MSG_FIELD_IO(depc);
-
+#ifdef ENABLE_EXTENSION_GRAPH
+    if((curEdt != NULL) && (curEdt->graphCapture != NULL)) {
+        // Dependences not added by the creation are recorded by ocrAddDependence below
+#ifndef EDT_DEPV_DELAYED
+        graphCaptureEdt(curEdt, edtGuid, templateGuid, paramc, paramv, depc, (depvSize != 0) ? depv : NULL,
+                        properties, hint, outputEvent);
+#else
+        graphCaptureEdt(curEdt, edtGuid, templateGuid, paramc, paramv, depc, NULL,
+                        properties, hint, outputEvent);
+#endif
+    }
+#endif
 
 
 #ifndef EDT_DEPV_DELAYED
@@ -638,8 +657,59 @@ u8 ocrAddDependence(ocrGuid_t source, ocrGuid_t destination, u32 slot,
 #undef PD_MSG
 #undef PD_TYPE
     }
+#endif
+#ifdef ENABLE_EXTENSION_GRAPH
+    if((returnCode == 0) && (curEdt != NULL) && (curEdt->graphCapture != NULL))
+        graphCaptureDep(curEdt, source, destination, slot, mode);
 #endif
     DPRINTF_COND_LVL(returnCode, DEBUG_LVL_WARN, DEBUG_LVL_INFO,
                      "EXIT ocrAddDependence(src="GUIDF", dest="GUIDF") -> %"PRIu32"\n", GUIDA(source), GUIDA(destination), returnCode);
     RETURN_PROFILE(returnCode);
 }
+
+u8 ocrAddDependences(u32 count, ocrDependence_t *deps) {
+    START_PROFILE(api_ocrAddDependences);
+    DPRINTF(DEBUG_LVL_INFO, "ENTER ocrAddDependences(count=%"PRIu32")\n", count);
+    u8 returnCode = 0;
+    u32 i;
+#if defined(ENABLE_POLICY_DOMAIN_HC) && !defined(ENABLE_AMT_RESILIENCE) && !defined(ENABLE_OCR_API_DEFERRABLE)
+    PD_MSG_STACK(msg);
+    ocrPolicyDomain_t *pd = NULL;
+    ocrTask_t * curEdt = NULL;
+    getCurrentEnv(&pd, NULL, &curEdt, &msg);
+    for (i = 0; i < count; ++i) {
+        OCR_TOOL_TRACE(true, OCR_TRACE_TYPE_API_EVENT, OCR_ACTION_ADD_DEP,
+                       deps[i].source, deps[i].destination, deps[i].slot, deps[i].mode);
+    }
+#define PD_MSG (&msg)
+#define PD_TYPE PD_MSG_DEP_ADD_BULK
+    msg.type = PD_MSG_DEP_ADD_BULK | PD_MSG_REQUEST | PD_MSG_REQ_RESPONSE;
+    PD_MSG_FIELD_I(currentEdt.guid) = curEdt ? curEdt->guid : NULL_GUID;
+    PD_MSG_FIELD_I(currentEdt.metaDataPtr) = curEdt;
+    PD_MSG_FIELD_I(deps) = deps;
+    PD_MSG_FIELD_I(count) = count;
+    PD_MSG_FIELD_I(properties) = 0;
+    returnCode = pd->fcts.processMessage(pd, &msg, true);
+    if (returnCode == 0)
+        returnCode = PD_MSG_FIELD_O(returnDetail);
+#undef PD_MSG
+#undef PD_TYPE
+#ifdef ENABLE_EXTENSION_GRAPH
+    if((returnCode == 0) && (curEdt != NULL) && (curEdt->graphCapture != NULL)) {
+        for (i = 0; i < count; ++i) {
+            if (!(ocrGuidIsNull(deps[i].source) && ocrGuidIsNull(deps[i].destination)))
+                graphCaptureDep(curEdt, deps[i].source, deps[i].destination, deps[i].slot, deps[i].mode);
+        }
+    }
+#endif
+#else
+    // Resilience and deferred API calls need each dependence on its own
+    for (i = 0; i < count; ++i) {
+        u8 ret = ocrAddDependence(deps[i].source, deps[i].destination, deps[i].slot, deps[i].mode);
+        returnCode = returnCode ? returnCode : ret;
+    }
+#endif
+    DPRINTF_COND_LVL(returnCode, DEBUG_LVL_WARN, DEBUG_LVL_INFO,
+                     "EXIT ocrAddDependences(count=%"PRIu32") -> %"PRIu32"\n", count, returnCode);
+    RETURN_PROFILE(returnCode);
+}
@@ -58,6 +58,9 @@ static void pthreadRoutineInitializer(ocrCompPlatformPthread_t * pthreadCompPlat
                      ((ocrPolicyDomain_t *)(pthreadCompPlatform->base.pd))->myLocation, (u64)pthreadCompPlatform);
             d->output = fopen(buffer, "w");
             ASSERT(d->output);
+#ifdef PROFILER_SNAPSHOT
+            _profilerSnapshotRegister(d, ((ocrPolicyDomain_t *)(pthreadCompPlatform->base.pd))->myLocation);
+#endif
         }
         RESULT_ASSERT(pthread_setspecific(_profilerThreadData, d), ==, 0);
     }
@@ -307,6 +307,7 @@ static void processAcquireCallback(ocrDataBlock_t *self, dbWaiter_t * waiter, oc
 
 u8 lockableAcquire(ocrDataBlock_t *self, void** ptr, ocrFatGuid_t edt, ocrLocation_t destLoc, u32 edtSlot,
                   ocrDbAccessMode_t mode, bool isInternal, u32 properties) {
+    OCR_OBJECT_MARK_DIRTY(self);
     ocrDataBlockLockable_t *rself = (ocrDataBlockLockable_t*)self;
     bool unlock = lockButSelf(rself);
     if (IS_WRITABLE_MODE(mode) && (rself->attributes.singleAssign == 1)) {
@@ -328,6 +329,7 @@ u8 lockableAcquire(ocrDataBlock_t *self, void** ptr, ocrFatGuid_t edt, ocrLocati
 
 // 'edt' may be NULL_GUID here if we are doing a PD-level release
 u8 lockableRelease(ocrDataBlock_t *self, ocrFatGuid_t edt, ocrLocation_t srcLoc, bool isInternal) {
+    OCR_OBJECT_MARK_DIRTY(self);
     ocrDataBlockLockable_t *rself = (ocrDataBlockLockable_t*)self;
     dbWaiter_t * waiter = NULL;
     DPRINTF(DEBUG_LVL_VERB, "Releasing DB @ 0x%"PRIx64" (GUID "GUIDF") from EDT "GUIDF" (runtime release: %"PRId32")\n",
@@ -338,6 +340,9 @@ u8 lockableRelease(ocrDataBlock_t *self, ocrFatGuid_t edt, ocrLocation_t srcLoc,
     ocrWorker_t * worker;
     getCurrentEnv(NULL, &worker, NULL, NULL);
     rself->worker = worker;
+    // Holding the DB in EW or ITW mode means the releasing EDT could write to it
+    if (!isInternal && (rself->attributes.modeLock != DB_LOCKED_NONE) && (worker != NULL))
+        self->lastWriter = (u32)worker->id;
 
     // The registered EDT can be different if a DB has been released by the user
     // and the runtime tries to release it afterwards. It could be that in
@@ -572,6 +577,7 @@ u8 lockableDestruct(ocrDataBlock_t *self) {
 
 #ifdef ENABLE_AMT_RESILIENCE
 static u8 lockablePublishInternal(ocrDataBlock_t *self, u32 properties) {
+    OCR_OBJECT_MARK_DIRTY(self);
     RESULT_ASSERT(salResilientDataBlockPublish(self), ==, 0);
     ocrDataBlockLockable_t * rself = (ocrDataBlockLockable_t*) self;
     rself->attributes.published = 1;
@@ -590,6 +596,7 @@ u8 lockablePublish(ocrDataBlock_t *self, u32 properties) {
 #endif
 
 u8 lockableFree(ocrDataBlock_t *self, ocrFatGuid_t edt, ocrLocation_t srcLoc, u32 properties) {
+    OCR_OBJECT_MARK_DIRTY(self);
     bool isInternal = ((properties & DB_PROP_RT_ACQUIRE) != 0);
     bool reqRelease = ((properties & DB_PROP_NO_RELEASE) == 0);
     ocrDataBlockLockable_t *rself = (ocrDataBlockLockable_t*)self;
@@ -695,12 +702,14 @@ u8 newDataBlockLockable(ocrDataBlockFactory_t *factory, ocrFatGuid_t *guid, ocrF
 #ifdef ENABLE_RESILIENCY
     result->base.base.kind = OCR_GUID_DB;
     result->base.base.size = mSize;
+    result->base.base.epoch = 0;
 #endif
     result->base.allocator = allocator.guid;
     result->base.allocatingPD = allocPD.guid;
     result->base.size = size;
     result->base.ptr = ptr;
     result->base.fctId = factory->factoryId;
+    result->base.lastWriter = ((u32)-1);
     // Only keep flags that represent the nature of
     // the DB as opposed to one-time usage creation flags
     result->base.flags = (flags & (DB_PROP_SINGLE_ASSIGNMENT | DB_PROP_RT_PROXY | DB_PROP_RESILIENT | DB_PROP_PUBLISH_EAGER));
@@ -760,6 +769,7 @@ u8 newDataBlockLockable(ocrDataBlockFactory_t *factory, ocrFatGuid_t *guid, ocrF
 }
 
 u8 lockableSetHint(ocrDataBlock_t* self, ocrHint_t *hint) {
+    OCR_OBJECT_MARK_DIRTY(self);
     ocrDataBlockLockable_t *derived = (ocrDataBlockLockable_t*)self;
     ocrRuntimeHint_t *rHint = &(derived->hint);
     OCR_RUNTIME_HINT_SET(hint, rHint, OCR_HINT_COUNT_DB_LOCKABLE, ocrHintPropDbLockable, OCR_HINT_DB_PROP_START);
@@ -99,6 +99,13 @@ u8 regularRelease(ocrDataBlock_t *self, ocrFatGuid_t edt,
     rself->attributes.numUsers -= 1;
     if(isInternal)
         rself->attributes.internalUsers -= 1;
+    // Access modes are not tracked here: any user release may follow a write
+    if(!isInternal) {
+        ocrWorker_t * worker = NULL;
+        getCurrentEnv(NULL, &worker, NULL, NULL);
+        if(worker != NULL)
+            self->lastWriter = (u32)worker->id;
+    }
 
     DPRINTF(DEBUG_LVL_VVERB, "DB (GUID: "GUIDF") attributes: numUsers %"PRId32" (including %"PRId32" runtime users); freeRequested %"PRId32"\n",
             GUIDA(self->guid), rself->attributes.numUsers, rself->attributes.internalUsers, rself->attributes.freeRequested);
@@ -279,6 +286,7 @@ u8 newDataBlockRegular(ocrDataBlockFactory_t *factory, ocrFatGuid_t *guid, ocrFa
     result->base.allocatingPD = allocPD.guid;
     result->base.size = size;
     result->base.ptr = ptr;
+    result->base.lastWriter = ((u32)-1);
     // Only keep flags that represent the nature of
     // the DB as opposed to one-time usage creation flags
     result->base.flags = (flags & DB_PROP_SINGLE_ASSIGNMENT);
@@ -71,5 +71,13 @@ u64 ocrVersionExtensionBitmap(void)
     retval |= OCR_VERSION_LABELING_BIT;
 #endif
 
+#ifdef ENABLE_EXTENSION_RUNTIME_QUERY
+    retval |= OCR_VERSION_RUNTIME_QUERY_BIT;
+#endif
+
+#ifdef ENABLE_EXTENSION_GRAPH
+    retval |= OCR_VERSION_GRAPH_BIT;
+#endif
+
     return retval;
 }
@@ -211,6 +211,12 @@ u8 destructEventHc(ocrEvent_t *base) {
     }
 #endif
 
+#ifdef HCEVT_FINISH_LATCH_SUB_COUNTERS
+    if ((base->kind == OCR_EVENT_LATCH_T) && (((ocrEventHcLatch_t*)base)->subs != NULL)) {
+        pd->fcts.pdFree(pd, ((ocrEventHcLatch_t*)base)->subs);
+    }
+#endif
+
     // Destroy datablocks linked with this event
     if (!(ocrGuidIsUninitialized(event->waitersDb.guid))) {
 #define PD_MSG (&msg)
@@ -366,9 +372,9 @@ static u8 commonSatisfyRegNode(ocrPolicyDomain_t * pd, ocrPolicyMsg_t * msg,
     return 0;
 }
 
-static u8 commonSatisfyWaiters(ocrPolicyDomain_t *pd, ocrEvent_t *base, ocrFatGuid_t db, u32 waitersCount,
-                                ocrFatGuid_t currentEdt, ocrPolicyMsg_t * msg,
-                                bool isPersistentEvent) {
+static u8 commonSatisfyWaitersEach(ocrPolicyDomain_t *pd, ocrEvent_t *base, ocrFatGuid_t db, u32 waitersCount,
+                                    ocrFatGuid_t currentEdt, ocrPolicyMsg_t * msg,
+                                    bool isPersistentEvent) {
     ocrEventHc_t * event = (ocrEventHc_t *) base;
     // waitersDb is safe to read because non-persistent event forbids further
     // registrations and persistent event registration is closed because of
@@ -432,9 +438,26 @@ static u8 commonSatisfyWaiters(ocrPolicyDomain_t *pd, ocrEvent_t *base, ocrFatGu
     return 0;
 }
 
+static u8 commonSatisfyWaiters(ocrPolicyDomain_t *pd, ocrEvent_t *base, ocrFatGuid_t db, u32 waitersCount,
+                                ocrFatGuid_t currentEdt, ocrPolicyMsg_t * msg,
+                                bool isPersistentEvent) {
+    // Hand the EDTs made ready by a fan-out to the scheduler in batches
+    ocrWorker_t * worker = NULL;
+    getCurrentEnv(NULL, &worker, NULL, NULL);
+    bool batched = (waitersCount > 1) && (worker != NULL) && schedulerReadyBatchBegin(pd, worker);
+    u8 res = commonSatisfyWaitersEach(pd, base, db, waitersCount, currentEdt, msg, isPersistentEvent);
+    if (batched) {
+        u8 flushRes = schedulerReadyBatchEnd(pd, worker);
+        if (res == 0)
+            res = flushRes;
+    }
+    return res;
+}
+
 // For once events, we don't have to worry about
 // concurrent registerWaiter calls (this would be a programmer error)
 u8 satisfyEventHcOnce(ocrEvent_t *base, ocrFatGuid_t db, u32 slot) {
+    OCR_OBJECT_MARK_DIRTY(base);
     ocrEventHc_t *event = (ocrEventHc_t*)base;
     ASSERT(slot == 0); // For non-latch events, only one slot
 
@@ -535,6 +558,7 @@ static void destructEventHcPeers(ocrEvent_t *base, locNode_t * curHead) {
 #ifdef ENABLE_EXTENSION_COUNTED_EVT
 // For counted event
 u8 satisfyEventHcCounted(ocrEvent_t *base, ocrFatGuid_t db, u32 slot) {
+    OCR_OBJECT_MARK_DIRTY(base);
     ocrEventHc_t * event = (ocrEventHc_t*) base;
     bool destroy = false;
     hal_lock(&(event->waitersLock));
@@ -595,6 +619,7 @@ static u32 setSatisfiedEventHcPersist(ocrEvent_t *base, ocrFatGuid_t db, locNode
 
 // For idempotent events, accessed through the fct pointers interface
 u8 satisfyEventHcPersistIdem(ocrEvent_t *base, ocrFatGuid_t db, u32 slot) {
+    OCR_OBJECT_MARK_DIRTY(base);
     // Register the satisfy
     locNode_t * curHead;
     u32 waitersCount = setSatisfiedEventHcPersist(base, db, &curHead, /*checkError*/ false);
@@ -618,6 +643,7 @@ u8 satisfyEventHcPersistIdem(ocrEvent_t *base, ocrFatGuid_t db, u32 slot) {
 
 // For sticky events, accessed through the fct pointers interface
 u8 satisfyEventHcPersistSticky(ocrEvent_t *base, ocrFatGuid_t db, u32 slot) {
+    OCR_OBJECT_MARK_DIRTY(base);
     // Register the satisfy
     locNode_t * curHead;
     u32 waitersCount = setSatisfiedEventHcPersist(base, db, &curHead, /*checkError*/ true);
@@ -657,6 +683,7 @@ static u8 resilientLatchDone(ocrEvent_t *self) {
     ocrTask_t *suspendedTask = worker->curTask;
     jmp_buf *suspendedBuf = worker->jmpbuf;
     int blockedContexts = worker->blockedContexts;
+    u32 readyBatchDepth = worker->readyBatchDepth;
     hal_fence();
     jmp_buf buf;
     int rc = setjmp(buf);
@@ -684,6 +711,7 @@ static u8 resilientLatchDone(ocrEvent_t *self) {
     } else {
         DPRINTF(DEBUG_LVL_WARN, "Worker aborted processing resilientLatchDone\n");
         ASSERT(worker->blockedContexts == blockedContexts);
+        worker->readyBatchDepth = readyBatchDepth; // Close the batching scopes the abort jumped out of
     }
     hal_fence();
     worker->waitloc = suspendedwaitloc;
@@ -722,8 +750,93 @@ static u8 destructResilientScope(ocrEvent_t *self) {
 }
 #endif
 
+#ifdef HCEVT_FINISH_LATCH_SUB_COUNTERS
+// Finish latches act as a scalable non-zero indicator: the count is spread over
+// per-worker sub-counters that never go negative and 'counter' is the number of
+// non-zero sub-counters. Units are interchangeable so a worker decrementing a unit
+// it did not increment takes it from another sub-counter, along with half of that
+// sub-counter's surplus so that its next decrements stay local. The latch reaches
+// zero when the last non-zero sub-counter drops to zero.
+//
+// Each latch allocates workerCount cache lines and a decrement may have to wait
+// for surplus units another worker is moving, so this is only worth it for finish
+// scopes with many children spread over many workers.
+
+static u32 finishLatchSubIdx(ocrEventHcLatch_t *event) {
+    ocrWorker_t *worker = NULL;
+    getCurrentEnv(NULL, &worker, NULL, NULL);
+    return (worker == NULL) ? 0 : (u32) (worker->id % event->subCount);
+}
+
+static void finishLatchSubAdd(ocrEventHcLatch_t *event, ocrEventHcLatchSub_t *sub, s32 incr) {
+    bool checkedIn = false;
+    s32 count;
+    do {
+        count = sub->count;
+        if ((count == 0) && !checkedIn) {
+            // Account for the sub-counter before it becomes non-zero
+            hal_xadd32((u32 *)&(event->counter), 1);
+            checkedIn = true;
+        }
+    } while(hal_cmpswap32((u32 *)&(sub->count), count, count+incr) != count);
+    if (checkedIn && (count != 0)) {
+        // Someone else made it non-zero first, the root can't reach zero here
+        hal_xadd32((u32 *)&(event->counter), -1);
+    }
+}
+
+// Returns true if the latch reached zero
+static bool finishLatchSubDecr(ocrEventHcLatch_t *event) {
+    u32 mine = finishLatchSubIdx(event);
+    u32 i = mine;
+    while (true) {
+        ocrEventHcLatchSub_t *sub = &(event->subs[i]);
+        s32 count = sub->count;
+        if (count > 0) {
+            s32 take = (i == mine) ? 1 : ((count + 1) / 2);
+            if (hal_cmpswap32((u32 *)&(sub->count), count, count-take) != count) {
+                continue;
+            }
+            // Move the surplus before 'sub' possibly releases its hold on the root
+            if (take > 1) {
+                finishLatchSubAdd(event, &(event->subs[mine]), take-1);
+            }
+            if (count != take) {
+                return false;
+            }
+            return (hal_xadd32((u32 *)&(event->counter), -1) == 1);
+        }
+        i = ((i + 1) == event->subCount) ? 0 : (i + 1);
+        if (i == mine) {
+            // Units are being moved between sub-counters
+            hal_pause();
+        }
+    }
+}
+
+static void initFinishLatchSubs(ocrEventHcLatch_t *event) {
+    ocrPolicyDomain_t *pd = NULL;
+    getCurrentEnv(&pd, NULL, NULL, NULL);
+    if (pd->workerCount < 2) {
+        return;
+    }
+    ASSERT(event->counter >= 0);
+    event->subCount = (u32) pd->workerCount;
+    event->subs = pd->fcts.pdMalloc(pd, sizeof(ocrEventHcLatchSub_t) * event->subCount);
+    u32 i;
+    for (i = 0; i < event->subCount; i++) {
+        event->subs[i].count = 0;
+    }
+    if (event->counter != 0) {
+        event->subs[finishLatchSubIdx(event)].count = event->counter;
+        event->counter = 1;
+    }
+}
+#endif
+
 // This is for latch events
 u8 satisfyEventHcLatch(ocrEvent_t *base, ocrFatGuid_t db, u32 slot) {
+    OCR_OBJECT_MARK_DIRTY(base);
     ocrEventHcLatch_t *event = (ocrEventHcLatch_t*)base;
 #ifdef ENABLE_AMT_RESILIENCE
     if (slot == OCR_EVENT_LATCH_SHUTDOWN_SLOT) {
@@ -813,11 +926,25 @@ u8 satisfyEventHcLatch(ocrEvent_t *base, ocrFatGuid_t db, u32 slot) {
            slot == OCR_EVENT_LATCH_INCR_SLOT);
 
     s32 incr = (slot == OCR_EVENT_LATCH_DECR_SLOT)?-1:1;
-    s32 count;
-    do {
-        count = event->counter;
-        // FIXME: the (u32 *) cast on the line below is because event->counter is an (s32 *)
-    } while(hal_cmpswap32((u32 *)&(event->counter), count, count+incr) != count);
+    bool reachedZero;
+#ifdef HCEVT_FINISH_LATCH_SUB_COUNTERS
+    if (event->subs != NULL) {
+        if (incr > 0) {
+            finishLatchSubAdd(event, &(event->subs[finishLatchSubIdx(event)]), 1);
+            reachedZero = false;
+        } else {
+            reachedZero = finishLatchSubDecr(event);
+        }
+    } else
+#endif
+    {
+        s32 count;
+        do {
+            count = event->counter;
+            // FIXME: the (u32 *) cast on the line below is because event->counter is an (s32 *)
+        } while(hal_cmpswap32((u32 *)&(event->counter), count, count+incr) != count);
+        reachedZero = (count + incr == 0);
+    }
 
     DPRINTF(DEBUG_LVL_INFO, "Satisfy %s: "GUIDF" %s\n", eventTypeToString(base),
             GUIDA(base->guid), ((slot == OCR_EVENT_LATCH_DECR_SLOT) ? "decr":"incr"));
@@ -833,7 +960,7 @@ u8 satisfyEventHcLatch(ocrEvent_t *base, ocrFatGuid_t db, u32 slot) {
 #ifdef OCR_ENABLE_STATISTICS
     statsDEP_SATISFYToEvt(pd, currentEdt.guid, NULL, base->guid, base, data, slot);
 #endif
-    if(count + incr != 0) {
+    if(!reachedZero) {
         return 0;
     }
     // Here the event is satisfied
@@ -1064,6 +1191,7 @@ u8 registerWaiterEventHc(ocrEvent_t *base, ocrFatGuid_t waiter, u32 slot, bool i
 #else
 u8 registerWaiterEventHc(ocrEvent_t *base, ocrFatGuid_t waiter, u32 slot, bool isDepAdd) {
 #endif
+    OCR_OBJECT_MARK_DIRTY(base);
     // Here we always add the waiter to our list so we ignore isDepAdd
     ocrEventHc_t *event = (ocrEventHc_t*)base;
 
@@ -1107,6 +1235,7 @@ u8 registerWaiterEventHcPersist(ocrEvent_t *base, ocrFatGuid_t waiter, u32 slot,
 #else
 u8 registerWaiterEventHcPersist(ocrEvent_t *base, ocrFatGuid_t waiter, u32 slot, bool isDepAdd) {
 #endif
+    OCR_OBJECT_MARK_DIRTY(base);
     ocrEventHcPersist_t *event = (ocrEventHcPersist_t*)base;
 
     ocrPolicyDomain_t *pd = NULL;
@@ -1162,6 +1291,186 @@ u8 registerWaiterEventHcPersist(ocrEvent_t *base, ocrFatGuid_t waiter, u32 slot,
 #endif
 }
 
+#ifndef REG_ASYNC_SGL
+/**
+ * @brief Appends 'count' waiters to the event's waiter list.
+ *
+ * Same as calling commonEnqueueWaiter for each waiter but the waiters
+ * DB is acquired once and grown at most once.
+ */
+static u8 commonEnqueueWaiters(ocrPolicyDomain_t *pd, ocrEvent_t *base, u32 count, ocrFatGuid_t *waiters,
+                               u32 *slots, ocrFatGuid_t currentEdt, ocrPolicyMsg_t * msg) {
+    // Warn: Caller must have acquired the waitersLock
+    ocrEventHc_t *event = (ocrEventHc_t*)base;
+    u32 i = 0;
+#if HCEVT_WAITER_STATIC_COUNT
+    while ((i < count) && (event->waitersCount < HCEVT_WAITER_STATIC_COUNT)) {
+        event->waiters[event->waitersCount].guid = waiters[i].guid;
+        event->waiters[event->waitersCount].slot = slots[i];
+        ++event->waitersCount;
+        ++i;
+    }
+    if (i == count) {
+        hal_unlock(&(event->waitersLock));
+        return 0;
+    }
+#endif
+    ocrFatGuid_t oldDbGuid = {.guid = NULL_GUID, .metaDataPtr = NULL};
+    regNode_t *nodes = NULL;
+    regNode_t *nodesNew = NULL;
+    u8 toReturn = 0;
+    if (event->waitersCount == HCEVT_WAITER_STATIC_COUNT) {
+        // Initial setup, sized for all the waiters left
+        u32 dynCount = HCEVT_WAITER_DYNAMIC_COUNT;
+        while (dynCount <= (count - i))
+            dynCount *= 2;
+        toReturn = createDbRegNode(&(event->waitersDb), dynCount, false, &nodes);
+        if (toReturn) {
+            ASSERT(false && "Failed allocating db waiter");
+            hal_unlock(&(event->waitersLock));
+            return toReturn;
+        }
+        event->waitersMax += dynCount;
+    } else {
+        // Acquire the DB that contains the waiters
+#define PD_MSG (msg)
+#define PD_TYPE PD_MSG_DB_ACQUIRE
+        getCurrentEnv(NULL, NULL, NULL, msg);
+        msg->type = PD_MSG_DB_ACQUIRE | PD_MSG_REQUEST | PD_MSG_REQ_RESPONSE;
+        PD_MSG_FIELD_IO(guid) = event->waitersDb;
+        PD_MSG_FIELD_IO(edt) = currentEdt;
+        PD_MSG_FIELD_IO(destLoc) = pd->myLocation;
+        PD_MSG_FIELD_IO(edtSlot) = EDT_SLOT_NONE;
+        PD_MSG_FIELD_IO(properties) = DB_MODE_RW | DB_PROP_RT_ACQUIRE;
+        if((toReturn = pd->fcts.processMessage(pd, msg, true))) {
+            ASSERT(false); // debug
+            hal_unlock(&(event->waitersLock));
+            return toReturn; //BUG #603 error codes
+        }
+        nodes = (regNode_t*)PD_MSG_FIELD_O(ptr);
+        event->waitersDb = PD_MSG_FIELD_IO(guid);
+        ASSERT(nodes);
+#undef PD_TYPE
+        u32 newMax = event->waitersMax;
+        while (event->waitersCount + (count - i) >= newMax)
+            newMax *= 2;
+        if (newMax != event->waitersMax) {
+            // We need to create a new DB and copy things over
+#define PD_TYPE PD_MSG_DB_CREATE
+            ocrFatGuid_t newDbGuid = {.guid = NULL_GUID, .metaDataPtr = NULL};
+            getCurrentEnv(NULL, NULL, NULL, msg);
+            msg->type = PD_MSG_DB_CREATE | PD_MSG_REQUEST | PD_MSG_REQ_RESPONSE;
+            PD_MSG_FIELD_IO(guid) = newDbGuid;
+            PD_MSG_FIELD_IO(properties) = DB_PROP_RT_ACQUIRE;
+            PD_MSG_FIELD_IO(size) = sizeof(regNode_t)*newMax;
+            PD_MSG_FIELD_I(edt) = currentEdt;
+            PD_MSG_FIELD_I(hint) = NULL_HINT;
+            PD_MSG_FIELD_I(dbType) = RUNTIME_DBTYPE;
+            PD_MSG_FIELD_I(allocator) = NO_ALLOC;
+            if((toReturn = pd->fcts.processMessage(pd, msg, true))) {
+                ASSERT(false); // debug
+                hal_unlock(&(event->waitersLock));
+                return toReturn; //BUG #603 error codes
+            }
+            nodesNew = (regNode_t*)PD_MSG_FIELD_O(ptr);
+            oldDbGuid = event->waitersDb;
+            event->waitersDb = PD_MSG_FIELD_IO(guid);
+#undef PD_TYPE
+#undef PD_MSG
+            u32 nbNodes = event->waitersCount-HCEVT_WAITER_STATIC_COUNT;
+            hal_memCopy(nodesNew, nodes, sizeof(regNode_t)*(nbNodes), false);
+            u32 j;
+            for(j = nbNodes; j < newMax-HCEVT_WAITER_STATIC_COUNT; ++j) {
+                nodesNew[j].guid = NULL_GUID;
+                nodesNew[j].slot = 0;
+                nodesNew[j].mode = -1;
+            }
+            event->waitersMax = newMax;
+            nodes = nodesNew;
+        }
+    }
+    // Release the DB read from the event while holding the lock, see commonEnqueueWaiter
+    ocrFatGuid_t dbGuid = event->waitersDb;
+    for(; i < count; ++i) {
+        u32 idx = event->waitersCount-HCEVT_WAITER_STATIC_COUNT;
+        nodes[idx].guid = waiters[i].guid;
+        nodes[idx].slot = slots[i];
+        ++event->waitersCount;
+    }
+    hal_unlock(&(event->waitersLock));
+
+#define PD_MSG (msg)
+#define PD_TYPE PD_MSG_DB_RELEASE
+    getCurrentEnv(NULL, NULL, NULL, msg);
+    msg->type = PD_MSG_DB_RELEASE | PD_MSG_REQUEST | PD_MSG_REQ_RESPONSE;
+    PD_MSG_FIELD_IO(guid) = dbGuid;
+    PD_MSG_FIELD_I(edt) = currentEdt;
+    PD_MSG_FIELD_I(srcLoc) = pd->myLocation;
+    PD_MSG_FIELD_I(ptr) = NULL;
+    PD_MSG_FIELD_I(size) = 0;
+    PD_MSG_FIELD_I(properties) = DB_PROP_RT_ACQUIRE;
+    RESULT_PROPAGATE(pd->fcts.processMessage(pd, msg, true));
+#undef PD_MSG
+#undef PD_TYPE
+
+    if(nodesNew) {
+        // Free the old DB (implicitely released)
+#define PD_MSG (msg)
+#define PD_TYPE PD_MSG_DB_FREE
+        getCurrentEnv(NULL, NULL, NULL, msg);
+        msg->type = PD_MSG_DB_FREE | PD_MSG_REQUEST;
+        PD_MSG_FIELD_I(guid) = oldDbGuid;
+        PD_MSG_FIELD_I(edt) = currentEdt;
+        PD_MSG_FIELD_I(srcLoc) = pd->myLocation;
+        PD_MSG_FIELD_I(properties) = DB_PROP_RT_ACQUIRE;
+        if((toReturn = pd->fcts.processMessage(pd, msg, false))) {
+            ASSERT(false); // debug
+            return toReturn; //BUG #603 error codes
+        }
+#undef PD_MSG
+#undef PD_TYPE
+    }
+    return 0;
+}
+
+/**
+ * @brief Registers several waiters on a persistent event while adding dependences.
+ *
+ * Same as registerWaiterEventHcPersist for each waiter, with the waitersLock
+ * grabbed once.
+ */
+u8 registerWaitersEventHcPersist(ocrEvent_t *base, u32 count, ocrFatGuid_t *waiters, u32 *slots) {
+    OCR_OBJECT_MARK_DIRTY(base);
+    ocrEventHcPersist_t *event = (ocrEventHcPersist_t*)base;
+
+    ocrPolicyDomain_t *pd = NULL;
+    ocrTask_t *curTask = NULL;
+    PD_MSG_STACK(msg);
+    getCurrentEnv(&pd, NULL, &curTask, &msg);
+    ocrFatGuid_t currentEdt;
+    currentEdt.guid = (curTask == NULL) ? NULL_GUID : curTask->guid;
+    currentEdt.metaDataPtr = curTask;
+
+    DPRINTF(DEBUG_LVL_INFO, "Register %"PRIu32" waiters %s: "GUIDF"\n",
+            count, eventTypeToString(base), GUIDA(base->guid));
+    if (count == 0)
+        return 0;
+    hal_lock(&(event->base.waitersLock));
+    if (!(ocrGuidIsUninitialized(event->data))) {
+        ocrFatGuid_t dataGuid = {.guid = event->data, .metaDataPtr = NULL};
+        hal_unlock(&(event->base.waitersLock));
+        u32 i;
+        for(i = 0; i < count; ++i) {
+            regNode_t node = {.guid = waiters[i].guid, .slot = slots[i]};
+            RESULT_PROPAGATE(commonSatisfyRegNode(pd, &msg, base, dataGuid, currentEdt, &node));
+        }
+        return 0;
+    }
+    // Lock is released by commonEnqueueWaiters
+    return commonEnqueueWaiters(pd, base, count, waiters, slots, currentEdt, &msg);
+}
+#endif
+
 /**
  * @brief Registers waiters on a counted-event.
  *
@@ -1175,6 +1484,7 @@ u8 registerWaiterEventHcCounted(ocrEvent_t *base, ocrFatGuid_t waiter, u32 slot,
 #else
 u8 registerWaiterEventHcCounted(ocrEvent_t *base, ocrFatGuid_t waiter, u32 slot, bool isDepAdd) {
 #endif
+    OCR_OBJECT_MARK_DIRTY(base);
     ocrEventHcPersist_t *event = (ocrEventHcPersist_t*)base;
 
     ocrPolicyDomain_t *pd = NULL;
@@ -1251,6 +1561,7 @@ u8 registerWaiterEventHcCounted(ocrEvent_t *base, ocrFatGuid_t waiter, u32 slot,
 
 // In this call, we do not contend with satisfy
 u8 unregisterWaiterEventHc(ocrEvent_t *base, ocrFatGuid_t waiter, u32 slot, bool isDepRem) {
+    OCR_OBJECT_MARK_DIRTY(base);
     // Always search for the waiter because we don't know if it registered or not so
     // ignore isDepRem
     ocrEventHc_t *event = (ocrEventHc_t*)base;
@@ -1316,6 +1627,7 @@ u8 unregisterWaiterEventHc(ocrEvent_t *base, ocrFatGuid_t waiter, u32 slot, bool
 
 // In this call, we can have concurrent satisfy
 u8 unregisterWaiterEventHcPersist(ocrEvent_t *base, ocrFatGuid_t waiter, u32 slot) {
+    OCR_OBJECT_MARK_DIRTY(base);
     ocrEventHcPersist_t *event = (ocrEventHcPersist_t*)base;
 
 
@@ -1390,6 +1702,7 @@ u8 unregisterWaiterEventHcPersist(ocrEvent_t *base, ocrFatGuid_t waiter, u32 slo
 }
 
 u8 setHintEventHc(ocrEvent_t* self, ocrHint_t *hint) {
+    OCR_OBJECT_MARK_DIRTY(self);
     ocrEventHc_t *derived = (ocrEventHc_t*)self;
     ocrRuntimeHint_t *rHint = &(derived->hint);
     OCR_RUNTIME_HINT_SET(hint, rHint, OCR_HINT_COUNT_EVT_HC, ocrHintPropEventHc, OCR_HINT_EVT_PROP_START);
@@ -1587,6 +1900,10 @@ static u8 initNewEventHc(ocrEventHc_t * event, ocrEventTypes_t eventType, ocrGui
         } else {
             ((ocrEventHcLatch_t*)event)->counter = 0;
         }
+#ifdef HCEVT_FINISH_LATCH_SUB_COUNTERS
+        ((ocrEventHcLatch_t*)event)->subs = NULL;
+        ((ocrEventHcLatch_t*)event)->subCount = 0;
+#endif
 #ifdef ENABLE_AMT_RESILIENCE
         ((ocrEventHcLatch_t*)event)->readyToDestruct = 0;
         ((ocrEventHcLatch_t*)event)->shutdownLatch = 0;
@@ -1758,6 +2075,7 @@ static u8 allocateNewEventHc(ocrGuidKind guidKind, ocrFatGuid_t * resultGuid, u3
     ocrEvent_t *evt = (ocrEvent_t*)resultGuid->metaDataPtr;
     evt->base.kind = guidKind;
     evt->base.size = (*sizeofMd) + hintc*sizeof(u64);
+    evt->base.epoch = 0;
 #endif
 #undef PD_MSG
 #undef PD_TYPE
@@ -1892,6 +2210,11 @@ u8 newEventHc(ocrEventFactory_t * factory, ocrFatGuid_t *fguid,
     ocrEventHc_t *event = (ocrEventHc_t*) fguid->metaDataPtr;
     returnValue = initNewEventHc(event, eventType, UNINITIALIZED_GUID, factory, sizeOfMd, userArg, perInstance);
     if (returnValue) { return returnValue; }
+#ifdef HCEVT_FINISH_LATCH_SUB_COUNTERS
+    if ((eventType == OCR_EVENT_LATCH_T) && (properties & EVT_RT_PROP_FINISH_LATCH)) {
+        initFinishLatchSubs((ocrEventHcLatch_t*) event);
+    }
+#endif
 
     // Do this at the very end; it indicates that the object
     // of the GUID is actually valid
@@ -2082,6 +2405,7 @@ u8 registerWaiterEventHcChannel(ocrEvent_t *base, ocrFatGuid_t waiter, u32 slot,
 #else
 u8 registerWaiterEventHcChannel(ocrEvent_t *base, ocrFatGuid_t waiter, u32 slot, bool isDepAdd) {
 #endif
+    OCR_OBJECT_MARK_DIRTY(base);
     ocrEventHc_t * evt = ((ocrEventHc_t*)base);
     ocrEventHcChannel_t * devt = ((ocrEventHcChannel_t*)base);
     hal_lock(&evt->waitersLock);
@@ -2123,6 +2447,7 @@ u8 registerWaiterEventHcChannel(ocrEvent_t *base, ocrFatGuid_t waiter, u32 slot,
 }
 
 u8 satisfyEventHcChannel(ocrEvent_t *base, ocrFatGuid_t db, u32 slot) {
+    OCR_OBJECT_MARK_DIRTY(base);
     ocrEventHc_t * evt = ((ocrEventHc_t*)base);
     ocrEventHcChannel_t * devt = ((ocrEventHcChannel_t*)base);
     hal_lock(&evt->waitersLock);
@@ -2568,6 +2893,15 @@ ocrEventFactory_t * newEventFactoryHc(ocrParamList_t *perType, u32 factoryId) {
     base->fcts[OCR_EVENT_CHANNEL_T].unregisterWaiter =
         FUNC_ADDR(u8 (*)(ocrEvent_t*, ocrFatGuid_t, u32, bool), unregisterWaiterEventHcChannel);
 #endif
+    // Bulk registration of waiters, only for persistent events
+    for(i = 0; i < (u32)OCR_EVENT_T_MAX; ++i) {
+        base->fcts[i].registerWaiters = NULL;
+    }
+#ifndef REG_ASYNC_SGL
+    base->fcts[OCR_EVENT_IDEM_T].registerWaiters =
+    base->fcts[OCR_EVENT_STICKY_T].registerWaiters =
+        FUNC_ADDR(u8 (*)(ocrEvent_t*, u32, ocrFatGuid_t*, u32*), registerWaitersEventHcPersist);
+#endif
 
     base->factoryId = factoryId;
 
@@ -37,6 +37,12 @@
 #define ENABLE_EVENT_MDC 0
 #endif
 
+// Finish latches spread their count over per-worker sub-counters when
+// this is defined. Checkpointing serializes events as flat copies.
+#ifdef ENABLE_RESILIENCY
+#undef HCEVT_FINISH_LATCH_SUB_COUNTERS
+#endif
+
 #define MDC_SUPPORT_EVT(guidKind) (ENABLE_EVENT_MDC && ((guidKind == OCR_GUID_EVENT_IDEM) || (guidKind == OCR_GUID_EVENT_STICKY)))
 
 typedef struct _paramListEventHc_t {
@@ -81,9 +87,20 @@ typedef struct _ocrEventHcCounted_t {
     u64 nbDeps; // this is only updated inside a lock
 } ocrEventHcCounted_t;
 
+#ifdef HCEVT_FINISH_LATCH_SUB_COUNTERS
+typedef union _ocrEventHcLatchSub_t {
+    volatile s32 count;
+    u8 padding[CACHE_LINE_SZB];
+} ocrEventHcLatchSub_t;
+#endif
+
 typedef struct _ocrEventHcLatch_t {
     ocrEventHc_t base;
-    s32 counter;
+    s32 counter; // With sub-counters, the number of non-zero ones
+#ifdef HCEVT_FINISH_LATCH_SUB_COUNTERS
+    ocrEventHcLatchSub_t * subs; // Per-worker sub-counters of a finish latch, NULL otherwise
+    u32 subCount;
+#endif
 #ifdef ENABLE_AMT_RESILIENCE
     u8 readyToDestruct;
     u8 shutdownLatch;
@@ -61,6 +61,7 @@
 #define GP_HASHTABLE_PUT(hashtable, key, value) hashtableConcBucketLockedPut(GP_RESOLVE_HASHTABLE(hashtable,key), key, value)
 #define GP_HASHTABLE_DEL(hashtable, key, valueBack) hashtableConcBucketLockedRemove(GP_RESOLVE_HASHTABLE(hashtable,key), key, valueBack)
 #define GP_HASHTABLE_ITERATE(hashtable, iterate, args) iterateHashtable(hashtable, iterate, args)
+#define GP_HASHTABLE_ITERATE_RANGE(hashtable, first, last, iterate, args) iterateHashtableRange(hashtable, first, last, iterate, args)
 #endif
 
 #define RSELF_TYPE ocrGuidProviderCountedMap_t
@@ -522,6 +523,32 @@ static u8 countedMapGetVal(ocrGuidProvider_t* self, ocrGuid_t guid, u64* val, oc
     return (*val) ? 0 : OCR_EPEND;
 }
 
+#ifdef ENABLE_RESILIENCY
+/**
+ * @brief Remember a released GUID so that the next incremental checkpoint
+ * can replay its removal. Nothing is recorded until a base checkpoint exists.
+ */
+static void recordTombstone(ocrGuidProviderCountedMap_t * derived, ocrGuid_t guid) {
+    if (derived->chkptEpoch == 0)
+        return;
+    hal_lock(&(derived->tombstoneLock));
+    if (derived->tombstoneCount == derived->tombstoneMax) {
+        ocrPolicyDomain_t *pd = NULL;
+        getCurrentEnv(&pd, NULL, NULL, NULL);
+        u64 newMax = (derived->tombstoneMax == 0) ? 64 : (derived->tombstoneMax << 1);
+        ocrGuid_t *newTombstones = (ocrGuid_t*)pd->fcts.pdMalloc(pd, newMax * sizeof(ocrGuid_t));
+        if (derived->tombstones != NULL) {
+            hal_memCopy(newTombstones, derived->tombstones, derived->tombstoneCount * sizeof(ocrGuid_t), false);
+            pd->fcts.pdFree(pd, derived->tombstones);
+        }
+        derived->tombstones = newTombstones;
+        derived->tombstoneMax = newMax;
+    }
+    derived->tombstones[derived->tombstoneCount++] = guid;
+    hal_unlock(&(derived->tombstoneLock));
+}
+#endif
+
 /**
  * @brief Remove an already existing GUID and its associated value from the provider
  */
@@ -533,6 +560,9 @@ u8 countedMapUnregisterGuid(ocrGuidProvider_t* self, ocrGuid_t guid, u64 ** val)
     GP_HASHTABLE_DEL(((ocrGuidProviderCountedMap_t *) self)->guidImplTable, (void *) guid.lower, (void **) val);
 #else
 #error Unknown type of GUID
+#endif
+#ifdef ENABLE_RESILIENCY
+    recordTombstone((ocrGuidProviderCountedMap_t *) self, guid);
 #endif
     return 0;
 }
@@ -548,6 +578,9 @@ u8 countedMapReleaseGuid(ocrGuidProvider_t *self, ocrFatGuid_t fatGuid, bool rel
     GP_HASHTABLE_DEL(derived->guidImplTable, (void *)guid.lower, NULL);
 #else
 #error Unknown type of GUID
+#endif
+#ifdef ENABLE_RESILIENCY
+    recordTombstone(derived, guid);
 #endif
     // If there's metaData associated with guid we need to deallocate memory
     if(releaseVal && (fatGuid.metaDataPtr != NULL)) {
@@ -579,6 +612,10 @@ extern u8 deserializeProxyDb(u8* buffer, void **value);
 extern void fixupProxyDb(void *value);
 extern void destructProxyDb(void *value);
 
+void serializeGuid(void * key, void * value, void * args);
+void fixupGuid(void * key, void * value, void * args);
+void resetProgramState(void * key, void * value, void * args);
+
 //Returns the serialization size of the MdProxy only,
 //excluding the size of linked OCR object in mdProxy->ptr
 u64 getSerializationSizeMdProxy(MdProxy_t *mdProxy) {
@@ -726,20 +763,41 @@ void destructMdProxy(MdProxy_t *mdProxy) {
     pd->fcts.pdFree(pd, mdProxy);
 }
 
+//Iteration state shared by the serialization callbacks
+typedef struct {
+    u8 *buffer;     // Next free byte of the checkpoint buffer
+    u64 size;       // Accumulated serialization size
+    u64 count;      // Number of objects visited
+    u32 epoch;      // Stamp applied to serialized objects
+    bool isDelta;   // Only consider objects dirtied since the last checkpoint
+} guidSerializeArgs_t;
+
+//Returns true if the object carries its own checkpoint epoch stamp.
+//MdProxies, DB proxies and affinities do not and are always serialized.
+static bool isEpochTracked(ocrGuidKind kind, ocrObject_t *ocrObj, MdProxy_t *mdProxy) {
+    if (mdProxy != NULL || ocrObj->kind != kind)
+        return false;
+    return (kind == OCR_GUID_DB) || (kind == OCR_GUID_EDT) ||
+           (kind == OCR_GUID_EDT_TEMPLATE) || ((kind & OCR_GUID_EVENT) != 0);
+}
+
+static bool isSerializedGuid(guidSerializeArgs_t *sargs, ocrGuidKind kind, ocrObject_t *ocrObj, MdProxy_t *mdProxy) {
+    return !sargs->isDelta || !isEpochTracked(kind, ocrObj, mdProxy) || (ocrObj->epoch == 0);
+}
+
 void calcSerializationSize(void * key, void * value, void * args) {
     ASSERT(key != NULL);
     ASSERT(value != NULL);
     ASSERT(args != NULL);
 
     ocrPolicyDomain_t *pd = NULL;
-    ocrTask_t * curEdt = NULL;
-    getCurrentEnv(&pd, NULL, &curEdt, NULL);
+    getCurrentEnv(&pd, NULL, NULL, NULL);
 
     //Do not checkpoint current EDT
-    if (value == curEdt)
+    if (value == ((ocrGuidProviderCountedMap_t*)pd->guidProviders[0])->chkptSkipEdt)
         return;
 
-    u64 *size = (u64*)args;
+    guidSerializeArgs_t *sargs = (guidSerializeArgs_t*)args;
     ocrGuid_t guid;
 #if GUID_BIT_COUNT == 64
     guid.guid = (u64)key;
@@ -766,6 +824,9 @@ void calcSerializationSize(void * key, void * value, void * args) {
         ASSERT(mdProxySize > 0 && mdProxy->base.size == mdProxySize);
     }
 
+    if (!isSerializedGuid(sargs, kind, ocrObj, mdProxy))
+        return;
+
     u64 mdSize = 0;
     if (kind == OCR_GUID_DB) {
         if (ocrObj->kind == kind) {
@@ -822,19 +883,165 @@ void calcSerializationSize(void * key, void * value, void * args) {
         }
     }
     ASSERT(mdSize > 0);
-    *size += sizeof(ocrGuid_t) + mdProxySize + mdSize;
+    sargs->size += sizeof(ocrGuid_t) + mdProxySize + mdSize;
+    sargs->count++;
+}
+
+/* Partitioned (de)serialization
+ *
+ * The GUID table is split in contiguous bucket ranges processed independently,
+ * possibly in parallel through self->parallelFor. A first pass computes the
+ * serialized size of each partition; an exclusive prefix sum over these sizes
+ * then gives each partition its own slice of the checkpoint buffer. The sizes
+ * are stored in a partition table ahead of the records so that restart can
+ * deserialize the partitions independently as well:
+ * [u64 nbPartitions][u64 partitionSize[nbPartitions]]
+ */
+#define PARTITION_TABLE_SIZE(nbParts) ((1 + (u64)(nbParts)) * sizeof(u64))
+
+//State shared by the partitions of a pass
+typedef struct {
+    ocrGuidProviderCountedMap_t *derived;
+    u8 *records;            // Start of the records region
+    u64 *partitionSize;     // Serialized size of each partition
+    u64 *partitionOffset;   // Offset of each partition in the records region
+    u32 epoch;
+    bool isDelta;
+} guidPassArgs_t;
+
+static void getPartitionBuckets(ocrGuidProviderCountedMap_t *derived, u32 partition, u32 *first, u32 *last) {
+    u64 nbBuckets = derived->guidImplTable->nbBuckets;
+    *first = (u32)((nbBuckets * partition) / derived->chkptPartitions);
+    *last = (u32)((nbBuckets * (partition + 1)) / derived->chkptPartitions);
+}
+
+static void runPartitions(ocrGuidProvider_t *self, ocrGuidParallelFct_t fct, void *args, u32 count) {
+    if (self->parallelFor != NULL) {
+        self->parallelFor(self->pd, fct, args, count);
+    } else {
+        u32 i;
+        for (i = 0; i < count; i++)
+            fct(args, i);
+    }
+}
+
+static void calcSerializationSizePartition(void *args, u32 partition) {
+    guidPassArgs_t *pargs = (guidPassArgs_t*)args;
+    ocrGuidProviderCountedMap_t *derived = pargs->derived;
+    guidSerializeArgs_t sargs = {.buffer = NULL, .size = 0, .count = 0, .epoch = 0, .isDelta = pargs->isDelta};
+    u32 first, last;
+    getPartitionBuckets(derived, partition, &first, &last);
+    GP_HASHTABLE_ITERATE_RANGE(derived->guidImplTable, first, last, calcSerializationSize, (void*)(&sargs));
+    pargs->partitionSize[partition] = sargs.size;
+    hal_xadd64(&derived->objectsCounted, sargs.count);
+}
 
+static void serializePartition(void *args, u32 partition) {
+    guidPassArgs_t *pargs = (guidPassArgs_t*)args;
+    ocrGuidProviderCountedMap_t *derived = pargs->derived;
+    u8 *start = pargs->records + pargs->partitionOffset[partition];
+    guidSerializeArgs_t sargs = {.buffer = start, .size = 0, .count = 0, .epoch = pargs->epoch, .isDelta = pargs->isDelta};
+    u32 first, last;
+    getPartitionBuckets(derived, partition, &first, &last);
+    GP_HASHTABLE_ITERATE_RANGE(derived->guidImplTable, first, last, serializeGuid, (void*)(&sargs));
+    if ((sargs.buffer - start) != pargs->partitionSize[partition]) {
+        DPRINTF(DEBUG_LVL_WARN, "Checkpoint partition %"PRIu32" overflow! (Partition Size: %lu Serialized Size: %lu)\n",
+                partition, pargs->partitionSize[partition], (u64)(sargs.buffer - start));
+        ASSERT(0);
+    }
+    hal_xadd64(&derived->objectsSerialized, sargs.count);
+}
+
+static u8 deserializeGuidRecords(ocrGuidProvider_t* self, u8* buffer, u8* endOfBuffer, bool isDelta);
+
+static void deserializePartition(void *args, u32 partition) {
+    guidPassArgs_t *pargs = (guidPassArgs_t*)args;
+    u8 *start = pargs->records + pargs->partitionOffset[partition];
+    RESULT_ASSERT(deserializeGuidRecords((ocrGuidProvider_t*)pargs->derived, start,
+                  start + pargs->partitionSize[partition], pargs->isDelta), ==, 0);
+}
+
+static void fixupPartition(void *args, u32 partition) {
+    guidPassArgs_t *pargs = (guidPassArgs_t*)args;
+    ocrGuidProviderCountedMap_t *derived = pargs->derived;
+    u32 first, last;
+    getPartitionBuckets(derived, partition, &first, &last);
+    GP_HASHTABLE_ITERATE_RANGE(derived->guidImplTable, first, last, fixupGuid, (void*)derived);
+}
+
+//Computes the size of every partition, returns the total size of the records
+static u64 calcPartitionSizes(ocrGuidProvider_t* self, bool isDelta) {
+    ocrGuidProviderCountedMap_t * derived = (ocrGuidProviderCountedMap_t *) self;
+    u32 nbBuckets = derived->guidImplTable->nbBuckets;
+    derived->chkptPartitions = (nbBuckets < GUID_PROVIDER_CHKPT_PARTITIONS) ? nbBuckets : GUID_PROVIDER_CHKPT_PARTITIONS;
+    derived->objectsCounted = 0;
+    //The serialization pass that follows skips the same EDT
+    getCurrentEnv(NULL, NULL, &derived->chkptSkipEdt, NULL);
+    guidPassArgs_t pargs = {.derived = derived, .records = NULL, .partitionSize = derived->chkptPartitionSize,
+                            .partitionOffset = NULL, .epoch = 0, .isDelta = isDelta};
+    runPartitions(self, calcSerializationSizePartition, (void*)(&pargs), derived->chkptPartitions);
+    u64 size = 0;
+    u32 i;
+    for (i = 0; i < derived->chkptPartitions; i++)
+        size += derived->chkptPartitionSize[i];
+    return size;
+}
+
+//Writes the partition table followed by the records of all the partitions
+//sized by the last calcPartitionSizes call. Returns the end of the records.
+static u8* serializePartitions(ocrGuidProvider_t* self, u8* buffer, u8* records, bool isDelta) {
+    ocrGuidProviderCountedMap_t * derived = (ocrGuidProviderCountedMap_t *) self;
+    u32 nbParts = derived->chkptPartitions;
+    u64 *table = (u64*)buffer;
+    table[0] = nbParts;
+    hal_memCopy(&table[1], derived->chkptPartitionSize, nbParts * sizeof(u64), false);
+
+    u64 partitionOffset[GUID_PROVIDER_CHKPT_PARTITIONS];
+    u64 offset = 0;
+    u32 i;
+    for (i = 0; i < nbParts; i++) {
+        partitionOffset[i] = offset;
+        offset += derived->chkptPartitionSize[i];
+    }
+
+    derived->objectsSerialized = 0;
+    guidPassArgs_t pargs = {.derived = derived, .records = records, .partitionSize = derived->chkptPartitionSize,
+                            .partitionOffset = partitionOffset, .epoch = ++derived->chkptEpoch, .isDelta = isDelta};
+    runPartitions(self, serializePartition, (void*)(&pargs), nbParts);
+    return records + offset;
+}
+
+//Reads a partition table and deserializes the records that follow it
+static u8 deserializePartitions(ocrGuidProvider_t* self, u8* buffer, u8* records, u8* endOfBuffer, bool isDelta) {
     ocrGuidProviderCountedMap_t * derived = (ocrGuidProviderCountedMap_t *) self;
-    derived->objectsCounted++;
+    u64 *table = (u64*)buffer;
+    u64 nbParts = table[0];
+    if (nbParts > GUID_PROVIDER_CHKPT_PARTITIONS)
+        return OCR_EINVAL;
+
+    u64 partitionOffset[GUID_PROVIDER_CHKPT_PARTITIONS];
+    u64 offset = 0;
+    u32 i;
+    for (i = 0; i < nbParts; i++) {
+        partitionOffset[i] = offset;
+        offset += table[1 + i];
+    }
+    if ((records + offset) != endOfBuffer)
+        return OCR_EINVAL;
+
+    guidPassArgs_t pargs = {.derived = derived, .records = records, .partitionSize = &table[1],
+                            .partitionOffset = partitionOffset, .epoch = 0, .isDelta = isDelta};
+    runPartitions(self, deserializePartition, (void*)(&pargs), (u32)nbParts);
+    return 0;
 }
 
+#define FULL_HEADER_SIZE (sizeof(ocrObject_t) + sizeof(u64))
+
 u8 getSerializationSizeGuidProviderCounted(ocrGuidProvider_t* self, u64* size) {
     ocrGuidProviderCountedMap_t * derived = (ocrGuidProviderCountedMap_t *) self;
-    derived->objectsCounted = 0;
-    *size = 0;
-    GP_HASHTABLE_ITERATE(derived->guidImplTable, calcSerializationSize, (void*)size);
-    ASSERT(derived->objectsCounted > 0 && *size > 0);
-    *size += sizeof(ocrObject_t) + sizeof(u64);
+    u64 recordsSize = calcPartitionSizes(self, false);
+    ASSERT(derived->objectsCounted > 0 && recordsSize > 0);
+    *size = FULL_HEADER_SIZE + PARTITION_TABLE_SIZE(derived->chkptPartitions) + recordsSize;
 #ifdef GUID_PROVIDER_WID_INGUID
 #error "Unsupported option for resiliency"
 #endif
@@ -849,15 +1056,13 @@ void serializeGuid(void * key, void * value, void * args) {
     ASSERT(args != NULL);
 
     ocrPolicyDomain_t *pd = NULL;
-    ocrTask_t * curEdt = NULL;
-    getCurrentEnv(&pd, NULL, &curEdt, NULL);
+    getCurrentEnv(&pd, NULL, NULL, NULL);
 
     //Do not checkpoint current EDT
-    if (value == curEdt)
+    if (value == ((ocrGuidProviderCountedMap_t*)pd->guidProviders[0])->chkptSkipEdt)
         return;
 
-    u8 **buffer = (u8**)args;
-    u8* ptr = *buffer;
+    guidSerializeArgs_t *sargs = (guidSerializeArgs_t*)args;
     ocrGuid_t guid;
 #if GUID_BIT_COUNT == 64
     guid.guid = (u64)key;
@@ -868,9 +1073,6 @@ void serializeGuid(void * key, void * value, void * args) {
 #error Unknown type of GUID
 #endif
 
-    *((ocrGuid_t*)ptr) = guid;
-    ptr += sizeof(ocrGuid_t);
-
     u64 len = 0;
     ocrGuidProvider_t* self = pd->guidProviders[0];
     ocrGuidKind kind;
@@ -882,10 +1084,20 @@ void serializeGuid(void * key, void * value, void * args) {
         mdProxy = (MdProxy_t*)value;
         ASSERT(mdProxy->base.kind == OCR_GUID_MD_PROXY);
         ocrObj = (ocrObject_t*)mdProxy->ptr;
+    }
+    ASSERT(ocrObj);
+
+    if (!isSerializedGuid(sargs, kind, ocrObj, mdProxy))
+        return;
+
+    u8* ptr = sargs->buffer;
+    *((ocrGuid_t*)ptr) = guid;
+    ptr += sizeof(ocrGuid_t);
+
+    if (mdProxy != NULL) {
         len = serializeMdProxy(mdProxy, ptr);
         ptr += len;
     }
-    ASSERT(ocrObj);
 
     u64 size = 0;
     if (kind == OCR_GUID_DB) {
@@ -945,15 +1157,14 @@ void serializeGuid(void * key, void * value, void * args) {
     ASSERT(size > 0);
     ptr += size;
 
-    *buffer = ptr;
-
-    ocrGuidProviderCountedMap_t * derived = (ocrGuidProviderCountedMap_t *) self;
-    derived->objectsSerialized++;
+    sargs->buffer = ptr;
+    if (isEpochTracked(kind, ocrObj, mdProxy))
+        ocrObj->epoch = sargs->epoch;
+    sargs->count++;
 }
 
 u8 serializeGuidProviderCounted(ocrGuidProvider_t* self, u8* buffer) {
     ocrGuidProviderCountedMap_t * derived = (ocrGuidProviderCountedMap_t *) self;
-    derived->objectsSerialized = 0;
     u8* bufferHead = buffer;
     ocrObject_t * ocrObj = (ocrObject_t *)bufferHead;
     *ocrObj = self->base;
@@ -962,7 +1173,10 @@ u8 serializeGuidProviderCounted(ocrGuidProvider_t* self, u8* buffer) {
     *guidCounter = derived->guidCounter;
     buffer += sizeof(u64);
 
-    GP_HASHTABLE_ITERATE(derived->guidImplTable, serializeGuid, (void*)(&buffer));
+    // A full checkpoint supersedes all the GUIDs released so far
+    derived->tombstoneCount = 0;
+    u8 *records = buffer + PARTITION_TABLE_SIZE(derived->chkptPartitions);
+    buffer = serializePartitions(self, buffer, records, false);
 
     if ((buffer - bufferHead) != self->base.size) {
         DPRINTF(DEBUG_LVL_WARN, "Checkpoint buffer overflow! (Buffer Size: %lu Serialized Size: %lu Overflow: %lu Start: %p End: %p)\n",
@@ -973,18 +1187,14 @@ u8 serializeGuidProviderCounted(ocrGuidProvider_t* self, u8* buffer) {
     return 0;
 }
 
-u8 deserializeGuidProviderCounted(ocrGuidProvider_t* self, u8* buffer) {
+//Deserializes the (guid, [MdProxy], object) records found in [buffer, endOfBuffer)
+//and registers them in the provider. When replaying a delta, an object already
+//present in the map is an older version of the record and gets discarded first.
+static u8 deserializeGuidRecords(ocrGuidProvider_t* self, u8* buffer, u8* endOfBuffer, bool isDelta) {
     ocrPolicyDomain_t *pd = NULL;
     getCurrentEnv(&pd, NULL, NULL, NULL);
     ocrGuidProviderCountedMap_t * derived = (ocrGuidProviderCountedMap_t *) self;
-
-    ocrObject_t * ocrObj = (ocrObject_t *)buffer;
-    ASSERT(ocrObj->kind == OCR_GUID_GUIDMAP);
-    u8* endOfBuffer = buffer + ocrObj->size;
-    buffer += sizeof(ocrObject_t);
-    u64 *guidCounter = (u64*)buffer;
-    derived->guidCounter = *guidCounter;
-    buffer += sizeof(u64);
+    ocrObject_t * ocrObj = NULL;
 
     while(buffer < endOfBuffer) {
         ocrGuid_t guid = *((ocrGuid_t*)buffer);
@@ -1055,28 +1265,138 @@ u8 deserializeGuidProviderCounted(ocrGuidProvider_t* self, u8* buffer) {
         }
 
 #if GUID_BIT_COUNT == 64
-        GP_HASHTABLE_PUT(derived->guidImplTable, (void *) guid.guid, val);
+        void *key = (void *) guid.guid;
 #elif GUID_BIT_COUNT == 128
-        GP_HASHTABLE_PUT(derived->guidImplTable, (void *) guid.lower, val);
+        void *key = (void *) guid.lower;
 #else
 #error Unknown type of GUID
 #endif
+        if (isDelta) {
+            void *prevVal = GP_HASHTABLE_GET(derived->guidImplTable, key);
+            if (prevVal != NULL)
+                resetProgramState(key, prevVal, self);
+        }
+        GP_HASHTABLE_PUT(derived->guidImplTable, key, val);
         buffer += size;
     }
     return 0;
 }
 
+u8 deserializeGuidProviderCounted(ocrGuidProvider_t* self, u8* buffer) {
+    ocrGuidProviderCountedMap_t * derived = (ocrGuidProviderCountedMap_t *) self;
+
+    ocrObject_t * ocrObj = (ocrObject_t *)buffer;
+    ASSERT(ocrObj->kind == OCR_GUID_GUIDMAP);
+    u8* endOfBuffer = buffer + ocrObj->size;
+    buffer += sizeof(ocrObject_t);
+    u64 *guidCounter = (u64*)buffer;
+    derived->guidCounter = *guidCounter;
+    buffer += sizeof(u64);
+
+    u8 *records = buffer + PARTITION_TABLE_SIZE(((u64*)buffer)[0]);
+    return deserializePartitions(self, buffer, records, endOfBuffer, false);
+}
+
+/* Incremental checkpoints
+ *
+ * A delta only holds the objects dirtied (null epoch stamp) since the previous
+ * checkpoint along with the GUIDs released in between. Its layout is:
+ * [ocrObject_t header][guidCounter][phase][tombstoneCount][partition table][tombstones...][records...]
+ * where the partition table and records use the same format as a full checkpoint.
+ */
+#define DELTA_HEADER_SIZE (sizeof(ocrObject_t) + 3*sizeof(u64))
+
+u8 getDeltaSerializationSizeGuidProviderCounted(ocrGuidProvider_t* self, u64* size) {
+    ocrGuidProviderCountedMap_t * derived = (ocrGuidProviderCountedMap_t *) self;
+    ASSERT(derived->chkptEpoch > 0);
+    u64 recordsSize = calcPartitionSizes(self, true);
+    *size = DELTA_HEADER_SIZE + PARTITION_TABLE_SIZE(derived->chkptPartitions) +
+            (derived->tombstoneCount * sizeof(ocrGuid_t)) + recordsSize;
+    self->base.size = *size;
+    self->base.kind = OCR_GUID_GUIDMAP;
+    return 0;
+}
+
+u8 serializeDeltaGuidProviderCounted(ocrGuidProvider_t* self, u8* buffer, u64 phase) {
+    ocrGuidProviderCountedMap_t * derived = (ocrGuidProviderCountedMap_t *) self;
+    ASSERT(derived->chkptEpoch > 0 && phase > 0);
+    u8* bufferHead = buffer;
+    ocrObject_t * ocrObj = (ocrObject_t *)bufferHead;
+    *ocrObj = self->base;
+    buffer += sizeof(ocrObject_t);
+    u64 *header = (u64*)buffer;
+    header[0] = derived->guidCounter;
+    header[1] = phase;
+    header[2] = derived->tombstoneCount;
+    buffer += 3*sizeof(u64);
+
+    u8 *tombstones = buffer + PARTITION_TABLE_SIZE(derived->chkptPartitions);
+    u64 len = derived->tombstoneCount * sizeof(ocrGuid_t);
+    if (len > 0) {
+        hal_memCopy(tombstones, derived->tombstones, len, false);
+        derived->tombstoneCount = 0;
+    }
+    buffer = serializePartitions(self, buffer, tombstones + len, true);
+
+    if ((buffer - bufferHead) != self->base.size) {
+        DPRINTF(DEBUG_LVL_WARN, "Checkpoint delta buffer overflow! (Buffer Size: %lu Serialized Size: %lu Start: %p End: %p)\n",
+            self->base.size, (buffer - bufferHead), bufferHead, buffer);
+        DPRINTF(DEBUG_LVL_WARN, "Objects counted: %lu Objects serialized: %lu\n", derived->objectsCounted, derived->objectsSerialized);
+        ASSERT(0);
+    }
+    DPRINTF(DEBUG_LVL_VERB, "Checkpoint delta for phase %lu: %lu objects, %lu released\n",
+            phase, derived->objectsSerialized, header[2]);
+    return 0;
+}
+
+u8 deserializeDeltaGuidProviderCounted(ocrGuidProvider_t* self, u8* buffer, u64 maxPhase) {
+    ocrGuidProviderCountedMap_t * derived = (ocrGuidProviderCountedMap_t *) self;
+
+    ocrObject_t * ocrObj = (ocrObject_t *)buffer;
+    if (ocrObj->kind != OCR_GUID_GUIDMAP || ocrObj->size < DELTA_HEADER_SIZE)
+        return OCR_EINVAL;
+    u64 *header = (u64*)(buffer + sizeof(ocrObject_t));
+    //Segments of a phase that was never made stable are discarded
+    if (header[1] == 0 || header[1] > maxPhase)
+        return OCR_EINVAL;
+    u8* endOfBuffer = buffer + ocrObj->size;
+    derived->guidCounter = header[0];
+    buffer += DELTA_HEADER_SIZE;
+    u8 *partitionTable = buffer;
+    buffer += PARTITION_TABLE_SIZE(((u64*)partitionTable)[0]);
+
+    //Removals are replayed first: a delta never holds a record for a released GUID
+    u64 i;
+    for (i = 0; i < header[2]; i++) {
+        ocrGuid_t guid = ((ocrGuid_t*)buffer)[i];
+#if GUID_BIT_COUNT == 64
+        void *key = (void *) guid.guid;
+#elif GUID_BIT_COUNT == 128
+        void *key = (void *) guid.lower;
+#else
+#error Unknown type of GUID
+#endif
+        void *val = GP_HASHTABLE_GET(derived->guidImplTable, key);
+        if (val != NULL)
+            resetProgramState(key, val, self);
+    }
+    buffer += header[2] * sizeof(ocrGuid_t);
+    ASSERT(buffer <= endOfBuffer);
+
+    DPRINTF(DEBUG_LVL_VERB, "Replaying checkpoint delta for phase %lu\n", header[1]);
+    return deserializePartitions(self, partitionTable, buffer, endOfBuffer, true);
+}
+
 void fixupGuid(void * key, void * value, void * args) {
     ASSERT(key != NULL);
     ASSERT(value != NULL);
     ASSERT(args != NULL);
 
     ocrPolicyDomain_t *pd = NULL;
-    ocrTask_t * curEdt = NULL;
-    getCurrentEnv(&pd, NULL, &curEdt, NULL);
+    getCurrentEnv(&pd, NULL, NULL, NULL);
 
     //Do not change current EDT
-    if (value == curEdt)
+    if (value == ((ocrGuidProviderCountedMap_t*)args)->chkptSkipEdt)
         return;
 
     ocrGuid_t guid;
@@ -1155,7 +1475,12 @@ void fixupGuid(void * key, void * value, void * args) {
 
 u8 fixupGuidProviderCounted(ocrGuidProvider_t* self) {
     ocrGuidProviderCountedMap_t * derived = (ocrGuidProviderCountedMap_t *) self;
-    GP_HASHTABLE_ITERATE(derived->guidImplTable, fixupGuid, self);
+    u32 nbBuckets = derived->guidImplTable->nbBuckets;
+    derived->chkptPartitions = (nbBuckets < GUID_PROVIDER_CHKPT_PARTITIONS) ? nbBuckets : GUID_PROVIDER_CHKPT_PARTITIONS;
+    getCurrentEnv(NULL, NULL, &derived->chkptSkipEdt, NULL);
+    guidPassArgs_t pargs = {.derived = derived, .records = NULL, .partitionSize = NULL,
+                            .partitionOffset = NULL, .epoch = 0, .isDelta = false};
+    runPartitions(self, fixupPartition, (void*)(&pargs), derived->chkptPartitions);
     return 0;
 }
 
@@ -1263,6 +1588,9 @@ void resetProgramState(void * key, void * value, void * args) {
 
 u8 resetGuidProviderCounted(ocrGuidProvider_t* self) {
     ocrGuidProviderCountedMap_t * derived = (ocrGuidProviderCountedMap_t *) self;
+    // Objects restored from here on are not covered by any checkpoint of this run
+    derived->chkptEpoch = 0;
+    derived->tombstoneCount = 0;
     GP_HASHTABLE_ITERATE(derived->guidImplTable, resetProgramState, self);
     return 0;
 }
@@ -1289,6 +1617,14 @@ static ocrGuidProvider_t* newGuidProviderCountedMap(ocrGuidProviderFactory_t *fa
 #ifdef ENABLE_RESILIENCY
     rself->objectsCounted = 0;
     rself->objectsSerialized = 0;
+    rself->chkptEpoch = 0;
+    rself->tombstoneLock = INIT_LOCK;
+    rself->tombstoneCount = 0;
+    rself->tombstoneMax = 0;
+    rself->tombstones = NULL;
+    rself->chkptPartitions = 0;
+    rself->chkptSkipEdt = NULL;
+    base->parallelFor = NULL;
 #endif
     return base;
 }
@@ -1326,6 +1662,9 @@ ocrGuidProviderFactory_t *newGuidProviderFactoryCountedMap(ocrParamList_t *typeA
     base->providerFcts.getSerializationSize = FUNC_ADDR(u8 (*)(ocrGuidProvider_t*, u64*), getSerializationSizeGuidProviderCounted);
     base->providerFcts.serialize = FUNC_ADDR(u8 (*)(ocrGuidProvider_t*, u8*), serializeGuidProviderCounted);
     base->providerFcts.deserialize = FUNC_ADDR(u8 (*)(ocrGuidProvider_t*, u8*), deserializeGuidProviderCounted);
+    base->providerFcts.getDeltaSerializationSize = FUNC_ADDR(u8 (*)(ocrGuidProvider_t*, u64*), getDeltaSerializationSizeGuidProviderCounted);
+    base->providerFcts.serializeDelta = FUNC_ADDR(u8 (*)(ocrGuidProvider_t*, u8*, u64), serializeDeltaGuidProviderCounted);
+    base->providerFcts.deserializeDelta = FUNC_ADDR(u8 (*)(ocrGuidProvider_t*, u8*, u64), deserializeDeltaGuidProviderCounted);
     base->providerFcts.reset = FUNC_ADDR(u8 (*)(ocrGuidProvider_t*), resetGuidProviderCounted);
     base->providerFcts.fixup = FUNC_ADDR(u8 (*)(ocrGuidProvider_t*), fixupGuidProviderCounted);
 #endif
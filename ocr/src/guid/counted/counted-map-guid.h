@@ -26,6 +26,13 @@
 
 #define GUID_WID_CACHE_SIZE (CACHE_LINE_SZB/sizeof(u64))
 
+#ifdef ENABLE_RESILIENCY
+// Maximum number of bucket ranges checkpoint (de)serialization is split in
+#ifndef GUID_PROVIDER_CHKPT_PARTITIONS
+#define GUID_PROVIDER_CHKPT_PARTITIONS 64
+#endif
+#endif
+
 typedef struct {
     ocrGuidProvider_t base;
     hashtable_t * guidImplTable;
@@ -38,6 +45,20 @@ typedef struct {
 #ifdef ENABLE_RESILIENCY
     u64 objectsCounted;
     u64 objectsSerialized;
+    // Incremented on every checkpoint. Serialized objects are stamped with it
+    // and objects with a null stamp are considered dirty
+    u32 chkptEpoch;
+    // GUIDs released since the last checkpoint, replayed as removals on restart
+    lock_t tombstoneLock;
+    u64 tombstoneCount;
+    u64 tombstoneMax;
+    ocrGuid_t *tombstones;
+    // Bucket-range partitions of the last serialization size pass
+    u32 chkptPartitions;
+    u64 chkptPartitionSize[GUID_PROVIDER_CHKPT_PARTITIONS];
+    // EDT the partitioned passes leave out. Captured before they start since
+    // the partitions may run on other workers than the caller's
+    struct _ocrTask_t *chkptSkipEdt;
 #endif
 } ocrGuidProviderCountedMap_t;
 
@@ -774,6 +774,9 @@ ocrGuidProviderFactory_t *newGuidProviderFactoryLabeled(ocrParamList_t *typeArg,
     base->providerFcts.getSerializationSize = NULL;
     base->providerFcts.serialize = NULL;
     base->providerFcts.deserialize = NULL;
+    base->providerFcts.getDeltaSerializationSize = NULL;
+    base->providerFcts.serializeDelta = NULL;
+    base->providerFcts.deserializeDelta = NULL;
     base->providerFcts.reset = NULL;
     base->providerFcts.fixup = NULL;
 #endif
@@ -0,0 +1,115 @@
+/**
+ * @brief Runtime support for graph capture and replay.
+  **/
+
+/*
+ * This file is subject to the license agreement located in the file LICENSE
+ * and cannot be distributed without it. This notice cannot be
+ * removed or modified.
+ */
+
+#ifndef __OCR_GRAPH_RUNTIME_H__
+#define __OCR_GRAPH_RUNTIME_H__
+
+#ifdef ENABLE_EXTENSION_GRAPH
+
+#include "ocr-types.h"
+#include "ocr-edt.h"
+
+struct _ocrTask_t;
+struct _hashtable;
+
+// References from an operation to a GUID of the graph: a node index,
+// an input index (tagged with GRAPH_REF_INPUT) or one of the special values
+#define GRAPH_REF_INPUT  ((u32)0x80000000)
+#define GRAPH_REF_UNINIT ((u32)-2)
+#define GRAPH_REF_NULL   ((u32)-1)
+
+typedef enum {
+    GRAPH_OP_EVENT,
+    GRAPH_OP_EDT,
+    GRAPH_OP_DEP,
+    GRAPH_OP_NONE, // Dependence folded into the creation of its EDT
+} ocrGraphOpKind_t;
+
+/**
+ * @brief A recorded API call
+ */
+typedef struct {
+    ocrGraphOpKind_t kind;
+    union {
+        struct {
+            u32 node;
+            ocrEventTypes_t type;
+            u16 properties;
+            bool hasParams;
+            ocrEventParams_t params;
+        } event;
+        struct {
+            ocrGuid_t templateGuid;
+            u32 node;
+            u32 paramc, paramOffset;    // Parameters are in the graph's params
+            u32 depc, depvOffset;       // Sources of the slots are in the graph's refs
+            u32 hint;                   // Index in the graph's hints or GRAPH_REF_NULL
+            u16 properties;
+            bool hasOutputEvent;        // Output event is node 'node + 1'
+        } edt;
+        struct {
+            u32 source, destination;
+            u32 slot;
+            ocrDbAccessMode_t mode;
+        } dep;
+    };
+} ocrGraphOp_t;
+
+/**
+ * @brief A recorded sub-graph
+ *
+ * While capturing, each array is allocated separately and grows as
+ * needed. ocrGraphCaptureEnd() compacts them after this structure
+ * in a single allocation.
+ */
+typedef struct _ocrGraph_t {
+    ocrGraphOp_t *ops;
+    ocrHint_t *hints;
+    ocrGuid_t *inputs;
+    u64 *params;
+    u32 *refs;
+    ocrGuid_t *nodes;   // Only while capturing: GUIDs of the nodes
+    struct _hashtable *refMap; // Only while capturing: reference of each GUID of 'nodes' and 'inputs'
+    u32 opCount, hintCount, inputCount, paramCount, refCount, nodeCount;
+    u32 opMax, hintMax, inputMax, paramMax, refMax, nodeMax;
+    u32 edtCount, eventCount, depCount;
+    u32 maxDepc;
+    bool unsupported;   // The captured calls cannot be replayed
+    bool failed;        // The recording could not be allocated
+} ocrGraph_t;
+
+/**
+ * @brief Records the creation of an event by 'task'
+ */
+void graphCaptureEvent(struct _ocrTask_t *task, ocrGuid_t guid, ocrEventTypes_t type,
+                       u16 properties, ocrEventParams_t *params);
+
+/**
+ * @brief Records the creation of an EDT by 'task'
+ *
+ * 'depv' are the dependences added by the creation itself, if any
+ */
+void graphCaptureEdt(struct _ocrTask_t *task, ocrGuid_t guid, ocrGuid_t templateGuid,
+                     u32 paramc, u64 *paramv, u32 depc, ocrGuid_t *depv,
+                     u16 properties, ocrHint_t *hint, ocrGuid_t *outputEvent);
+
+/**
+ * @brief Records a dependence added by 'task'
+ */
+void graphCaptureDep(struct _ocrTask_t *task, ocrGuid_t source, ocrGuid_t destination,
+                     u32 slot, ocrDbAccessMode_t mode);
+
+/**
+ * @brief Discards the capture 'task' did not end
+ */
+void graphCaptureAbort(struct _ocrTask_t *task);
+
+#endif /* ENABLE_EXTENSION_GRAPH */
+#endif /* __OCR_GRAPH_RUNTIME_H__ */
@@ -268,6 +268,8 @@ typedef struct _ocrDataBlock_t {
     u32 flags;              /**< flags for the data-block, lower 16 bits are info
                                  from user, upper 16 bits is for internal bookeeping */
     u32 fctId;              /**< ID determining which functions to use */
+    u32 lastWriter;         /**< ID of the worker that last released the
+                                 data-block after writing to it, (u32)-1 if none */
 #ifdef ENABLE_RESILIENCY
     void* bkPtr;
     ocrGuid_t singleAssigner;
@@ -136,6 +136,22 @@ typedef struct _ocrEventFcts_t {
     u8 (*registerWaiter)(struct _ocrEvent_t *self, ocrFatGuid_t waiter, u32 slot,
                          bool isDepAdd);
 #endif
+
+    /**
+     * @brief Register several waiters on the event as part of adding
+     * dependences
+     *
+     * Equivalent to calling registerWaiter for each waiter with 'isDepAdd'
+     * set, but the waiter list is locked and grown once. May be NULL if
+     * the event type does not support it.
+     *
+     * @param[in] self          Pointer to this event
+     * @param[in] count         Number of waiters
+     * @param[in] waiters       EDTs/Events to register as waiters
+     * @param[in] slots         Slot to satisfy each waiter on
+     * @return 0 on success and a non-zero code on failure
+     */
+    u8 (*registerWaiters)(struct _ocrEvent_t *self, u32 count, ocrFatGuid_t *waiters, u32 *slots);
     /**
      * @brief Unregisters a "waiter" (aka a dependence) on the event
      *
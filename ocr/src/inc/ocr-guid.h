@@ -76,6 +76,19 @@ typedef struct {
 // END TODO
 //
 
+#ifdef ENABLE_RESILIENCY
+/**
+ * @brief Function run on one partition of a parallel pass
+ */
+typedef void (*ocrGuidParallelFct_t)(void * args, u32 partition);
+
+/**
+ * @brief Runs fct on partitions [0, count) and returns once all are done.
+ * Partitions may run concurrently on the workers of the policy domain.
+ */
+typedef void (*ocrGuidParallelFor_t)(struct _ocrPolicyDomain_t * pd, ocrGuidParallelFct_t fct, void * args, u32 count);
+#endif
+
 
 /**
  * @brief GUID provider function pointers
@@ -270,6 +283,9 @@ typedef struct _ocrGuidProviderFcts_t {
     /**
      * @brief Get the serialization size
      *
+     * This and the other (de)serialization functions below may split their
+     * work in partitions run through the provider's parallelFor runner.
+     *
      * @param[in] self        Pointer to this GUID provider
      * @param[out] size       Buffer size required to serialize GUID provider metadata
      * @return 0 on success and a non-zero code on failure
@@ -294,6 +310,40 @@ typedef struct _ocrGuidProviderFcts_t {
      */
     u8 (*deserialize)(struct _ocrGuidProvider_t *self, u8 * buffer);
 
+    /**
+     * @brief Get the serialization size of an incremental checkpoint
+     *
+     * Only metadata created or modified since the last call to serialize
+     * or serializeDelta is accounted for.
+     *
+     * @param[in] self        Pointer to this GUID provider
+     * @param[out] size       Buffer size required to serialize the delta
+     * @return 0 on success and a non-zero code on failure
+     */
+    u8 (*getDeltaSerializationSize)(struct _ocrGuidProvider_t *self, u64 * size);
+
+    /**
+     * @brief Serialize GUID provider metadata modified since the last
+     * checkpoint into buffer
+     *
+     * @param[in] self        Pointer to this GUID provider
+     * @param[in/out] buffer  Buffer to serialize into
+     * @param[in] phase       Checkpoint phase the delta belongs to
+     * @return 0 on success and a non-zero code on failure
+     */
+    u8 (*serializeDelta)(struct _ocrGuidProvider_t *self, u8 * buffer, u64 phase);
+
+    /**
+     * @brief Replay a delta on top of previously deserialized state
+     *
+     * @param[in] self        Pointer to this GUID provider
+     * @param[in] buffer      Buffer to deserialize from
+     * @param[in] maxPhase    Last checkpoint phase the replay should include
+     * @return 0 on success, OCR_EINVAL if buffer does not hold a valid
+     * delta belonging to a phase up to maxPhase
+     */
+    u8 (*deserializeDelta)(struct _ocrGuidProvider_t *self, u8 * buffer, u64 maxPhase);
+
     /**
      * @brief Reset GUID provider user program state by clearing
      * all user program metadata
@@ -327,6 +377,9 @@ typedef struct _ocrGuidProvider_t {
     struct _ocrPolicyDomain_t *pd;  /**< Policy domain of this GUID provider */
     u32 id;                         /**< Function IDs for this GUID provider */
     ocrGuidProviderFcts_t fcts;     /**< Functions for this instance */
+#ifdef ENABLE_RESILIENCY
+    ocrGuidParallelFor_t parallelFor; /**< Runner for the (de)serialization passes (NULL: sequential) */
+#endif
 } ocrGuidProvider_t;
 
 
@@ -30,6 +30,8 @@ typedef enum _perfEvents {
     PERF_L1_HITS,             // Total hits to the cache (varies by architecture)
     PERF_L1_MISSES,           // Total hits to the memory (varies by architecture)
     PERF_FLOAT_OPS,           // Total arithmetic floating point ops
+    PERF_INSTRUCTIONS,        // Total instructions retired
+    PERF_STALLED_CYCLES,      // Cycles stalled waiting on the memory subsystem
     PERF_HW_MAX,
     /* Software events below */
     PERF_EDT_CREATES = PERF_HW_MAX,  // No. of EDTs created by this EDT
@@ -37,6 +39,7 @@ typedef enum _perfEvents {
     PERF_DB_CREATES,                 // Total size of all DBs created by this EDT
     PERF_DB_DESTROYS,                // Total size of all DBs destroyed by this EDT
     PERF_EVT_SATISFIES,              // Total no. of events satisfied by this EDT
+    PERF_EDT_SUCCESSORS,             // No. of EDTs made runnable by this EDT
     PERF_MAX
 } perfEvents;
 
@@ -48,13 +51,67 @@ typedef enum _perfEvents {
 #define STEADY_STATE_SHIFT  4         // Absolute difference is < 6.25% (1/1<<4)
 #endif
 
+#ifndef PERF_BOTTOM_LEVEL_DISCOUNT_SHIFT
+#define PERF_BOTTOM_LEVEL_DISCOUNT_SHIFT 3  // The successors' bottom level loses 1/(1<<3) per hop so
+#endif                                      // that EDT functions that (transitively) follow themselves
+                                            // converge to a finite estimate
+
+#ifndef PERF_DB_NAME_SIZE
+#define PERF_DB_NAME_SIZE   64        // Maximum length of the symbol naming an EDT (including '\0')
+#endif
+
 typedef struct _ocrPerfCounters {
     void *edt;                        // EDT identified by its function pointer
     ocrPerfStat_t stats[PERF_MAX];    // Performance statistics for each counter
     u32 count;                        // No of samples
     u32 steadyStateMask;              // Mask indicating which counters haven't reached 'steady state'
+    u64 bottomLevel;                  // Estimated remaining critical path (cycles), this EDT included
+    char name[PERF_DB_NAME_SIZE];     // Symbol of the EDT, used to persist the statistics
 } ocrPerfCounters_t;
 
+/**
+ * @brief Adds a sample to a counter's statistics
+ *
+ * Keeps a running mean (var_m) and sum of squared deviations (var_s)
+ * using Welford's method; 'average' is the integral part of the mean.
+ *
+ * @param stat      Statistics to update
+ * @param value     New sample
+ * @param count     Number of samples, including this one
+ */
+static inline void perfStatUpdate(ocrPerfStat_t *stat, u64 value, u32 count) {
+    double delta = (double)value - stat->var.var_m;
+    stat->var.var_m += delta / (double)count;
+    stat->var.var_s += delta * ((double)value - stat->var.var_m);
+    stat->average = (u64)stat->var.var_m;
+    stat->current = value;
+}
+
+/**
+ * @brief Returns the sample variance of a counter
+ */
+static inline double perfStatVariance(ocrPerfStat_t *stat, u32 count) {
+    return (count > 1) ? (stat->var.var_s / (double)(count - 1)) : 0.0;
+}
+
+/**
+ * @brief Folds one execution into an EDT's bottom level estimate
+ *
+ * The bottom level of an EDT is its average duration plus the (discounted)
+ * largest bottom level among the EDTs it made runnable. When cycles are not
+ * measured every EDT weighs 1 and the estimate degenerates to a depth.
+ * Updates are racy, we sacrifice accuracy for performance.
+ *
+ * @param ctrs             Statistics of the EDT function
+ * @param succBottomLevel  Largest bottom level among the successors of this execution
+ */
+static inline void perfBottomLevelUpdate(ocrPerfCounters_t *ctrs, u64 succBottomLevel) {
+    u64 cycles = ctrs->stats[PERF_HW_CYCLES].average;
+    u64 bottomLevel = ((cycles == 0) ? 1 : cycles) + succBottomLevel
+                      - (succBottomLevel >> PERF_BOTTOM_LEVEL_DISCOUNT_SHIFT);
+    ctrs->bottomLevel = (ctrs->bottomLevel == 0) ? bottomLevel : ((ctrs->bottomLevel + bottomLevel + 1) >> 1);
+}
+
 
 #endif /* __OCR_PERFSTAT_H__ */
 
@@ -243,6 +243,10 @@ typedef struct _paramListPolicyDomainInst_t {
 /**< Removes a potential dynamic dependence */
 #define PD_MSG_DEP_DYNREMOVE    0x00088080
 
+/**< Add several dependences at once. Equivalent to a PD_MSG_DEP_ADD per
+ * dependence but registrations on the same object are done together */
+#define PD_MSG_DEP_ADD_BULK     0x00049080
+
 /**< AND with this and if result non-null, low-level OS operation */
 #define PD_MSG_SAL_OP           0x100
 /**< Print operation */
@@ -1080,6 +1084,20 @@ typedef struct _ocrPolicyMsg_t {
             } inOrOut __attribute__ (( aligned(8) ));
         } PD_MSG_STRUCT_NAME(PD_MSG_DEP_DYNREMOVE);
 
+        struct {
+            union {
+                struct {
+                    ocrFatGuid_t currentEdt; /**< In: EDT that is adding the deps */
+                    ocrDependence_t *deps;   /**< In: Dependences to add (not copied) */
+                    u32 count;               /**< In: Number of dependences in deps */
+                    u32 properties;          /**< In: Properties */
+                } in;
+                struct {
+                    u32 returnDetail;        /**< Out: Success or error code of the first failure */
+                } out;
+            } inOrOut __attribute__ (( aligned(8) ));
+        } PD_MSG_STRUCT_NAME(PD_MSG_DEP_ADD_BULK);
+
         struct {
             union {
                 struct {
@@ -1562,7 +1580,7 @@ typedef struct _ocrPolicyDomain_t {
 
     struct _pdStrandTable_t* strandTables[2];
 
-    Queue_t* taskPerfs;                        /**< Table maintaining performance statistics of each EDT */
+    struct _ocrPerfDb_t* taskPerfs;            /**< Database of the performance statistics of each EDT */
 
     /**
      * @brief Two dimensional array:
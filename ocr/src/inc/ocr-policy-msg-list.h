@@ -53,6 +53,7 @@ PER_TYPE(PD_MSG_DEP_UNREGSIGNALER)
 PER_TYPE(PD_MSG_DEP_UNREGWAITER)
 PER_TYPE(PD_MSG_DEP_DYNADD)
 PER_TYPE(PD_MSG_DEP_DYNREMOVE)
+PER_TYPE(PD_MSG_DEP_ADD_BULK)
 
 PER_TYPE(PD_MSG_SAL_PRINT)
 PER_TYPE(PD_MSG_SAL_READ)
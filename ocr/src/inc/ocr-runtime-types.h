@@ -100,6 +100,7 @@ typedef struct _ocrObject_t {
     u32 fctId;              /**< Factory ID for this object */
 #ifdef ENABLE_RESILIENCY
     ocrGuidKind kind;
+    u32 epoch;              /**< Checkpoint epoch this object was last serialized in (0 if dirty) */
     u64 size;
 #endif
 } ocrObject_t;
@@ -108,6 +109,20 @@ typedef struct _ocrObject_t {
 
 #define setObjectField(self, name, value) (((ocrObject_t *)(self))->name = value)
 
+/**
+ * @brief Flag an object as modified since the last checkpoint
+ *
+ * Incremental checkpoints only serialize objects that have been
+ * created or modified since the previous checkpoint epoch. Any
+ * implementation mutating the serialized state of an object must
+ * mark it dirty.
+ */
+#ifdef ENABLE_RESILIENCY
+#define OCR_OBJECT_MARK_DIRTY(self) (((ocrObject_t *)(self))->epoch = 0)
+#else
+#define OCR_OBJECT_MARK_DIRTY(self)
+#endif
+
 /**
  * @brief Functions common to all objects
  */
@@ -366,6 +381,7 @@ typedef enum {
  * @brief Event Runtime Properties
  */
 #define EVT_RT_PROP_RESILIENT_LATCH 0x10000
+#define EVT_RT_PROP_FINISH_LATCH    0x20000
 
 /**
  * @brief Type of pop from workpiles.
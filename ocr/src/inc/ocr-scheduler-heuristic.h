@@ -250,6 +250,8 @@ typedef struct _ocrSchedulerHeuristic_t {
     ocrCostTable_t *costTable;                              /*< TBD: Placeholder for a cost table */
     ocrSchedulerHeuristicFcts_t fcts;                       /*< Functions called by the scheduler */
     bool isMaster;                                          /*< The master heuristic is used by the scheduler as default */
+    bool notifyBatch;                                       /*< Handles OCR_SCHED_NOTIFY_EDTS_READY */
+    bool notifyInline;                                      /*< Workers may run a single successor without notifying it */
     u32 factoryId;
 } ocrSchedulerHeuristic_t;
 
@@ -43,6 +43,8 @@ struct _ocrPolicyMsg_t;
 #define SCHEDULER_OBJECT_INSERT_POSITION_HEAD               0x101   // Insert position is head(begin) of the scheduler object
 #define SCHEDULER_OBJECT_INSERT_POSITION_TAIL               0x201   // Insert position is tail(end) of the scheduler object
 #define SCHEDULER_OBJECT_INSERT_POSITION_ITERATOR           0x301   // Insert position is as pointed by the iterator
+#define SCHEDULER_OBJECT_INSERT_BATCH                       0x1001  // Element points to an array of singleton elements inserted at once
+                                                                    // - [in] iterator->data points to the u32 element count
 
 // Remove
 #define SCHEDULER_OBJECT_REMOVE_HEAD                        0x12    // Remove element from the head(begin) of the scheduler object
@@ -126,6 +128,7 @@ typedef enum {
     OCR_SCHEDULER_OBJECT_WST                               =0x520,
     OCR_SCHEDULER_OBJECT_PR_WSH                            =0x620,
     OCR_SCHEDULER_OBJECT_BIN_HEAP                          =0x720,
+    OCR_SCHEDULER_OBJECT_PR_MQ                             =0x820,
 
     //specialized schedulerObjects:
     //    These schedulerObjects can hold other schedulerObjects, both singleton and aggregate.
@@ -21,6 +21,23 @@ struct _ocrPolicyDomain_t;
 #define OCR_SCHED_ARG_NAME(name) _arg_##name
 #define OCR_SCHED_ARG_FIELD(type) data.OCR_SCHED_ARG_NAME(type)
 
+// Maximum number of EDTs a worker accumulates before handing
+// them to the scheduler in one OCR_SCHED_NOTIFY_EDTS_READY
+#ifndef SCHED_READY_BATCH_MAX
+#define SCHED_READY_BATCH_MAX 32
+#endif
+
+// Maximum number of EDTs a worker runs in a row from its inline slot
+// before going back to the scheduler (0 never bypasses the scheduler)
+#ifndef SCHED_INLINE_SUCCESSOR_DEPTH_MAX
+#define SCHED_INLINE_SUCCESSOR_DEPTH_MAX 16
+#endif
+#ifdef ENABLE_RESILIENCY
+// Inline successors would bypass the checkpoint and restart checks of GET_WORK
+#undef SCHED_INLINE_SUCCESSOR_DEPTH_MAX
+#define SCHED_INLINE_SUCCESSOR_DEPTH_MAX 0
+#endif
+
 /****************************************************/
 /* PARAMETER LISTS                                  */
 /****************************************************/
@@ -101,6 +118,7 @@ typedef enum {
     OCR_SCHED_NOTIFY_EDT_CREATE,                    /* BUG #920 Cleanup - Notify scheduler that an EDT is created */
     OCR_SCHED_NOTIFY_EDT_SATISFIED,                 /* Notify scheduler that an EDT is fully satisfied */
     OCR_SCHED_NOTIFY_EDT_READY,                     /* Notify scheduler that an EDT is ready to execute */
+    OCR_SCHED_NOTIFY_EDTS_READY,                    /* Notify scheduler that a batch of local EDTs is ready to execute */
     OCR_SCHED_NOTIFY_EDT_DONE,                      /* BUG #920 Cleanup - Notify scheduler that an EDT is done executing */
     OCR_SCHED_NOTIFY_COMM_READY,                    /* Notify scheduler that a communication task is ready to execute */
 } ocrSchedNotifyKind;
@@ -136,6 +154,10 @@ typedef union _ocrSchedNotifyData_t {
     struct {
         ocrFatGuid_t guid;                          /* Scheduler is notified about this edt guid */
     } OCR_SCHED_ARG_NAME(OCR_SCHED_NOTIFY_EDT_READY);
+    struct {
+        ocrFatGuid_t *guids;                        /* Scheduler is notified about these edt guids (metaDataPtr always set) */
+        u32 count;                                  /* Number of guids, at most SCHED_READY_BATCH_MAX */
+    } OCR_SCHED_ARG_NAME(OCR_SCHED_NOTIFY_EDTS_READY);
     struct {
         ocrFatGuid_t guid;                          /* Scheduler is notified about this edt guid */
     } OCR_SCHED_ARG_NAME(OCR_SCHED_NOTIFY_EDT_DONE);
@@ -446,4 +468,80 @@ typedef struct _ocrSchedulerFactory_t {
 
 void initializeSchedulerOcr(ocrSchedulerFactory_t * factory, ocrScheduler_t * self, ocrParamList_t *perInstance);
 
+/****************************************************/
+/* READY EDTS BATCHING                              */
+/****************************************************/
+
+struct _ocrWorker_t;
+
+/**
+ * @brief Opens a scope in which the EDTs the worker makes ready are
+ * accumulated instead of being given to the scheduler one at a time.
+ *
+ * Scopes nest; the EDTs are handed over when the outermost scope closes
+ * or when the batch is full. Nothing is batched if the scheduler's master
+ * heuristic does not handle OCR_SCHED_NOTIFY_EDTS_READY.
+ *
+ * @return true if a scope was opened, in which case the caller must
+ * close it with schedulerReadyBatchEnd
+ */
+bool schedulerReadyBatchBegin(struct _ocrPolicyDomain_t *pd, struct _ocrWorker_t *worker);
+
+/**
+ * @brief Adds a ready EDT to the worker's open batch
+ *
+ * @return true if the EDT was batched, false if no scope is open and the
+ * caller must notify the scheduler itself
+ */
+bool schedulerReadyBatchAdd(struct _ocrPolicyDomain_t *pd, struct _ocrWorker_t *worker, ocrFatGuid_t edt);
+
+/**
+ * @brief Gives the EDTs batched so far to the scheduler, the scope stays open
+ */
+u8 schedulerReadyBatchFlush(struct _ocrPolicyDomain_t *pd, struct _ocrWorker_t *worker);
+
+/**
+ * @brief Closes a scope opened by schedulerReadyBatchBegin
+ */
+u8 schedulerReadyBatchEnd(struct _ocrPolicyDomain_t *pd, struct _ocrWorker_t *worker);
+
+/****************************************************/
+/* INLINE SUCCESSOR                                 */
+/****************************************************/
+
+/**
+ * @brief Opens the window, around a task epilogue, in which the single
+ * EDT the epilogue makes ready is kept in the worker's inline slot
+ *
+ * The worker then runs it next without a scheduler round trip. Nothing
+ * is kept if the scheduler's master heuristic does not set notifyInline
+ * or if the worker has no inline depth.
+ *
+ * @return true if the window was opened, in which case the caller must
+ * close it with schedulerInlineSuccessorEnd
+ */
+bool schedulerInlineSuccessorBegin(struct _ocrPolicyDomain_t *pd, struct _ocrWorker_t *worker);
+
+/**
+ * @brief Offers a ready EDT to the worker's inline slot
+ *
+ * A second ready EDT closes the window: the one already kept goes to the
+ * scheduler (or the open ready batch) and so does the new one.
+ *
+ * @return true if the EDT was kept, false if the caller must give it to
+ * the scheduler itself
+ */
+bool schedulerInlineSuccessorAdd(struct _ocrPolicyDomain_t *pd, struct _ocrWorker_t *worker, ocrFatGuid_t edt);
+
+/**
+ * @brief Closes a window opened by schedulerInlineSuccessorBegin
+ */
+void schedulerInlineSuccessorEnd(struct _ocrPolicyDomain_t *pd, struct _ocrWorker_t *worker);
+
+/**
+ * @brief Hands the EDT kept in the worker's inline slot, if any, to the
+ * scheduler (or the open ready batch) and empties the slot
+ */
+void schedulerInlineSuccessorRelease(struct _ocrPolicyDomain_t *pd, struct _ocrWorker_t *worker);
+
 #endif /* __OCR_SCHEDULER_H__ */
@@ -256,6 +256,25 @@ typedef struct _ocrTaskFcts_t {
     u8 (*registerSignaler)(struct _ocrTask_t* self, ocrFatGuid_t src, u32 slot,
                            ocrDbAccessMode_t mode, bool isDepAdd);
 
+    /**
+     * @brief Informs the task that the events 'srcs' are linked to
+     * its input slots 'slots'
+     *
+     * Equivalent to calling registerSignaler on each event as part of
+     * adding a dependence, but the task's state is updated once for
+     * all of them. The signalers must be persistent events. May be NULL
+     * if the task implementation does not support it.
+     *
+     * @param[in] self        Pointer to this task
+     * @param[in] count       Number of signalers
+     * @param[in] srcs        GUIDs of the signalers
+     * @param[in] slots       Slot on self each signaler is linked to
+     * @param[in] modes       The access mode for each dependence's data
+     * @return 0 on success and a non-zero value on failure
+     */
+    u8 (*registerSignalers)(struct _ocrTask_t* self, u32 count, ocrFatGuid_t *srcs, u32 *slots,
+                            ocrDbAccessMode_t *modes);
+
     /**
      * @brief Informs the task that the event/db 'src' is no longer linked
      * to it on 'slot'
@@ -447,6 +466,10 @@ typedef struct _ocrTask_t {
 #ifdef ENABLE_EXTENSION_PERF
     ocrPerfCounters_t *taskPerfsEntry;
     u32 swPerfCtrs[PERF_MAX-PERF_HW_MAX];
+    u64 succBottomLevel;    /**< Largest bottom level of the EDTs this task made runnable */
+#endif
+#ifdef ENABLE_EXTENSION_GRAPH
+    struct _ocrGraph_t *graphCapture; /**< Graph this task is recording, if any */
 #endif
 #ifdef ENABLE_AMT_RESILIENCE
     ocrGuid_t resilientLatch;       /**< Latch event of enclosing resilient finish latch scope */
@@ -13,6 +13,7 @@
 #include "ocr-scheduler.h"
 #include "ocr-types.h"
 #include "ocr-hal.h"
+#include "utils/rt-counters.h"
 #ifdef ENABLE_AMT_RESILIENCE
 #include <setjmp.h>
 #endif
@@ -110,6 +111,7 @@ typedef struct _ocrWorker_t {
     ocrWorkerType_t type;
     u8 amBlessed; // BUG #583: Clean-up runlevels; maybe merge in type?
     u64 id; //Worker id as indicated in runtime config
+    u32 numaDomain; //NUMA domain the worker runs in; also the index of its DB allocator in the PD
     // Workers are capable modules so
     // part of their runlevel processing happens asynchronously
     // This provides a convenient location to save
@@ -148,6 +150,14 @@ typedef struct _ocrWorker_t {
     ocrLocation_t waitloc;
     int blockedContexts;
 #endif
+    rtCounters_t counters;      /**< Always-on counters, written by this worker only */
+    u32 readyBatchDepth;        /**< Nesting of open ready EDTs batching scopes (0 if none) */
+    u32 readyBatchCount;        /**< Number of EDTs in readyBatch */
+    ocrFatGuid_t readyBatch[SCHED_READY_BATCH_MAX]; /**< EDTs made ready but not yet given to the scheduler */
+    u32 inlineDepthMax;         /**< EDTs run in a row from inlineNext before going back to the scheduler (0 disables) */
+    u32 inlineDepth;            /**< EDTs run in a row from inlineNext so far */
+    bool inlineCapture;         /**< A task epilogue is offering the EDTs it makes ready to inlineNext */
+    ocrFatGuid_t inlineNext;    /**< Single successor to run next, bypassing the scheduler (NULL_GUID if none) */
 } ocrWorker_t;
 
 
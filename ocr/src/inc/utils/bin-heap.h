@@ -13,7 +13,7 @@
 #include "ocr-policy-domain.h"
 
 #ifndef INIT_BIN_HEAP_CAPACITY
-// Set by configure
+// Set by configure. Heaps double their capacity when full.
 #   ifdef INIT_DEQUE_CAPACITY
 #   define INIT_BIN_HEAP_CAPACITY (INIT_DEQUE_CAPACITY*16)
 #   else
@@ -55,6 +55,7 @@ typedef struct _ocrBinHeap_t {
     /* The fields don't need to be volatile because we only
        have non-concurrent and locking implementations. */
     u32 count;
+    u32 capacity;
     ocrBinHeapEntry_t *data;
 
     /** @brief Destruct binHeap
@@ -65,6 +66,10 @@ typedef struct _ocrBinHeap_t {
      */
     void (*push)(struct _ocrBinHeap_t *self, void *entry, s64 priority, u8 doTry);
 
+    /** @brief Push 'count' elements at once
+     */
+    void (*pushBatch)(struct _ocrBinHeap_t *self, ocrBinHeapEntry_t *entries, u32 count, u8 doTry);
+
     /** @brief Pop element
      */
     void *(*pop)(struct _ocrBinHeap_t *self, u8 doTry);
@@ -86,6 +91,7 @@ typedef struct _ocrBinHeapLocked_t {
 /****************************************************/
 
 binHeap_t *newBinHeap(ocrPolicyDomain_t *pd, ocrBinHeapType_t type);
+binHeap_t *newBinHeapWithCapacity(ocrPolicyDomain_t *pd, ocrBinHeapType_t type, u32 capacity);
 
 #endif /* BIN_HEAP_H_ */
 
@@ -0,0 +1,150 @@
+/*
+ * This file is subject to the license agreement located in the file LICENSE
+ * and cannot be distributed without it. This notice cannot be
+ * removed or modified.
+ */
+
+#ifndef CHUNK_CODEC_H_
+#define CHUNK_CODEC_H_
+
+#include "ocr-config.h"
+#include "ocr-types.h"
+
+/****************************************************/
+/* CHUNKED CODEC STREAMS                            */
+/****************************************************/
+
+/* A codec stream stores a buffer as independently encoded chunks so that
+ * chunks can be encoded and decoded in parallel and corruption is detected
+ * per chunk:
+ *
+ *   [ocrCodecHeader_t][ocrCodecChunk_t x chunkCount][chunk data (8B aligned)]
+ *
+ * Each chunk records a CRC32 of its stored bytes and of its decoded bytes.
+ * A chunk that does not shrink when encoded is stored raw.
+ */
+
+#ifndef CODEC_CHUNK_SIZE
+#define CODEC_CHUNK_SIZE    (256*1024) /* Bytes of raw data per chunk */
+#endif
+
+#define CODEC_MAGIC         0x4d41455254534b43ULL
+#define CODEC_CHUNK_RAW     0x1 /* Chunk is stored without encoding */
+
+/**
+ * @brief Codecs a stream can be encoded with
+ */
+typedef enum {
+    CODEC_NONE          = 0x0, /* Chunks are stored raw (CRCs only) */
+    CODEC_ZRLE          = 0x1, /* Zero-run elision */
+    CODEC_MAX           = 0x2
+} ocrCodecKind_t;
+
+/* Configuration names of the codecs, indexed by ocrCodecKind_t */
+extern const char * codec_types[];
+
+typedef struct {
+    u64 magic;
+    u32 codec;          /**< ocrCodecKind_t */
+    u32 chunkCount;
+    u64 chunkSize;      /**< Raw bytes per chunk (the last one may be shorter) */
+    u64 rawSize;        /**< Size of the decoded buffer */
+    u64 encodedSize;    /**< Size of the whole stream, header included */
+} ocrCodecHeader_t;
+
+typedef struct {
+    u64 offset;         /**< Offset of the chunk data from the start of the stream */
+    u32 size;           /**< Stored size of the chunk */
+    u32 flags;          /**< CODEC_CHUNK_* */
+    u32 crc;            /**< CRC32 of the stored bytes */
+    u32 rawCrc;         /**< CRC32 of the decoded bytes */
+} ocrCodecChunk_t;
+
+#define CODEC_CHUNK_TABLE(stream) ((ocrCodecChunk_t*)(((u8*)(stream)) + sizeof(ocrCodecHeader_t)))
+
+/**
+ * @brief Update a CRC32 (IEEE 802.3) with a buffer
+ */
+u32 codecCrc32(u32 crc, const u8 *buf, u64 size);
+
+/**
+ * @brief Number of chunks a buffer of rawSize bytes is split into
+ */
+u32 codecChunkCount(u64 rawSize, u64 chunkSize);
+
+/**
+ * @brief Size of the header and chunk table of a stream
+ */
+u64 codecHeaderSize(u32 chunkCount);
+
+/**
+ * @brief Upper bound of the size of a stream encoding rawSize bytes
+ */
+u64 codecMaxEncodedSize(u64 rawSize, u64 chunkSize);
+
+/**
+ * @brief Returns true if the buffer starts with a codec stream header
+ */
+bool codecIsStream(const u8 *buf);
+
+/**
+ * @brief Initialize the header of a stream
+ *
+ * The chunk table is filled by codecEncodeChunk() and the chunk offsets
+ * and total size by codecLayoutStream().
+ */
+void codecInitStream(u8 *stream, ocrCodecKind_t codec, u64 rawSize, u64 chunkSize);
+
+/**
+ * @brief Encode one chunk of a buffer
+ *
+ * The chunk is written to dst, which must hold at least the raw size of the
+ * chunk, and described in the chunk table of the stream. Chunks are
+ * independent and may be encoded concurrently.
+ *
+ * @return the stored size of the chunk
+ */
+u64 codecEncodeChunk(u8 *stream, const u8 *src, u32 chunk, u8 *dst);
+
+/**
+ * @brief Assign the chunk offsets of an encoded stream (prefix sum)
+ *
+ * @return the total size of the stream
+ */
+u64 codecLayoutStream(u8 *stream);
+
+/**
+ * @brief Check the header and chunk table of a stream
+ *
+ * @param[in] size     Bytes available at stream
+ * @return 0 on success, OCR_EINVAL if the stream is malformed
+ */
+u8 codecValidateStream(const u8 *stream, u64 size);
+
+/**
+ * @brief Decode and verify one chunk of a validated stream into dst
+ *
+ * dst points to the start of the decoded buffer. Chunks are independent
+ * and may be decoded concurrently.
+ *
+ * @return 0 on success, OCR_EINVAL on a CRC mismatch or malformed chunk
+ */
+u8 codecDecodeChunk(const u8 *stream, u32 chunk, u8 *dst);
+
+/**
+ * @brief Encode a buffer sequentially
+ *
+ * @param[out] stream  Must hold codecMaxEncodedSize() bytes
+ * @return the size of the stream
+ */
+u64 codecEncode(ocrCodecKind_t codec, const u8 *src, u64 rawSize, u8 *stream);
+
+/**
+ * @brief Validate and decode a stream sequentially
+ *
+ * @param[out] dst     Must hold the rawSize of the stream
+ * @return 0 on success, OCR_EINVAL if the stream is malformed or corrupted
+ */
+u8 codecDecode(const u8 *stream, u64 size, u8 *dst);
+
+#endif /* CHUNK_CODEC_H_ */
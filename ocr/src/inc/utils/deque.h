@@ -67,6 +67,11 @@ typedef struct _ocrDeque_t {
      */
     void (*pushAtTail)(struct _ocrDeque_t *self, void* entry, u8 doTry);
 
+    /** @brief Push 'count' elements at tail, in order, publishing them at once
+     *  (NULL if the implementation does not support it)
+     */
+    void (*pushBatchAtTail)(struct _ocrDeque_t *self, void** entries, u32 count, u8 doTry);
+
     /** @brief Pop element from tail
      */
     void* (*popFromTail)(struct _ocrDeque_t *self, u8 doTry);
@@ -39,7 +39,9 @@ typedef void (*hashtableIterateFct)(void * key, void * value, void * args);
 
 typedef struct _hashtable {
     ocrPolicyDomain_t * pd;
+    /** @brief current number of buckets (bucket locked tables grow with their load). */
     u32 nbBuckets;
+    /** @brief bucket heads, NULL for bucket locked tables which manage their own buckets. */
     struct _ocr_hashtable_entry_struct ** table;
     /** @brief hashing function to determine bucket. */
     hashFct hashing;
@@ -64,6 +66,7 @@ bool hashtableConcBucketLockedRemove(hashtable_t * hashtable, void * key, void *
 hashtable_t * newHashtable(ocrPolicyDomain_t * pd, u32 nbBuckets, hashFct hashing);
 void destructHashtable(hashtable_t * hashtable, deallocFct entryDeallocator, void * deallocatorParam);
 void iterateHashtable(hashtable_t * hashtable, hashtableIterateFct iterate, void * args);
+void iterateHashtableRange(hashtable_t * hashtable, u32 firstBucket, u32 lastBucket, hashtableIterateFct iterate, void * args);
 
 hashtable_t * newHashtableBucketLocked(ocrPolicyDomain_t * pd, u32 nbBuckets, hashFct hashing);
 void destructHashtableBucketLocked(hashtable_t * hashtable, deallocFct entryDeallocator, void * deallocatorParam);
@@ -0,0 +1,97 @@
+/*
+ * This file is subject to the license agreement located in the file LICENSE
+ * and cannot be distributed without it. This notice cannot be
+ * removed or modified.
+ */
+
+#ifndef PERF_DB_H_
+#define PERF_DB_H_
+
+#include "ocr-config.h"
+
+#ifdef ENABLE_EXTENSION_PERF
+
+#include "ocr-types.h"
+#include "ocr-perfmon.h"
+#include "utils/hashtable.h"
+
+/****************************************************/
+/* PER-EDT PERFORMANCE DATABASE                     */
+/****************************************************/
+
+/* The database holds one ocrPerfCounters_t per EDT function, looked up
+ * by function pointer in constant time. On platforms with a file system,
+ * when a database file is configured (PERF_DB_FILE or the OCR_PERF_DB
+ * environment variable), the statistics are saved at shutdown, keyed by
+ * the EDT's symbol name, and used to warm-start the entries of the next run:
+ *
+ *   [ocrPerfDbHeader_t][ocrPerfDbRecord_t x recordCount]
+ *
+ * Records of the file that were not used by a run are saved again so
+ * that runs of different programs can share a database.
+ */
+
+#ifndef PERF_DB_BUCKETS
+#define PERF_DB_BUCKETS     64  /* Initial number of buckets (the table grows) */
+#endif
+
+#ifndef PERF_DB_FILE
+#define PERF_DB_FILE        "" /* No database file; overridden by the OCR_PERF_DB environment variable */
+#endif
+
+#define PERF_DB_MAGIC       0x4244465052434fULL
+#define PERF_DB_VERSION     2
+
+typedef struct {
+    u64 magic;
+    u32 version;
+    u32 counterCount;   /**< PERF_MAX of the runtime that wrote the file */
+    u64 recordCount;
+} ocrPerfDbHeader_t;
+
+typedef struct {
+    char name[PERF_DB_NAME_SIZE];
+    u32 count;              /**< Number of samples */
+    u32 steadyStateMask;
+    u64 bottomLevel;
+    struct {
+        double mean;
+        double m2;          /**< Sum of squared deviations from the mean */
+    } stats[PERF_MAX];
+} ocrPerfDbRecord_t;
+
+typedef struct _ocrPerfDb_t {
+    ocrPolicyDomain_t *pd;
+    hashtable_t *entries;           /**< EDT function pointer -> ocrPerfCounters_t */
+    hashtable_t *persisted;         /**< Name hash -> ocrPerfDbRecord_t loaded from the file */
+    ocrPerfDbRecord_t *records;     /**< Records loaded from the file */
+    u8 *claimed;                    /**< Per loaded record, set once an entry was warm-started from it */
+    u64 recordCount;
+} ocrPerfDb_t;
+
+/**
+ * @brief Creates a database and loads the statistics saved by previous runs
+ */
+ocrPerfDb_t *newPerfDb(ocrPolicyDomain_t *pd);
+
+/**
+ * @brief Returns the entry of an EDT function, creating it if needed
+ *
+ * @param db        Database to look into
+ * @param edt       Function pointer of the EDT
+ * @param name      Name of the EDT or NULL to resolve the symbol of 'edt'
+ */
+ocrPerfCounters_t *perfDbGet(ocrPerfDb_t *db, void *edt, const char *name);
+
+/**
+ * @brief Prints the statistics of all the entries
+ */
+void perfDbDump(ocrPerfDb_t *db);
+
+/**
+ * @brief Saves the statistics and destroys the database
+ */
+void destructPerfDb(ocrPerfDb_t *db);
+
+#endif /* ENABLE_EXTENSION_PERF */
+#endif /* PERF_DB_H_ */
@@ -0,0 +1,81 @@
+/*
+ * This file is subject to the license agreement located in the file LICENSE
+ * and cannot be distributed without it. This notice cannot be
+ * removed or modified.
+ */
+
+#ifndef RT_COUNTERS_H_
+#define RT_COUNTERS_H_
+
+#include "ocr-types.h"
+
+/****************************************************/
+/* ALWAYS-ON RUNTIME COUNTERS                       */
+/****************************************************/
+
+/* Each worker owns a block of counters that only it writes to, with
+ * plain (non-atomic) adds. Readers (ocrRuntimeQuery) sum the blocks of
+ * all the workers on demand and may see slightly stale values. The
+ * block is padded to whole cache lines so that workers never write to
+ * a line shared with another worker or with the rest of the worker
+ * structure.
+ */
+
+/* Normally set by the build, but tools outside of it include this header too */
+#ifndef CACHE_LINE_SZB
+#define CACHE_LINE_SZB 64
+#endif
+
+/* Must match ocrRuntimeCounter_t in extensions/ocr-runtime-query.h */
+typedef enum {
+    RT_COUNTER_EDTS_EXECUTED,
+    RT_COUNTER_STEALS_ATTEMPTED,
+    RT_COUNTER_STEALS_SUCCESSFUL,
+    RT_COUNTER_DB_BYTES_LOCAL,      /**< Bytes of DBs acquired for this PD */
+    RT_COUNTER_DB_BYTES_REMOTE,     /**< Bytes of DBs acquired for another PD */
+    RT_COUNTER_ALLOC_BYTES,         /**< DB bytes in use (allocations minus frees, may wrap per worker) */
+    RT_COUNTER_IDLE_NS,             /**< Time spent without work */
+    RT_COUNTER_MAX
+} rtCounterId_t;
+
+/* Messages are counted per category, i.e. per bit of the
+ * PD_MSG_*_OP masks (see ocr-policy-domain.h). Types without any
+ * of these bits are counted as RT_COUNTER_MSG_OTHER */
+#define RT_COUNTER_MSG_OPS      12
+#define RT_COUNTER_MSG_OTHER    RT_COUNTER_MSG_OPS
+#define RT_COUNTER_MSG_KINDS    (RT_COUNTER_MSG_OPS + 1)
+#define RT_COUNTER_MSG_KIND(type) \
+    ((((type) & ((1 << RT_COUNTER_MSG_OPS) - 1)) == 0) ? RT_COUNTER_MSG_OTHER : \
+     ctz32((u32)((type) & ((1 << RT_COUNTER_MSG_OPS) - 1))))
+
+typedef struct {
+    u64 values[RT_COUNTER_MAX];
+    u64 msgSent[RT_COUNTER_MSG_KINDS];
+    u64 msgReceived[RT_COUNTER_MSG_KINDS];
+    u64 idleStart;                  /**< Start of the current idle period, 0 if busy */
+} rtCountersData_t;
+
+typedef struct {
+    u8 padBefore[CACHE_LINE_SZB];
+    rtCountersData_t data;
+    u8 padAfter[CACHE_LINE_SZB - (sizeof(rtCountersData_t) % CACHE_LINE_SZB)];
+} rtCounters_t;
+
+/* Updates of the counters of a given worker */
+#define RT_WORKER_COUNTER_ADD(worker, counter, value) \
+    ((worker)->counters.data.values[(counter)] += (u64)(value))
+
+#define RT_WORKER_MSG_COUNT(worker, dir, type) \
+    ((worker)->counters.data.dir[RT_COUNTER_MSG_KIND(type)]++)
+
+/* Updates of the counters of the calling worker, if any */
+#define RT_COUNTER_ADD(counter, value) do {                             \
+        struct _ocrWorker_t *__rtWorker = NULL;                         \
+        getCurrentEnv(NULL, &__rtWorker, NULL, NULL);                   \
+        if (__rtWorker != NULL)                                         \
+            RT_WORKER_COUNTER_ADD(__rtWorker, counter, value);          \
+    } while(0)
+
+#define RT_COUNTER_SUB(counter, value) RT_COUNTER_ADD(counter, -(s64)(value))
+
+#endif /* RT_COUNTERS_H_ */
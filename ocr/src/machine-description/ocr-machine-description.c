@@ -34,6 +34,7 @@
 #include "ocr-scheduler-object.h"
 
 #include "ocr-sysboot.h"
+#include "utils/chunk-codec.h"
 
 #include <stdio.h>
 #include <string.h>
@@ -193,8 +194,14 @@ s32 get_key_value(dictionary *dict, char *sec, char *field, s32 offset) {
     s32 lo, hi;
     s32 retval;
     static value_type key_value_type = TYPE_UNKNOWN;
+    static char lastkey[MAX_KEY_SZ] = "";
 
     snprintf(key, MAX_KEY_SZ, "%s:%s", sec, field);
+    // A CSV whose values were all consumed leaves the type set; re-detect it for a new key
+    if (strcmp(key, lastkey)) {
+        key_value_type = TYPE_UNKNOWN;
+        snprintf(lastkey, MAX_KEY_SZ, "%s", key);
+    }
     if (key_value_type == TYPE_UNKNOWN) {
         if (INI_IS_CSV(key)) {
             key_value_type = TYPE_CSV;
@@ -653,6 +660,12 @@ s32 populate_inst(ocrParamList_t **inst_param, int inst_param_size, void **insta
 
             snprintf(key, MAX_KEY_SZ, "%s:%s", secname, "size");
             ((paramListMemPlatformInst_t *)inst_param[j])->size = (u64)iniparser_getlonglong(dict, key, 0);
+            // Node the numa_alloc mem-platform takes its memory from
+            ((paramListMemPlatformInst_t *)inst_param[j])->numa_node = 0;
+            if (key_exists(dict, secname, "numa_node")) {
+                value = get_key_value(dict, secname, "numa_node", j-low);
+                ((paramListMemPlatformInst_t *)inst_param[j])->numa_node = (value == -1) ? 0 : value;
+            }
 
 #ifdef ENABLE_MEM_PLATFORM_FSIM
             // Adjust the start and size according to size of ELF binary
@@ -846,6 +859,8 @@ s32 populate_inst(ocrParamList_t **inst_param, int inst_param_size, void **insta
                         INI_GET_STR (key, valuestr, "");
                         if (strcmp(valuestr, "STATIC") == 0) {
                             ((paramListSchedulerObjectWst_t*)inst_param[j])->config = SCHEDULER_OBJECT_WST_CONFIG_STATIC;
+                        } else if (strcmp(valuestr, "LOCKED") == 0) {
+                            ((paramListSchedulerObjectWst_t*)inst_param[j])->config = SCHEDULER_OBJECT_WST_CONFIG_LOCKED;
                         }
                     }
                 }
@@ -890,6 +905,42 @@ s32 populate_inst(ocrParamList_t **inst_param, int inst_param_size, void **insta
                     }
                     break;
                 }
+#endif
+#if defined(ENABLE_SCHEDULER_HEURISTIC_HC)
+                case schedulerHeuristicHc_id: {
+                    ALLOC_PARAM_LIST(inst_param[j], paramListSchedulerHeuristicHc_t);
+                    ((paramListSchedulerHeuristicHc_t*)inst_param[j])->dbAffinity = false;
+                    if(key_exists(dict, secname, "dbaffinity")) {
+                        char *valuestr = NULL;
+                        snprintf(key, MAX_KEY_SZ, "%s:%s", secname, "dbaffinity");
+                        INI_GET_STR(key, valuestr, "no");
+                        if(strcmp(valuestr, "yes") == 0) {
+                            ((paramListSchedulerHeuristicHc_t*)inst_param[j])->dbAffinity = true;
+                        } else {
+                            u32 t = strcmp(valuestr, "no");
+                            ASSERT(t == 0 && "dbaffinity should be 'yes' or 'no'");
+                        }
+                    }
+                    break;
+                }
+#endif
+#if defined(ENABLE_SCHEDULER_HEURISTIC_PRIORITY)
+                case schedulerHeuristicPriority_id: {
+                    ALLOC_PARAM_LIST(inst_param[j], paramListSchedulerHeuristicPriority_t);
+                    ((paramListSchedulerHeuristicPriority_t*)inst_param[j])->criticalPath = false;
+                    if(key_exists(dict, secname, "criticalpath")) {
+                        char *valuestr = NULL;
+                        snprintf(key, MAX_KEY_SZ, "%s:%s", secname, "criticalpath");
+                        INI_GET_STR(key, valuestr, "no");
+                        if(strcmp(valuestr, "yes") == 0) {
+                            ((paramListSchedulerHeuristicPriority_t*)inst_param[j])->criticalPath = true;
+                        } else {
+                            u32 t = strcmp(valuestr, "no");
+                            ASSERT(t == 0 && "criticalpath should be 'yes' or 'no'");
+                        }
+                    }
+                    break;
+                }
 #endif
                 default: {
                     ALLOC_PARAM_LIST(inst_param[j], paramListSchedulerHeuristic_t);
@@ -937,6 +988,12 @@ s32 populate_inst(ocrParamList_t **inst_param, int inst_param_size, void **insta
                     ALLOC_PARAM_LIST(inst_param[j], paramListWorkerHcInst_t);
                     ((paramListWorkerHcInst_t *)inst_param[j])->workerType = workertype;
                     ((paramListWorkerInst_t *)inst_param[j])->workerId = j; // using "id" for now, not a separate key
+                    // NUMA domain of the worker; indexes the PD allocator its DBs come from
+                    ((paramListWorkerHcInst_t *)inst_param[j])->numaDomain = 0;
+                    if (key_exists(dict, secname, "numadomain")) {
+                        value = get_key_value(dict, secname, "numadomain", j-low);
+                        ((paramListWorkerHcInst_t *)inst_param[j])->numaDomain = (value == -1) ? 0 : value;
+                    }
                 }
                 break;
 #endif
@@ -986,6 +1043,7 @@ s32 populate_inst(ocrParamList_t **inst_param, int inst_param_size, void **insta
                     ALLOC_PARAM_LIST(inst_param[j], paramListWorkerHcInst_t);
                     ((paramListWorkerHcInst_t *)inst_param[j])->workerType = workertype;
                     ((paramListWorkerInst_t *)inst_param[j])->workerId = j;
+                    ((paramListWorkerHcInst_t *)inst_param[j])->numaDomain = 0;
                 }
                 break;
 #endif
@@ -1067,6 +1125,10 @@ s32 populate_inst(ocrParamList_t **inst_param, int inst_param_size, void **insta
             TO_ENUM (mytype, inststr, policyDomainType_t, policyDomain_types, policyDomainMax_id);
             switch (mytype) {
 #ifdef ENABLE_POLICY_DOMAIN_HC
+#ifdef ENABLE_POLICY_DOMAIN_HC_DIST
+            // HC-Dist initializes its HC base from the same parameters
+            case policyDomainHcDist_id:
+#endif
             case policyDomainHc_id: {
                 ALLOC_PARAM_LIST(inst_param[j], paramListPolicyDomainHcInst_t);
                 if (key_exists(dict, secname, "rank")) {
@@ -1075,6 +1137,19 @@ s32 populate_inst(ocrParamList_t **inst_param, int inst_param_size, void **insta
                 } else {
                     ((paramListPolicyDomainHcInst_t *)inst_param[j])->rank = (u32)-1;
                 }
+                ((paramListPolicyDomainHcInst_t *)inst_param[j])->codec = PD_HC_CODEC_DISABLED;
+                if (key_exists(dict, secname, "codec")) {
+                    char *valuestr = NULL;
+                    ocrCodecKind_t codec = CODEC_MAX;
+                    snprintf(key, MAX_KEY_SZ, "%s:%s", secname, "codec");
+                    INI_GET_STR (key, valuestr, "");
+                    TO_ENUM (codec, valuestr, ocrCodecKind_t, codec_types, CODEC_MAX);
+                    if (codec == CODEC_MAX) {
+                        DPRINTF(DEBUG_LVL_WARN, "Unknown codec %s, checkpoints and published data-blocks stay uncompressed\n", valuestr);
+                    } else {
+                        ((paramListPolicyDomainHcInst_t *)inst_param[j])->codec = codec;
+                    }
+                }
             }
             break;
 #endif
@@ -38,6 +38,7 @@
 #include "policy-domain/ce/ce-policy.h"
 #include "allocator/allocator-all.h"
 #include "extensions/ocr-hints.h"
+#include "utils/perf-db.h"
 
 #include "xstg-map.h"
 
@@ -799,8 +800,7 @@ u8 cePdSwitchRunlevel(ocrPolicyDomain_t *policy, ocrRunlevel_t runlevel, u32 pro
         if(properties & RL_BRING_UP) {
 
 #ifdef ENABLE_EXTENSION_PERF
-#define MAX_EDT_TEMPLATES 64
-                policy->taskPerfs = newBoundedQueue(policy, MAX_EDT_TEMPLATES);
+                policy->taskPerfs = newPerfDb(policy);
 #endif
 
             phaseCount = RL_GET_PHASE_COUNT_UP(policy, RL_COMPUTE_OK);
@@ -827,17 +827,8 @@ u8 cePdSwitchRunlevel(ocrPolicyDomain_t *policy, ocrRunlevel_t runlevel, u32 pro
         } else {
 
 #ifdef ENABLE_EXTENSION_PERF
-                ocrPerfCounters_t *counters;
-                PRINTF("EDT\tCount\tHW_CYCLES\tL1_HITS\tL1_MISS\tFLOAT_OPS\tEDT_CREATES\tDB_TOTAL\tDB_CREATES\tDB_DESTROYS\tEVT_SATISFIES\tMask\n");
-                while(!queueIsEmpty(policy->taskPerfs)) {
-                    u32 i;
-                    counters = queueRemoveLast(policy->taskPerfs);
-                    PRINTF("%p\t%"PRIu32"\t", counters->edt, counters->count);
-                    for(i = 0; i < PERF_MAX; i++) PRINTF("%"PRId64"\t", counters->stats[i].average);
-                    PRINTF("0x%"PRIx32"\n", counters->steadyStateMask);
-                    policy->fcts.pdFree(policy, counters);
-                }
-                queueDestroy(policy->taskPerfs);
+                perfDbDump(policy->taskPerfs);
+                destructPerfDb(policy->taskPerfs);
 #endif
             // Tear down
             phaseCount = RL_GET_PHASE_COUNT_DOWN(policy, RL_COMPUTE_OK);
@@ -384,6 +384,7 @@ static ProxyDb_t * createProxyDb(ocrPolicyDomain_t * pd) {
 #ifdef ENABLE_RESILIENCY
     proxyDb->base.kind = OCR_GUID_DB_PROXY;
     proxyDb->base.size = sizeof(ProxyDb_t);
+    proxyDb->base.epoch = 0;
 #endif
     proxyDb->state = PROXY_DB_CREATED;
     proxyDb->nbUsers = 0;
@@ -1197,6 +1198,7 @@ u8 hcDistProcessMessage(ocrPolicyDomain_t *self, ocrPolicyMsg_t *msg, u8 isBlock
 #ifdef ENABLE_RESILIENCY
                 tpl->base.base.kind = OCR_GUID_EDT_TEMPLATE;
                 tpl->base.base.size = metaDataSize;
+                tpl->base.base.epoch = 0;
 #endif
 
 #ifdef ENABLE_EXTENSION_PERF
@@ -1763,6 +1765,7 @@ u8 hcDistProcessMessage(ocrPolicyDomain_t *self, ocrPolicyMsg_t *msg, u8 isBlock
     }
     // filter out local messages
     case PD_MSG_DEP_ADD:
+    case PD_MSG_DEP_ADD_BULK:
     case PD_MSG_MEM_OP:
     case PD_MSG_MEM_ALLOC:
     case PD_MSG_MEM_UNALLOC:
@@ -2520,6 +2523,7 @@ u8 hcDistPdSendMessage(ocrPolicyDomain_t* self, ocrLocation_t target, ocrPolicyM
     }
 #endif
     u32 id = worker->id;
+    RT_WORKER_MSG_COUNT(worker, msgSent, message->type);
     u8 ret = self->commApis[id]->fcts.sendMessage(self->commApis[id], target, message, handle, properties);
     return ret;
 }
@@ -2532,6 +2536,10 @@ u8 hcDistPdPollMessage(ocrPolicyDomain_t *self, ocrMsgHandle_t **handle) {
     getCurrentEnv(NULL, &worker, NULL, NULL);
     u32 id = worker->id;
     u8 ret = self->commApis[id]->fcts.pollMessage(self->commApis[id], handle);
+    if ((ret == POLL_MORE_MESSAGE) && (*handle != NULL)) {
+        ocrPolicyMsg_t *message = ((*handle)->status == HDL_RESPONSE_OK) ? (*handle)->response : (*handle)->msg;
+        RT_WORKER_MSG_COUNT(worker, msgReceived, message->type);
+    }
     return ret;
 }
 
@@ -27,6 +27,7 @@
 
 #include "utils/profiler/profiler.h"
 #include "utils/ocr-utils.h"
+#include "utils/perf-db.h"
 
 #include "policy-domain/hc/hc-policy.h"
 #include "allocator/allocator-all.h"
@@ -38,6 +39,7 @@
 
 #ifdef ENABLE_RESILIENCY
 #include "worker/hc/hc-worker.h"
+#include "utils/chunk-codec.h"
 #endif
 
 // Currently required to find out if self is the blessed PD
@@ -388,8 +390,7 @@ u8 hcPdSwitchRunlevel(ocrPolicyDomain_t *policy, ocrRunlevel_t runlevel, u32 pro
         if(properties & RL_BRING_UP) {
 
 #ifdef ENABLE_EXTENSION_PERF
-#define MAX_EDT_TEMPLATES 64
-                policy->taskPerfs = newBoundedQueue(policy, MAX_EDT_TEMPLATES);
+                policy->taskPerfs = newPerfDb(policy);
 #endif
 
             phaseCount = policy->phasesPerRunlevel[RL_COMPUTE_OK][0] & 0xF;
@@ -477,17 +478,8 @@ u8 hcPdSwitchRunlevel(ocrPolicyDomain_t *policy, ocrRunlevel_t runlevel, u32 pro
                         policy->workers[j], policy, runlevel, rself->rlSwitch.nextPhase, properties, NULL, 0);
                 }
 #ifdef ENABLE_EXTENSION_PERF
-                ocrPerfCounters_t *counters;
-                PRINTF("EDT\tCount\tHW_CYCLES\tL1_HITS\tL1_MISS\tFLOAT_OPS\tEDT_CREATES\tDB_TOTAL\tDB_CREATES\tDB_DESTROYS\tEVT_SATISFIES\tMask\n");
-                while(!queueIsEmpty(policy->taskPerfs)) {
-                    u32 i;
-                    counters = queueRemoveLast(policy->taskPerfs);
-                    PRINTF("%p\t%"PRId32"\t", counters->edt, counters->count);
-                    for(i = 0; i < PERF_MAX; i++) PRINTF("%"PRId64"\t", counters->stats[i].average);
-                    PRINTF("%"PRIx32"\n", counters->steadyStateMask);
-                    policy->fcts.pdFree(policy, counters);
-                }
-                queueDestroy(policy->taskPerfs);
+                perfDbDump(policy->taskPerfs);
+                destructPerfDb(policy->taskPerfs);
 #endif
                 //to be deprecated
                 destroyLocationPlacer(policy);
@@ -760,9 +752,16 @@ static u8 hcAllocateDb(ocrPolicyDomain_t *self, ocrFatGuid_t *guid, void** ptr,
     // eventually be eliminated here and instead, above this level, processed into the "prescription"
     // variable, which has been added to this argument list.  The prescription indicates an order in
     // which to attempt to allocate the block to a pool.
+    //
+    // With one allocator per NUMA domain, the block comes from the domain of the
+    // worker creating it (the first EDT to touch it usually runs there too).
     u64 idx = 0, hints = 0;
     if(dbType == USER_DBTYPE)
         hints = OCR_ALLOC_HINT_USER;
+    ocrWorker_t * worker = NULL;
+    getCurrentEnv(NULL, &worker, NULL, NULL);
+    if((worker != NULL) && (worker->numaDomain < self->allocatorCount))
+        idx = worker->numaDomain;
     void * result = self->allocators[idx]->fcts.allocate(self->allocators[idx], size, hints);
     if (result) {
         u8 returnValue = 0;
@@ -919,6 +918,161 @@ static u8 convertDepAddToSatisfy(ocrPolicyDomain_t *self, ocrFatGuid_t dbGuid,
     return 0;
 }
 
+// Adds a single dependence of a PD_MSG_DEP_ADD_BULK through a regular PD_MSG_DEP_ADD
+static u8 addDependenceOne(ocrPolicyDomain_t *self, ocrDependence_t *dep, ocrFatGuid_t currentEdt) {
+    PD_MSG_STACK(msg);
+    getCurrentEnv(NULL, NULL, NULL, &msg);
+#define PD_MSG (&msg)
+#define PD_TYPE PD_MSG_DEP_ADD
+    msg.type = PD_MSG_DEP_ADD | PD_MSG_REQUEST;
+    PD_MSG_FIELD_I(source.guid) = dep->source;
+    PD_MSG_FIELD_I(source.metaDataPtr) = NULL;
+    PD_MSG_FIELD_I(dest.guid) = dep->destination;
+    PD_MSG_FIELD_I(dest.metaDataPtr) = NULL;
+    PD_MSG_FIELD_I(slot) = dep->slot;
+    PD_MSG_FIELD_IO(properties) = dep->mode;
+    PD_MSG_FIELD_I(currentEdt) = currentEdt;
+#undef PD_MSG
+#undef PD_TYPE
+    return self->fcts.processMessage(self, &msg, true);
+}
+
+#if !(defined(REG_ASYNC) || defined(REG_ASYNC_SGL))
+// Kinds of dependences a PD_MSG_DEP_ADD_BULK registers in groups
+#define DEP_BULK_ONE       0 // Added on its own
+#define DEP_BULK_WAITER    1 // Local persistent event to event: grouped by source
+#define DEP_BULK_SIGNALER  2 // Persistent event to local EDT: grouped by destination
+#endif
+
+/**
+ * @brief Adds 'count' dependences
+ *
+ * Dependences from a local persistent event to events are registered on
+ * the event with one registerWaiters call per run of consecutive
+ * dependences sharing that source. Dependences from persistent events to
+ * a local EDT are registered with one registerSignalers call per run of
+ * dependences sharing that destination. Anything else goes through
+ * PD_MSG_DEP_ADD, before the groups are registered.
+ *
+ * Returns the first error encountered, 0 otherwise.
+ */
+static u8 addDependencesBulk(ocrPolicyDomain_t *self, u32 count, ocrDependence_t *deps,
+                             ocrFatGuid_t currentEdt) {
+    u8 returnCode = 0;
+    u32 i;
+    if (count == 0)
+        return 0;
+#if !(defined(REG_ASYNC) || defined(REG_ASYNC_SGL))
+    ocrEventFactory_t *evtFactory = (ocrEventFactory_t*)(self->factories[self->eventFactoryIdx]);
+    ocrTaskFactory_t *taskFactory = (ocrTaskFactory_t*)(self->factories[self->taskFactoryIdx]);
+    // Resolved GUIDs and kind of each dependence, then the arguments of a group
+    u64 size = count * (2*sizeof(ocrFatGuid_t) + sizeof(u8) + sizeof(ocrFatGuid_t) +
+                        sizeof(u32) + sizeof(ocrDbAccessMode_t));
+    ocrFatGuid_t *srcs = (ocrFatGuid_t*)self->fcts.pdMalloc(self, size);
+    ocrFatGuid_t *dsts = srcs + count;
+    ocrFatGuid_t *others = dsts + count;
+    u32 *slots = (u32*)(others + count);
+    ocrDbAccessMode_t *modes = (ocrDbAccessMode_t*)(slots + count);
+    u8 *kinds = (u8*)(modes + count);
+    u32 nbGrouped = 0;
+    for (i = 0; i < count; ++i) {
+        ocrDependence_t *dep = &deps[i];
+        kinds[i] = DEP_BULK_ONE;
+        if (ocrGuidIsNull(dep->source)) {
+            if (!ocrGuidIsNull(dep->destination)) {
+                u8 ret = addDependenceOne(self, dep, currentEdt);
+                returnCode = returnCode ? returnCode : ret;
+            }
+            continue;
+        }
+        ocrGuidKind srcKind, dstKind;
+        srcs[i].guid = dep->source;
+        srcs[i].metaDataPtr = NULL;
+        dsts[i].guid = dep->destination;
+        dsts[i].metaDataPtr = NULL;
+        self->guidProviders[0]->fcts.getVal(
+            self->guidProviders[0], srcs[i].guid, (u64*)(&(srcs[i].metaDataPtr)), &srcKind, MD_LOCAL, NULL);
+        self->guidProviders[0]->fcts.getVal(
+            self->guidProviders[0], dsts[i].guid, (u64*)(&(dsts[i].metaDataPtr)), &dstKind, MD_LOCAL, NULL);
+        bool srcIsPersistent = (srcKind == OCR_GUID_EVENT_STICKY) || (srcKind == OCR_GUID_EVENT_IDEM);
+        if (srcIsPersistent && (dstKind & OCR_GUID_EVENT) && (srcs[i].metaDataPtr != NULL) && isLocalGuid(self, srcs[i].guid) &&
+            (evtFactory->fcts[((ocrEvent_t*)srcs[i].metaDataPtr)->kind].registerWaiters != NULL)) {
+            kinds[i] = DEP_BULK_WAITER;
+        } else if (srcIsPersistent && (dstKind == OCR_GUID_EDT) && (dsts[i].metaDataPtr != NULL) && isLocalGuid(self, dsts[i].guid) &&
+                   (taskFactory->fcts.registerSignalers != NULL)) {
+            kinds[i] = DEP_BULK_SIGNALER;
+        }
+        if (kinds[i] == DEP_BULK_ONE) {
+            u8 ret = addDependenceOne(self, dep, currentEdt);
+            returnCode = returnCode ? returnCode : ret;
+        } else {
+            ++nbGrouped;
+        }
+    }
+
+    // Register the groups. A dependence is marked DEP_BULK_ONE once registered.
+    u32 start = 0;
+    while (nbGrouped != 0) {
+        while (kinds[start] == DEP_BULK_ONE)
+            ++start;
+        u8 kind = kinds[start];
+        ocrFatGuid_t *key = (kind == DEP_BULK_WAITER) ? &srcs[start] : &dsts[start];
+        u32 n = 0;
+        for (i = start; i < count; ++i) {
+            if (kinds[i] != kind)
+                continue;
+            ocrFatGuid_t *cur = (kind == DEP_BULK_WAITER) ? &srcs[i] : &dsts[i];
+            if (!ocrGuidIsEq(cur->guid, key->guid))
+                break;
+            others[n] = (kind == DEP_BULK_WAITER) ? dsts[i] : srcs[i];
+            slots[n] = deps[i].slot;
+            modes[n] = (deps[i].mode & DB_ACCESS_MODE_MASK);
+            kinds[i] = DEP_BULK_ONE;
+            ++n;
+        }
+        u8 ret;
+        if (kind == DEP_BULK_WAITER) {
+            ocrEvent_t *evt = (ocrEvent_t*)(key->metaDataPtr);
+            ASSERT(evt->fctId == evtFactory->factoryId);
+            ret = evtFactory->fcts[evt->kind].registerWaiters(evt, n, others, slots);
+        } else {
+            ocrTask_t *edt = (ocrTask_t*)(key->metaDataPtr);
+            ASSERT(edt->fctId == taskFactory->factoryId);
+            ret = taskFactory->fcts.registerSignalers(edt, n, others, slots, modes);
+        }
+        DPRINTF(DEBUG_LVL_INFO, "Dependences added in bulk (%s: "GUIDF", count: %"PRIu32") -> %"PRIu32"\n",
+                (kind == DEP_BULK_WAITER) ? "src" : "dest", GUIDA(key->guid), n, ret);
+#if defined(OCR_TRACE_BINARY) || defined(OCR_ENABLE_STATISTICS)
+        // Each edge is recorded as if it went through PD_MSG_DEP_ADD
+        for (i = 0; i < n; ++i) {
+            ocrGuid_t srcGuid = (kind == DEP_BULK_WAITER) ? key->guid : others[i].guid;
+            ocrGuid_t dstGuid = (kind == DEP_BULK_WAITER) ? others[i].guid : key->guid;
+            if (kind == DEP_BULK_WAITER) {
+                OCR_TOOL_TRACE(false, OCR_TRACE_TYPE_EVENT, OCR_ACTION_ADD_DEP, traceEventAddDependence, srcGuid, dstGuid);
+            } else {
+                OCR_TOOL_TRACE(false, OCR_TRACE_TYPE_EDT, OCR_ACTION_ADD_DEP, traceTaskAddDependence, srcGuid, dstGuid);
+            }
+#ifdef OCR_ENABLE_STATISTICS
+            statsDEP_ADD(self, currentEdt.guid, NULL, srcGuid, dstGuid, NULL, slots[i]);
+#endif
+        }
+#endif
+        returnCode = returnCode ? returnCode : ret;
+        nbGrouped -= n;
+    }
+    self->fcts.pdFree(self, srcs);
+#else
+    // The registrations cannot be grouped with asynchronous registration
+    for (i = 0; i < count; ++i) {
+        if (ocrGuidIsNull(deps[i].source) && ocrGuidIsNull(deps[i].destination))
+            continue;
+        u8 ret = addDependenceOne(self, &deps[i], currentEdt);
+        returnCode = returnCode ? returnCode : ret;
+    }
+#endif
+    return returnCode;
+}
+
 #ifdef OCR_ENABLE_STATISTICS
 static ocrStats_t* hcGetStats(ocrPolicyDomain_t *self) {
     return self->statsObject;
@@ -992,6 +1146,109 @@ static void checkinWorkerForCheckpoint(ocrPolicyDomain_t *self, ocrWorker_t *wor
     }
 }
 
+//Run the partitions of the current quiesced pass until none is left to claim
+static void runQuiescedWork(ocrPolicyDomainHc_t *rself) {
+    u32 ticket = rself->quiesceWorkTicket;
+    while (ticket < rself->quiesceWorkEnd) {
+        if (hal_cmpswap32(&rself->quiesceWorkTicket, ticket, ticket + 1) == ticket) {
+            //The pass cannot complete before this ticket is done: fct and args are stable
+            rself->quiesceWorkFct(rself->quiesceWorkArgs, ticket - rself->quiesceWorkBase);
+            hal_fence();
+            hal_xadd32(&rself->quiesceWorkDone, 1);
+        }
+        ticket = rself->quiesceWorkTicket;
+    }
+}
+
+//ocrGuidParallelFor_t runner spreading a GUID provider pass over the
+//resiliency master and the comp workers parked in the quiesceComps loop
+static void hcQuiescedParallelFor(ocrPolicyDomain_t *self, ocrGuidParallelFct_t fct, void *args, u32 count) {
+    ocrPolicyDomainHc_t *rself = (ocrPolicyDomainHc_t *)self;
+    u32 base = rself->quiesceWorkEnd;
+    ASSERT(rself->quiesceWorkTicket == base && rself->quiesceWorkDone == base);
+    rself->quiesceWorkFct = fct;
+    rself->quiesceWorkArgs = args;
+    rself->quiesceWorkBase = base;
+    hal_fence();
+    rself->quiesceWorkEnd = base + count;
+    hal_fence();
+    runQuiescedWork(rself);
+    while (rself->quiesceWorkDone != (base + count))
+        ;
+    hal_fence();
+}
+
+// Codec stage of checkpoint segments: the chunks of a segment are encoded
+// (or decoded) in parallel by the quiesced workers
+typedef struct {
+    u8 *stream;         // Stream header and chunk table
+    u8 *raw;            // Serialized PD
+    u8 *scratch;        // CODEC_CHUNK_SIZE bytes per encoded chunk
+    u8 *dst;            // Checkpoint buffer
+    volatile u32 failed;
+} hcCodecArgs_t;
+
+static void encodeCheckpointChunk(void *args, u32 chunk) {
+    hcCodecArgs_t *cargs = (hcCodecArgs_t*)args;
+    codecEncodeChunk(cargs->stream, cargs->raw, chunk, cargs->scratch + ((u64)chunk * CODEC_CHUNK_SIZE));
+}
+
+static void copyCheckpointChunk(void *args, u32 chunk) {
+    hcCodecArgs_t *cargs = (hcCodecArgs_t*)args;
+    ocrCodecChunk_t *desc = CODEC_CHUNK_TABLE(cargs->stream) + chunk;
+    hal_memCopy(cargs->dst + desc->offset, cargs->scratch + ((u64)chunk * CODEC_CHUNK_SIZE), desc->size, false);
+}
+
+static void decodeCheckpointChunk(void *args, u32 chunk) {
+    hcCodecArgs_t *cargs = (hcCodecArgs_t*)args;
+    if (codecDecodeChunk(cargs->dst, chunk, cargs->raw) != 0)
+        cargs->failed = 1;
+}
+
+//Encode a serialized PD and return the size of the resulting segment
+static u64 encodeCheckpoint(ocrPolicyDomain_t *self, hcCodecArgs_t *cargs, u8 *raw, u64 size) {
+    ocrPolicyDomainHc_t *rself = (ocrPolicyDomainHc_t *)self;
+    u32 count = codecChunkCount(size, CODEC_CHUNK_SIZE);
+    cargs->stream = (u8*)self->fcts.pdMalloc(self, codecHeaderSize(count));
+    cargs->raw = raw;
+    cargs->scratch = (u8*)self->fcts.pdMalloc(self, (u64)count * CODEC_CHUNK_SIZE);
+    cargs->dst = NULL;
+    codecInitStream(cargs->stream, rself->codec, size, CODEC_CHUNK_SIZE);
+    hcQuiescedParallelFor(self, encodeCheckpointChunk, cargs, count);
+    return codecLayoutStream(cargs->stream);
+}
+
+//Write an encoded PD to the checkpoint buffer
+static void writeCheckpoint(ocrPolicyDomain_t *self, hcCodecArgs_t *cargs, u8 *buffer) {
+    ocrCodecHeader_t *hdr = (ocrCodecHeader_t*)cargs->stream;
+    cargs->dst = buffer;
+    hal_memCopy(buffer, cargs->stream, codecHeaderSize(hdr->chunkCount), false);
+    hcQuiescedParallelFor(self, copyCheckpointChunk, cargs, hdr->chunkCount);
+    self->fcts.pdFree(self, cargs->scratch);
+    self->fcts.pdFree(self, cargs->stream);
+}
+
+//Get the serialized PD stored in a checkpoint segment, decoding it if needed.
+//Returns NULL if the segment is an invalid codec stream.
+static u8* readCheckpointSegment(ocrPolicyDomain_t *self, u8 *segment, u64 maxSize, u64 *segmentSize) {
+    if (!codecIsStream(segment)) {
+        *segmentSize = ((ocrObject_t*)segment)->size;
+        return segment;
+    }
+    if (codecValidateStream(segment, maxSize) != 0)
+        return NULL;
+    ocrCodecHeader_t *hdr = (ocrCodecHeader_t*)segment;
+    hcCodecArgs_t cargs = {.stream = segment, .raw = NULL, .scratch = NULL, .dst = segment, .failed = 0};
+    cargs.raw = (u8*)self->fcts.pdMalloc(self, hdr->rawSize);
+    hcQuiescedParallelFor(self, decodeCheckpointChunk, &cargs, hdr->chunkCount);
+    if (cargs.failed) {
+        self->fcts.pdFree(self, cargs.raw);
+        return NULL;
+    }
+    *segmentSize = hdr->encodedSize;
+    return cargs.raw;
+}
+
 static void startPdCheckpoint(ocrPolicyDomain_t *self) {
     ocrPolicyDomainHc_t *rself = (ocrPolicyDomainHc_t *)self;
     DPRINTF(DEBUG_LVL_VERB, "PD checkpoint start...\n");
@@ -1038,17 +1295,71 @@ static void startPdCheckpoint(ocrPolicyDomain_t *self) {
 
     char *chkptName = NULL;
     u64 chkptSize = 0;
-    self->guidProviders[0]->fcts.getSerializationSize(self->guidProviders[0], &chkptSize);
-    DPRINTF(DEBUG_LVL_VERB, "PD checkpoint size: %lu\n", chkptSize);
+    u8 *buffer = NULL;
+    ocrGuidProvider_t *guidProvider = self->guidProviders[0];
+    guidProvider->parallelFor = hcQuiescedParallelFor;
+
+    //Append a delta to the current checkpoint unless it has grown
+    //too long or the delta would not be smaller than a full checkpoint
+    bool isDelta = false;
+#ifndef ENABLE_CHECKPOINT_VERIFICATION
+    //(Verification restores the PD from each checkpoint and needs full ones)
+    if (rself->currCheckpointName != NULL && rself->checkpointDeltaCount < OCR_CHECKPOINT_MAX_DELTAS) {
+        guidProvider->fcts.getDeltaSerializationSize(guidProvider, &chkptSize);
+        isDelta = (chkptSize < rself->checkpointBaseSize);
+    }
+#endif
+
+    if (isDelta) {
+        DPRINTF(DEBUG_LVL_VERB, "PD checkpoint delta size: %lu\n", chkptSize);
+    } else {
+        guidProvider->fcts.getSerializationSize(guidProvider, &chkptSize);
+        DPRINTF(DEBUG_LVL_VERB, "PD checkpoint size: %lu\n", chkptSize);
+    }
 
-    u8 *buffer = salCreatePdCheckpoint(&chkptName, chkptSize);
+    //With a codec, the PD is serialized in a temporary buffer and encoded
+    //before the checkpoint buffer of the encoded size is created
+    u64 phase = salGetNextCheckpointPhase();
+    u8 *serialBuffer = NULL;
+    u64 bufferSize = chkptSize;
+    hcCodecArgs_t cargs;
+    if (rself->codec != PD_HC_CODEC_DISABLED) {
+        serialBuffer = (u8*)self->fcts.pdMalloc(self, chkptSize);
+        if (isDelta) {
+            guidProvider->fcts.serializeDelta(guidProvider, serialBuffer, phase);
+        } else {
+            guidProvider->fcts.serialize(guidProvider, serialBuffer);
+        }
+        bufferSize = encodeCheckpoint(self, &cargs, serialBuffer, chkptSize);
+        DPRINTF(DEBUG_LVL_VERB, "PD checkpoint encoded size: %lu\n", bufferSize);
+    }
+
+    if (isDelta) {
+        buffer = salExtendPdCheckpoint(rself->currCheckpointName, &chkptName, bufferSize);
+    } else {
+        buffer = salCreatePdCheckpoint(&chkptName, bufferSize);
+    }
+    ASSERT(salGetCheckpointPhase(chkptName) == phase);
     ASSERT(rself->prevCheckpointName == NULL);
     rself->prevCheckpointName = rself->currCheckpointName;
     rself->currCheckpointName = chkptName;
     DPRINTF(DEBUG_LVL_VERB, "PD checkpoint buffer: %p\n", buffer);
 
-    self->guidProviders[0]->fcts.serialize(self->guidProviders[0], buffer);
-    DPRINTF(DEBUG_LVL_VERB, "PD serialized...\n");
+    if (serialBuffer != NULL) {
+        writeCheckpoint(self, &cargs, buffer);
+    } else if (isDelta) {
+        guidProvider->fcts.serializeDelta(guidProvider, buffer, phase);
+    } else {
+        guidProvider->fcts.serialize(guidProvider, buffer);
+    }
+    if (isDelta) {
+        rself->checkpointDeltaCount++;
+        DPRINTF(DEBUG_LVL_VERB, "PD delta serialized...\n");
+    } else {
+        rself->checkpointDeltaCount = 0;
+        rself->checkpointBaseSize = chkptSize;
+        DPRINTF(DEBUG_LVL_VERB, "PD serialized...\n");
+    }
 
 #ifdef ENABLE_CHECKPOINT_VERIFICATION
     DPRINTF(DEBUG_LVL_VERB, "Starting PD reset ...\n");
@@ -1057,12 +1368,15 @@ static void startPdCheckpoint(ocrPolicyDomain_t *self) {
     DPRINTF(DEBUG_LVL_VERB, "PD reset done!\n");
 
     DPRINTF(DEBUG_LVL_VERB, "Starting PD deserialize from checkpoint ...\n");
-    self->guidProviders[0]->fcts.deserialize(self->guidProviders[0], buffer);
+    self->guidProviders[0]->fcts.deserialize(self->guidProviders[0], (serialBuffer != NULL) ? serialBuffer : buffer);
     self->guidProviders[0]->fcts.fixup(self->guidProviders[0]);
     DPRINTF(DEBUG_LVL_VERB, "Resuming PD from checkpoint ...\n");
 #endif
 
-    RESULT_ASSERT(salClosePdCheckpoint(buffer, chkptSize), ==, 0);
+    guidProvider->parallelFor = NULL;
+    if (serialBuffer != NULL)
+        self->fcts.pdFree(self, serialBuffer);
+    RESULT_ASSERT(salClosePdCheckpoint(buffer, bufferSize), ==, 0);
     DPRINTF(DEBUG_LVL_VERB, "PD checkpoint completed!\n");
     hal_fence();
 
@@ -1235,11 +1549,40 @@ static void startPdRestart(ocrPolicyDomain_t *self) {
     DPRINTF(DEBUG_LVL_VERB, "PD reset done!\n");
 
     DPRINTF(DEBUG_LVL_VERB, "Starting PD deserialize from checkpoint ...\n");
-    self->guidProviders[0]->fcts.deserialize(self->guidProviders[0], buffer);
-    self->guidProviders[0]->fcts.fixup(self->guidProviders[0]);
+    ocrGuidProvider_t *guidProvider = self->guidProviders[0];
+    guidProvider->parallelFor = hcQuiescedParallelFor;
+    u64 segmentSize = 0;
+    u8 *segment = readCheckpointSegment(self, buffer, chkptSize, &segmentSize);
+    if (segment == NULL) {
+        DPRINTF(DEBUG_LVL_WARN, "Corrupted PD checkpoint %s\n", chkptName);
+        ASSERT(0);
+    }
+    guidProvider->fcts.deserialize(guidProvider, segment);
+    if (segment != buffer)
+        self->fcts.pdFree(self, segment);
+
+    //Replay the deltas appended to the full checkpoint up to the stable phase.
+    //A delta past the stable phase may be torn, which also ends the replay.
+    u64 maxPhase = salGetCheckpointPhase(chkptName);
+    u64 offset = SAL_CHKPT_ALIGN(segmentSize);
+    while (offset < chkptSize) {
+        segment = readCheckpointSegment(self, buffer + offset, chkptSize - offset, &segmentSize);
+        if (segment == NULL)
+            break;
+        u8 rc = guidProvider->fcts.deserializeDelta(guidProvider, segment, maxPhase);
+        if (segment != (buffer + offset))
+            self->fcts.pdFree(self, segment);
+        if (rc != 0)
+            break;
+        offset += SAL_CHKPT_ALIGN(segmentSize);
+    }
+    guidProvider->fcts.fixup(guidProvider);
+    guidProvider->parallelFor = NULL;
     DPRINTF(DEBUG_LVL_VERB, "Resuming PD from checkpoint ...\n");
 
     RESULT_ASSERT(salClosePdCheckpoint(buffer, chkptSize), ==, 0);
+    //The restored objects are not tracked against any checkpoint of this run
+    rself->checkpointDeltaCount = OCR_CHECKPOINT_MAX_DELTAS;
 
     DPRINTF(DEBUG_LVL_VERB, "PD restart completed...\n");
 
@@ -1803,6 +2146,7 @@ u8 hcPolicyDomainProcessMessage(ocrPolicyDomain_t *self, ocrPolicyMsg_t *msg, u8
                 DPRINTF(DEBUG_LVL_VERB, "Creating a datablock of size %"PRIu64" @ %p (GUID: "GUIDF") (edt GUID: "GUIDF")\n",
                         db->size, db->ptr, GUIDA(db->guid), GUIDA(tEdt.guid));
                 OCR_TOOL_TRACE(true, OCR_TRACE_TYPE_DATABLOCK, OCR_ACTION_CREATE, traceDataCreate, db->guid, db->size);
+                RT_COUNTER_ADD(RT_COUNTER_ALLOC_BYTES, db->size);
             }
             ASSERT(db);
             if(doNotAcquireDb) {
@@ -1813,6 +2157,7 @@ u8 hcPolicyDomainProcessMessage(ocrPolicyDomain_t *self, ocrPolicyMsg_t *msg, u8
                 PD_MSG_FIELD_O(returnDetail) = ((ocrDataBlockFactory_t*)(self->factories[self->datablockFactoryIdx]))->fcts.acquire(
                     db, &(PD_MSG_FIELD_O(ptr)), tEdt, self->myLocation, EDT_SLOT_NONE, DB_MODE_RW, !!(PD_MSG_FIELD_IO(properties) & DB_PROP_RT_ACQUIRE),
                     (u32) DB_MODE_RW);
+                RT_COUNTER_ADD(RT_COUNTER_DB_BYTES_LOCAL, db->size);
                 // Set the default mode in the response message for the caller
                 PD_MSG_FIELD_IO(properties) |= DB_MODE_RW;
             }
@@ -1876,6 +2221,10 @@ u8 hcPolicyDomainProcessMessage(ocrPolicyDomain_t *self, ocrPolicyMsg_t *msg, u8
                         GUIDA(db->guid), db->size, GUIDA(PD_MSG_FIELD_IO(edt.guid)));
                 OCR_TOOL_TRACE(false, OCR_TRACE_TYPE_EDT, OCR_ACTION_DATA_ACQUIRE, traceTaskDataAcquire, PD_MSG_FIELD_IO(edt.guid),
                                 db->guid, db->size);
+                if (PD_MSG_FIELD_IO(destLoc) == self->myLocation)
+                    RT_COUNTER_ADD(RT_COUNTER_DB_BYTES_LOCAL, db->size);
+                else
+                    RT_COUNTER_ADD(RT_COUNTER_DB_BYTES_REMOTE, db->size);
                 msg->type &= ~PD_MSG_REQUEST;
                 msg->type |= PD_MSG_RESPONSE;
             }
@@ -1942,6 +2291,7 @@ u8 hcPolicyDomainProcessMessage(ocrPolicyDomain_t *self, ocrPolicyMsg_t *msg, u8
         ASSERT(!(msg->type & PD_MSG_REQ_RESPONSE));
         //Save a copy of the DB guid for DPRINTF() and tracing before the free call
         ocrGuid_t dbGuid = PD_MSG_FIELD_I(guid).guid;
+        u64 dbSize = db->size;
         PD_MSG_FIELD_O(returnDetail) = ((ocrDataBlockFactory_t*)(self->factories[self->datablockFactoryIdx]))->fcts.free(
             db, PD_MSG_FIELD_I(edt), PD_MSG_FIELD_I(srcLoc), PD_MSG_FIELD_I(properties));
         if(PD_MSG_FIELD_O(returnDetail)!=0)
@@ -1950,6 +2300,7 @@ u8 hcPolicyDomainProcessMessage(ocrPolicyDomain_t *self, ocrPolicyMsg_t *msg, u8
             DPRINTF(DEBUG_LVL_INFO,
                     "DB guid: "GUIDF" Destroyed\n", GUIDA(dbGuid));
             OCR_TOOL_TRACE(false, OCR_TRACE_TYPE_DATABLOCK, OCR_ACTION_DESTROY, traceDataDestroy, dbGuid);
+            RT_COUNTER_SUB(RT_COUNTER_ALLOC_BYTES, dbSize);
 
         }
 #undef PD_MSG
@@ -3090,6 +3441,23 @@ u8 hcPolicyDomainProcessMessage(ocrPolicyDomain_t *self, ocrPolicyMsg_t *msg, u8
         break;
     }
 
+    case PD_MSG_DEP_ADD_BULK: {
+        START_PROFILE(pd_hc_AddDepBulk);
+#define PD_MSG msg
+#define PD_TYPE PD_MSG_DEP_ADD_BULK
+        u8 returnDetail = addDependencesBulk(self, PD_MSG_FIELD_I(count), PD_MSG_FIELD_I(deps),
+                                             PD_MSG_FIELD_I(currentEdt));
+        PD_MSG_FIELD_O(returnDetail) = returnDetail;
+#undef PD_MSG
+#undef PD_TYPE
+        msg->type &= ~PD_MSG_REQUEST;
+        if (msg->type & PD_MSG_REQ_RESPONSE) {
+            msg->type |= PD_MSG_RESPONSE;
+        }
+        EXIT_PROFILE;
+        break;
+    }
+
     case PD_MSG_DEP_REGSIGNALER: {
         START_PROFILE(pd_hc_RegSignaler);
 #define PD_MSG msg
@@ -3677,7 +4045,7 @@ u8 hcPolicyDomainProcessMessage(ocrPolicyDomain_t *self, ocrPolicyMsg_t *msg, u8
                     hal_xadd32(&rself->quiesceComps, 1);
                     DPRINTF(DEBUG_LVL_VERB, "Waiting at quiesceComps...\n");
                     while (rself->quiesceComps != 0)
-                        ;
+                        runQuiescedWork(rself);
                     DPRINTF(DEBUG_LVL_VERB, "Checking out of quiesceComps...\n");
                 } else if (rself->resumeAfterCheckpoint != 0) {
                     ASSERT(worker->stateOfCheckpoint != 0);
@@ -3946,6 +4314,12 @@ void initializePolicyDomainHc(ocrPolicyDomainFactory_t * factory, ocrPolicyDomai
 
     ocrPolicyDomainHc_t* derived = (ocrPolicyDomainHc_t*) self;
     derived->rlSwitch.legacySecondStart = false;
+#if defined(ENABLE_RESILIENCY) || defined(ENABLE_AMT_RESILIENCE)
+    derived->codec = ((paramListPolicyDomainHcInst_t*)perInstance)->codec;
+#endif
+#ifdef ENABLE_AMT_RESILIENCE
+    salSetPublishCodec(derived->codec);
+#endif
 #ifdef ENABLE_RESILIENCY
     derived->faultArgs.kind = OCR_FAULT_NONE;
     derived->shutdownInProgress = 0;
@@ -3967,6 +4341,14 @@ void initializePolicyDomainHc(ocrPolicyDomainFactory_t * factory, ocrPolicyDomai
     derived->restartWorkerCounter = 0;
     derived->restartPdCounter = 0;
     derived->checkpointInterval = OCR_CHECKPOINT_INTERVAL;
+    derived->quiesceWorkFct = NULL;
+    derived->quiesceWorkArgs = NULL;
+    derived->quiesceWorkBase = 0;
+    derived->quiesceWorkEnd = 0;
+    derived->quiesceWorkTicket = 0;
+    derived->quiesceWorkDone = 0;
+    derived->checkpointDeltaCount = 0;
+    derived->checkpointBaseSize = 0;
     derived->timestamp = 0;
     derived->calTime = 0;
     derived->currCheckpointName = NULL;
@@ -21,6 +21,15 @@
 #define OCR_CHECKPOINT_INTERVAL     10000000UL /* 10 miliseconds */
 #endif
 
+// Number of incremental checkpoints appended to a full one before
+// a new full checkpoint is taken (0 disables incremental checkpoints)
+#ifndef OCR_CHECKPOINT_MAX_DELTAS
+#define OCR_CHECKPOINT_MAX_DELTAS   8
+#endif
+
+// Codec setting leaving checkpoints and published data-blocks raw
+#define PD_HC_CODEC_DISABLED        ((u32)-1)
+
 typedef struct {
     ocrPolicyDomainFactory_t base;
 } ocrPolicyDomainFactoryHc_t;
@@ -45,6 +54,10 @@ typedef struct {
     ocrPolicyDomain_t base;
     pdHcResumeSwitchRL_t rlSwitch; // Used for asynchronous RL switch
     hcPqrFlags pqrFlags;
+#if defined(ENABLE_RESILIENCY) || defined(ENABLE_AMT_RESILIENCE)
+    u32 codec;      // ocrCodecKind_t checkpoints and published data-blocks are
+                    // stored with (PD_HC_CODEC_DISABLED to store them raw)
+#endif
 #ifdef ENABLE_RESILIENCY
     ocrFaultArgs_t faultArgs;
     volatile u32 shutdownInProgress;
@@ -66,6 +79,17 @@ typedef struct {
     u32 restartWorkerCounter;
     u32 restartPdCounter;
     u64 checkpointInterval;
+    // Partitioned work handed to the quiesced comp workers during checkpoint
+    // and restart: the partitions of the current pass are the tickets
+    // [quiesceWorkBase, quiesceWorkEnd) of a monotonic counter
+    void (*quiesceWorkFct)(void *, u32);
+    void *quiesceWorkArgs;
+    u32 quiesceWorkBase;
+    volatile u32 quiesceWorkEnd;
+    volatile u32 quiesceWorkTicket;
+    volatile u32 quiesceWorkDone;
+    u32 checkpointDeltaCount; // Deltas appended to the current full checkpoint
+    u64 checkpointBaseSize;   // Size of the current full checkpoint
     u64 timestamp;
     u64 calTime;    // Calendar start time agreed by all PD's
     char *currCheckpointName;
@@ -76,6 +100,7 @@ typedef struct {
 typedef struct {
     paramListPolicyDomainInst_t base;
     u32 rank; // set through the CFG file, not used for now
+    u32 codec; // ocrCodecKind_t set through the CFG file, or PD_HC_CODEC_DISABLED
 } paramListPolicyDomainHcInst_t;
 
 ocrPolicyDomainFactory_t *newPolicyDomainFactoryHc(ocrParamList_t *perType);
@@ -110,6 +110,8 @@ u64 salPerfStop(salPerfCounter* perfCtr) {
     perfCtr[PERF_L1_MISSES].perfVal = *(u64 *)(AR_PMU_BASE + sizeof(u64)*pmuCounters[4]) +
                               *(u64 *)(AR_PMU_BASE + sizeof(u64)*pmuCounters[5]);
     perfCtr[PERF_FLOAT_OPS].perfVal = 0xdeaddead;
+    perfCtr[PERF_INSTRUCTIONS].perfVal = *(u64 *)(AR_PMU_BASE + sizeof(u64)*pmuCounters[1]);
+    perfCtr[PERF_STALLED_CYCLES].perfVal = *(u64 *)(AR_PMU_BASE + sizeof(u64)*pmuCounters[0]);
 
     return 0;
 }
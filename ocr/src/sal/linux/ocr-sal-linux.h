@@ -43,11 +43,13 @@ extern void registerSignalHandler();
 #ifdef ENABLE_EXTENSION_PERF
 
 typedef struct _salPerfCounter {
-    u64 perfVal;
-    u32 perfFd;
+    u64 perfVal;        // Value over the last start/stop interval
+    u64 perfStart;      // Snapshot taken by salPerfStart
+    s32 perfFd;         // -1 if the counter is not available
     u32 perfType;
     u64 perfConfig;
     struct perf_event_attr perfAttr;
+    struct perf_event_mmap_page *perfPage; // For user-space reads (rdpmc)
 } salPerfCounter;
 
 u64 salPerfInit(salPerfCounter* perfCtr);
@@ -55,16 +57,28 @@ u64 salPerfStart(salPerfCounter* perfCtr);
 u64 salPerfStop(salPerfCounter* perfCtr);
 u64 salPerfShutdown(salPerfCounter *perfCtr);
 
+// Persistence of the per-EDT performance database (see utils/perf-db.h)
+u64 salPerfDbSize();
+u64 salPerfDbRead(u8 *buffer, u64 size);
+u8 salPerfDbWrite(u8 *buffer, u64 size);
+void salSymbolName(void *fctPtr, char *name, u32 size);
+
 #endif
 
 #ifdef ENABLE_RESILIENCY
+// Checkpoint files and each segment appended to them are page aligned
+#define SAL_CHKPT_ALIGN(size) ((((size) >> 12) + !!((size) & 0xFFFULL)) << 12)
+
 u64 salGetCalTime();
 u8* salCreatePdCheckpoint(char **name, u64 size);
+u8* salExtendPdCheckpoint(char *name, char **newName, u64 size);
 u8* salOpenPdCheckpoint(char *name, u64 *size);
 u8  salClosePdCheckpoint(u8 *buffer, u64 size);
 u8  salRemovePdCheckpoint(char *name);
 u8 salSetPdCheckpoint(char *name);
 char* salGetCheckpointName();
+u64 salGetCheckpointPhase(char *name);
+u64 salGetNextCheckpointPhase();
 bool salCheckpointExists();
 bool salCheckpointExistsResumeQuery();
 #endif
@@ -74,6 +88,7 @@ bool salCheckpointExistsResumeQuery();
 #include "ocr-event.h"
 #include "ocr-datablock.h"
 //Init/Finialize
+void      salSetPublishCodec(u32 codec);
 void      salInitPublishFetch();
 void      salFinalizePublishFetch();
 
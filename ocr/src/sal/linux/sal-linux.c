@@ -13,11 +13,14 @@
 #include "ocr-errors.h"
 
 //Including platform specific headers for fault injection
-#ifdef ENABLE_RESILIENCY
+#if defined(ENABLE_RESILIENCY) || defined(ENABLE_AMT_RESILIENCE)
 #include "policy-domain/hc/hc-policy.h"
+#endif
+#ifdef ENABLE_RESILIENCY
 #include "task/hc/hc-task.h"
 #endif
 #include "utils/hashtable.h"
+#include "utils/chunk-codec.h"
 
 #include <stdio.h>
 #include <stdlib.h>
@@ -35,6 +38,11 @@
 #include <dirent.h>
 #endif
 
+#ifdef ENABLE_EXTENSION_PERF
+#include <dlfcn.h>
+#include "utils/perf-db.h"
+#endif
+
 #ifdef __MACH__
 
 #include <mach/mach_time.h>
@@ -66,36 +74,128 @@ u64 salGetTime(){
 
 #ifdef ENABLE_EXTENSION_PERF
 
-static u64 perfEventOpen(struct perf_event_attr *hw_event)
+static s32 perfEventOpen(struct perf_event_attr *hw_event, s32 groupFd)
 {
-   u64 ret;
+   s32 ret;
 
-   ret = syscall(__NR_perf_event_open, hw_event, 0, -1, -1, 0);
+   ret = syscall(__NR_perf_event_open, hw_event, 0, -1, groupFd, 0);
                                                // pid, cpu, group_perfFd, flags
    return ret;
 }
 
 // FIXME: The following should come from config file
-s32 counter_type[PERF_HW_MAX] = { PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_RAW };
-s32 counter_cfg [PERF_HW_MAX] = { PERF_COUNT_HW_BUS_CYCLES, PERF_COUNT_HW_CACHE_REFERENCES, PERF_COUNT_HW_CACHE_MISSES, 0xf110 };
+// The first counter leads the group: all counters are scheduled together on
+// the PMU and can be read at once
+s32 counter_type[PERF_HW_MAX] = { PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_RAW,
+                                  PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE };
+s32 counter_cfg [PERF_HW_MAX] = { PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_CACHE_REFERENCES, PERF_COUNT_HW_CACHE_MISSES, 0xf110,
+                                  PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_STALLED_CYCLES_BACKEND };
+
+#if defined(__x86_64__) || defined(__i386__)
+static inline u64 perfRdpmc(u32 counter) {
+    u32 low, high;
+    __asm__ __volatile__("rdpmc" : "=a" (low), "=d" (high) : "c" (counter));
+    return low | ((u64)high << 32);
+}
+
+// Reads a counter from user space through its mmap'd page. Returns 0 if
+// the kernel does not let us (counter not on the PMU, rdpmc disabled)
+static u8 perfReadUser(struct perf_event_mmap_page *page, u64 *value) {
+    u32 seq, idx;
+    u64 count;
+    do {
+        seq = page->lock;
+        __asm__ __volatile__("" ::: "memory");
+        idx = page->index;
+        if (!page->cap_user_rdpmc || (idx == 0))
+            return 0;
+        s64 pmc = perfRdpmc(idx - 1);
+        // Sign extend the raw counter to the width of the PMU
+        pmc <<= 64 - page->pmc_width;
+        pmc >>= 64 - page->pmc_width;
+        count = page->offset + pmc;
+        __asm__ __volatile__("" ::: "memory");
+    } while (page->lock != seq);
+    *value = count;
+    return 1;
+}
+#endif
+
+// Reads the current value of all the counters of the group in perfVal.
+// Each counter is read with rdpmc when possible, otherwise the whole group
+// is read with a single read() on the leader
+static void perfReadGroup(salPerfCounter *perfCtr) {
+    u32 i, n = 0;
+#if defined(__x86_64__) || defined(__i386__)
+    for(i = 0; i < PERF_HW_MAX; i++) {
+        if(perfCtr[i].perfFd == -1) {
+            perfCtr[i].perfVal = 0;
+            continue;
+        }
+        if((perfCtr[i].perfPage == NULL) || !perfReadUser(perfCtr[i].perfPage, &perfCtr[i].perfVal))
+            break;
+    }
+    if(i == PERF_HW_MAX)
+        return;
+#endif
+    // Layout of PERF_FORMAT_GROUP: number of counters, then their values in opening order
+    u64 values[PERF_HW_MAX + 1];
+    if(read(perfCtr[0].perfFd, values, sizeof(values)) < (ssize_t)sizeof(u64)) {
+        DPRINTF(DEBUG_LVL_WARN, "Unable to read counter group\n");
+        for(i = 0; i < PERF_HW_MAX; i++) perfCtr[i].perfVal = 0;
+        return;
+    }
+    for(i = 0; i < PERF_HW_MAX; i++) {
+        if(perfCtr[i].perfFd == -1)
+            perfCtr[i].perfVal = 0;
+        else
+            perfCtr[i].perfVal = (n < values[0]) ? values[1 + n++] : 0;
+    }
+}
 
 u64 salPerfInit(salPerfCounter* perfCtr) {
     u32 i;
     u32 retval = 0;
+    long pageSize = sysconf(_SC_PAGESIZE);
 
     for(i = 0; i < PERF_HW_MAX; i++) {
         memset(&perfCtr[i].perfAttr, 0, sizeof(perfCtr[i].perfAttr));
+        perfCtr[i].perfVal = 0;
+        perfCtr[i].perfStart = 0;
+        perfCtr[i].perfPage = NULL;
+        perfCtr[i].perfType = counter_type[i];
+        perfCtr[i].perfConfig = counter_cfg[i];
         perfCtr[i].perfAttr.type = counter_type[i];
         perfCtr[i].perfAttr.size = sizeof(struct perf_event_attr);
         perfCtr[i].perfAttr.config = counter_cfg[i];
-        perfCtr[i].perfAttr.disabled = 1;
+        perfCtr[i].perfAttr.read_format = PERF_FORMAT_GROUP;
+        // Members follow the leader, which is enabled once the group is complete
+        perfCtr[i].perfAttr.disabled = (i == 0);
         perfCtr[i].perfAttr.exclude_kernel = 1;
         perfCtr[i].perfAttr.exclude_hv = 1;
 
-        perfCtr[i].perfFd = perfEventOpen(&perfCtr[i].perfAttr);
+        if((i != 0) && (perfCtr[0].perfFd == -1)) {
+            perfCtr[i].perfFd = -1;
+            continue;
+        }
+        perfCtr[i].perfFd = perfEventOpen(&perfCtr[i].perfAttr, (i == 0) ? -1 : perfCtr[0].perfFd);
         if (perfCtr[i].perfFd == -1) {
             DPRINTF(DEBUG_LVL_WARN, "Error opening counter 0x%"PRIx64"\n", (u64)perfCtr[i].perfAttr.config);
             retval = OCR_EFAULT;
+            continue;
+        }
+        // The first page of the mapping exposes the counter to rdpmc
+        void *page = mmap(NULL, pageSize, PROT_READ, MAP_SHARED, perfCtr[i].perfFd, 0);
+        if(page != MAP_FAILED)
+            perfCtr[i].perfPage = (struct perf_event_mmap_page *)page;
+    }
+
+    // Counters run for the life of the worker; start/stop only take snapshots
+    if(perfCtr[0].perfFd != -1) {
+        if(ioctl(perfCtr[0].perfFd, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP) ||
+           ioctl(perfCtr[0].perfFd, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP)) {
+            DPRINTF(DEBUG_LVL_WARN, "Unable to enable counter group\n");
+            retval = OCR_EFAULT;
         }
     }
 
@@ -104,44 +204,116 @@ u64 salPerfInit(salPerfCounter* perfCtr) {
 
 u64 salPerfStart(salPerfCounter* perfCtr) {
     u32 i;
-    u32 retval = 0;
 
-    for(i = 0; i < PERF_HW_MAX; i++) {
-        retval = ioctl(perfCtr[i].perfFd, PERF_EVENT_IOC_RESET, 0);
-        if(retval) DPRINTF(DEBUG_LVL_WARN, "Unable to reset counter %"PRId32"\n", i);
-        retval = ioctl(perfCtr[i].perfFd, PERF_EVENT_IOC_ENABLE, 0);
-        if(retval) DPRINTF(DEBUG_LVL_WARN, "Unable to enable counter %"PRId32"\n", i);
-    }
+    if(perfCtr[0].perfFd == -1)
+        return OCR_EFAULT;
+    perfReadGroup(perfCtr);
+    for(i = 0; i < PERF_HW_MAX; i++)
+        perfCtr[i].perfStart = perfCtr[i].perfVal;
 
-    return retval;
+    return 0;
 }
 
 u64 salPerfStop(salPerfCounter* perfCtr) {
     u32 i;
-    u32 retval = 0;
 
-    for(i = 0; i < PERF_HW_MAX; i++) {
-        retval = ioctl(perfCtr[i].perfFd, PERF_EVENT_IOC_DISABLE, 0);
-        if(retval) DPRINTF(DEBUG_LVL_WARN, "Unable to disable counter %"PRId32"\n", i);
-        retval = read(perfCtr[i].perfFd, &perfCtr[i].perfVal, sizeof(u64));
-        if(retval < 0) DPRINTF(DEBUG_LVL_WARN, "Unable to read counter %"PRId32"\n", i);
+    if(perfCtr[0].perfFd == -1) {
+        for(i = 0; i < PERF_HW_MAX; i++) perfCtr[i].perfVal = 0;
+        return OCR_EFAULT;
     }
+    perfReadGroup(perfCtr);
+    for(i = 0; i < PERF_HW_MAX; i++)
+        perfCtr[i].perfVal -= perfCtr[i].perfStart;
     // Convert L1_REFERENCES to L1_HITS by subtracting misses
     perfCtr[PERF_L1_HITS].perfVal -= perfCtr[PERF_L1_MISSES].perfVal;
 
-    return retval;
+    return 0;
 }
 
 u64 salPerfShutdown(salPerfCounter *perfCtr) {
     u32 i;
     u32 retval = 0;
+    long pageSize = sysconf(_SC_PAGESIZE);
 
-    for(i = 0; i < PERF_HW_MAX; i++) {
-        close(perfCtr[i].perfFd);
+    // Close the members before the leader
+    for(i = PERF_HW_MAX; i-- > 0;) {
+        if(perfCtr[i].perfPage != NULL)
+            munmap(perfCtr[i].perfPage, pageSize);
+        perfCtr[i].perfPage = NULL;
+        if(perfCtr[i].perfFd != -1)
+            close(perfCtr[i].perfFd);
+        perfCtr[i].perfFd = -1;
     }
     return retval;
 }
 
+static const char* salPerfDbFileName() {
+    const char *name = getenv("OCR_PERF_DB");
+    return (name != NULL) ? name : PERF_DB_FILE;
+}
+
+// Returns the size of the performance database file, 0 if there is none
+u64 salPerfDbSize() {
+    struct stat st;
+    const char *name = salPerfDbFileName();
+    if ((name[0] == '\0') || (stat(name, &st) != 0))
+        return 0;
+    return st.st_size;
+}
+
+u64 salPerfDbRead(u8 *buffer, u64 size) {
+    u64 rd;
+    FILE *file = fopen(salPerfDbFileName(), "rb");
+    if (file == NULL)
+        return 0;
+    rd = fread(buffer, 1, size, file);
+    fclose(file);
+    return rd;
+}
+
+// The database is written to a temporary file that replaces the previous one
+// so that concurrent runs never observe a partial file. Returns OCR_ENOENT
+// when no database file is configured.
+u8 salPerfDbWrite(u8 *buffer, u64 size) {
+    char tmpName[PATH_MAX];
+    const char *name = salPerfDbFileName();
+    FILE *file;
+    if (name[0] == '\0')
+        return OCR_ENOENT;
+    snprintf(tmpName, PATH_MAX, "%s.%"PRIu32".tmp", name, (u32)getpid());
+    file = fopen(tmpName, "wb");
+    if (file == NULL) {
+        DPRINTF(DEBUG_LVL_WARN, "Unable to create %s\n", tmpName);
+        return OCR_EFAULT;
+    }
+    if ((fwrite(buffer, 1, size, file) != size) | (fclose(file) != 0)) {
+        DPRINTF(DEBUG_LVL_WARN, "Unable to write %s\n", tmpName);
+        unlink(tmpName);
+        return OCR_EFAULT;
+    }
+    if (rename(tmpName, name) != 0) {
+        DPRINTF(DEBUG_LVL_WARN, "Unable to rename %s to %s\n", tmpName, name);
+        unlink(tmpName);
+        return OCR_EFAULT;
+    }
+    return 0;
+}
+
+// Names a function by its symbol, or by its offset in its module when
+// the symbol is not exported (dladdr then reports the closest symbol)
+void salSymbolName(void *fctPtr, char *name, u32 size) {
+    Dl_info info;
+    if (dladdr(fctPtr, &info) == 0) {
+        snprintf(name, size, "%p", fctPtr);
+    } else if ((info.dli_sname != NULL) && (info.dli_saddr == fctPtr)) {
+        snprintf(name, size, "%s", info.dli_sname);
+    } else {
+        const char *module = strrchr(info.dli_fname, '/');
+        snprintf(name, size, "%s+0x%"PRIx64, (module != NULL) ? (module + 1) : info.dli_fname,
+                 (u64)fctPtr - (u64)info.dli_fbase);
+    }
+}
+
 #endif
 
 #ifdef ENABLE_RESILIENCY
@@ -301,7 +473,7 @@ u8* salCreatePdCheckpoint(char **name, u64 size) {
         return NULL;
     }
 
-    size = ((size >> 12) + !!(size & 0xFFFULL)) << 12; //Align size to 4096 bytes
+    size = SAL_CHKPT_ALIGN(size);
     if (fd>=0) {
         int rc = ftruncate(fd, size);
         if (rc) {
@@ -323,6 +495,68 @@ u8* salCreatePdCheckpoint(char **name, u64 size) {
     return ptr;
 }
 
+//Append a new segment to an existing checkpoint
+//The extended checkpoint is published under a new name (hard link to the
+//same file) so that the stable name keeps referring to a valid checkpoint
+//until salSetPdCheckpoint() is called on the new one. Segments written past
+//the stable phase are ignored on restart.
+u8* salExtendPdCheckpoint(char *name, char **newName, u64 size) {
+    ASSERT(name && newName);
+
+    if (fdChkpt >= 0) {
+        fprintf(stderr, "Cannot open new checkpoint buffer. Previous buffer has not been closed yet. \n");
+        ASSERT(0);
+        return NULL;
+    }
+
+    struct stat sb;
+    if (stat(name, &sb) == -1) {
+        fprintf(stderr, "stat failed: (filename: %s)\n", name);
+        ASSERT(0);
+        return NULL;
+    }
+    u64 offset = sb.st_size;
+    ASSERT(offset > 0 && offset == SAL_CHKPT_ALIGN(offset));
+
+    ocrPolicyDomain_t *pd;
+    getCurrentEnv(&pd, NULL, NULL, NULL);
+    ocrPolicyDomainHc_t *hcPolicy = (ocrPolicyDomainHc_t*)pd;
+    const char *filename = salConstructPdCheckpointFileName(hcPolicy->calTime, ++chkptPhase, pd->myLocation);
+
+    int rc = link(name, filename);
+    if (rc) {
+        fprintf(stderr, "link failed: (filename: %s target: %s)\n", name, filename);
+        ASSERT(0);
+        return NULL;
+    }
+
+    int fd = open(filename, O_RDWR, S_IRUSR | S_IWUSR );
+    if (fd<0) {
+        fprintf(stderr, "open failed: (filename: %s)\n", filename);
+        ASSERT(0);
+        return NULL;
+    }
+
+    size = SAL_CHKPT_ALIGN(size);
+    rc = ftruncate(fd, offset + size);
+    if (rc) {
+        fprintf(stderr, "ftruncate failed: (filename: %s filedesc: %d)\n", filename, fd);
+        ASSERT(0);
+        return NULL;
+    }
+
+    u8 *ptr = (u8*)mmap( NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, offset );
+    if (ptr == MAP_FAILED) {
+        fprintf(stderr, "mmap failed for size %lu at offset %lu (filename: %s filedesc: %d)\n", size, offset, filename, fd);
+        ASSERT(0);
+        return NULL;
+    }
+
+    *newName = (char*)filename;
+    fdChkpt = fd;
+    return ptr;
+}
+
 //Open a previously closed stable checkpoint
 //salGetCheckpointName() provides the stable checkpoint name
 u8* salOpenPdCheckpoint(char *name, u64 *size) {
@@ -509,6 +743,30 @@ char* salGetCheckpointName() {
     return (char*)chkptFilename;
 }
 
+//Get the phase a checkpoint was written in
+//Checkpoint segments tagged with a later phase are not part of it
+u64 salGetCheckpointPhase(char *name) {
+    ASSERT(name != NULL);
+    if (strlen(name) >= 4096) {
+        ASSERT(0);
+        return 0;
+    }
+    char checkpointStr[4096];
+    strcpy(checkpointStr, name);
+    u64 calTime = 0;
+    u64 phase = 0;
+    u64 loc = 0;
+    int rc = salGetCheckpointNameTokens(checkpointStr, &calTime, &phase, &loc);
+    if (rc != 0)
+        return 0;
+    return phase;
+}
+
+//Get the phase the next checkpoint buffer will be created in
+u64 salGetNextCheckpointPhase() {
+    return chkptPhase + 1;
+}
+
 //Check if any valid checkpoint exists
 static bool salCheckpointExistsInternal(bool doQuery) {
     struct stat sb;
@@ -587,7 +845,7 @@ bool salCheckpointExistsResumeQuery() {
 
 //Publish-Fetch hashtable
 static int pfIsInitialized = 0;
-static hashtable_t * pfTable = NULL;    //Hashtable containing pointers to published data
+static hashtable_t * pfTable = NULL;    //Hashtable indexing published data in the publish log
 static hashtable_t * faultTable = NULL; //Hashtable containing EDT guids which have encountered faults
 static lock_t pfLock;
 static lock_t depLock;
@@ -637,15 +895,427 @@ static volatile u32 salWaiterMaster = 0;
 static u64 lastAdvanceTime = 0UL;
 #define DEADLOCK_TIMEOUT  5000000000UL /* 10 seconds */
 
+/* Log-structured publish store
+ *
+ * Published data-blocks are appended as records to a few large segment files
+ * per location ("<loc>.<seq>.pubseg") instead of one file per data-block:
+ *
+ *   [salPubRecord_t header][payload, padded to 8 bytes]
+ *
+ * The payload is written before the header so that a record only becomes
+ * visible (valid magic) once it is complete. A removal appends a payload-less
+ * tombstone record. pfTable maps a GUID to the segment and offset of its
+ * record; records published by other locations are indexed by scanning their
+ * segments on a lookup miss.
+ *
+ * Durability is provided by a background flusher thread: publishers request
+ * a flush and wait for it, so that concurrent publishers share a single
+ * fdatasync of the dirty segments (group commit). When idle, the flusher
+ * relocates the live records of the oldest sealed segment of this location
+ * if it is mostly dead, and deletes it once it holds no live record.
+ *
+ * When a codec is configured for the policy domain, payloads are stored as
+ * codec streams (utils/chunk-codec.h) and verified when fetched.
+ */
+
+#ifndef SAL_PUB_SEGMENT_SIZE
+#define SAL_PUB_SEGMENT_SIZE         (64ULL << 20) /* Segment rotation threshold (bytes) */
+#endif
+
+#ifndef SAL_PUB_COMPACT_LIVE_PERCENT
+#define SAL_PUB_COMPACT_LIVE_PERCENT 50            /* Compact sealed segments with less live data */
+#endif
+
+#ifndef SAL_PUB_FLUSH_IDLE_NS
+#define SAL_PUB_FLUSH_IDLE_NS        100000000L    /* Flusher compaction period (100 ms) */
+#endif
+
+#define SAL_PUB_MAGIC                0x4f43525055424c53ULL
+#define SAL_PUB_FLAG_TOMBSTONE       0x1
+#define SAL_PUB_FLAG_ENCODED         0x2
+#define SAL_PUB_NO_SEQ               ((u64)-1)
+#define SAL_PUB_ALIGN(size)          (((size) + 7ULL) & ~7ULL)
+#define SAL_PUB_RECORD_SIZE(size)    (sizeof(salPubRecord_t) + SAL_PUB_ALIGN(size))
+
+typedef struct _salPubRecord {
+    u64 magic;              //SAL_PUB_MAGIC once the record is complete
+    u64 key;                //GUID of the published data-block
+    u64 size;               //Stored payload size
+    u64 rawSize;            //Data-block size
+    u64 flags;
+} salPubRecord_t;
+
+typedef struct _salPubSegment {
+    int fd;
+    u64 loc;
+    u64 seq;
+    volatile u64 tail;      //Next free offset (own segments only)
+    volatile u64 live;      //Bytes of records referenced by the index (own segments only)
+    u64 scanned;            //Offset up to which records have been indexed
+    volatile u32 dirty;     //Written since the last flush
+    struct _salPubSegment * volatile next;
+} salPubSegment_t;
+
+typedef struct _salPubEntry {
+    salPubSegment_t *seg;
+    u64 offset;             //Offset of the record header
+    u64 size;               //Data-block size
+    u64 stored;             //Stored payload size
+    u64 flags;
+} salPubEntry_t;
+
+static salPubSegment_t ** pubSegHead = NULL;    //Per-location list of open segments, oldest first
+static salPubSegment_t ** pubSegTail = NULL;    //Per-location newest segment (own: active segment)
+static u64 pubMyLoc = 0;
+static u64 pubNbLocs = 0;
+static u32 pubCodec = PD_HC_CODEC_DISABLED;
+static pthread_rwlock_t pubIndexLock;           //Excludes compaction and removals from readers and writers
+static pthread_mutex_t pubFlushMutex;
+static pthread_cond_t pubFlushCond;
+static pthread_cond_t pubFlushDoneCond;
+static u64 pubFlushRequested = 0;
+static u64 pubFlushDone = 0;
+static u32 pubFlushStop = 0;
+static pthread_t pubFlusher;
+
+static u8 salPubSegmentName(char *fname, u64 loc, u64 seq) {
+    int c = snprintf(fname, FNL, "%lu.%lu.pubseg", loc, seq);
+    if (c < 0 || c >= FNL) {
+        fprintf(stderr, "failed to create filename for publish segment\n");
+        ASSERT(0);
+        return 1;
+    }
+    return 0;
+}
+
+//Open a segment. Returns NULL if a segment of another location does not exist.
+static salPubSegment_t* salPubOpenSegment(u64 loc, u64 seq) {
+    char fname[FNL];
+    salPubSegmentName(fname, loc, seq);
+    bool own = (loc == pubMyLoc);
+    int fd = own ? open(fname, O_RDWR | O_CREAT | O_EXCL, S_IRUSR | S_IWUSR) : open(fname, O_RDONLY);
+    if (fd<0) {
+        if (own) {
+            fprintf(stderr, "open failed: (filename: %s)\n", fname);
+            ASSERT(0);
+        }
+        return NULL;
+    }
+    salPubSegment_t *seg = (salPubSegment_t*)malloc(sizeof(salPubSegment_t));
+    seg->fd = fd;
+    seg->loc = loc;
+    seg->seq = seq;
+    seg->tail = 0;
+    seg->live = 0;
+    seg->scanned = 0;
+    seg->dirty = 0;
+    seg->next = NULL;
+    return seg;
+}
+
+//Lowest segment sequence number of a location still on disk
+static u64 salPubFirstSeq(u64 loc) {
+    u64 first = SAL_PUB_NO_SEQ;
+    DIR *dir = opendir(".");
+    if (dir == NULL)
+        return first;
+    struct dirent *ent;
+    while ((ent = readdir(dir)) != NULL) {
+        u64 l, s;
+        char ext[8];
+        if (sscanf(ent->d_name, "%lu.%lu.%7s", &l, &s, ext) == 3 && strcmp(ext, "pubseg") == 0 &&
+            l == loc && s < first)
+            first = s;
+    }
+    closedir(dir);
+    return first;
+}
+
+//Reserve room for a record in the active segment, rotating it when full
+static salPubSegment_t* salPubReserve(u64 len, u64 *offset) {
+    while (1) {
+        salPubSegment_t *seg = pubSegTail[pubMyLoc];
+        if (seg != NULL) {
+            u64 off = hal_xadd64(&seg->tail, len);
+            //A record larger than a segment gets a segment of its own
+            if ((off + len) <= SAL_PUB_SEGMENT_SIZE || off == 0) {
+                *offset = off;
+                return seg;
+            }
+        }
+        //Segment is sealed: the first thread to get here opens the next one
+        hal_lock(&pfLock);
+        if (pubSegTail[pubMyLoc] == seg) {
+            salPubSegment_t *newSeg = salPubOpenSegment(pubMyLoc, (seg == NULL) ? 0 : (seg->seq + 1));
+            if (seg == NULL) {
+                pubSegHead[pubMyLoc] = newSeg;
+            } else {
+                seg->next = newSeg;
+            }
+            hal_fence();
+            pubSegTail[pubMyLoc] = newSeg;
+        }
+        hal_unlock(&pfLock);
+    }
+}
+
+static u8 salPubWrite(int fd, const void *buf, u64 size, u64 offset) {
+    const u8 *ptr = (const u8*)buf;
+    while (size > 0) {
+        ssize_t rc = pwrite(fd, ptr, size, offset);
+        if (rc <= 0) {
+            fprintf(stderr, "pwrite failed: (filedesc: %d size: %lu offset: %lu)\n", fd, size, offset);
+            ASSERT(0);
+            return 1;
+        }
+        ptr += rc; size -= rc; offset += rc;
+    }
+    return 0;
+}
+
+static u8 salPubRead(int fd, void *buf, u64 size, u64 offset) {
+    u8 *ptr = (u8*)buf;
+    while (size > 0) {
+        ssize_t rc = pread(fd, ptr, size, offset);
+        if (rc <= 0)
+            return 1;
+        ptr += rc; size -= rc; offset += rc;
+    }
+    return 0;
+}
+
+//Append a record to the active segment and return its segment and offset
+static salPubSegment_t* salPubAppend(u64 key, const void *ptr, u64 size, u64 rawSize, u64 flags, u64 *offset) {
+    salPubSegment_t *seg = salPubReserve(SAL_PUB_RECORD_SIZE(size), offset);
+    if (size > 0)
+        salPubWrite(seg->fd, ptr, size, *offset + sizeof(salPubRecord_t));
+    salPubRecord_t rec = {.magic = SAL_PUB_MAGIC, .key = key, .size = size, .rawSize = rawSize, .flags = flags};
+    salPubWrite(seg->fd, &rec, sizeof(salPubRecord_t), *offset);
+    seg->dirty = 1;
+    return seg;
+}
+
+//Group commit: wait until a flush started after this call has completed
+static void salPubCommit() {
+    pthread_mutex_lock(&pubFlushMutex);
+    u64 ticket = ++pubFlushRequested;
+    pthread_cond_signal(&pubFlushCond);
+    while (pubFlushDone < ticket)
+        pthread_cond_wait(&pubFlushDoneCond, &pubFlushMutex);
+    pthread_mutex_unlock(&pubFlushMutex);
+}
+
+//Index the complete records of a segment from the last scanned offset
+//Must be called with pubIndexLock held for writing
+static void salPubScanSegment(ocrPolicyDomain_t *pd, salPubSegment_t *seg) {
+    salPubRecord_t rec;
+    while (salPubRead(seg->fd, &rec, sizeof(salPubRecord_t), seg->scanned) == 0 && rec.magic == SAL_PUB_MAGIC) {
+        salPubEntry_t *entry = (salPubEntry_t*)hashtableConcBucketLockedGet(pfTable, (void*)rec.key);
+        if (rec.flags & SAL_PUB_FLAG_TOMBSTONE) {
+            if (entry != NULL) {
+                hashtableConcBucketLockedRemove(pfTable, (void*)rec.key, NULL);
+                pd->fcts.pdFree(pd, entry);
+            }
+        } else {
+            if (entry == NULL) {
+                entry = (salPubEntry_t*)pd->fcts.pdMalloc(pd, sizeof(salPubEntry_t));
+                hashtableConcBucketLockedPut(pfTable, (void*)rec.key, entry);
+            }
+            //Later records supersede earlier ones (relocated copies)
+            entry->seg = seg;
+            entry->offset = seg->scanned;
+            entry->size = rec.rawSize;
+            entry->stored = rec.size;
+            entry->flags = rec.flags;
+        }
+        seg->scanned += SAL_PUB_RECORD_SIZE(rec.size);
+    }
+}
+
+//Index the records appended by the other locations since the last scan
+static void salPubRescan(ocrPolicyDomain_t *pd) {
+    pthread_rwlock_wrlock(&pubIndexLock);
+    u64 loc;
+    for (loc = 0; loc < pubNbLocs; loc++) {
+        if (loc == pubMyLoc)
+            continue;
+        salPubSegment_t *seg = pubSegTail[loc];
+        if (seg == NULL) {
+            //Older segments may already have been compacted away
+            u64 seq = salPubFirstSeq(loc);
+            if (seq == SAL_PUB_NO_SEQ || (seg = salPubOpenSegment(loc, seq)) == NULL)
+                continue;
+            pubSegHead[loc] = pubSegTail[loc] = seg;
+        }
+        while (seg != NULL) {
+            salPubScanSegment(pd, seg);
+            salPubSegment_t *next = salPubOpenSegment(loc, seg->seq + 1);
+            if (next != NULL) {
+                seg->next = next;
+                pubSegTail[loc] = next;
+            }
+            seg = next;
+        }
+    }
+    pthread_rwlock_unlock(&pubIndexLock);
+}
+
+//Relocate the live records of a sealed segment to the active segment
+//Must be called with pubIndexLock held for writing
+static void salPubRelocate(salPubSegment_t *seg) {
+    u64 offset = 0;
+    void *buf = NULL;
+    u64 bufSize = 0;
+    salPubRecord_t rec;
+    while (seg->live > 0 && salPubRead(seg->fd, &rec, sizeof(salPubRecord_t), offset) == 0 && rec.magic == SAL_PUB_MAGIC) {
+        u64 len = SAL_PUB_RECORD_SIZE(rec.size);
+        salPubEntry_t *entry = (salPubEntry_t*)hashtableConcBucketLockedGet(pfTable, (void*)rec.key);
+        if (!(rec.flags & SAL_PUB_FLAG_TOMBSTONE) && entry != NULL && entry->seg == seg && entry->offset == offset) {
+            if (bufSize < rec.size) {
+                free(buf);
+                buf = malloc(rec.size);
+                bufSize = rec.size;
+            }
+            salPubRead(seg->fd, buf, rec.size, offset + sizeof(salPubRecord_t));
+            u64 newOffset;
+            salPubSegment_t *newSeg = salPubAppend(rec.key, buf, rec.size, rec.rawSize, rec.flags, &newOffset);
+            hal_xadd64(&newSeg->live, len);
+            hal_xadd64(&seg->live, -len);
+            entry->seg = newSeg;
+            entry->offset = newOffset;
+        }
+        offset += len;
+    }
+    free(buf);
+}
+
+//Compact the oldest sealed segment of this location. Segments are deleted
+//oldest first so that a tombstone always outlives the record it cancels.
+static void salPubCompact() {
+    salPubSegment_t *seg = pubSegHead[pubMyLoc];
+    if (seg == NULL || seg == pubSegTail[pubMyLoc])
+        return;
+    if (seg->live > 0 && (seg->live * 100) >= (seg->tail * SAL_PUB_COMPACT_LIVE_PERCENT))
+        return;
+
+    pthread_rwlock_wrlock(&pubIndexLock);
+    if (seg->live > 0) {
+        salPubRelocate(seg);
+        //Relocated copies must be durable before the originals go away
+        salPubSegment_t *cur;
+        for (cur = seg->next; cur != NULL; cur = cur->next) {
+            if (cur->dirty) {
+                cur->dirty = 0;
+                fdatasync(cur->fd);
+            }
+        }
+    }
+    if (seg->live == 0) {
+        char fname[FNL];
+        pubSegHead[pubMyLoc] = seg->next;
+        close(seg->fd);
+        if (salPubSegmentName(fname, seg->loc, seg->seq) == 0)
+            unlink(fname);
+        free(seg);
+    }
+    pthread_rwlock_unlock(&pubIndexLock);
+}
+
+static void* salPubFlusherRoutine(void *arg) {
+    pthread_mutex_lock(&pubFlushMutex);
+    while (!pubFlushStop) {
+        if (pubFlushDone == pubFlushRequested) {
+            struct timespec ts;
+            clock_gettime(CLOCK_REALTIME, &ts);
+            ts.tv_nsec += SAL_PUB_FLUSH_IDLE_NS;
+            ts.tv_sec += ts.tv_nsec / 1000000000L;
+            ts.tv_nsec %= 1000000000L;
+            if (pthread_cond_timedwait(&pubFlushCond, &pubFlushMutex, &ts) != 0 &&
+                pubFlushDone == pubFlushRequested && !pubFlushStop) {
+                pthread_mutex_unlock(&pubFlushMutex);
+                salPubCompact();
+                pthread_mutex_lock(&pubFlushMutex);
+            }
+            continue;
+        }
+        //Every publisher that requested a flush so far has completed its writes
+        u64 target = pubFlushRequested;
+        pthread_mutex_unlock(&pubFlushMutex);
+        salPubSegment_t *seg;
+        for (seg = pubSegHead[pubMyLoc]; seg != NULL; seg = seg->next) {
+            if (seg->dirty) {
+                seg->dirty = 0;
+                if (fdatasync(seg->fd)) {
+                    fprintf(stderr, "fdatasync failed: (filedesc: %d)\n", seg->fd);
+                    ASSERT(0);
+                }
+            }
+        }
+        pthread_mutex_lock(&pubFlushMutex);
+        pubFlushDone = target;
+        pthread_cond_broadcast(&pubFlushDoneCond);
+    }
+    pthread_mutex_unlock(&pubFlushMutex);
+    return NULL;
+}
+
+static void salPubInit(ocrPolicyDomain_t *pd) {
+    pubMyLoc = (u64)pd->myLocation;
+    pubNbLocs = pd->neighborCount + 1;
+    pubSegHead = (salPubSegment_t**)calloc(pubNbLocs, sizeof(salPubSegment_t*));
+    pubSegTail = (salPubSegment_t**)calloc(pubNbLocs, sizeof(salPubSegment_t*));
+    pthread_rwlock_init(&pubIndexLock, NULL);
+    pthread_mutex_init(&pubFlushMutex, NULL);
+    pthread_cond_init(&pubFlushCond, NULL);
+    pthread_cond_init(&pubFlushDoneCond, NULL);
+    pubFlushRequested = 0;
+    pubFlushDone = 0;
+    pubFlushStop = 0;
+    //The active segment is created on first publish, after the startup cleanup
+    int rc = pthread_create(&pubFlusher, NULL, salPubFlusherRoutine, NULL);
+    if (rc) {
+        fprintf(stderr, "pthread_create failed for the publish flusher\n");
+        ASSERT(0);
+    }
+}
+
+static void salPubFinalize() {
+    pthread_mutex_lock(&pubFlushMutex);
+    pubFlushStop = 1;
+    pthread_cond_signal(&pubFlushCond);
+    pthread_mutex_unlock(&pubFlushMutex);
+    pthread_join(pubFlusher, NULL);
+    u64 loc;
+    for (loc = 0; loc < pubNbLocs; loc++) {
+        salPubSegment_t *seg = pubSegHead[loc];
+        while (seg != NULL) {
+            salPubSegment_t *next = seg->next;
+            if (seg->dirty) fdatasync(seg->fd);
+            close(seg->fd);
+            free(seg);
+            seg = next;
+        }
+    }
+    free(pubSegHead);
+    free(pubSegTail);
+    pubSegHead = pubSegTail = NULL;
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 //////////////////////////////  Init/Destroy Functions  ///////////////////////
 ///////////////////////////////////////////////////////////////////////////////
 
+//Set by the policy domain before salInitPublishFetch
+void salSetPublishCodec(u32 codec) {
+    pubCodec = codec;
+}
+
 //Initialize the hashtable
 void salInitPublishFetch() {
     ocrPolicyDomain_t *pd;
     getCurrentEnv(&pd, NULL, NULL, NULL);
     pfTable = newHashtableBucketLockedModulo(pd, RECORD_INCR_SIZE);
+    salPubInit(pd);
     faultTable = newHashtableBucketLockedModulo(pd, RECORD_INCR_SIZE);
     pfLock = INIT_LOCK;
     depLock = INIT_LOCK;
@@ -657,6 +1327,7 @@ void salInitPublishFetch() {
 
 void salFinalizePublishFetch() {
     ASSERT(pfIsInitialized);
+    salPubFinalize();
 }
 
 
@@ -664,105 +1335,119 @@ void salFinalizePublishFetch() {
 ///////////////////////////////////////////  Static Utility Functions  /////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-//Publish the guid and insert the ptr to the hashtable
-static u8 salPublishData(char *fname, u64 key, void *ptr, u64 size) {
-    struct stat sb;
-    if (stat(fname, &sb) == 0) {
-        fprintf(stderr, "Found existing file %s during publish!\n", fname);
-        ASSERT(0);
-        return 1;
-    }
-
-    int fd = open(fname, O_RDWR | O_CREAT, S_IRUSR | S_IWUSR );
-    if (fd<0) {
-        fprintf(stderr, "open failed: (filename: %s)\n", fname);
+//Append the data to the publish log, index it and wait for it to be durable
+static u8 salPublishData(u64 key, void *ptr, u64 size) {
+    ocrPolicyDomain_t *pd;
+    getCurrentEnv(&pd, NULL, NULL, NULL);
+    if (hashtableConcBucketLockedGet(pfTable, (void*)key) != NULL) {
+        fprintf(stderr, "Found existing buffer for guid [0x%lx] during publish!\n", key);
         ASSERT(0);
         return 1;
     }
+    salPubEntry_t *entry = (salPubEntry_t*)pd->fcts.pdMalloc(pd, sizeof(salPubEntry_t));
+    entry->size = size;
+    entry->stored = size;
+    entry->flags = 0;
 
-    int rc = ftruncate(fd, size);
-    if (rc) {
-        fprintf(stderr, "ftruncate failed: (filename: %s filedesc: %d)\n", fname, fd);
-        ASSERT(0);
-        return 1;
+    //Encode outside of the index lock
+    void *stream = NULL;
+    if (pubCodec != PD_HC_CODEC_DISABLED) {
+        stream = malloc(codecMaxEncodedSize(size, CODEC_CHUNK_SIZE));
+        entry->stored = codecEncode(pubCodec, (u8*)ptr, size, (u8*)stream);
+        entry->flags = SAL_PUB_FLAG_ENCODED;
     }
 
-    //TODO: Cleanup
-    void *buf = mmap( NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0 );
-    if (buf == MAP_FAILED) {
-        fprintf(stderr, "mmap failed for size %lu (filename: %s filedesc: %d)\n", size, fname, fd);
-        ASSERT(0);
-        return 1;
-    }
+    pthread_rwlock_rdlock(&pubIndexLock);
+    entry->seg = salPubAppend(key, (stream != NULL) ? stream : ptr, entry->stored, size, entry->flags, &entry->offset);
+    hal_xadd64(&entry->seg->live, SAL_PUB_RECORD_SIZE(entry->stored));
+    hashtableConcBucketLockedPut(pfTable, (void*)key, entry);
+    pthread_rwlock_unlock(&pubIndexLock);
+    free(stream);
 
-    memcpy(buf, ptr, size);
+    salPubCommit();
+    return 0;
+}
 
-    rc = msync(buf, size, MS_INVALIDATE | MS_SYNC);
-    if (rc) {
-        fprintf(stderr, "msync failed for buffer %p of size %lu\n", buf, size);
-        ASSERT(0);
-        return 1;
+//Get the size of published data. Returns 0 if found.
+static u8 salLookupData(u64 key, u64 *size) {
+    u8 i;
+    for (i = 0; i < 2; i++) {
+        pthread_rwlock_rdlock(&pubIndexLock);
+        salPubEntry_t *entry = (salPubEntry_t*)hashtableConcBucketLockedGet(pfTable, (void*)key);
+        if (entry != NULL) *size = entry->size;
+        pthread_rwlock_unlock(&pubIndexLock);
+        if (entry != NULL)
+            return 0;
+        if (i == 0) {
+            //Not published here: look for it in the logs of the other locations
+            ocrPolicyDomain_t *pd;
+            getCurrentEnv(&pd, NULL, NULL, NULL);
+            salPubRescan(pd);
+        }
     }
+    return 1;
+}
 
-    if (hashtableConcBucketLockedGet(pfTable, (void*)key) != NULL) {
-        fprintf(stderr, "Found existing buffer for guid [0x%lx] during publish!\n", key);
-        ASSERT(0);
-        return 1;
+//Read published data through the index
+static u8 salFetchData(u64 key, void *ptr, u64 size) {
+    u64 pubSize = 0;
+    if (salLookupData(key, &pubSize)) {
+        fprintf(stderr, "Cannot find published data for guid [0x%lx] during fetch!\n", key);
+        ASSERT(0);
+        return 1;
+    }
+    ASSERT(size <= pubSize);
+    pthread_rwlock_rdlock(&pubIndexLock);
+    salPubEntry_t *entry = (salPubEntry_t*)hashtableConcBucketLockedGet(pfTable, (void*)key);
+    ASSERT(entry != NULL);
+    u8 rc = 0;
+    if (entry->flags & SAL_PUB_FLAG_ENCODED) {
+        u64 stored = entry->stored;
+        u8 *stream = (u8*)malloc(stored);
+        rc = salPubRead(entry->seg->fd, stream, stored, entry->offset + sizeof(salPubRecord_t));
+        pthread_rwlock_unlock(&pubIndexLock);
+        if (rc == 0) {
+            u8 *raw = (size == pubSize) ? (u8*)ptr : (u8*)malloc(pubSize);
+            rc = codecDecode(stream, stored, raw);
+            if (raw != ptr) {
+                memcpy(ptr, raw, size);
+                free(raw);
+            }
+            free(stream);
+            if (rc) {
+                fprintf(stderr, "Corrupted published data for guid [0x%lx] during fetch!\n", key);
+                ASSERT(0);
+                return 1;
+            }
+            return 0;
+        }
+        free(stream);
+    } else {
+        rc = salPubRead(entry->seg->fd, ptr, size, entry->offset + sizeof(salPubRecord_t));
+        pthread_rwlock_unlock(&pubIndexLock);
     }
-    hashtableConcBucketLockedPut(pfTable, (void*)key, buf);
-
-    rc = close(fd);
     if (rc) {
-        fprintf(stderr, "close failed: (filedesc: %d)\n", fd);
+        fprintf(stderr, "pread failed for guid [0x%lx] during fetch!\n", key);
         ASSERT(0);
         return 1;
     }
-
     return 0;
 }
 
-//Read from hashtable ptr. If not found, then from exisiting metadata file.
-static u8 salFetchData(char *fname, u64 key, void *ptr, u64 size) {
-    void* buf = hashtableConcBucketLockedGet(pfTable, (void*)key);
-    if (buf != NULL) {
-        memcpy(ptr, buf, size);
-        return 0;
-    }
-
-    hal_lock(&pfLock);
-
-    buf = hashtableConcBucketLockedGet(pfTable, (void*)key);
-    if (buf == NULL) {
-        struct stat sb;
-        if (stat(fname, &sb) != 0) {
-            fprintf(stderr, "Cannot find existing file %s during fetch!\n", fname);
-            ASSERT(0);
-            return 1;
-        }
-        int fd = open(fname, O_RDWR);
-        if (fd<0) {
-            fprintf(stderr, "open failed: (filename: %s)\n", fname);
-            ASSERT(0);
-            return 1;
-        }
-        buf = mmap( NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0 );
-        if (buf == MAP_FAILED) {
-            fprintf(stderr, "mmap failed for size %lu (filename: %s filedesc: %d)\n", size, fname, fd);
-            ASSERT(0);
-            return 1;
-        }
-        hashtableConcBucketLockedPut(pfTable, (void*)key, buf);
-        int rc = close(fd);
-        if (rc) {
-            fprintf(stderr, "close failed: (filedesc: %d)\n", fd);
-            ASSERT(0);
-            return 1;
-        }
-    }
-
-    hal_unlock(&pfLock);
-
-    memcpy(ptr, buf, size);
+//Drop published data. The removal is logged so that a rescan does not resurrect it.
+static u8 salRemoveData(u64 key) {
+    ocrPolicyDomain_t *pd;
+    getCurrentEnv(&pd, NULL, NULL, NULL);
+    salPubEntry_t *entry = NULL;
+    pthread_rwlock_wrlock(&pubIndexLock);
+    hashtableConcBucketLockedRemove(pfTable, (void*)key, (void**)&entry);
+    if (entry != NULL && entry->seg->loc == pubMyLoc)
+        hal_xadd64(&entry->seg->live, -SAL_PUB_RECORD_SIZE(entry->stored));
+    u64 offset;
+    salPubAppend(key, NULL, 0, 0, SAL_PUB_FLAG_TOMBSTONE, &offset);
+    pthread_rwlock_unlock(&pubIndexLock);
+    if (entry != NULL)
+        pd->fcts.pdFree(pd, entry);
     return 0;
 }
 
@@ -1271,6 +1956,7 @@ static u8 salResilientEdtSatisfy(salWaiter_t *waiter) {
     ASSERT(worker->curTask == NULL);
     ASSERT(worker->jmpbuf == NULL);
     int blockedContexts = worker->blockedContexts;
+    u32 readyBatchDepth = worker->readyBatchDepth;
     hal_fence();
     jmp_buf buf;
     int rc = setjmp(buf);
@@ -1283,6 +1969,7 @@ static u8 salResilientEdtSatisfy(salWaiter_t *waiter) {
     } else {
         DPRINTF(DEBUG_LVL_WARN, "Worker aborted scheduling EDT "GUIDF"\n", GUIDA(waiter->guid));
         ASSERT(worker->blockedContexts == blockedContexts);
+        worker->readyBatchDepth = readyBatchDepth; // Close the batching scopes the abort jumped out of
     }
     hal_fence();
     waiter->status = WAITER_DONE;
@@ -1982,14 +2669,7 @@ u8 salResilientGuidRemove(ocrGuid_t guid) {
     ocrGuidKind kind;
     pd->guidProviders[0]->fcts.getKind(pd->guidProviders[0], guid, &kind);
     if (kind == OCR_GUID_DB) {
-        char dname[FNL];
-        int c = snprintf(dname, FNL, "%lu.db", g);
-        if (c < 0 || c >= FNL) {
-            fprintf(stderr, "failed to create filename for publish\n");
-            ASSERT(0);
-            return 1;
-        }
-        unlink(dname);
+        salRemoveData(g);
     } else if (kind == OCR_GUID_EDT) {
         char ename[FNL];
         int c = snprintf(ename, FNL, "%lu.edt", g);
@@ -2051,7 +2731,7 @@ u8 salResilientRecordDestroyGuids(ocrGuid_t pguid, ocrGuid_t *guidArray, u32 cou
 //dumped during a fault
 u8 salResilientGuidCleanup() {
     char command[FNL];
-    int c = snprintf(command, FNL, "rm -f *.guid *.key *.sig *.api *.new *.old *.db *.edt *.root *.destroy *.fault *.node* *.dep*");
+    int c = snprintf(command, FNL, "rm -f *.guid *.key *.sig *.api *.new *.old *.pubseg *.edt *.root *.destroy *.fault *.node* *.dep*");
     if (c < 0 || c >= FNL) {
         fprintf(stderr, "failed to create filename for publish\n");
         ASSERT(0);
@@ -2084,14 +2764,7 @@ u8 salResilientDataBlockPublish(ocrDataBlock_t *db) {
 #error Unknown type of GUID
 #endif
     //Publish DB contents
-    char fname[FNL];
-    int c = snprintf(fname, FNL, "%lu.db", g);
-    if (c < 0 || c >= FNL) {
-        fprintf(stderr, "failed to create filename for publish\n");
-        ASSERT(0);
-        return 1;
-    }
-    salPublishData(fname, g, db->ptr, db->size);
+    salPublishData(g, db->ptr, db->size);
 
     hal_fence();
 
@@ -2128,22 +2801,14 @@ void* salResilientDataBlockFetch(ocrGuid_t guid, u64 *gSize) {
 #else
 #error Unknown type of GUID
 #endif
-    char fname[FNL];
-    int c = snprintf(fname, FNL, "%lu.db", g);
-    if (c < 0 || c >= FNL) {
-        fprintf(stderr, "failed to create filename for fetch\n");
-        ASSERT(0);
-        return NULL;
-    }
-    struct stat sb;
-    if (stat(fname, &sb) != 0) {
+    u64 size = 0;
+    if (salLookupData(g, &size) != 0) {
         DPRINTF(DEBUG_LVL_WARN, "Cannot fetch DB "GUIDF": (data-block is not yet published)\n", GUIDA(guid));
         return NULL;
     }
     ASSERT(salIsSatisfiedResilientGuid(guid));
-    u64 size = sb.st_size;
     void *buf = pd->fcts.pdMalloc(pd, size);
-    RESULT_ASSERT(salFetchData(fname, g, buf, size), ==, 0);
+    RESULT_ASSERT(salFetchData(g, buf, size), ==, 0);
     if (gSize) *gSize = size;
     return buf;
 }
@@ -17,7 +17,10 @@
 #include "ocr-sysboot.h"
 #include "ocr-workpile.h"
 #include "ocr-scheduler-object.h"
+#include "ocr-datablock.h"
 #include "scheduler-heuristic/hc/hc-scheduler-heuristic.h"
+#include "scheduler-object/wst/wst-scheduler-object.h"
+#include "task/hc/hc-task.h"
 
 #define DEBUG_TYPE SCHEDULER_HEURISTIC
 
@@ -35,6 +38,12 @@
 ocrSchedulerHeuristic_t* newSchedulerHeuristicHc(ocrSchedulerHeuristicFactory_t * factory, ocrParamList_t *perInstance) {
     ocrSchedulerHeuristic_t* self = (ocrSchedulerHeuristic_t*) runtimeChunkAlloc(sizeof(ocrSchedulerHeuristicHc_t), PERSISTENT_CHUNK);
     initializeSchedulerHeuristicOcr(factory, self, perInstance);
+    self->notifyBatch = true;
+    ocrSchedulerHeuristicHc_t *dself = (ocrSchedulerHeuristicHc_t*)self;
+    dself->dbAffinity = ((paramListSchedulerHeuristicHc_t*)perInstance)->dbAffinity;
+    // DB affinity places each ready EDT itself, the inline slot would bypass it
+    self->notifyInline = !dself->dbAffinity;
+    dself->numaSteal = false;
     return self;
 }
 
@@ -47,6 +56,7 @@ static void initializeContextHc(ocrSchedulerHeuristicContext_t *context, u64 con
     ocrSchedulerHeuristicContextHc_t *hcContext = (ocrSchedulerHeuristicContextHc_t*)context;
     hcContext->stealSchedulerObjectIndex = ((u64)-1);
     hcContext->mySchedulerObject = NULL;
+    hcContext->numaDomain = 0;
     return;
 }
 
@@ -117,6 +127,22 @@ u8 hcSchedulerHeuristicSwitchRunlevel(ocrSchedulerHeuristic_t *self, ocrPolicyDo
                 ASSERT(hcContext->mySchedulerObject);
                 hcContext->stealSchedulerObjectIndex = (i + 1) % self->contextCount;
             }
+            ocrSchedulerHeuristicHc_t *dself = (ocrSchedulerHeuristicHc_t*)self;
+            for (i = 0; i < PD->workerCount; i++) {
+                ocrWorker_t *worker = PD->workers[i];
+                ASSERT(worker->id < self->contextCount);
+                ocrSchedulerHeuristicContextHc_t *hcContext = (ocrSchedulerHeuristicContextHc_t*)self->contexts[worker->id];
+                hcContext->numaDomain = worker->numaDomain;
+                if (worker->numaDomain != PD->workers[0]->numaDomain)
+                    dself->numaSteal = true;
+            }
+#ifdef OCR_ASSERT
+            // DB affinity pushes onto other workers' deques: work-stealing deques do not allow it
+            if (((ocrSchedulerHeuristicHc_t*)self)->dbAffinity) {
+                ASSERT(rootFact->kind == OCR_SCHEDULER_OBJECT_WST);
+                ASSERT(((ocrSchedulerObjectWst_t*)rootObj)->config == SCHEDULER_OBJECT_WST_CONFIG_LOCKED);
+            }
+#endif
         }
         break;
     }
@@ -164,6 +190,7 @@ static u8 hcSchedulerHeuristicGetEdt(ocrSchedulerHeuristic_t *self, ocrScheduler
 
     //If pop fails, then try to steal from other deques
     if (ocrGuidIsNull(edtObj.guid.guid)) {
+        u64 stealAttempts = 1;
 
         //First try to steal from the last deque that was visited (probably had a successful steal)
         ocrSchedulerObject_t *stealSchedulerObject = ((ocrSchedulerHeuristicContextHc_t*)self->contexts[hcContext->stealSchedulerObjectIndex])->mySchedulerObject;
@@ -173,16 +200,33 @@ static u8 hcSchedulerHeuristicGetEdt(ocrSchedulerHeuristic_t *self, ocrScheduler
         //If cached steal failed, then restart steal loop from starting index
         ocrSchedulerObject_t *rootObj = self->scheduler->rootObj;
         ocrSchedulerObjectFactory_t *sFact = self->scheduler->pd->schedulerObjectFactories[rootObj->fctId];
+        // Across NUMA domains, a first pass only visits the deques of the same domain
+        u32 passCount = ((ocrSchedulerHeuristicHc_t*)self)->numaSteal ? 2 : 1;
         while (ocrGuidIsNull(edtObj.guid.guid) && sFact->fcts.count(sFact, rootObj, countProp) != 0) {
-            u32 i;
-            for (i = 1; ocrGuidIsNull(edtObj.guid.guid) && i < self->contextCount; i++) {
-                hcContext->stealSchedulerObjectIndex = (context->id + i) % self->contextCount; //simple round robin stealing
-                stealSchedulerObject = ((ocrSchedulerHeuristicContextHc_t*)self->contexts[hcContext->stealSchedulerObjectIndex])->mySchedulerObject;
-                if (stealSchedulerObject){
-                    retVal = fact->fcts.remove(fact, stealSchedulerObject, kind, 1, &edtObj, NULL, SCHEDULER_OBJECT_REMOVE_HEAD);
+            u32 i, pass;
+            for (pass = 0; ocrGuidIsNull(edtObj.guid.guid) && pass < passCount; pass++) {
+                for (i = 1; ocrGuidIsNull(edtObj.guid.guid) && i < self->contextCount; i++) {
+                    u64 victim = (context->id + i) % self->contextCount; //simple round robin stealing
+                    ocrSchedulerHeuristicContextHc_t *victimContext = (ocrSchedulerHeuristicContextHc_t*)self->contexts[victim];
+                    if ((passCount > 1) && ((victimContext->numaDomain == hcContext->numaDomain) != (pass == 0)))
+                        continue;
+                    hcContext->stealSchedulerObjectIndex = victim;
+                    stealSchedulerObject = victimContext->mySchedulerObject;
+                    if (stealSchedulerObject){
+                        retVal = fact->fcts.remove(fact, stealSchedulerObject, kind, 1, &edtObj, NULL, SCHEDULER_OBJECT_REMOVE_HEAD);
+                        stealAttempts++;
+                    }
                 }
             }
         }
+
+        ocrWorker_t *worker = NULL;
+        getCurrentEnv(NULL, &worker, NULL, NULL);
+        if (worker != NULL) {
+            RT_WORKER_COUNTER_ADD(worker, RT_COUNTER_STEALS_ATTEMPTED, stealAttempts);
+            if (!(ocrGuidIsNull(edtObj.guid.guid)))
+                RT_WORKER_COUNTER_ADD(worker, RT_COUNTER_STEALS_SUCCESSFUL, 1);
+        }
     }
 
     if (!(ocrGuidIsNull(edtObj.guid.guid))){
@@ -270,8 +314,63 @@ u8 hcSchedulerHeuristicGetWorkSimulate(ocrSchedulerHeuristic_t *self, ocrSchedul
     return OCR_ENOTSUP;
 }
 
+/* DB affinity mode: the context of the worker that last wrote more than
+ * half of the EDT's DB bytes, unless its deque is already loaded well
+ * beyond the current worker's one. Otherwise the current context. */
+static ocrSchedulerHeuristicContext_t* hcSchedulerHeuristicDbAffinityContext(ocrSchedulerHeuristic_t *self, ocrSchedulerHeuristicContext_t *context, ocrTask_t *task) {
+    if ((task->depc == 0) || ((task->flags & OCR_TASK_FLAG_RUNTIME_EDT) != 0))
+        return context;
+    ocrPolicyDomain_t *pd = self->scheduler->pd;
+    ocrEdtDep_t *depv = ((ocrTaskHc_t*)task)->resolvedDeps;
+    ASSERT(depv);
+    // Weighted majority vote: finds the writer of more than half of the
+    // bytes in one pass if there is one, the second pass checks it
+    u32 candidate = ((u32)-1);
+    u64 weight = 0, total = 0, owned = 0;
+    u32 i;
+    for (i = 0; i < task->depc; i++) {
+        if (ocrGuidIsNull(depv[i].guid)) continue;
+        ocrDataBlock_t *db = NULL;
+        pd->guidProviders[0]->fcts.getVal(pd->guidProviders[0], depv[i].guid, (u64*)(&db), NULL, MD_LOCAL, NULL);
+        if (db == NULL) continue;
+        total += db->size;
+        if (db->lastWriter == candidate) {
+            weight += db->size;
+        } else if (weight >= db->size) {
+            weight -= db->size;
+        } else {
+            candidate = db->lastWriter;
+            weight = db->size - weight;
+        }
+    }
+    if ((candidate >= self->contextCount) || (candidate == context->id))
+        return context;
+    for (i = 0; i < task->depc; i++) {
+        if (ocrGuidIsNull(depv[i].guid)) continue;
+        ocrDataBlock_t *db = NULL;
+        pd->guidProviders[0]->fcts.getVal(pd->guidProviders[0], depv[i].guid, (u64*)(&db), NULL, MD_LOCAL, NULL);
+        if ((db != NULL) && (db->lastWriter == candidate))
+            owned += db->size;
+    }
+    if ((owned * 2) <= total)
+        return context;
+
+    ocrSchedulerObject_t *mySchedObj = ((ocrSchedulerHeuristicContextHc_t*)context)->mySchedulerObject;
+    ocrSchedulerObject_t *targetSchedObj = ((ocrSchedulerHeuristicContextHc_t*)self->contexts[candidate])->mySchedulerObject;
+    ocrSchedulerObjectFactory_t *fact = pd->schedulerObjectFactories[mySchedObj->fctId];
+    u64 myLoad = fact->fcts.count(fact, mySchedObj, SCHEDULER_OBJECT_COUNT_EDT);
+    u64 targetLoad = fact->fcts.count(fact, targetSchedObj, SCHEDULER_OBJECT_COUNT_EDT);
+    if (targetLoad > (myLoad + HC_DB_AFFINITY_IMBALANCE_MAX))
+        return context;
+    return self->contexts[candidate];
+}
+
 static u8 hcSchedulerHeuristicNotifyEdtReadyInvoke(ocrSchedulerHeuristic_t *self, ocrSchedulerHeuristicContext_t *context, ocrSchedulerOpArgs_t *opArgs, ocrRuntimeHint_t *hints) {
     ocrSchedulerOpNotifyArgs_t *notifyArgs = (ocrSchedulerOpNotifyArgs_t*)opArgs;
+    if (((ocrSchedulerHeuristicHc_t*)self)->dbAffinity) {
+        ocrTask_t *task = (ocrTask_t*)notifyArgs->OCR_SCHED_ARG_FIELD(OCR_SCHED_NOTIFY_EDT_READY).guid.metaDataPtr;
+        context = hcSchedulerHeuristicDbAffinityContext(self, context, task);
+    }
     ocrSchedulerHeuristicContextHc_t *hcContext = (ocrSchedulerHeuristicContextHc_t*)context;
     ocrSchedulerObject_t *schedObj = hcContext->mySchedulerObject;
     ASSERT(schedObj);
@@ -294,12 +393,69 @@ static u8 hcSchedulerHeuristicNotifyEdtReadyInvoke(ocrSchedulerHeuristic_t *self
     return fact->fcts.insert(fact, schedObj, &edtObj, NULL, (SCHEDULER_OBJECT_INSERT_AFTER | SCHEDULER_OBJECT_INSERT_POSITION_TAIL));
 }
 
+/* A batch goes to the worker's own deque: WST deques only take pushes from
+ * their owner, idle workers get their share by stealing. In DB affinity
+ * mode, the EDTs that belong to another worker are pushed there one by one. */
+static u8 hcSchedulerHeuristicNotifyEdtsReadyInvoke(ocrSchedulerHeuristic_t *self, ocrSchedulerHeuristicContext_t *context, ocrSchedulerOpArgs_t *opArgs, ocrRuntimeHint_t *hints) {
+    ocrSchedulerOpNotifyArgs_t *notifyArgs = (ocrSchedulerOpNotifyArgs_t*)opArgs;
+    ocrSchedulerHeuristicContextHc_t *hcContext = (ocrSchedulerHeuristicContextHc_t*)context;
+    ocrSchedulerObject_t *schedObj = hcContext->mySchedulerObject;
+    ASSERT(schedObj);
+    ocrFatGuid_t *guids = notifyArgs->OCR_SCHED_ARG_FIELD(OCR_SCHED_NOTIFY_EDTS_READY).guids;
+    u32 count = notifyArgs->OCR_SCHED_ARG_FIELD(OCR_SCHED_NOTIFY_EDTS_READY).count;
+    ASSERT(count <= SCHED_READY_BATCH_MAX);
+    ocrSchedulerObjectFactory_t *fact = self->scheduler->pd->schedulerObjectFactories[schedObj->fctId];
+    ocrSchedulerObject_t edtObjs[SCHED_READY_BATCH_MAX];
+    u8 toReturn = 0;
+    u32 i, localCount = 0;
+    for (i = 0; i < count; i++) {
+        ocrSchedulerObject_t *edtObj = &(edtObjs[localCount]);
+        edtObj->guid = guids[i];
+        edtObj->kind = OCR_SCHEDULER_OBJECT_EDT;
+#ifdef ENABLE_SCHEDULER_RUNTIME_OBJECT_MGMT
+        ocrTask_t *task = (ocrTask_t*)guids[i].metaDataPtr;
+        if ((task->flags & OCR_TASK_FLAG_RUNTIME_EDT) != 0) {
+            edtObj->kind = OCR_SCHEDULER_OBJECT_RUNTIME_EDT;
+        } else {
+            ASSERT(task->state == ALLACQ_EDTSTATE);
+        }
+#endif
+        if (((ocrSchedulerHeuristicHc_t*)self)->dbAffinity) {
+            ocrSchedulerHeuristicContext_t *target = hcSchedulerHeuristicDbAffinityContext(self, context, (ocrTask_t*)guids[i].metaDataPtr);
+            if (target != context) {
+                ocrSchedulerObject_t *targetSchedObj = ((ocrSchedulerHeuristicContextHc_t*)target)->mySchedulerObject;
+#ifdef OCR_MONITOR_SCHEDULER
+                OCR_TOOL_TRACE(false, OCR_TRACE_TYPE_EDT, OCR_ACTION_SCHEDULED, guids[i].guid, targetSchedObj);
+#endif
+                u8 ret = fact->fcts.insert(fact, targetSchedObj, edtObj, NULL, (SCHEDULER_OBJECT_INSERT_AFTER | SCHEDULER_OBJECT_INSERT_POSITION_TAIL));
+                if (toReturn == 0) toReturn = ret;
+                continue;
+            }
+        }
+#ifdef OCR_MONITOR_SCHEDULER
+        OCR_TOOL_TRACE(false, OCR_TRACE_TYPE_EDT, OCR_ACTION_SCHEDULED, guids[i].guid, schedObj);
+#endif
+        localCount++;
+    }
+    if (localCount != 0) {
+        ocrSchedulerObjectIterator_t batch;
+        batch.schedObj = schedObj;
+        batch.data = &localCount;
+        batch.fctId = schedObj->fctId;
+        u8 ret = fact->fcts.insert(fact, schedObj, edtObjs, &batch, (SCHEDULER_OBJECT_INSERT_AFTER | SCHEDULER_OBJECT_INSERT_POSITION_TAIL | SCHEDULER_OBJECT_INSERT_BATCH));
+        if (toReturn == 0) toReturn = ret;
+    }
+    return toReturn;
+}
+
 u8 hcSchedulerHeuristicNotifyInvoke(ocrSchedulerHeuristic_t *self, ocrSchedulerOpArgs_t *opArgs, ocrRuntimeHint_t *hints) {
     ocrSchedulerHeuristicContext_t *context = self->fcts.getContext(self, opArgs->location);
     ocrSchedulerOpNotifyArgs_t *notifyArgs = (ocrSchedulerOpNotifyArgs_t*)opArgs;
     switch(notifyArgs->kind) {
     case OCR_SCHED_NOTIFY_EDT_READY:
         return hcSchedulerHeuristicNotifyEdtReadyInvoke(self, context, opArgs, hints);
+    case OCR_SCHED_NOTIFY_EDTS_READY:
+        return hcSchedulerHeuristicNotifyEdtsReadyInvoke(self, context, opArgs, hints);
     case OCR_SCHED_NOTIFY_EDT_DONE:
         {
             // Destroy the work
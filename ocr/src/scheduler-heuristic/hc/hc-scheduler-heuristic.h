@@ -19,11 +19,19 @@
 /* HC SCHEDULER_HEURISTIC                           */
 /****************************************************/
 
+// In DB affinity mode, an EDT does not move to the deque of the worker
+// that last wrote most of its DB bytes if that deque holds more than
+// this many EDTs beyond the current worker's own deque
+#ifndef HC_DB_AFFINITY_IMBALANCE_MAX
+#define HC_DB_AFFINITY_IMBALANCE_MAX 8
+#endif
+
 // Cached information about context
 typedef struct _ocrSchedulerHeuristicContextHc_t {
     ocrSchedulerHeuristicContext_t base;
     ocrSchedulerObject_t *mySchedulerObject;    // The deque owned by a specific worker (context)
     u64 stealSchedulerObjectIndex;        // Cached index of the deque lasted visited during steal attempts
+    u32 numaDomain;                       // NUMA domain of the worker owning this context
 #if 0 // Example fields for simulation mode
     ocrSchedulerObjectActionSet_t singleActionSet;
     ocrSchedulerObjectAction_t insertAction;
@@ -33,6 +41,8 @@ typedef struct _ocrSchedulerHeuristicContextHc_t {
 
 typedef struct _ocrSchedulerHeuristicHc_t {
     ocrSchedulerHeuristic_t base;
+    bool dbAffinity;        // Ready EDTs go to the worker that last wrote most of their DB bytes
+    bool numaSteal;         // Workers span several NUMA domains: steal within the domain first
 } ocrSchedulerHeuristicHc_t;
 
 /****************************************************/
@@ -41,6 +51,7 @@ typedef struct _ocrSchedulerHeuristicHc_t {
 
 typedef struct _paramListSchedulerHeuristicHc_t {
     paramListSchedulerHeuristic_t base;
+    bool dbAffinity;
 } paramListSchedulerHeuristicHc_t;
 
 typedef struct _ocrSchedulerHeuristicFactoryHc_t {
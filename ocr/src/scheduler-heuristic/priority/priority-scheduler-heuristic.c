@@ -3,8 +3,12 @@
  * and cannot be distributed without it. This notice cannot be
  * removed or modified.
  *
- * - A scheduler heuristic for PR_WSH root schedulerObjects
+ * - A scheduler heuristic for PR_WSH and PR_MQ root schedulerObjects
  *
+ * With 'criticalpath = yes' in its configuration, EDTs that do not carry a
+ * user priority are prioritized by the estimated length of the critical
+ * path that remains after them (their bottom level), which the workers learn
+ * per EDT function (requires ENABLE_EXTENSION_PERF).
  */
 
 #include "ocr-config.h"
@@ -15,10 +19,14 @@
 #include "ocr-policy-domain.h"
 #include "ocr-runtime-types.h"
 #include "ocr-sysboot.h"
+#include "ocr-task.h"
 #include "ocr-workpile.h"
+#include "extensions/ocr-hints.h"
 #include "ocr-scheduler-object.h"
 #include "scheduler-heuristic/priority/priority-scheduler-heuristic.h"
 
+#define DEBUG_TYPE SCHEDULER_HEURISTIC
+
 /******************************************************/
 /* OCR-PRIORITY SCHEDULER_HEURISTIC                   */
 /******************************************************/
@@ -26,6 +34,15 @@
 ocrSchedulerHeuristic_t* newSchedulerHeuristicPriority(ocrSchedulerHeuristicFactory_t * factory, ocrParamList_t *perInstance) {
     ocrSchedulerHeuristic_t* self = (ocrSchedulerHeuristic_t*) runtimeChunkAlloc(sizeof(ocrSchedulerHeuristicPriority_t), PERSISTENT_CHUNK);
     initializeSchedulerHeuristicOcr(factory, self, perInstance);
+    ocrSchedulerHeuristicPriority_t *derived = (ocrSchedulerHeuristicPriority_t*)self;
+    derived->criticalPath = ((paramListSchedulerHeuristicPriority_t*)perInstance)->criticalPath;
+    self->notifyBatch = true;
+#ifndef ENABLE_EXTENSION_PERF
+    if (derived->criticalPath) {
+        DPRINTF(DEBUG_LVL_WARN, "Priority heuristic: criticalpath requires ENABLE_EXTENSION_PERF, ignored\n");
+        derived->criticalPath = false;
+    }
+#endif
     return self;
 }
 
@@ -177,6 +194,28 @@ u8 prioritySchedulerHeuristicGetWorkSimulate(ocrSchedulerHeuristic_t *self, ocrS
     return OCR_ENOTSUP;
 }
 
+#ifdef ENABLE_EXTENSION_PERF
+/* Give an EDT without a user priority its function's bottom level as priority,
+ * the average number of EDTs it makes runnable breaks the ties */
+static void prioritySchedulerHeuristicCriticalPathHint(ocrPolicyDomain_t *pd, ocrTask_t *task) {
+    if ((task == NULL) || !(task->flags & OCR_TASK_FLAG_USES_HINTS) || (task->taskPerfsEntry == NULL))
+        return;
+    ocrTaskFactory_t *taskFact = (ocrTaskFactory_t*)pd->factories[task->fctId];
+    ocrHint_t edtHints;
+    u64 priority;
+    ocrHintInit(&edtHints, OCR_HINT_EDT_T);
+    taskFact->fcts.getHint(task, &edtHints);
+    if (ocrGetHintValue(&edtHints, OCR_HINT_EDT_PRIORITY, &priority) == 0)
+        return; // Set by the user (or already set by us)
+    ocrPerfCounters_t *ctrs = task->taskPerfsEntry;
+    u64 degree = ctrs->stats[PERF_EDT_SUCCESSORS].average;
+    const u64 degreeMask = (1ULL << PRIORITY_CRITICAL_PATH_DEGREE_BITS) - 1;
+    priority = (ctrs->bottomLevel << PRIORITY_CRITICAL_PATH_DEGREE_BITS) | ((degree > degreeMask) ? degreeMask : degree);
+    ocrSetHintValue(&edtHints, OCR_HINT_EDT_PRIORITY, priority);
+    taskFact->fcts.setHint(task, &edtHints);
+}
+#endif
+
 static u8 prioritySchedulerHeuristicNotifyEdtReadyInvoke(ocrSchedulerHeuristic_t *self, ocrSchedulerHeuristicContext_t *context, ocrSchedulerOpArgs_t *opArgs, ocrRuntimeHint_t *hints) {
     ocrSchedulerOpNotifyArgs_t *notifyArgs = (ocrSchedulerOpNotifyArgs_t*)opArgs;
     ocrSchedulerHeuristicContextPriority_t *priorityContext = (ocrSchedulerHeuristicContextPriority_t*)context;
@@ -185,6 +224,10 @@ static u8 prioritySchedulerHeuristicNotifyEdtReadyInvoke(ocrSchedulerHeuristic_t
     ocrSchedulerObject_t edtObj;
     edtObj.guid = notifyArgs->OCR_SCHED_ARG_FIELD(OCR_SCHED_NOTIFY_EDT_READY).guid;
     edtObj.kind = OCR_SCHEDULER_OBJECT_EDT;
+#ifdef ENABLE_EXTENSION_PERF
+    if (((ocrSchedulerHeuristicPriority_t*)self)->criticalPath)
+        prioritySchedulerHeuristicCriticalPathHint(self->scheduler->pd, (ocrTask_t*)edtObj.guid.metaDataPtr);
+#endif
     ocrSchedulerObjectFactory_t *fact = self->scheduler->pd->schedulerObjectFactories[schedObj->fctId];
 #ifdef OCR_MONITOR_SCHEDULER
     ocrGuid_t taskGuid = notifyArgs->OCR_SCHED_ARG_FIELD(OCR_SCHED_NOTIFY_EDT_READY).guid.guid;
@@ -193,12 +236,44 @@ static u8 prioritySchedulerHeuristicNotifyEdtReadyInvoke(ocrSchedulerHeuristic_t
     return fact->fcts.insert(fact, schedObj, &edtObj, NULL, (SCHEDULER_OBJECT_INSERT_AFTER | SCHEDULER_OBJECT_INSERT_POSITION_TAIL));
 }
 
+/* The heaps are shared by all the workers: a batch needs no distribution */
+static u8 prioritySchedulerHeuristicNotifyEdtsReadyInvoke(ocrSchedulerHeuristic_t *self, ocrSchedulerHeuristicContext_t *context, ocrSchedulerOpArgs_t *opArgs, ocrRuntimeHint_t *hints) {
+    ocrSchedulerOpNotifyArgs_t *notifyArgs = (ocrSchedulerOpNotifyArgs_t*)opArgs;
+    ocrSchedulerHeuristicContextPriority_t *priorityContext = (ocrSchedulerHeuristicContextPriority_t*)context;
+    ocrSchedulerObject_t *schedObj = priorityContext->mySchedulerObject;
+    ASSERT(schedObj);
+    ocrFatGuid_t *guids = notifyArgs->OCR_SCHED_ARG_FIELD(OCR_SCHED_NOTIFY_EDTS_READY).guids;
+    u32 count = notifyArgs->OCR_SCHED_ARG_FIELD(OCR_SCHED_NOTIFY_EDTS_READY).count;
+    ASSERT(count <= SCHED_READY_BATCH_MAX);
+    ocrSchedulerObject_t edtObjs[SCHED_READY_BATCH_MAX];
+    u32 i;
+    for (i = 0; i < count; i++) {
+        edtObjs[i].guid = guids[i];
+        edtObjs[i].kind = OCR_SCHEDULER_OBJECT_EDT;
+#ifdef ENABLE_EXTENSION_PERF
+        if (((ocrSchedulerHeuristicPriority_t*)self)->criticalPath)
+            prioritySchedulerHeuristicCriticalPathHint(self->scheduler->pd, (ocrTask_t*)guids[i].metaDataPtr);
+#endif
+#ifdef OCR_MONITOR_SCHEDULER
+        OCR_TOOL_TRACE(false, OCR_TRACE_TYPE_EDT, OCR_ACTION_SCHEDULED, guids[i].guid, schedObj);
+#endif
+    }
+    ocrSchedulerObjectIterator_t batch;
+    batch.schedObj = schedObj;
+    batch.data = &count;
+    batch.fctId = schedObj->fctId;
+    ocrSchedulerObjectFactory_t *fact = self->scheduler->pd->schedulerObjectFactories[schedObj->fctId];
+    return fact->fcts.insert(fact, schedObj, edtObjs, &batch, (SCHEDULER_OBJECT_INSERT_AFTER | SCHEDULER_OBJECT_INSERT_POSITION_TAIL | SCHEDULER_OBJECT_INSERT_BATCH));
+}
+
 u8 prioritySchedulerHeuristicNotifyInvoke(ocrSchedulerHeuristic_t *self, ocrSchedulerOpArgs_t *opArgs, ocrRuntimeHint_t *hints) {
     ocrSchedulerHeuristicContext_t *context = self->fcts.getContext(self, opArgs->location);
     ocrSchedulerOpNotifyArgs_t *notifyArgs = (ocrSchedulerOpNotifyArgs_t*)opArgs;
     switch(notifyArgs->kind) {
     case OCR_SCHED_NOTIFY_EDT_READY:
         return prioritySchedulerHeuristicNotifyEdtReadyInvoke(self, context, opArgs, hints);
+    case OCR_SCHED_NOTIFY_EDTS_READY:
+        return prioritySchedulerHeuristicNotifyEdtsReadyInvoke(self, context, opArgs, hints);
     case OCR_SCHED_NOTIFY_EDT_DONE:
         {
             // Destroy the work
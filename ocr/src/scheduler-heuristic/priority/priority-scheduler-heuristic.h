@@ -19,6 +19,12 @@
 /* PRIORITY SCHEDULER_HEURISTIC                           */
 /****************************************************/
 
+// In critical path mode, number of low-order priority bits holding
+// the average out-degree of the EDT (ties between equal bottom levels)
+#ifndef PRIORITY_CRITICAL_PATH_DEGREE_BITS
+#define PRIORITY_CRITICAL_PATH_DEGREE_BITS 8
+#endif
+
 // Cached information about context
 typedef struct _ocrSchedulerHeuristicContextPriority_t {
     ocrSchedulerHeuristicContext_t base;
@@ -32,6 +38,7 @@ typedef struct _ocrSchedulerHeuristicContextPriority_t {
 
 typedef struct _ocrSchedulerHeuristicPriority_t {
     ocrSchedulerHeuristic_t base;
+    bool criticalPath;      // EDTs without a user priority get their estimated bottom level
 } ocrSchedulerHeuristicPriority_t;
 
 /****************************************************/
@@ -40,6 +47,7 @@ typedef struct _ocrSchedulerHeuristicPriority_t {
 
 typedef struct _paramListSchedulerHeuristicPriority_t {
     paramListSchedulerHeuristic_t base;
+    bool criticalPath;
 } paramListSchedulerHeuristicPriority_t;
 
 typedef struct _ocrSchedulerHeuristicFactoryPriority_t {
@@ -93,5 +93,7 @@ void initializeSchedulerHeuristicOcr(ocrSchedulerHeuristicFactory_t * factory, o
     self->costTable = NULL;
     self->fcts = factory->fcts;
     self->isMaster = params->isMaster;
+    self->notifyBatch = false;
+    self->notifyInline = false;
     self->factoryId = factory->factoryId;
 }
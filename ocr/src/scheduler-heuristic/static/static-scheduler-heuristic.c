@@ -35,6 +35,7 @@ ocrSchedulerHeuristic_t* newSchedulerHeuristicStatic(ocrSchedulerHeuristicFactor
     dself->rrCounter = 0;
     dself->isDistributed = false;
     dself->isTraceActive = false;
+    self->notifyBatch = true;
     return self;
 }
 
@@ -264,6 +265,94 @@ static u8 staticSchedulerHeuristicNotifyEdtReadyInvoke(ocrSchedulerHeuristic_t *
     return fact->fcts.insert(fact, schedObj, &edtObj, NULL, (SCHEDULER_OBJECT_INSERT_AFTER | SCHEDULER_OBJECT_INSERT_POSITION_TAIL));
 }
 
+/* Group the batch per target context so that each deque is pushed to once.
+ * With SCHED_READY_BATCH_DISTRIBUTE, the EDTs that would stay on the current
+ * worker are instead spread over the contexts whose deque is empty. */
+static u8 staticSchedulerHeuristicNotifyEdtsReadyInvoke(ocrSchedulerHeuristic_t *self, ocrSchedulerHeuristicContext_t *context, ocrSchedulerOpArgs_t *opArgs, ocrRuntimeHint_t *hints) {
+    ocrSchedulerOpNotifyArgs_t *notifyArgs = (ocrSchedulerOpNotifyArgs_t*)opArgs;
+    ocrFatGuid_t *guids = notifyArgs->OCR_SCHED_ARG_FIELD(OCR_SCHED_NOTIFY_EDTS_READY).guids;
+    u32 count = notifyArgs->OCR_SCHED_ARG_FIELD(OCR_SCHED_NOTIFY_EDTS_READY).count;
+    ASSERT(count <= SCHED_READY_BATCH_MAX);
+    ocrPolicyDomain_t *pd;
+    getCurrentEnv(&pd, NULL, NULL, NULL);
+    u64 targets[SCHED_READY_BATCH_MAX];
+    u32 i, j;
+    for (i = 0; i < count; i++) {
+        ocrTask_t *task = (ocrTask_t*)guids[i].metaDataPtr;
+        ASSERT(task);
+        u64 contextId = (u64)(-1);
+        ocrHint_t edtHint;
+        ocrHintInit(&edtHint, OCR_HINT_EDT_T);
+        RESULT_ASSERT(((ocrTaskFactory_t*)(pd->factories[pd->taskFactoryIdx]))->fcts.getHint(task, &edtHint), ==, 0);
+        if (ocrGetHintValue(&edtHint, OCR_HINT_EDT_SPACE, &contextId) == 0) {
+            ASSERT(contextId < self->contextCount);
+            targets[i] = contextId;
+        } else {
+            targets[i] = context->id;
+        }
+    }
+
+#ifdef SCHED_READY_BATCH_DISTRIBUTE
+    {
+        ocrSchedulerHeuristicStatic_t *dself = (ocrSchedulerHeuristicStatic_t*)self;
+        u64 first = dself->isDistributed ? 1 : 0;
+        u64 last = dself->isTraceActive ? (self->contextCount - 1) : self->contextCount;
+        u64 idle = context->id;
+        bool kept = false;
+        for (i = 0; i < count; i++) {
+            if (targets[i] != context->id) continue;
+            // The current worker keeps the first one for itself
+            if (!kept) {
+                kept = true;
+                continue;
+            }
+            // Look for the next idle context, giving up after a full round
+            u64 k;
+            for (k = 0; k < (last - first); k++) {
+                idle = (idle + 1 < last) ? (idle + 1) : first;
+                if (idle == context->id) continue;
+                ocrSchedulerObject_t *idleObj = ((ocrSchedulerHeuristicContextStatic_t*)self->contexts[idle])->mySchedulerObject;
+                ocrSchedulerObjectFactory_t *idleFact = pd->schedulerObjectFactories[idleObj->fctId];
+                if (idleFact->fcts.count(idleFact, idleObj, SCHEDULER_OBJECT_COUNT_EDT) == 0)
+                    break;
+            }
+            if (k == (last - first)) break;
+            targets[i] = idle;
+        }
+    }
+#endif
+
+    u8 toReturn = 0;
+    bool done[SCHED_READY_BATCH_MAX];
+    for (i = 0; i < count; i++)
+        done[i] = false;
+    ocrSchedulerObject_t edtObjs[SCHED_READY_BATCH_MAX];
+    for (i = 0; i < count; i++) {
+        if (done[i]) continue;
+        ocrSchedulerObject_t *schedObj = ((ocrSchedulerHeuristicContextStatic_t*)self->contexts[targets[i]])->mySchedulerObject;
+        ASSERT(schedObj);
+        u32 groupCount = 0;
+        for (j = i; j < count; j++) {
+            if (done[j] || (targets[j] != targets[i])) continue;
+            done[j] = true;
+            edtObjs[groupCount].guid = guids[j];
+            edtObjs[groupCount].kind = OCR_SCHEDULER_OBJECT_EDT;
+            groupCount++;
+#ifdef OCR_MONITOR_SCHEDULER
+            OCR_TOOL_TRACE(false, OCR_TRACE_TYPE_EDT, OCR_ACTION_SCHEDULED, guids[j].guid, schedObj);
+#endif
+        }
+        ocrSchedulerObjectIterator_t batch;
+        batch.schedObj = schedObj;
+        batch.data = &groupCount;
+        batch.fctId = schedObj->fctId;
+        ocrSchedulerObjectFactory_t *fact = self->scheduler->pd->schedulerObjectFactories[schedObj->fctId];
+        u8 ret = fact->fcts.insert(fact, schedObj, edtObjs, &batch, (SCHEDULER_OBJECT_INSERT_AFTER | SCHEDULER_OBJECT_INSERT_POSITION_TAIL | SCHEDULER_OBJECT_INSERT_BATCH));
+        if (toReturn == 0) toReturn = ret;
+    }
+    return toReturn;
+}
+
 static u8 staticSchedulerHeuristicNotifyPreProcessMsgInvoke(ocrSchedulerHeuristic_t *self, ocrSchedulerHeuristicContext_t *context, ocrSchedulerOpArgs_t *opArgs, ocrRuntimeHint_t *hints) {
     ocrPolicyDomain_t *pd;
     ocrWorker_t *worker;
@@ -400,6 +489,8 @@ u8 staticSchedulerHeuristicNotifyInvoke(ocrSchedulerHeuristic_t *self, ocrSchedu
         return staticSchedulerHeuristicNotifyPostProcessMsgInvoke(self, context, opArgs, hints);
     case OCR_SCHED_NOTIFY_EDT_READY:
         return staticSchedulerHeuristicNotifyEdtReadyInvoke(self, context, opArgs, hints);
+    case OCR_SCHED_NOTIFY_EDTS_READY:
+        return staticSchedulerHeuristicNotifyEdtsReadyInvoke(self, context, opArgs, hints);
     case OCR_SCHED_NOTIFY_EDT_DONE:
         {
             // Destroy the work
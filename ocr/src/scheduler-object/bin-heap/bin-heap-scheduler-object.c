@@ -85,11 +85,7 @@ u8 binHeapSchedulerObjectDestroy(ocrSchedulerObjectFactory_t *fact, ocrScheduler
     return 0;
 }
 
-u8 binHeapSchedulerObjectInsert(ocrSchedulerObjectFactory_t *fact, ocrSchedulerObject_t *self, ocrSchedulerObject_t *element, ocrSchedulerObjectIterator_t *iterator, u32 properties) {
-    ocrSchedulerObjectBinHeap_t *schedObj = (ocrSchedulerObjectBinHeap_t*)self;
-    ASSERT(IS_SCHEDULER_OBJECT_TYPE_SINGLETON(element->kind));
-    binHeap_t * heap = schedObj->binHeap;
-    ocrGuid_t edtGuid = element->guid.guid;
+static s64 _edtPriority(ocrSchedulerObject_t *element) {
     // FIXME: should default to ZERO, but that doesn't play well with OCR_TASK_FLAG_RUNTIME_EDT,
     // since none of the runtime EDTs execute when you expect...
     s64 priority = INT64_MAX;
@@ -97,17 +93,52 @@ u8 binHeapSchedulerObjectInsert(ocrSchedulerObjectFactory_t *fact, ocrSchedulerO
         ASSERT(element->kind == OCR_SCHEDULER_OBJECT_EDT);
         ocrHint_t edtHints;
         ocrHintInit(&edtHints, OCR_HINT_EDT_T);
-        ocrGetHint(edtGuid, &edtHints);
+        ocrGetHint(element->guid.guid, &edtHints);
         ocrGetHintValue(&edtHints, OCR_HINT_EDT_PRIORITY, (u64*)&priority);
     }
+    return priority;
+}
 
+static inline void * _edtEntry(ocrSchedulerObject_t *element) {
     // See BUG #928 on GUID issues
 #if GUID_BIT_COUNT == 64
-    heap->push(heap, (void *)edtGuid.guid, priority, 0);
+    return (void *)element->guid.guid.guid;
 #elif GUID_BIT_COUNT == 128
-    heap->push(heap, (void *)edtGuid.lower, priority, 0);
+    return (void *)element->guid.guid.lower;
 #endif
+}
+
+// Number of entries handed to the heap at once by a batch insert
+#define BIN_HEAP_INSERT_BATCH_CHUNK 32
+
+static u8 binHeapSchedulerObjectInsertBatch(ocrSchedulerObject_t *self, ocrSchedulerObject_t *elements, u32 count) {
+    ocrSchedulerObjectBinHeap_t *schedObj = (ocrSchedulerObjectBinHeap_t*)self;
+    binHeap_t * heap = schedObj->binHeap;
+    ocrBinHeapEntry_t entries[BIN_HEAP_INSERT_BATCH_CHUNK];
+    u32 i, n = 0;
+    for (i = 0; i < count; i++) {
+        ASSERT(IS_SCHEDULER_OBJECT_TYPE_SINGLETON(elements[i].kind));
+        entries[n].priority = _edtPriority(&elements[i]);
+        entries[n].entry = _edtEntry(&elements[i]);
+        if (++n == BIN_HEAP_INSERT_BATCH_CHUNK) {
+            heap->pushBatch(heap, entries, n, 0);
+            n = 0;
+        }
+    }
+    if (n != 0)
+        heap->pushBatch(heap, entries, n, 0);
+    return 0;
+}
 
+u8 binHeapSchedulerObjectInsert(ocrSchedulerObjectFactory_t *fact, ocrSchedulerObject_t *self, ocrSchedulerObject_t *element, ocrSchedulerObjectIterator_t *iterator, u32 properties) {
+    if ((properties & SCHEDULER_OBJECT_INSERT_BATCH) == SCHEDULER_OBJECT_INSERT_BATCH) {
+        ASSERT(iterator != NULL && iterator->data != NULL);
+        return binHeapSchedulerObjectInsertBatch(self, element, *((u32*)iterator->data));
+    }
+    ocrSchedulerObjectBinHeap_t *schedObj = (ocrSchedulerObjectBinHeap_t*)self;
+    ASSERT(IS_SCHEDULER_OBJECT_TYPE_SINGLETON(element->kind));
+    binHeap_t * heap = schedObj->binHeap;
+    heap->push(heap, _edtEntry(element), _edtPriority(element), 0);
     return 0;
 }
 
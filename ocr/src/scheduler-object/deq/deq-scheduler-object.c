@@ -97,8 +97,60 @@ u8 deqSchedulerObjectDestroy(ocrSchedulerObjectFactory_t *fact, ocrSchedulerObje
     return 0;
 }
 
+// Number of entries handed to the deque at once by a batch insert
+#define DEQ_INSERT_BATCH_CHUNK 32
+
+static void deqPushEntries(deque_t *deq, void **entries, u32 count) {
+    if (deq->pushBatchAtTail != NULL) {
+        deq->pushBatchAtTail(deq, entries, count, 0);
+    } else {
+        u32 i;
+        for (i = 0; i < count; i++)
+            deq->pushAtTail(deq, entries[i], 0);
+    }
+}
+
+u8 deqSchedulerObjectInsert(ocrSchedulerObjectFactory_t *fact, ocrSchedulerObject_t *self, ocrSchedulerObject_t *element, ocrSchedulerObjectIterator_t *iterator, u32 properties);
+
+static u8 deqSchedulerObjectInsertBatch(ocrSchedulerObjectFactory_t *fact, ocrSchedulerObject_t *self, ocrSchedulerObject_t *elements, u32 count) {
+    ocrSchedulerObjectDeq_t *schedObj = (ocrSchedulerObjectDeq_t*)self;
+    deque_t * deq = schedObj->deque;
+    if (deq == NULL) {
+        ocrPolicyDomain_t *pd = NULL;
+        getCurrentEnv(&pd, NULL, NULL, NULL);
+        deq = newDeque(pd, NULL, schedObj->dequeType);
+        schedObj->deque = deq;
+    }
+    void * entries[DEQ_INSERT_BATCH_CHUNK];
+    u32 i, n = 0;
+    for (i = 0; i < count; i++) {
+        ocrSchedulerObject_t *element = &elements[i];
+        ASSERT(IS_SCHEDULER_OBJECT_TYPE_SINGLETON(element->kind));
+        //Sanity check - Ensure work is local
+        ASSERT(element->guid.metaDataPtr != NULL);
+#ifdef ENABLE_SCHEDULER_RUNTIME_OBJECT_MGMT
+        if (IS_SCHEDULER_OBJECT_TYPE_RUNTIME(element->kind)) {
+            deqSchedulerObjectInsert(fact, self, element, NULL, (SCHEDULER_OBJECT_INSERT_AFTER | SCHEDULER_OBJECT_INSERT_POSITION_TAIL));
+            continue;
+        }
+#endif
+        entries[n++] = element->guid.metaDataPtr;
+        if (n == DEQ_INSERT_BATCH_CHUNK) {
+            deqPushEntries(deq, entries, n);
+            n = 0;
+        }
+    }
+    if (n != 0)
+        deqPushEntries(deq, entries, n);
+    return 0;
+}
+
 u8 deqSchedulerObjectInsert(ocrSchedulerObjectFactory_t *fact, ocrSchedulerObject_t *self, ocrSchedulerObject_t *element, ocrSchedulerObjectIterator_t *iterator, u32 properties) {
     ocrSchedulerObjectDeq_t *schedObj = (ocrSchedulerObjectDeq_t*)self;
+    if ((properties & SCHEDULER_OBJECT_INSERT_BATCH) == SCHEDULER_OBJECT_INSERT_BATCH) {
+        ASSERT(iterator != NULL && iterator->data != NULL);
+        return deqSchedulerObjectInsertBatch(fact, self, element, *((u32*)iterator->data));
+    }
     ASSERT(IS_SCHEDULER_OBJECT_TYPE_SINGLETON(element->kind));
 #ifdef ENABLE_SCHEDULER_RUNTIME_OBJECT_MGMT
     if (IS_SCHEDULER_OBJECT_TYPE_RUNTIME(element->kind)) {
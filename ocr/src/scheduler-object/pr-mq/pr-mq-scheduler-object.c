@@ -0,0 +1,453 @@
+/*
+ * This file is subject to the license agreement located in the file LICENSE
+ * and cannot be distributed without it. This notice cannot be
+ * removed or modified.
+ *
+ * Relaxed concurrent priority queue (MultiQueue): the tasks are spread over
+ * PR_MQ_QUEUES_PER_WORKER x workerCount heaps, each protected by its own lock.
+ * Insertions go to a random heap. Removals look at the top of two random heaps
+ * and pop from the best one, which returns one of the highest priority tasks
+ * with high probability without serializing all workers on a single lock.
+ */
+
+#include "ocr-config.h"
+#include "extensions/ocr-hints.h"
+#ifdef ENABLE_SCHEDULER_OBJECT_PR_MQ
+
+#include "debug.h"
+#include "ocr-errors.h"
+#include "ocr-policy-domain.h"
+#include "ocr-runtime-types.h"
+#include "ocr-sysboot.h"
+#include "ocr-task.h"
+#include "ocr-worker.h"
+#include "scheduler-object/pr-mq/pr-mq-scheduler-object.h"
+#include "scheduler-object/scheduler-object-all.h"
+
+#define DEBUG_TYPE SCHEDULER_OBJECT
+
+// Priority advertised by an empty heap
+#define PR_MQ_EMPTY INT64_MIN
+
+// Number of two-choice pops attempted before sweeping all the heaps
+#define PR_MQ_POP_TRIES 4
+
+/*********************************************************/
+/* OCR PR-MQ SCHEDULER_OBJECT FUNCTIONS                  */
+/*********************************************************/
+
+static u32 prMqRandom(ocrSchedulerObjectPrMq_t *schedObj) {
+    ocrWorker_t *worker = NULL;
+    getCurrentEnv(NULL, &worker, NULL, NULL);
+    // Non-worker threads share a state, losing an update there is harmless
+    u64 *seed = &(schedObj->seeds[(worker == NULL) ? 0 : (worker->id % schedObj->seedCount)].seed);
+    u64 x = *seed;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    *seed = x;
+    return (u32)(x >> 32);
+}
+
+static inline void prMqUpdateTop(prMqQueue_t *q) {
+    q->top = (q->heap->count == 0) ? PR_MQ_EMPTY : q->heap->data[0].priority;
+}
+
+static inline ocrGuid_t prMqPopLocked(prMqQueue_t *q) {
+    // See BUG #928 on GUID issues
+    void *data = q->heap->pop(q->heap, 0);
+    prMqUpdateTop(q);
+    ocrGuid_t retGuid = NULL_GUID;
+#if GUID_BIT_COUNT == 64
+    if (data) retGuid.guid = (intptr_t)data;
+#elif GUID_BIT_COUNT == 128
+    if (data) retGuid.lower = (intptr_t)data;
+#endif
+    return retGuid;
+}
+
+static ocrGuid_t prMqPop(ocrSchedulerObjectPrMq_t *schedObj) {
+    const u32 n = schedObj->queueCount;
+    u32 i;
+    for (i = 0; i < PR_MQ_POP_TRIES; i++) {
+        prMqQueue_t *q = &(schedObj->queues[prMqRandom(schedObj) % n].queue);
+        prMqQueue_t *q2 = &(schedObj->queues[prMqRandom(schedObj) % n].queue);
+        if (q2->top > q->top)
+            q = q2;
+        if (q->top == PR_MQ_EMPTY)
+            break;
+        if (hal_trylock(&(q->lock)))
+            continue;
+        ocrGuid_t retGuid = prMqPopLocked(q);
+        hal_unlock(&(q->lock));
+        if (!ocrGuidIsNull(retGuid))
+            return retGuid;
+    }
+    // Both choices kept failing: sweep all the heaps so no task is left behind
+    u32 start = prMqRandom(schedObj) % n;
+    for (i = 0; i < n; i++) {
+        prMqQueue_t *q = &(schedObj->queues[(start + i) % n].queue);
+        if (q->heap->count == 0) //racy, rechecked under the lock
+            continue;
+        hal_lock(&(q->lock));
+        ocrGuid_t retGuid = prMqPopLocked(q);
+        hal_unlock(&(q->lock));
+        if (!ocrGuidIsNull(retGuid))
+            return retGuid;
+    }
+    return NULL_GUID;
+}
+
+static void prMqSchedulerObjectStart(ocrSchedulerObject_t *self, ocrPolicyDomain_t *PD) {
+    self->loc = PD->myLocation;
+    self->mapping = OCR_SCHEDULER_OBJECT_MAPPING_PINNED;
+    ocrSchedulerObjectPrMq_t *prMqSchedObj = (ocrSchedulerObjectPrMq_t*)self;
+    ASSERT(PD->workerCount > 0);
+    u32 i;
+    prMqSchedObj->queueCount = PR_MQ_QUEUES_PER_WORKER * PD->workerCount;
+    prMqSchedObj->queues = (prMqPaddedQueue_t*)PD->fcts.pdMalloc(PD, sizeof(prMqPaddedQueue_t) * prMqSchedObj->queueCount);
+    for (i = 0; i < prMqSchedObj->queueCount; i++) {
+        prMqQueue_t *q = &(prMqSchedObj->queues[i].queue);
+        q->lock = INIT_LOCK;
+        q->top = PR_MQ_EMPTY;
+        q->heap = newBinHeapWithCapacity(PD, NON_CONCURRENT_BIN_HEAP, PR_MQ_INIT_HEAP_CAPACITY);
+    }
+    prMqSchedObj->seedCount = PD->workerCount;
+    prMqSchedObj->seeds = (prMqPaddedSeed_t*)PD->fcts.pdMalloc(PD, sizeof(prMqPaddedSeed_t) * prMqSchedObj->seedCount);
+    for (i = 0; i < prMqSchedObj->seedCount; i++) {
+        // Any non-zero value works for xorshift
+        prMqSchedObj->seeds[i].seed = 0x9E3779B97F4A7C15ULL * (i + 1);
+    }
+}
+
+static void prMqSchedulerObjectFinish(ocrSchedulerObject_t *self, ocrPolicyDomain_t *PD) {
+    ocrSchedulerObjectPrMq_t *prMqSchedObj = (ocrSchedulerObjectPrMq_t*)self;
+    u32 i;
+    for (i = 0; i < prMqSchedObj->queueCount; i++) {
+        binHeap_t *heap = prMqSchedObj->queues[i].queue.heap;
+        heap->destruct(PD, heap);
+    }
+    PD->fcts.pdFree(PD, prMqSchedObj->queues);
+    PD->fcts.pdFree(PD, prMqSchedObj->seeds);
+    prMqSchedObj->queues = NULL;
+    prMqSchedObj->queueCount = 0;
+    prMqSchedObj->seeds = NULL;
+    prMqSchedObj->seedCount = 0;
+}
+
+static void prMqSchedulerObjectInitialize(ocrSchedulerObjectFactory_t *fact, ocrSchedulerObject_t *self) {
+    self->guid.guid = NULL_GUID;
+    self->guid.metaDataPtr = self;
+    self->kind = OCR_SCHEDULER_OBJECT_PR_MQ;
+    self->fctId = fact->factoryId;
+    self->loc = INVALID_LOCATION;
+    self->mapping = OCR_SCHEDULER_OBJECT_MAPPING_UNDEFINED;
+    ocrSchedulerObjectPrMq_t* prMqSchedObj = (ocrSchedulerObjectPrMq_t*)self;
+    prMqSchedObj->queues = NULL;
+    prMqSchedObj->queueCount = 0;
+    prMqSchedObj->seeds = NULL;
+    prMqSchedObj->seedCount = 0;
+}
+
+ocrSchedulerObject_t* newSchedulerObjectPrMq(ocrSchedulerObjectFactory_t *factory, ocrParamList_t *perInstance) {
+    paramListSchedulerObject_t *paramSchedObj __attribute__((unused)) = (paramListSchedulerObject_t*)perInstance;
+    ASSERT(paramSchedObj->config);
+    ASSERT(!paramSchedObj->guidRequired);
+    ocrSchedulerObject_t* schedObj = (ocrSchedulerObject_t*)runtimeChunkAlloc(sizeof(ocrSchedulerObjectPrMq_t), PERSISTENT_CHUNK);
+    prMqSchedulerObjectInitialize(factory, schedObj);
+    schedObj->kind |= OCR_SCHEDULER_OBJECT_ALLOC_CONFIG;
+    return schedObj;
+}
+
+ocrSchedulerObject_t* prMqSchedulerObjectCreate(ocrSchedulerObjectFactory_t *factory, ocrParamList_t *perInstance) {
+    paramListSchedulerObject_t *paramSchedObj __attribute__((unused)) = (paramListSchedulerObject_t*)perInstance;
+    ASSERT(!paramSchedObj->config);
+    ASSERT(!paramSchedObj->guidRequired);
+    ocrPolicyDomain_t *pd = NULL;
+    getCurrentEnv(&pd, NULL, NULL, NULL);
+    ocrSchedulerObject_t* schedObj = (ocrSchedulerObject_t*)pd->fcts.pdMalloc(pd, sizeof(ocrSchedulerObjectPrMq_t));
+    prMqSchedulerObjectInitialize(factory, schedObj);
+    prMqSchedulerObjectStart(schedObj, pd);
+    schedObj->kind |= OCR_SCHEDULER_OBJECT_ALLOC_PD;
+    return schedObj;
+}
+
+u8 prMqSchedulerObjectDestroy(ocrSchedulerObjectFactory_t *fact, ocrSchedulerObject_t *self) {
+    if (IS_SCHEDULER_OBJECT_CONFIG_ALLOCATED(self->kind)) {
+        runtimeChunkFree((u64)self, PERSISTENT_CHUNK);
+    } else {
+        ASSERT(IS_SCHEDULER_OBJECT_PD_ALLOCATED(self->kind));
+        ocrPolicyDomain_t *pd = NULL;
+        getCurrentEnv(&pd, NULL, NULL, NULL);
+        prMqSchedulerObjectFinish(self, pd);
+        pd->fcts.pdFree(pd, self);
+    }
+    return 0;
+}
+
+static void prMqReadEntry(ocrSchedulerObject_t *element, ocrBinHeapEntry_t *entry) {
+    ASSERT(IS_SCHEDULER_OBJECT_TYPE_SINGLETON(element->kind));
+    ocrGuid_t edtGuid = element->guid.guid;
+    // Same default as the BIN_HEAP scheduler object
+    s64 priority = INT64_MAX;
+    { // read EDT hint
+        ASSERT(element->kind == OCR_SCHEDULER_OBJECT_EDT);
+        ocrHint_t edtHints;
+        ocrHintInit(&edtHints, OCR_HINT_EDT_T);
+        ocrGetHint(edtGuid, &edtHints);
+        ocrGetHintValue(&edtHints, OCR_HINT_EDT_PRIORITY, (u64*)&priority);
+    }
+    entry->priority = priority;
+    // See BUG #928 on GUID issues
+#if GUID_BIT_COUNT == 64
+    entry->entry = (void *)edtGuid.guid;
+#elif GUID_BIT_COUNT == 128
+    entry->entry = (void *)edtGuid.lower;
+#endif
+}
+
+static void prMqPush(ocrSchedulerObjectPrMq_t *schedObj, ocrBinHeapEntry_t *entries, u32 count) {
+    // Any heap will do: skip the busy ones for a while, then wait
+    const u32 n = schedObj->queueCount;
+    prMqQueue_t *q = NULL;
+    u32 i;
+    for (i = 0; i < n; i++) {
+        q = &(schedObj->queues[prMqRandom(schedObj) % n].queue);
+        if (!hal_trylock(&(q->lock)))
+            break;
+    }
+    if (i == n)
+        hal_lock(&(q->lock));
+    q->heap->pushBatch(q->heap, entries, count, 0);
+    prMqUpdateTop(q);
+    hal_unlock(&(q->lock));
+}
+
+// Number of entries a batch insert pushes to one heap
+#define PR_MQ_INSERT_BATCH_CHUNK 32
+
+u8 prMqSchedulerObjectInsert(ocrSchedulerObjectFactory_t *fact, ocrSchedulerObject_t *self, ocrSchedulerObject_t *element, ocrSchedulerObjectIterator_t *iterator, u32 properties) {
+    ocrSchedulerObjectPrMq_t *schedObj = (ocrSchedulerObjectPrMq_t*)self;
+    if ((properties & SCHEDULER_OBJECT_INSERT_BATCH) == SCHEDULER_OBJECT_INSERT_BATCH) {
+        // The whole chunk goes to a single heap, under one lock
+        ASSERT(iterator != NULL && iterator->data != NULL);
+        u32 count = *((u32*)iterator->data);
+        ocrBinHeapEntry_t entries[PR_MQ_INSERT_BATCH_CHUNK];
+        u32 i, n = 0;
+        for (i = 0; i < count; i++) {
+            prMqReadEntry(&element[i], &entries[n]);
+            if (++n == PR_MQ_INSERT_BATCH_CHUNK) {
+                prMqPush(schedObj, entries, n);
+                n = 0;
+            }
+        }
+        if (n != 0)
+            prMqPush(schedObj, entries, n);
+        return 0;
+    }
+    ocrBinHeapEntry_t entry;
+    prMqReadEntry(element, &entry);
+    prMqPush(schedObj, &entry, 1);
+    return 0;
+}
+
+u8 prMqSchedulerObjectRemove(ocrSchedulerObjectFactory_t *fact, ocrSchedulerObject_t *self, ocrSchedulerObjectKind kind, u32 count, ocrSchedulerObject_t *dst, ocrSchedulerObjectIterator_t *iterator, u32 properties) {
+    u32 i;
+    ocrSchedulerObjectPrMq_t *schedObj = (ocrSchedulerObjectPrMq_t*)self;
+    ASSERT(IS_SCHEDULER_OBJECT_TYPE_SINGLETON(kind));
+    if (schedObj->queues == NULL) return count;
+
+    for (i = 0; i < count; i++) {
+        ocrGuid_t retGuid = NULL_GUID;
+        switch(properties) {
+        case SCHEDULER_OBJECT_REMOVE_TAIL:
+        case SCHEDULER_OBJECT_REMOVE_HEAD:
+            {
+                START_PROFILE(sched_prMq_Pop);
+                retGuid = prMqPop(schedObj);
+                EXIT_PROFILE;
+            }
+            break;
+        default:
+            ASSERT(0);
+            return OCR_ENOTSUP;
+        }
+
+        if(ocrGuidIsNull(retGuid))
+            break;
+
+        if (IS_SCHEDULER_OBJECT_TYPE_SINGLETON(dst->kind)) {
+            ASSERT(ocrGuidIsNull(dst->guid.guid) && count == 1);
+            dst->guid.guid = retGuid;
+        } else {
+            ocrSchedulerObject_t taken;
+            taken.guid.guid = retGuid;
+            taken.kind = kind;
+            ocrSchedulerObjectFactory_t *dstFactory = fact->pd->schedulerObjectFactories[dst->fctId];
+            dstFactory->fcts.insert(dstFactory, dst, &taken, NULL, 0);
+        }
+    }
+
+    // Success (0) if at least one element has been removed
+    return (i == 0);
+}
+
+u64 prMqSchedulerObjectCount(ocrSchedulerObjectFactory_t *fact, ocrSchedulerObject_t *self, u32 properties) {
+    ocrSchedulerObjectPrMq_t *schedObj = (ocrSchedulerObjectPrMq_t*)self;
+    u64 count = 0;
+    u32 i;
+    for (i = 0; i < schedObj->queueCount; i++) {
+        count += schedObj->queues[i].queue.heap->count; //this may be racy but ok for approx count
+    }
+    return count;
+}
+
+ocrSchedulerObjectIterator_t* prMqSchedulerObjectCreateIterator(ocrSchedulerObjectFactory_t *fact, ocrSchedulerObject_t *self, u32 properties) {
+    ASSERT(0);
+    return NULL;
+}
+
+u8 prMqSchedulerObjectDestroyIterator(ocrSchedulerObjectFactory_t * fact, ocrSchedulerObjectIterator_t *iterator) {
+    ASSERT(0);
+    return OCR_ENOTSUP;
+}
+
+u8 prMqSchedulerObjectIterate(ocrSchedulerObjectFactory_t *fact, ocrSchedulerObjectIterator_t *iterator, u32 properties) {
+    ASSERT(0);
+    return OCR_ENOTSUP;
+}
+
+ocrSchedulerObject_t* prMqGetSchedulerObjectForLocation(ocrSchedulerObjectFactory_t *fact, ocrSchedulerObject_t *self, ocrSchedulerObjectKind kind, ocrLocation_t loc, ocrSchedulerObjectMappingKind mapping, u32 properties) {
+    // All the workers share the multi-queue
+    return self;
+}
+
+u8 prMqSetLocationForSchedulerObject(ocrSchedulerObjectFactory_t *fact, ocrSchedulerObject_t *self, ocrLocation_t loc, ocrSchedulerObjectMappingKind mapping) {
+    self->loc = loc;
+    self->mapping = mapping;
+    return 0;
+}
+
+ocrSchedulerObjectActionSet_t* prMqSchedulerObjectNewActionSet(ocrSchedulerObjectFactory_t *fact, ocrSchedulerObject_t *self, u32 count) {
+    ASSERT(0);
+    return NULL;
+}
+
+u8 prMqSchedulerObjectDestroyActionSet(ocrSchedulerObjectFactory_t *fact, ocrSchedulerObjectActionSet_t *actionSet) {
+    ASSERT(0);
+    return OCR_ENOTSUP;
+}
+
+u8 prMqSchedulerObjectSwitchRunlevel(ocrSchedulerObject_t *self, ocrPolicyDomain_t *PD, ocrRunlevel_t runlevel,
+                                     phase_t phase, u32 properties, void (*callback)(ocrPolicyDomain_t*, u64), u64 val) {
+
+    u8 toReturn = 0;
+
+    // This is an inert module, we do not handle callbacks (caller needs to wait on us)
+    ASSERT(callback == NULL);
+
+    // Verify properties for this call
+    ASSERT((properties & RL_REQUEST) && !(properties & RL_RESPONSE)
+           && !(properties & RL_RELEASE));
+    ASSERT(!(properties & RL_FROM_MSG));
+
+    switch(runlevel) {
+    case RL_CONFIG_PARSE:
+        // On bring-up: Update PD->phasesPerRunlevel on phase 0
+        // and check compatibility on phase 1
+        break;
+    case RL_NETWORK_OK:
+        break;
+    case RL_PD_OK:
+        break;
+    case RL_MEMORY_OK:
+        DPRINTF(DEBUG_LVL_VVERB, "Runlevel: RL_MEMORY_OK\n");
+        if((properties & RL_BRING_UP) && RL_IS_FIRST_PHASE_UP(PD, RL_PD_OK, phase)) {
+            u32 i;
+            // The scheduler calls this before switching itself. Do we want
+            // to invert this?
+            for(i = 0; i < PD->schedulerObjectFactoryCount; ++i) {
+                if(PD->schedulerObjectFactories[i])
+                    PD->schedulerObjectFactories[i]->pd = PD;
+            }
+        }
+        break;
+    case RL_GUID_OK:
+        DPRINTF(DEBUG_LVL_VVERB, "Runlevel: RL_GUID_OK\n");
+        // Memory is up
+        if(properties & RL_BRING_UP) {
+            if(RL_IS_FIRST_PHASE_UP(PD, RL_MEMORY_OK, phase)) {
+                prMqSchedulerObjectStart(self, PD);
+            }
+        } else {
+            // Tear down
+            if(RL_IS_LAST_PHASE_DOWN(PD, RL_MEMORY_OK, phase)) {
+                prMqSchedulerObjectFinish(self, PD);
+            }
+        }
+        break;
+    case RL_COMPUTE_OK:
+        break;
+    case RL_USER_OK:
+        break;
+    default:
+        ASSERT(0);
+    }
+    return toReturn;
+}
+
+u8 prMqSchedulerObjectOcrPolicyMsgGetMsgSize(ocrSchedulerObjectFactory_t *fact, ocrPolicyMsg_t *msg, u64 *marshalledSize, u32 properties) {
+    ASSERT(0);
+    return OCR_ENOTSUP;
+}
+
+u8 prMqSchedulerObjectOcrPolicyMsgMarshallMsg(ocrSchedulerObjectFactory_t *fact, ocrPolicyMsg_t *msg, u8 *buffer, u32 properties) {
+    ASSERT(0);
+    return OCR_ENOTSUP;
+}
+
+u8 prMqSchedulerObjectOcrPolicyMsgUnMarshallMsg(ocrSchedulerObjectFactory_t *fact, ocrPolicyMsg_t *msg, u8 *localMainPtr, u8 *localAddlPtr, u32 properties) {
+    ASSERT(0);
+    return OCR_ENOTSUP;
+}
+
+/*********************************************************/
+/* OCR PR-MQ SCHEDULER_OBJECT FACTORY FUNCTIONS          */
+/*********************************************************/
+
+void destructSchedulerObjectFactoryPrMq(ocrSchedulerObjectFactory_t * factory) {
+    runtimeChunkFree((u64)factory, PERSISTENT_CHUNK);
+}
+
+ocrSchedulerObjectFactory_t * newOcrSchedulerObjectFactoryPrMq(ocrParamList_t *perType, u32 factoryId) {
+    ocrSchedulerObjectFactory_t *schedObjFact = (ocrSchedulerObjectFactory_t*) runtimeChunkAlloc(
+                                      sizeof(ocrSchedulerObjectFactoryPrMq_t), PERSISTENT_CHUNK);
+
+    schedObjFact->factoryId = schedulerObjectPrMq_id;
+    schedObjFact->kind = OCR_SCHEDULER_OBJECT_PR_MQ;
+    schedObjFact->pd = NULL;
+
+    schedObjFact->destruct = &destructSchedulerObjectFactoryPrMq;
+    schedObjFact->instantiate = &newSchedulerObjectPrMq;
+
+    schedObjFact->fcts.create = FUNC_ADDR(ocrSchedulerObject_t* (*)(ocrSchedulerObjectFactory_t*, ocrParamList_t*), prMqSchedulerObjectCreate);
+    schedObjFact->fcts.destroy = FUNC_ADDR(u8 (*)(ocrSchedulerObjectFactory_t*, ocrSchedulerObject_t*), prMqSchedulerObjectDestroy);
+    schedObjFact->fcts.insert = FUNC_ADDR(u8 (*)(ocrSchedulerObjectFactory_t*, ocrSchedulerObject_t*, ocrSchedulerObject_t*, ocrSchedulerObjectIterator_t*, u32), prMqSchedulerObjectInsert);
+    schedObjFact->fcts.remove = FUNC_ADDR(u8 (*)(ocrSchedulerObjectFactory_t*, ocrSchedulerObject_t*, ocrSchedulerObjectKind, u32, ocrSchedulerObject_t*, ocrSchedulerObjectIterator_t*, u32), prMqSchedulerObjectRemove);
+    schedObjFact->fcts.count = FUNC_ADDR(u64 (*)(ocrSchedulerObjectFactory_t*, ocrSchedulerObject_t*, u32), prMqSchedulerObjectCount);
+    schedObjFact->fcts.createIterator = FUNC_ADDR(ocrSchedulerObjectIterator_t* (*)(ocrSchedulerObjectFactory_t*, ocrSchedulerObject_t*, u32), prMqSchedulerObjectCreateIterator);
+    schedObjFact->fcts.destroyIterator = FUNC_ADDR(u8 (*)(ocrSchedulerObjectFactory_t*, ocrSchedulerObjectIterator_t*), prMqSchedulerObjectDestroyIterator);
+    schedObjFact->fcts.iterate = FUNC_ADDR(u8 (*)(ocrSchedulerObjectFactory_t*, ocrSchedulerObjectIterator_t*, u32), prMqSchedulerObjectIterate);
+    schedObjFact->fcts.setLocationForSchedulerObject = FUNC_ADDR(u8 (*)(ocrSchedulerObjectFactory_t*, ocrSchedulerObject_t*, ocrLocation_t, ocrSchedulerObjectMappingKind), prMqSetLocationForSchedulerObject);
+    schedObjFact->fcts.getSchedulerObjectForLocation = FUNC_ADDR(ocrSchedulerObject_t* (*)(ocrSchedulerObjectFactory_t*, ocrSchedulerObject_t*, ocrSchedulerObjectKind, ocrLocation_t, ocrSchedulerObjectMappingKind, u32), prMqGetSchedulerObjectForLocation);
+    schedObjFact->fcts.createActionSet = FUNC_ADDR(ocrSchedulerObjectActionSet_t* (*)(ocrSchedulerObjectFactory_t*, ocrSchedulerObject_t*, u32), prMqSchedulerObjectNewActionSet);
+    schedObjFact->fcts.destroyActionSet = FUNC_ADDR(u8 (*)(ocrSchedulerObjectFactory_t*, ocrSchedulerObjectActionSet_t*), prMqSchedulerObjectDestroyActionSet);
+    schedObjFact->fcts.switchRunlevel = FUNC_ADDR(u8 (*)(ocrSchedulerObject_t*, ocrPolicyDomain_t*, ocrRunlevel_t,
+                                                        phase_t, u32, void (*)(ocrPolicyDomain_t*, u64), u64), prMqSchedulerObjectSwitchRunlevel);
+    schedObjFact->fcts.ocrPolicyMsgGetMsgSize = FUNC_ADDR(u8 (*)(ocrSchedulerObjectFactory_t*, ocrPolicyMsg_t*, u64*, u32), prMqSchedulerObjectOcrPolicyMsgGetMsgSize);
+    schedObjFact->fcts.ocrPolicyMsgMarshallMsg = FUNC_ADDR(u8 (*)(ocrSchedulerObjectFactory_t*, ocrPolicyMsg_t*, u8*, u32), prMqSchedulerObjectOcrPolicyMsgMarshallMsg);
+    schedObjFact->fcts.ocrPolicyMsgUnMarshallMsg = FUNC_ADDR(u8 (*)(ocrSchedulerObjectFactory_t*, ocrPolicyMsg_t*, u8*, u8*, u32), prMqSchedulerObjectOcrPolicyMsgUnMarshallMsg);
+    return schedObjFact;
+}
+
+#endif /* ENABLE_SCHEDULER_OBJECT_PR_MQ */
@@ -0,0 +1,80 @@
+/*
+ * This file is subject to the license agreement located in the file LICENSE
+ * and cannot be distributed without it. This notice cannot be
+ * removed or modified.
+ */
+
+#ifndef __PR_MQ_SCHEDULER_OBJECT_H__
+#define __PR_MQ_SCHEDULER_OBJECT_H__
+
+#include "ocr-config.h"
+#ifdef ENABLE_SCHEDULER_OBJECT_PR_MQ
+
+#include "ocr-scheduler-object.h"
+#include "ocr-types.h"
+#include "utils/ocr-utils.h"
+#include "utils/bin-heap.h"
+
+/****************************************************/
+/* OCR PR_MQ SCHEDULER_OBJECT                       */
+/* (relaxed priority multi-queue)                   */
+/****************************************************/
+
+// Number of heaps per worker
+#ifndef PR_MQ_QUEUES_PER_WORKER
+#define PR_MQ_QUEUES_PER_WORKER 2
+#endif
+
+// Initial capacity of each heap, heaps grow when full
+#ifndef PR_MQ_INIT_HEAP_CAPACITY
+#define PR_MQ_INIT_HEAP_CAPACITY 1024
+#endif
+
+typedef struct _prMqQueue_t {
+    lock_t lock;
+    volatile s64 top;   // priority at the root of the heap, read without the lock
+    binHeap_t *heap;    // non-concurrent heap, guarded by 'lock'
+} prMqQueue_t;
+
+#define PR_MQ_QUEUE_SZB \
+    (((sizeof(prMqQueue_t) + CACHE_LINE_SZB - 1) / CACHE_LINE_SZB) * CACHE_LINE_SZB)
+
+typedef union _prMqPaddedQueue_t {
+    prMqQueue_t queue;
+    u8 padding[PR_MQ_QUEUE_SZB];
+} prMqPaddedQueue_t;
+
+typedef union _prMqPaddedSeed_t {
+    u64 seed;
+    u8 padding[CACHE_LINE_SZB];
+} prMqPaddedSeed_t;
+
+typedef struct _paramListSchedulerObjectPrMq_t {
+    paramListSchedulerObject_t base;
+} paramListSchedulerObjectPrMq_t;
+
+typedef struct _ocrSchedulerObjectPrMq_t {
+    ocrSchedulerObject_t base;
+    prMqPaddedQueue_t *queues;
+    u32 queueCount;
+    prMqPaddedSeed_t *seeds;        // per-worker random state to pick queues
+    u32 seedCount;
+} ocrSchedulerObjectPrMq_t;
+
+/****************************************************/
+/* OCR PR_MQ SCHEDULER_OBJECT FACTORY               */
+/****************************************************/
+
+typedef struct _ocrSchedulerObjectFactoryPrMq_t {
+    ocrSchedulerObjectFactory_t base;
+} ocrSchedulerObjectFactoryPrMq_t;
+
+typedef struct _paramListSchedulerObjectFactPrMq_t {
+    paramListSchedulerObjectFact_t base;
+} paramListSchedulerObjectFactPrMq_t;
+
+ocrSchedulerObjectFactory_t * newOcrSchedulerObjectFactoryPrMq(ocrParamList_t *perType, u32 factoryId);
+
+#endif /* ENABLE_SCHEDULER_OBJECT_PR_MQ */
+#endif /* __PR_MQ_SCHEDULER_OBJECT_H__ */
+
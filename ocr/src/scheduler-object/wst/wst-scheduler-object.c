@@ -53,6 +53,8 @@ static void wstSchedulerObjectStart(ocrSchedulerObject_t *self, ocrPolicyDomain_
                 params.type = WORK_STEALING_DEQUE;
             }
 #endif
+        } else if (wstSchedObj->config == SCHEDULER_OBJECT_WST_CONFIG_LOCKED) {
+            params.type = LOCKED_DEQUE;
         }
         ocrSchedulerObject_t *deque = dequeFactory->fcts.create(dequeFactory, (ocrParamList_t*)(&params));
         wstSchedObj->deques[i] = deque;
@@ -103,6 +105,7 @@ static void wstSchedulerObjectInitialize(ocrSchedulerObjectFactory_t *fact, ocrS
         switch(paramsWst->config) {
         case SCHEDULER_OBJECT_WST_CONFIG_REGULAR:
         case SCHEDULER_OBJECT_WST_CONFIG_STATIC:
+        case SCHEDULER_OBJECT_WST_CONFIG_LOCKED:
             break;
         default:
             ASSERT(0);
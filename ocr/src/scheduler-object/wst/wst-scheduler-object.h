@@ -21,6 +21,7 @@
 typedef enum {
     SCHEDULER_OBJECT_WST_CONFIG_REGULAR,    /* Configures scheduler object as an array of workstealing deques */
     SCHEDULER_OBJECT_WST_CONFIG_STATIC,     /* Configures scheduler object as an array of semi-concurrent deques */
+    SCHEDULER_OBJECT_WST_CONFIG_LOCKED,     /* Configures scheduler object as an array of locked deques (any worker may push) */
 } wstConfigType;
 typedef struct _paramListSchedulerObjectWst_t {
     paramListSchedulerObject_t base;
@@ -53,7 +53,29 @@ static u8 masterHelper(ocrWorker_t * worker) {
     // In helper mode, just try to execute another task
     // on top of the currently executing task's stack.
     worker->curTask = NULL; // nullify because we may execute MT
+    // The blocked EDT may be in the middle of a batched satisfy: what it made
+    // ready so far must be visible before this worker looks for work.
+    if (worker->readyBatchCount != 0) {
+        ocrPolicyDomain_t *pd = NULL;
+        getCurrentEnv(&pd, NULL, NULL, NULL);
+        RESULT_ASSERT(schedulerReadyBatchFlush(pd, worker), ==, 0);
+    }
+    // EDTs made ready by the tasks run meanwhile are not successors of the blocked one
+    bool inlineCapture = worker->inlineCapture;
+    worker->inlineCapture = false;
+    // Nor do they belong to its batching scopes: these only close once it resumes
+    u32 readyBatchDepth = worker->readyBatchDepth;
+    worker->readyBatchDepth = 0;
     worker->fcts.workShift(worker);
+    // The successor a task run meanwhile kept inline must not wait for the
+    // blocked EDT to complete: give it back to the scheduler
+    if (!ocrGuidIsNull(worker->inlineNext.guid)) {
+        ocrPolicyDomain_t *pd = NULL;
+        getCurrentEnv(&pd, NULL, NULL, NULL);
+        schedulerInlineSuccessorRelease(pd, worker);
+    }
+    worker->readyBatchDepth = readyBatchDepth;
+    worker->inlineCapture = inlineCapture;
 
     // restore worker context
     //BUG #204 this should be implemented in the worker
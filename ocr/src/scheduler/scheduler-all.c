@@ -6,6 +6,8 @@
 
 #include "scheduler/scheduler-all.h"
 #include "debug.h"
+#include "ocr-policy-domain.h"
+#include "ocr-worker.h"
 
 const char * scheduler_types[] = {
 #ifdef ENABLE_SCHEDULER_COMMON
@@ -65,3 +67,116 @@ void initializeSchedulerOcr(ocrSchedulerFactory_t * factory, ocrScheduler_t * se
     self->schedulerHeuristicCount = 0;
     self->fcts = factory->schedulerFcts;
 }
+
+bool schedulerReadyBatchBegin(ocrPolicyDomain_t *pd, ocrWorker_t *worker) {
+    if (worker->readyBatchDepth == 0) {
+        ocrScheduler_t *scheduler = pd->schedulers[0];
+        if ((scheduler->schedulerHeuristicCount == 0) ||
+            !scheduler->schedulerHeuristics[scheduler->masterHeuristicId]->notifyBatch)
+            return false;
+    }
+    ++worker->readyBatchDepth;
+    return true;
+}
+
+bool schedulerReadyBatchAdd(ocrPolicyDomain_t *pd, ocrWorker_t *worker, ocrFatGuid_t edt) {
+    if (worker->readyBatchDepth == 0) {
+        // Leftovers of scopes closed by an abort go first
+        if (worker->readyBatchCount != 0)
+            RESULT_ASSERT(schedulerReadyBatchFlush(pd, worker), ==, 0);
+        return false;
+    }
+    ASSERT(edt.metaDataPtr != NULL);
+    if (worker->readyBatchCount == SCHED_READY_BATCH_MAX)
+        RESULT_ASSERT(schedulerReadyBatchFlush(pd, worker), ==, 0);
+    worker->readyBatch[worker->readyBatchCount++] = edt;
+    return true;
+}
+
+u8 schedulerReadyBatchFlush(ocrPolicyDomain_t *pd, ocrWorker_t *worker) {
+    if (worker->readyBatchCount == 0)
+        return 0;
+    PD_MSG_STACK(msg);
+    getCurrentEnv(NULL, NULL, NULL, &msg);
+#define PD_MSG (&msg)
+#define PD_TYPE PD_MSG_SCHED_NOTIFY
+    msg.type = PD_MSG_SCHED_NOTIFY | PD_MSG_REQUEST;
+    PD_MSG_FIELD_IO(schedArgs).kind = OCR_SCHED_NOTIFY_EDTS_READY;
+    PD_MSG_FIELD_IO(schedArgs).OCR_SCHED_ARG_FIELD(OCR_SCHED_NOTIFY_EDTS_READY).guids = worker->readyBatch;
+    PD_MSG_FIELD_IO(schedArgs).OCR_SCHED_ARG_FIELD(OCR_SCHED_NOTIFY_EDTS_READY).count = worker->readyBatchCount;
+    RESULT_PROPAGATE(pd->fcts.processMessage(pd, &msg, false));
+    ASSERT(PD_MSG_FIELD_O(returnDetail) == 0);
+#undef PD_MSG
+#undef PD_TYPE
+    worker->readyBatchCount = 0;
+    return 0;
+}
+
+u8 schedulerReadyBatchEnd(ocrPolicyDomain_t *pd, ocrWorker_t *worker) {
+    ASSERT(worker->readyBatchDepth != 0);
+    if (--worker->readyBatchDepth != 0)
+        return 0;
+    return schedulerReadyBatchFlush(pd, worker);
+}
+
+bool schedulerInlineSuccessorBegin(ocrPolicyDomain_t *pd, ocrWorker_t *worker) {
+    if (worker->inlineDepthMax == 0)
+        return false;
+    ocrScheduler_t *scheduler = pd->schedulers[0];
+    if ((scheduler->schedulerHeuristicCount == 0) ||
+        !scheduler->schedulerHeuristics[scheduler->masterHeuristicId]->notifyInline)
+        return false;
+    worker->inlineCapture = true;
+    return true;
+}
+
+bool schedulerInlineSuccessorAdd(ocrPolicyDomain_t *pd, ocrWorker_t *worker, ocrFatGuid_t edt) {
+    if (!worker->inlineCapture)
+        return false;
+    ocrTask_t *task = (ocrTask_t*)edt.metaDataPtr;
+    ASSERT(task != NULL);
+    if (ocrGuidIsNull(worker->inlineNext.guid)) {
+        // Runtime EDTs are accounted for by the scheduler
+        u32 skipFlags = OCR_TASK_FLAG_RUNTIME_EDT;
+#ifdef ENABLE_EXTENSION_BLOCKING_SUPPORT
+        // A helping worker must not pick up a LONG EDT
+        skipFlags |= OCR_TASK_FLAG_LONG;
+#endif
+        if ((worker->inlineDepth < worker->inlineDepthMax) && ((task->flags & skipFlags) == 0)) {
+            worker->inlineNext = edt;
+            return true;
+        }
+        worker->inlineCapture = false;
+        return false;
+    }
+    // More than one successor: they all go through the scheduler so
+    // that the idle workers can steal them
+    worker->inlineCapture = false;
+    schedulerInlineSuccessorRelease(pd, worker);
+    return false;
+}
+
+void schedulerInlineSuccessorRelease(ocrPolicyDomain_t *pd, ocrWorker_t *worker) {
+    if (ocrGuidIsNull(worker->inlineNext.guid))
+        return;
+    ocrFatGuid_t next = worker->inlineNext;
+    worker->inlineNext.guid = NULL_GUID;
+    worker->inlineNext.metaDataPtr = NULL;
+    if (schedulerReadyBatchAdd(pd, worker, next))
+        return;
+    PD_MSG_STACK(msg);
+    getCurrentEnv(NULL, NULL, NULL, &msg);
+#define PD_MSG (&msg)
+#define PD_TYPE PD_MSG_SCHED_NOTIFY
+    msg.type = PD_MSG_SCHED_NOTIFY | PD_MSG_REQUEST;
+    PD_MSG_FIELD_IO(schedArgs).kind = OCR_SCHED_NOTIFY_EDT_READY;
+    PD_MSG_FIELD_IO(schedArgs).OCR_SCHED_ARG_FIELD(OCR_SCHED_NOTIFY_EDT_READY).guid = next;
+    RESULT_ASSERT(pd->fcts.processMessage(pd, &msg, false), ==, 0);
+    ASSERT(PD_MSG_FIELD_O(returnDetail) == 0);
+#undef PD_MSG
+#undef PD_TYPE
+}
+
+void schedulerInlineSuccessorEnd(ocrPolicyDomain_t *pd, ocrWorker_t *worker) {
+    worker->inlineCapture = false;
+}
@@ -29,6 +29,11 @@
 #endif
 
 #include "ocr-perfmon.h"
+#include "utils/perf-db.h"
+
+#ifdef ENABLE_EXTENSION_GRAPH
+#include "experimental/ocr-graph-runtime.h"
+#endif
 
 #ifdef OCR_ENABLE_STATISTICS
 #include "ocr-statistics.h"
@@ -105,31 +110,14 @@ u8 destructTaskTemplateHc(ocrTaskTemplate_t *self) {
 #ifdef ENABLE_EXTENSION_PERF
 void addPerfEntry(ocrPolicyDomain_t *pd, void *executePtr,
                          ocrTaskTemplate_t *taskT) {
-    u32 k;
-
-    // Skip adding a new entry if we already have one
-    if(taskT && (taskT->taskPerfsEntry!=NULL)) {
-       // Nothing to do
-    } else {
-        for(k=0; k < queueGetSize(pd->taskPerfs); k++)
-            if(((ocrPerfCounters_t*)queueGet(pd->taskPerfs, k))->edt == executePtr)
-                break;
-
-        if(k==queueGetSize(pd->taskPerfs)) {
-            u32 j;
-            ocrPerfCounters_t *cumulativeStats = (ocrPerfCounters_t *)pd->fcts.pdMalloc(pd, sizeof(ocrPerfCounters_t));
-            for(j = 0; j<PERF_MAX; j++){
-                cumulativeStats->stats[j].average = 0;
-                cumulativeStats->stats[j].current = 0;
-            }
-            cumulativeStats->count = 0;
-            cumulativeStats->steadyStateMask = ((1 << PERF_MAX) - 1); // Steady state not reached
-            cumulativeStats->edt = executePtr;
-            if(queueIsFull(pd->taskPerfs)) queueDoubleResize(pd->taskPerfs, true);
-            queueAddLast(pd->taskPerfs, cumulativeStats);
-            taskT->taskPerfsEntry = cumulativeStats;
-        } else taskT->taskPerfsEntry = queueGet(pd->taskPerfs, k);
-    }
+    // Skip the lookup if we already have an entry
+    if(taskT && (taskT->taskPerfsEntry!=NULL))
+        return;
+#ifdef OCR_ENABLE_EDT_NAMING
+    taskT->taskPerfsEntry = perfDbGet(pd->taskPerfs, executePtr, taskT->name);
+#else
+    taskT->taskPerfsEntry = perfDbGet(pd->taskPerfs, executePtr, NULL);
+#endif
 }
 #endif
 
@@ -181,6 +169,7 @@ ocrTaskTemplate_t * newTaskTemplateHc(ocrTaskTemplateFactory_t* factory, ocrEdt_
 #ifdef ENABLE_RESILIENCY
     base->base.kind = OCR_GUID_EDT_TEMPLATE;
     base->base.size = sizeof(ocrTaskTemplateHc_t) + hintc*sizeof(u64);
+    base->base.epoch = 0;
 #endif
 
     ocrTaskTemplateHc_t *derived = (ocrTaskTemplateHc_t*)base;
@@ -208,6 +197,7 @@ ocrTaskTemplate_t * newTaskTemplateHc(ocrTaskTemplateFactory_t* factory, ocrEdt_
 }
 
 u8 setHintTaskTemplateHc(ocrTaskTemplate_t* self, ocrHint_t *hint) {
+    OCR_OBJECT_MARK_DIRTY(self);
     ocrTaskTemplateHc_t *derived = (ocrTaskTemplateHc_t*)self;
     ocrRuntimeHint_t *rHint = &(derived->hint);
     OCR_RUNTIME_HINT_SET(hint, rHint, OCR_HINT_COUNT_EDT_HC, ocrHintPropTaskHc, OCR_HINT_EDT_PROP_START);
@@ -422,6 +412,9 @@ static u8 initTaskHcInternal(ocrTaskHc_t *task, ocrGuid_t taskGuid, ocrPolicyDom
     task->lock = INIT_LOCK;
 #endif
     task->slotSatisfiedCount = 0;
+#ifdef ENABLE_DB_ACQUIRE_PIPELINE
+    task->pendingAcquires = 0;
+#endif
     task->unkDbs = NULL;
     task->countUnkDbs = 0;
     task->maxUnkDbs = 0;
@@ -447,6 +440,7 @@ static u8 initTaskHcInternal(ocrTaskHc_t *task, ocrGuid_t taskGuid, ocrPolicyDom
 
 #ifdef ENABLE_EXTENSION_PERF
     for(i = 0; i < PERF_MAX - PERF_HW_MAX; i++) task->base.swPerfCtrs[i] = 0;
+    task->base.succBottomLevel = 0;
 #endif
 
     return 0;
@@ -476,6 +470,108 @@ static u8 initTaskHcInternal(ocrTaskHc_t *task, ocrGuid_t taskGuid, ocrPolicyDom
     }
 }
 
+#ifdef ENABLE_DB_ACQUIRE_PIPELINE
+/**
+ * @brief Advance the DB iteration frontier to the next DB
+ * This implementation iterates on the GUID-sorted signaler vector
+ * Returns false when the end of depv is reached and all the DBs are acquired
+ *
+ * Acquires are issued in GUID order. An RO or CONST acquire that went to a
+ * remote PD does not stop the iteration: the following read acquires are
+ * issued while it is in flight, up to the next acquire that is local and
+ * busy or in a write mode (RW, EW), which is only issued once all the
+ * previous ones completed. 'pendingAcquires' counts the acquires in flight
+ * plus one for the caller so that whoever brings it to zero (this call or
+ * the last dependenceResolvedTaskHc) resumes the iteration.
+ */
+static u8 iterateDbFrontier(ocrTask_t *self) {
+    ocrTaskHc_t * rself = ((ocrTaskHc_t *) self);
+    regNode_t * depv = rself->signalers;
+    u32 i;
+    do {
+        hal_xadd32(&(rself->pendingAcquires), 1);
+        for (i = rself->frontierSlot; i < self->depc; ++i) {
+            // Write acquires wait for the reads in flight to keep the GUID order
+            if ((rself->pendingAcquires != 1) && !ocrGuidIsNull(depv[i].guid) &&
+                (((depv[i].mode & DB_ACCESS_MODE_MASK) != DB_MODE_RO) && ((depv[i].mode & DB_ACCESS_MODE_MASK) != DB_MODE_CONST))) {
+                break;
+            }
+            //ACQUIRE can be non-blocking so pre-increment the frontier
+            //slot and adjust by -1 in dependenceResolvedTaskHc
+            rself->frontierSlot++;
+            if (!(ocrGuidIsNull(depv[i].guid))) {
+                // Because the frontier is sorted, we can check for duplicates here
+                // and remember them to avoid double release. Their pointer is set
+                // once all the acquires completed.
+                if ((i > 0) && (ocrGuidIsEq(depv[i-1].guid, depv[i].guid))) {
+                    // If the below asserts, rebuild OCR with a higher OCR_MAX_MULTI_SLOT (in build/common.mk)
+                    ASSERT(depv[i].slot / 64 < OCR_MAX_MULTI_SLOT);
+                    rself->doNotReleaseSlots[depv[i].slot / 64] |= (1ULL << (depv[i].slot % 64));
+#ifdef ENABLE_AMT_RESILIENCE
+                } else if (self->flags & OCR_TASK_FLAG_RESILIENT) { //For resilient tasks and DB, fetch instead of acquire
+                    if (!salIsSatisfiedResilientGuid(depv[i].guid)) fprintf(stderr, "iterateDbFrontier: EDT: 0x%lx DB: 0x%lx\n", self->guid.guid, depv[i].guid.guid);
+                    ASSERT(salIsSatisfiedResilientGuid(depv[i].guid));
+                    rself->resolvedDeps[depv[i].slot].ptr = UNINITIALIZED_DB_FETCH_PTR;
+                    ASSERT(depv[i].slot / 64 < OCR_MAX_MULTI_SLOT);
+                    rself->doNotReleaseSlots[depv[i].slot / 64] |= (1ULL << (depv[i].slot % 64));
+#endif
+                } else {
+                    // Issue acquire request
+                    ocrPolicyDomain_t * pd = NULL;
+                    PD_MSG_STACK(msg);
+                    getCurrentEnv(&pd, NULL, NULL, &msg);
+#define PD_MSG (&msg)
+#define PD_TYPE PD_MSG_DB_ACQUIRE
+                    msg.type = PD_MSG_DB_ACQUIRE | PD_MSG_REQUEST | PD_MSG_REQ_RESPONSE;
+                    PD_MSG_FIELD_IO(guid.guid) = depv[i].guid; // DB guid
+                    PD_MSG_FIELD_IO(guid.metaDataPtr) = NULL;
+                    PD_MSG_FIELD_IO(destLoc) = pd->myLocation;
+                    PD_MSG_FIELD_IO(edt.guid) = self->guid; // EDT guid
+                    PD_MSG_FIELD_IO(edt.metaDataPtr) = self;
+                    PD_MSG_FIELD_IO(destLoc) = pd->myLocation;
+                    PD_MSG_FIELD_IO(edtSlot) = self->depc + 1; // RT slot
+                    PD_MSG_FIELD_IO(properties) = depv[i].mode;
+                    // The response may come back on another worker before processMessage returns
+                    hal_xadd32(&(rself->pendingAcquires), 1);
+                    u8 returnCode = pd->fcts.processMessage(pd, &msg, false);
+                    // DB_ACQUIRE is potentially asynchronous, check completion.
+                    // In shmem and dist HC PD, ACQUIRE is two-way, processed asynchronously
+                    // (the false in 'processMessage'). For now the CE/XE PD do not support this
+                    // mode so we need to check for the returnDetail of the acquire message instead.
+                    if (PD_MSG_FIELD_O(returnDetail) == OCR_EBUSY) {
+                        // Waiting on another EDT's release, locally or in the proxy
+                        break;
+                    }
+                    if (returnCode == OCR_EPEND) {
+                        // In flight to a remote PD
+                        continue;
+                    }
+                    hal_xadd32(&(rself->pendingAcquires), -1);
+#ifdef ENABLE_EXTENSION_PERF
+                    rself->base.swPerfCtrs[PERF_DB_TOTAL - PERF_HW_MAX] += PD_MSG_FIELD_O(size);
+#endif
+                    // else, acquire took place and was successful, continue iterating
+                    ASSERT(msg.type & PD_MSG_RESPONSE); // 2x check
+                    rself->resolvedDeps[depv[i].slot].ptr = PD_MSG_FIELD_O(ptr);
+#undef PD_MSG
+#undef PD_TYPE
+                }
+            }
+        }
+        if (hal_xadd32(&(rself->pendingAcquires), -1) != 1) {
+            // Some acquires are still in flight, the last one to complete resumes
+            return true;
+        }
+        // Else all completed meanwhile, resume if we stopped early
+    } while (rself->frontierSlot != self->depc);
+    for (i = 1; i < self->depc; ++i) {
+        if (!ocrGuidIsNull(depv[i].guid) && ocrGuidIsEq(depv[i-1].guid, depv[i].guid)) {
+            rself->resolvedDeps[depv[i].slot].ptr = rself->resolvedDeps[depv[i-1].slot].ptr;
+        }
+    }
+    return false;
+}
+#else
 /**
  * @brief Advance the DB iteration frontier to the next DB
  * This implementation iterates on the GUID-sorted signaler vector
@@ -542,6 +638,7 @@ static u8 iterateDbFrontier(ocrTask_t *self) {
     }
     return false;
 }
+#endif
 
 #ifdef ENABLE_AMT_RESILIENCE
 static u8 resilientLatchDecr(ocrTask_t *self) {
@@ -555,6 +652,7 @@ static u8 resilientLatchDecr(ocrTask_t *self) {
     ocrTask_t *suspendedTask = worker->curTask;
     jmp_buf *suspendedBuf = worker->jmpbuf;
     int blockedContexts = worker->blockedContexts;
+    u32 readyBatchDepth = worker->readyBatchDepth;
     hal_fence();
     jmp_buf buf;
     int rc = setjmp(buf);
@@ -582,6 +680,7 @@ static u8 resilientLatchDecr(ocrTask_t *self) {
     } else {
         DPRINTF(DEBUG_LVL_WARN, "Worker aborted processing resilientLatchDecr\n");
         ASSERT(worker->blockedContexts == blockedContexts);
+        worker->readyBatchDepth = readyBatchDepth; // Close the batching scopes the abort jumped out of
     }
     hal_fence();
     worker->waitloc = UNDEFINED_LOCATION;
@@ -605,8 +704,9 @@ static u8 scheduleTask(ocrTask_t *self) {
     DPRINTF(DEBUG_LVL_INFO, "Schedule "GUIDF"\n", GUIDA(self->guid));
     self->state = ALLACQ_EDTSTATE;
     ocrPolicyDomain_t *pd = NULL;
+    ocrWorker_t *worker = NULL;
     PD_MSG_STACK(msg);
-    getCurrentEnv(&pd, NULL, NULL, &msg);
+    getCurrentEnv(&pd, &worker, NULL, &msg);
 #ifdef ENABLE_AMT_RESILIENCE
     if (self->flags & OCR_TASK_FLAG_RESILIENT) {
         salResilientTaskPublish(self);
@@ -619,6 +719,14 @@ static u8 scheduleTask(ocrTask_t *self) {
 #ifdef OCR_MONITOR_SCHEDULER
     OCR_TOOL_TRACE(false, OCR_TRACE_TYPE_SCHEDULER, OCR_ACTION_SCHED_MSG_SEND, self->guid);
 #endif
+    // Single successor of the EDT this worker just completed (see taskEpilogue)
+    // or part of a batch of EDTs made ready together (see commonSatisfyWaiters)
+    if (worker != NULL) {
+        ocrFatGuid_t edt = {.guid = self->guid, .metaDataPtr = self};
+        if (schedulerInlineSuccessorAdd(pd, worker, edt) ||
+            schedulerReadyBatchAdd(pd, worker, edt))
+            return 0;
+    }
 
 #define PD_MSG (&msg)
 #define PD_TYPE PD_MSG_SCHED_NOTIFY
@@ -666,6 +774,19 @@ static u8 taskAllDepvSatisfied(ocrTask_t *self) {
     // In this implementation we want to acquire locks for DBs in EW mode
     ocrTaskHc_t * rself = (ocrTaskHc_t *) self;
     rself->slotSatisfiedCount++; // Mark the slotSatisfiedCount as being all satisfied
+#ifdef ENABLE_EXTENSION_PERF
+    {
+        // The EDT whose signal (or creation) makes this one runnable
+        // precedes it on the critical path
+        ocrTask_t * curEdt = NULL;
+        getCurrentEnv(NULL, NULL, &curEdt, NULL);
+        if ((curEdt != NULL) && (curEdt != self) && (self->taskPerfsEntry != NULL)) {
+            curEdt->swPerfCtrs[PERF_EDT_SUCCESSORS - PERF_HW_MAX]++;
+            if (self->taskPerfsEntry->bottomLevel > curEdt->succBottomLevel)
+                curEdt->succBottomLevel = self->taskPerfsEntry->bottomLevel;
+        }
+    }
+#endif
     if (self->depc > 0) {
         ocrPolicyDomain_t * pd = NULL;
         getCurrentEnv(&pd, NULL, NULL, NULL);
@@ -968,6 +1089,7 @@ u8 newTaskHc(ocrTaskFactory_t* factory, ocrFatGuid_t * edtGuid, ocrFatGuid_t edt
 #ifdef ENABLE_RESILIENCY
     self->base.kind = OCR_GUID_EDT;
     self->base.size = szMd;
+    self->base.epoch = 0;
 #endif
     // Set-up base structures
     self->templateGuid = edtTemplate.guid;
@@ -991,6 +1113,9 @@ u8 newTaskHc(ocrTaskFactory_t* factory, ocrFatGuid_t * edtGuid, ocrFatGuid_t edt
     self->depc = depc;
     self->flags = 0;
     self->fctId = factory->factoryId;
+#ifdef ENABLE_EXTENSION_GRAPH
+    self->graphCapture = NULL;
+#endif
     for(i = 0; i < paramc; ++i) {
         self->paramv[i] = paramv[i];
     }
@@ -1005,6 +1130,9 @@ u8 newTaskHc(ocrTaskFactory_t* factory, ocrFatGuid_t * edtGuid, ocrFatGuid_t edt
     if (hintc == 0) {
         dself->hint.hintMask = 0;
         dself->hint.hintVal = NULL;
+#ifdef ENABLE_EXTENSION_PERF
+        self->taskPerfsEntry = NULL;
+#endif
     } else {
         self->flags |= OCR_TASK_FLAG_USES_HINTS;
         ocrTaskTemplateHc_t *derived = (ocrTaskTemplateHc_t*)(edtTemplate.metaDataPtr);
@@ -1136,6 +1264,7 @@ u8 newTaskHc(ocrTaskFactory_t* factory, ocrFatGuid_t * edtGuid, ocrFatGuid_t edt
 }
 
 u8 dependenceResolvedTaskHc(ocrTask_t * self, ocrGuid_t dbGuid, void * localDbPtr, u32 slot) {
+    OCR_OBJECT_MARK_DIRTY(self);
     ocrTaskHc_t * rself = (ocrTaskHc_t *) self;
     //BUG #924 - We need to decouple satisfy and acquire. Until then, we will
     //use this workaround of using the slot info to do that.
@@ -1146,6 +1275,9 @@ u8 dependenceResolvedTaskHc(ocrTask_t * self, ocrGuid_t dbGuid, void * localDbPt
         //I believe the signalers are already sorted, this assert should
         //fail if that's not the case and we can revisit why
         ASSERT(rself->frontierSlot == 0);
+#ifdef ENABLE_DB_ACQUIRE_PIPELINE
+        ASSERT(rself->pendingAcquires == 0);
+#endif
         // Sort regnode in guid's ascending order.
         // This is the order in which we acquire the DBs
         sortRegNode(rself->signalers, self->depc);
@@ -1156,6 +1288,31 @@ u8 dependenceResolvedTaskHc(ocrTask_t * self, ocrGuid_t dbGuid, void * localDbPt
         // should only happen on RT event slot to manage DB acquire
         ASSERT(slot == (self->depc+1));
         ASSERT(rself->slotSatisfiedCount == slot);
+#ifdef ENABLE_DB_ACQUIRE_PIPELINE
+        // Several acquires may be in flight behind the frontier: look for the
+        // first signaler of the DB in the GUID-sorted vector (duplicates are
+        // not acquired). Each acquire resolves its own slot so we do not need
+        // to lock this code.
+        regNode_t * signalers = rself->signalers;
+        u32 lo = 0, hi = rself->frontierSlot;
+        while (lo < hi) {
+            u32 mid = (lo + hi) / 2;
+            if (ocrGuidIsLt(signalers[mid].guid, dbGuid)) {
+                lo = mid + 1;
+            } else {
+                hi = mid;
+            }
+        }
+        ASSERT((lo < rself->frontierSlot) && ocrGuidIsEq(dbGuid, signalers[lo].guid));
+#ifdef ENABLE_AMT_RESILIENCE
+        ASSERT(localDbPtr == UNINITIALIZED_DB_FETCH_PTR);
+#endif
+        rself->resolvedDeps[signalers[lo].slot].ptr = localDbPtr;
+        if (hal_xadd32(&(rself->pendingAcquires), -1) != 1) {
+            // Other acquires are in flight or the frontier is being advanced
+            return 0;
+        }
+#else
         // Implementation acquires DB sequentially, so the DB's GUID
         // must match the frontier's DB and we do not need to lock this code
         ASSERT(ocrGuidIsEq(dbGuid, rself->signalers[rself->frontierSlot-1].guid));
@@ -1163,6 +1320,7 @@ u8 dependenceResolvedTaskHc(ocrTask_t * self, ocrGuid_t dbGuid, void * localDbPt
         ASSERT(localDbPtr == UNINITIALIZED_DB_FETCH_PTR);
 #endif
         rself->resolvedDeps[rself->signalers[rself->frontierSlot-1].slot].ptr = localDbPtr;
+#endif
     }
     if (!iterateDbFrontier(self)) {
         scheduleTask(self);
@@ -1172,6 +1330,7 @@ u8 dependenceResolvedTaskHc(ocrTask_t * self, ocrGuid_t dbGuid, void * localDbPt
 
 #ifdef REG_ASYNC_SGL
 u8 satisfyTaskHcWithMode(ocrTask_t * base, ocrFatGuid_t data, u32 slot, ocrDbAccessMode_t mode) {
+    OCR_OBJECT_MARK_DIRTY(base);
     ASSERT (((!ocrGuidIsNull(data.guid)) ? (mode != -1) : 1) && "Mode should alway be provided");
     ASSERT(!ocrGuidIsUninitialized(data.guid) && !ocrGuidIsError(data.guid));
     // Check slot is in bounds
@@ -1215,6 +1374,7 @@ u8 registerSignalerTaskHc(ocrTask_t * base, ocrFatGuid_t signalerGuid, u32 slot,
 
 u8 satisfyTaskHc(ocrTask_t * base, ocrFatGuid_t data, u32 slot)
 {
+    OCR_OBJECT_MARK_DIRTY(base);
     // An EDT has a list of signalers, but only registers
     // incrementally as signals arrive AND on non-persistent
     // events (latch or ONCE)
@@ -1360,6 +1520,7 @@ u8 satisfyTaskHc(ocrTask_t * base, ocrFatGuid_t data, u32 slot)
  */
 u8 registerSignalerTaskHc(ocrTask_t * base, ocrFatGuid_t signalerGuid, u32 slot,
                             ocrDbAccessMode_t mode, bool isDepAdd) {
+    OCR_OBJECT_MARK_DIRTY(base);
     ASSERT(isDepAdd); // This should only be called when adding a dependence
 
     ocrTaskHc_t * self = (ocrTaskHc_t *) base;
@@ -1444,9 +1605,51 @@ u8 registerSignalerTaskHc(ocrTask_t * base, ocrFatGuid_t signalerGuid, u32 slot,
     return 0;
 }
 
+/**
+ * Bulk version of registerSignalerTaskHc for persistent events. All the slots
+ * are recorded under a single lock and the EDT only registers on the signaler
+ * of the frontier slot, the others are registered lazily as usual.
+ */
+u8 registerSignalersTaskHc(ocrTask_t * base, u32 count, ocrFatGuid_t *signalers, u32 *slots,
+                           ocrDbAccessMode_t *modes) {
+    OCR_OBJECT_MARK_DIRTY(base);
+    ocrTaskHc_t * self = (ocrTaskHc_t *) base;
+    bool doRegister = false;
+    u32 frontierSlot = 0;
+    u32 i;
+    hal_lock(&(self->lock));
+    for(i = 0; i < count; ++i) {
+        u32 slot = slots[i];
+        regNode_t * node = &(self->signalers[slot]);
+        ASSERT_BLOCK_BEGIN(slot < base->depc);
+        DPRINTF(DEBUG_LVL_WARN, "User-level error detected: add dependence slot is out of bounds: EDT="GUIDF" slot=%"PRIu32" depc=%"PRIu32"\n",
+                                GUIDA(base->guid), slot, base->depc);
+        ASSERT_BLOCK_END
+        ASSERT(!(ocrGuidIsNull(signalers[i].guid)));
+        ASSERT(node->slot == slot); // assumption from initialization
+        node->mode = modes[i];
+        node->guid = signalers[i].guid;
+        if(slot == self->frontierSlot) {
+            doRegister = true;
+            frontierSlot = slot;
+        }
+    }
+    hal_unlock(&(self->lock));
+    if(doRegister) {
+        // The EDT registers itself as a waiter on the frontier's event
+        ocrPolicyDomain_t *pd = NULL;
+        PD_MSG_STACK(msg);
+        getCurrentEnv(&pd, NULL, NULL, &msg);
+        RESULT_PROPAGATE(registerOnFrontier(self, pd, &msg, frontierSlot));
+    }
+    DPRINTF(DEBUG_LVL_INFO, "AddDependences %"PRIu32" signalers to "GUIDF"\n", count, GUIDA(base->guid));
+    return 0;
+}
+
 #else /* REG_ASYNC */
 
 u8 satisfyTaskHc(ocrTask_t * base, ocrFatGuid_t data, u32 slot) {
+    OCR_OBJECT_MARK_DIRTY(base);
     ocrTaskHc_t * self = (ocrTaskHc_t *) base;
     self->signalers[slot].guid = data.guid;
     hal_fence();
@@ -1467,6 +1670,7 @@ u8 satisfyTaskHc(ocrTask_t * base, ocrFatGuid_t data, u32 slot) {
 
 u8 registerSignalerTaskHc(ocrTask_t * base, ocrFatGuid_t signalerGuid, u32 slot,
                             ocrDbAccessMode_t mode, bool isDepAdd) {
+    OCR_OBJECT_MARK_DIRTY(base);
     ocrTaskHc_t * self = (ocrTaskHc_t *) base;
     self->signalers[slot].mode = mode;
     hal_fence();
@@ -1495,6 +1699,7 @@ u8 unregisterSignalerTaskHc(ocrTask_t * base, ocrFatGuid_t signalerGuid, u32 slo
 }
 
 u8 notifyDbAcquireTaskHc(ocrTask_t *base, ocrFatGuid_t db) {
+    OCR_OBJECT_MARK_DIRTY(base);
     // This implementation does NOT support EDTs moving while they are executing
     ocrTaskHc_t *derived = (ocrTaskHc_t*)base;
     ocrPolicyDomain_t *pd = NULL;
@@ -1521,6 +1726,7 @@ u8 notifyDbAcquireTaskHc(ocrTask_t *base, ocrFatGuid_t db) {
 }
 
 u8 notifyDbReleaseTaskHc(ocrTask_t *base, ocrFatGuid_t db) {
+    OCR_OBJECT_MARK_DIRTY(base);
     ocrTaskHc_t *derived = (ocrTaskHc_t*)base;
     if ((derived->unkDbs != NULL) || (base->depc != 0)) {
         // Search in the list of DBs created by the EDT
@@ -1717,9 +1923,16 @@ static u8 taskEpilogue(ocrTask_t * base, ocrPolicyDomain_t *pd, ocrWorker_t * cu
     statsEDT_END(pd, ctx->sourceObj, curWorker, base->guid, base);
 #endif /* OCR_ENABLE_STATISTICS */
     DPRINTF(DEBUG_LVL_INFO, "End_Execution "GUIDF"\n", GUIDA(base->guid));
-#if !defined(OCR_ENABLE_SIMULATOR)
+#if !defined(OCR_ENABLE_SIMULATOR) && !defined(ENABLE_EXTENSION_PERF)
+    // With performance monitoring, the worker traces the finish with the counters
     OCR_TOOL_TRACE(true, OCR_TRACE_TYPE_EDT, OCR_ACTION_FINISH, traceTaskFinish, base->guid);
 #endif
+#ifdef ENABLE_EXTENSION_GRAPH
+    if (base->graphCapture != NULL)
+        graphCaptureAbort(base);
+#endif
+    // If the epilogue makes a single EDT ready, the worker runs it next
+    bool inlineSuccessor = (curWorker != NULL) && schedulerInlineSuccessorBegin(pd, curWorker);
     // edt user code is done, if any deps, release data-blocks
     if(depc != 0) {
         START_PROFILE(ta_hc_dbRel);
@@ -1839,6 +2052,8 @@ static u8 taskEpilogue(ocrTask_t * base, ocrPolicyDomain_t *pd, ocrWorker_t * cu
         ASSERT(base->depc == 0); //Limitation
     }
 #endif
+    if (inlineSuccessor)
+        schedulerInlineSuccessorEnd(pd, curWorker);
     EXIT_PROFILE;
 
 //TODO-DEFERRED: In non-deferred this is in the worker code after task->execute. Pondering if that
@@ -1863,6 +2078,7 @@ static u8 taskEpilogue(ocrTask_t * base, ocrPolicyDomain_t *pd, ocrWorker_t * cu
 
 u8 taskExecute(ocrTask_t* base) {
     START_PROFILE(ta_hc_execute);
+    OCR_OBJECT_MARK_DIRTY(base);
     ocrTaskHc_t* derived = (ocrTaskHc_t*)base;
     // In this implementation each time a signaler has been satisfied, its guid
     // has been replaced by the db guid it has been satisfied with.
@@ -1932,7 +2148,7 @@ u8 taskExecute(ocrTask_t* base) {
             latchParams.EVENT_LATCH.counter = 1;
             PD_MSG_FIELD_I(params) = &latchParams;
 #endif
-            PD_MSG_FIELD_I(properties) = (base->flags & OCR_TASK_FLAG_RESILIENT) ? (EVT_PROP_RESILIENT | EVT_RT_PROP_RESILIENT_LATCH) : 0;
+            PD_MSG_FIELD_I(properties) = (base->flags & OCR_TASK_FLAG_RESILIENT) ? (EVT_PROP_RESILIENT | EVT_RT_PROP_RESILIENT_LATCH) : EVT_RT_PROP_FINISH_LATCH;
 #ifdef ENABLE_AMT_RESILIENCE
             PD_MSG_FIELD_I(resilientParentLatch) = (base->flags & OCR_TASK_FLAG_RESILIENT) ? base->resilientLatch : NULL_GUID;
             PD_MSG_FIELD_I(key) = 0;
@@ -2202,6 +2418,7 @@ u8 processEventTaskHc(ocrObject_t *self, pdEvent_t** evt, u32 idx) {
 
 
 u8 setHintTaskHc(ocrTask_t* self, ocrHint_t *hint) {
+    OCR_OBJECT_MARK_DIRTY(self);
     ocrTaskHc_t *derived = (ocrTaskHc_t*)self;
     ocrRuntimeHint_t *rHint = &(derived->hint);
     OCR_RUNTIME_HINT_SET(hint, rHint, OCR_HINT_COUNT_EDT_HC, ocrHintPropTaskHc, OCR_HINT_EDT_PROP_START);
@@ -2598,6 +2815,11 @@ ocrTaskFactory_t * newTaskFactoryHc(ocrParamList_t* perInstance, u32 factoryId)
 #endif
     base->fcts.registerSignaler = FUNC_ADDR(u8 (*)(ocrTask_t*, ocrFatGuid_t, u32, ocrDbAccessMode_t, bool), registerSignalerTaskHc);
     base->fcts.unregisterSignaler = FUNC_ADDR(u8 (*)(ocrTask_t*, ocrFatGuid_t, u32, bool), unregisterSignalerTaskHc);
+#if !defined(REG_ASYNC) && !defined(REG_ASYNC_SGL)
+    base->fcts.registerSignalers = FUNC_ADDR(u8 (*)(ocrTask_t*, u32, ocrFatGuid_t*, u32*, ocrDbAccessMode_t*), registerSignalersTaskHc);
+#else
+    base->fcts.registerSignalers = NULL;
+#endif
     base->fcts.notifyDbAcquire = FUNC_ADDR(u8 (*)(ocrTask_t*, ocrFatGuid_t), notifyDbAcquireTaskHc);
     base->fcts.notifyDbRelease = FUNC_ADDR(u8 (*)(ocrTask_t*, ocrFatGuid_t), notifyDbReleaseTaskHc);
     base->fcts.execute = FUNC_ADDR(u8 (*)(ocrTask_t*), taskExecute);
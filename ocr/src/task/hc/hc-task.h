@@ -70,6 +70,10 @@ typedef struct {
     u32 frontierSlot; /**< Slot of the execution frontier
                            This excludes once events */
     u32 slotSatisfiedCount; /**< Number of slots satisfied */
+#ifdef ENABLE_DB_ACQUIRE_PIPELINE
+    u32 pendingAcquires; /**< DB acquires in flight, plus one while
+                              the frontier is being advanced */
+#endif
     regNode_t * signalers; /**< Does not grow, set once when the task is created */
     ocrGuid_t* unkDbs;     /**< Contains the list of DBs dynamically acquired (through DB create) */
     u32 countUnkDbs;       /**< Count in unkDbs */
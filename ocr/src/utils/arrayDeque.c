@@ -461,6 +461,7 @@ deque_t* newArrayQueue(ocrPolicyDomain_t *pd, void * initValue) {
     self->base.size = adWsize;
     self->base.destruct = adWdestruct;
     self->base.pushAtTail = adWpushAtTail;
+    self->base.pushBatchAtTail = NULL;
     self->base.popFromTail = adWpopFromTail;
     self->base.pushAtHead = adWpushAtHead;
     self->base.popFromHead = adWpopFromHead;
@@ -34,33 +34,36 @@ void binHeapDestroy(ocrPolicyDomain_t *pd, binHeap_t* heap) {
  * where the function pointers to push and pop are set by the derived
  * implementation.
  */
-static void _baseBinHeapInit(binHeap_t* heap, ocrPolicyDomain_t *pd) {
+static void _baseBinHeapInit(binHeap_t* heap, ocrPolicyDomain_t *pd, u32 capacity) {
+    ASSERT(capacity > 0);
     heap->count = 0;
+    heap->capacity = capacity;
     heap->data = NULL;
-    heap->data = pd->fcts.pdMalloc(pd, sizeof(ocrBinHeapEntry_t)*INIT_BIN_HEAP_CAPACITY);
+    heap->data = pd->fcts.pdMalloc(pd, sizeof(ocrBinHeapEntry_t)*capacity);
     ASSERT(heap->data != NULL);
     heap->destruct = binHeapDestroy;
     // Set by derived implementation
     heap->push = NULL;
+    heap->pushBatch = NULL;
     heap->pop = NULL;
 }
 
-static void _lockedBinHeapInit(binHeapLocked_t* heap, ocrPolicyDomain_t *pd) {
-    _baseBinHeapInit((binHeap_t*)heap, pd);
+static void _lockedBinHeapInit(binHeapLocked_t* heap, ocrPolicyDomain_t *pd, u32 capacity) {
+    _baseBinHeapInit((binHeap_t*)heap, pd, capacity);
     heap->lock = INIT_LOCK;
 }
 
-static binHeap_t * _newBaseBinHeap(ocrPolicyDomain_t *pd, ocrBinHeapType_t type) {
+static binHeap_t * _newBaseBinHeap(ocrPolicyDomain_t *pd, ocrBinHeapType_t type, u32 capacity) {
     binHeap_t* heap = NULL;
     switch(type) {
         case NO_LOCK_BASE_BIN_HEAP:
             heap = (binHeap_t*) pd->fcts.pdMalloc(pd, sizeof(binHeap_t));
-            _baseBinHeapInit(heap, pd);
+            _baseBinHeapInit(heap, pd, capacity);
             // Warning: function pointers must be specialized in caller
             break;
         case LOCK_BASE_BIN_HEAP:
             heap = (binHeap_t*) pd->fcts.pdMalloc(pd, sizeof(binHeapLocked_t));
-            _lockedBinHeapInit((binHeapLocked_t*)heap, pd);
+            _lockedBinHeapInit((binHeapLocked_t*)heap, pd, capacity);
             // Warning: function pointers must be specialized in caller
             break;
     default:
@@ -140,8 +143,15 @@ static void _checkHeap(binHeap_t *heap) {
  */
 void nonConcBinHeapPush(binHeap_t *heap, void *entry, s64 priority, u8 doTry) {
     const u32 n = heap->count;
-    if (n == INIT_BIN_HEAP_CAPACITY) { /* binHeap looks full */
-        ASSERT("Binary heap full, increase bin-heap's size" && 0);
+    if (n == heap->capacity) { /* binHeap is full, double its capacity */
+        ocrPolicyDomain_t *pd = NULL;
+        getCurrentEnv(&pd, NULL, NULL, NULL);
+        ocrBinHeapEntry_t *oldData = heap->data;
+        heap->data = pd->fcts.pdMalloc(pd, sizeof(ocrBinHeapEntry_t)*(heap->capacity*2));
+        ASSERT(heap->data != NULL);
+        hal_memCopy(heap->data, oldData, sizeof(ocrBinHeapEntry_t)*n, false);
+        pd->fcts.pdFree(pd, oldData);
+        heap->capacity *= 2;
     }
     heap->count++;
     ocrBinHeapEntry_t node = { priority, entry };
@@ -150,6 +160,15 @@ void nonConcBinHeapPush(binHeap_t *heap, void *entry, s64 priority, u8 doTry) {
     _checkHeap(heap);
 }
 
+/*
+ * push 'count' entries onto the binHeap
+ */
+void nonConcBinHeapPushBatch(binHeap_t *heap, ocrBinHeapEntry_t *entries, u32 count, u8 doTry) {
+    u32 i;
+    for (i = 0; i < count; i++)
+        nonConcBinHeapPush(heap, entries[i].entry, entries[i].priority, doTry);
+}
+
 /*
  * pop the task out of the binHeap from the tail
  */
@@ -179,6 +198,17 @@ void lockedBinHeapPush(binHeap_t *self, void *entry, s64 priority, u8 doTry) {
     hal_unlock(&dself->lock);
 }
 
+/*
+ * Push 'count' entries onto the binHeap
+ * This operation locks the whole binHeap once.
+ */
+void lockedBinHeapPushBatch(binHeap_t *self, ocrBinHeapEntry_t *entries, u32 count, u8 doTry) {
+    binHeapLocked_t* dself = (binHeapLocked_t*)self;
+    hal_lock(&dself->lock);
+    nonConcBinHeapPushBatch(self, entries, count, doTry);
+    hal_unlock(&dself->lock);
+}
+
 /*
  * Pop the task out of the binHeap
  * This operation locks the whole binHeap.
@@ -200,19 +230,21 @@ void * lockedBinHeapPop(binHeap_t * self, u8 doTry) {
  * @brief BinHeap constructor. For a given type, create an instance and
  * initialize its base type.
  */
-binHeap_t * newBinHeap(ocrPolicyDomain_t *pd, ocrBinHeapType_t type) {
+binHeap_t * newBinHeapWithCapacity(ocrPolicyDomain_t *pd, ocrBinHeapType_t type, u32 capacity) {
     binHeap_t* heap = NULL;
     switch(type) {
     case NON_CONCURRENT_BIN_HEAP:
-        heap = _newBaseBinHeap(pd, NO_LOCK_BASE_BIN_HEAP);
+        heap = _newBaseBinHeap(pd, NO_LOCK_BASE_BIN_HEAP, capacity);
         // Specialize push/pop implementations
         heap->push = nonConcBinHeapPush;
+        heap->pushBatch = nonConcBinHeapPushBatch;
         heap->pop = nonConcBinHeapPop;
         break;
     case LOCKED_BIN_HEAP:
-        heap = _newBaseBinHeap(pd, LOCK_BASE_BIN_HEAP);
+        heap = _newBaseBinHeap(pd, LOCK_BASE_BIN_HEAP, capacity);
         // Specialize push/pop implementations
         heap->push =  lockedBinHeapPush;
+        heap->pushBatch = lockedBinHeapPushBatch;
         heap->pop = lockedBinHeapPop;
         break;
     default:
@@ -222,6 +254,10 @@ binHeap_t * newBinHeap(ocrPolicyDomain_t *pd, ocrBinHeapType_t type) {
     return heap;
 }
 
+binHeap_t * newBinHeap(ocrPolicyDomain_t *pd, ocrBinHeapType_t type) {
+    return newBinHeapWithCapacity(pd, type, INIT_BIN_HEAP_CAPACITY);
+}
+
 /**
  * @brief Unsynchronized implementation for push and pop
  */
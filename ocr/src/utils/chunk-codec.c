@@ -0,0 +1,286 @@
+/*
+ * This file is subject to the license agreement located in the file LICENSE
+ * and cannot be distributed without it. This notice cannot be
+ * removed or modified.
+ *
+ * Chunked codec streams used for checkpoints and published data-blocks.
+ * The zero-run elision (ZRLE) codec encodes a chunk as a sequence of tokens
+ *
+ *   [u32 literalLength][u32 zeroLength][literalLength bytes]
+ *
+ * which decode to the literal bytes followed by zeroLength zero bytes.
+ */
+
+#include "ocr-config.h"
+
+#include "ocr-hal.h"
+#include "debug.h"
+#include "ocr-errors.h"
+#include "ocr-types.h"
+#include "utils/chunk-codec.h"
+
+#define DEBUG_TYPE UTIL
+
+// Shorter zero runs are kept in literals since a token costs 8 bytes
+#define ZRLE_MIN_RUN        16
+#define ZRLE_TOKEN_SIZE     (2*sizeof(u32))
+#define CODEC_ALIGN(size)   (((size) + 7ULL) & ~7ULL)
+
+const char * codec_types[] = {
+    "none",
+    "zrle",
+    NULL
+};
+
+static const u32 crc32Table[256] = {
+    0x00000000U, 0x77073096U, 0xee0e612cU, 0x990951baU, 0x076dc419U, 0x706af48fU,
+    0xe963a535U, 0x9e6495a3U, 0x0edb8832U, 0x79dcb8a4U, 0xe0d5e91eU, 0x97d2d988U,
+    0x09b64c2bU, 0x7eb17cbdU, 0xe7b82d07U, 0x90bf1d91U, 0x1db71064U, 0x6ab020f2U,
+    0xf3b97148U, 0x84be41deU, 0x1adad47dU, 0x6ddde4ebU, 0xf4d4b551U, 0x83d385c7U,
+    0x136c9856U, 0x646ba8c0U, 0xfd62f97aU, 0x8a65c9ecU, 0x14015c4fU, 0x63066cd9U,
+    0xfa0f3d63U, 0x8d080df5U, 0x3b6e20c8U, 0x4c69105eU, 0xd56041e4U, 0xa2677172U,
+    0x3c03e4d1U, 0x4b04d447U, 0xd20d85fdU, 0xa50ab56bU, 0x35b5a8faU, 0x42b2986cU,
+    0xdbbbc9d6U, 0xacbcf940U, 0x32d86ce3U, 0x45df5c75U, 0xdcd60dcfU, 0xabd13d59U,
+    0x26d930acU, 0x51de003aU, 0xc8d75180U, 0xbfd06116U, 0x21b4f4b5U, 0x56b3c423U,
+    0xcfba9599U, 0xb8bda50fU, 0x2802b89eU, 0x5f058808U, 0xc60cd9b2U, 0xb10be924U,
+    0x2f6f7c87U, 0x58684c11U, 0xc1611dabU, 0xb6662d3dU, 0x76dc4190U, 0x01db7106U,
+    0x98d220bcU, 0xefd5102aU, 0x71b18589U, 0x06b6b51fU, 0x9fbfe4a5U, 0xe8b8d433U,
+    0x7807c9a2U, 0x0f00f934U, 0x9609a88eU, 0xe10e9818U, 0x7f6a0dbbU, 0x086d3d2dU,
+    0x91646c97U, 0xe6635c01U, 0x6b6b51f4U, 0x1c6c6162U, 0x856530d8U, 0xf262004eU,
+    0x6c0695edU, 0x1b01a57bU, 0x8208f4c1U, 0xf50fc457U, 0x65b0d9c6U, 0x12b7e950U,
+    0x8bbeb8eaU, 0xfcb9887cU, 0x62dd1ddfU, 0x15da2d49U, 0x8cd37cf3U, 0xfbd44c65U,
+    0x4db26158U, 0x3ab551ceU, 0xa3bc0074U, 0xd4bb30e2U, 0x4adfa541U, 0x3dd895d7U,
+    0xa4d1c46dU, 0xd3d6f4fbU, 0x4369e96aU, 0x346ed9fcU, 0xad678846U, 0xda60b8d0U,
+    0x44042d73U, 0x33031de5U, 0xaa0a4c5fU, 0xdd0d7cc9U, 0x5005713cU, 0x270241aaU,
+    0xbe0b1010U, 0xc90c2086U, 0x5768b525U, 0x206f85b3U, 0xb966d409U, 0xce61e49fU,
+    0x5edef90eU, 0x29d9c998U, 0xb0d09822U, 0xc7d7a8b4U, 0x59b33d17U, 0x2eb40d81U,
+    0xb7bd5c3bU, 0xc0ba6cadU, 0xedb88320U, 0x9abfb3b6U, 0x03b6e20cU, 0x74b1d29aU,
+    0xead54739U, 0x9dd277afU, 0x04db2615U, 0x73dc1683U, 0xe3630b12U, 0x94643b84U,
+    0x0d6d6a3eU, 0x7a6a5aa8U, 0xe40ecf0bU, 0x9309ff9dU, 0x0a00ae27U, 0x7d079eb1U,
+    0xf00f9344U, 0x8708a3d2U, 0x1e01f268U, 0x6906c2feU, 0xf762575dU, 0x806567cbU,
+    0x196c3671U, 0x6e6b06e7U, 0xfed41b76U, 0x89d32be0U, 0x10da7a5aU, 0x67dd4accU,
+    0xf9b9df6fU, 0x8ebeeff9U, 0x17b7be43U, 0x60b08ed5U, 0xd6d6a3e8U, 0xa1d1937eU,
+    0x38d8c2c4U, 0x4fdff252U, 0xd1bb67f1U, 0xa6bc5767U, 0x3fb506ddU, 0x48b2364bU,
+    0xd80d2bdaU, 0xaf0a1b4cU, 0x36034af6U, 0x41047a60U, 0xdf60efc3U, 0xa867df55U,
+    0x316e8eefU, 0x4669be79U, 0xcb61b38cU, 0xbc66831aU, 0x256fd2a0U, 0x5268e236U,
+    0xcc0c7795U, 0xbb0b4703U, 0x220216b9U, 0x5505262fU, 0xc5ba3bbeU, 0xb2bd0b28U,
+    0x2bb45a92U, 0x5cb36a04U, 0xc2d7ffa7U, 0xb5d0cf31U, 0x2cd99e8bU, 0x5bdeae1dU,
+    0x9b64c2b0U, 0xec63f226U, 0x756aa39cU, 0x026d930aU, 0x9c0906a9U, 0xeb0e363fU,
+    0x72076785U, 0x05005713U, 0x95bf4a82U, 0xe2b87a14U, 0x7bb12baeU, 0x0cb61b38U,
+    0x92d28e9bU, 0xe5d5be0dU, 0x7cdcefb7U, 0x0bdbdf21U, 0x86d3d2d4U, 0xf1d4e242U,
+    0x68ddb3f8U, 0x1fda836eU, 0x81be16cdU, 0xf6b9265bU, 0x6fb077e1U, 0x18b74777U,
+    0x88085ae6U, 0xff0f6a70U, 0x66063bcaU, 0x11010b5cU, 0x8f659effU, 0xf862ae69U,
+    0x616bffd3U, 0x166ccf45U, 0xa00ae278U, 0xd70dd2eeU, 0x4e048354U, 0x3903b3c2U,
+    0xa7672661U, 0xd06016f7U, 0x4969474dU, 0x3e6e77dbU, 0xaed16a4aU, 0xd9d65adcU,
+    0x40df0b66U, 0x37d83bf0U, 0xa9bcae53U, 0xdebb9ec5U, 0x47b2cf7fU, 0x30b5ffe9U,
+    0xbdbdf21cU, 0xcabac28aU, 0x53b39330U, 0x24b4a3a6U, 0xbad03605U, 0xcdd70693U,
+    0x54de5729U, 0x23d967bfU, 0xb3667a2eU, 0xc4614ab8U, 0x5d681b02U, 0x2a6f2b94U,
+    0xb40bbe37U, 0xc30c8ea1U, 0x5a05df1bU, 0x2d02ef8dU
+};
+
+u32 codecCrc32(u32 crc, const u8 *buf, u64 size) {
+    crc = ~crc;
+    u64 i;
+    for (i = 0; i < size; ++i)
+        crc = crc32Table[(crc ^ buf[i]) & 0xFF] ^ (crc >> 8);
+    return ~crc;
+}
+
+u32 codecChunkCount(u64 rawSize, u64 chunkSize) {
+    return (u32)((rawSize + chunkSize - 1) / chunkSize);
+}
+
+u64 codecHeaderSize(u32 chunkCount) {
+    return CODEC_ALIGN(sizeof(ocrCodecHeader_t) + chunkCount * sizeof(ocrCodecChunk_t));
+}
+
+u64 codecMaxEncodedSize(u64 rawSize, u64 chunkSize) {
+    u32 count = codecChunkCount(rawSize, chunkSize);
+    return codecHeaderSize(count) + rawSize + count * sizeof(u64);
+}
+
+bool codecIsStream(const u8 *buf) {
+    return (((ocrCodecHeader_t*)buf)->magic == CODEC_MAGIC);
+}
+
+static u64 chunkRawSize(const ocrCodecHeader_t *hdr, u32 chunk) {
+    u64 start = chunk * hdr->chunkSize;
+    return ((hdr->rawSize - start) < hdr->chunkSize) ? (hdr->rawSize - start) : hdr->chunkSize;
+}
+
+void codecInitStream(u8 *stream, ocrCodecKind_t codec, u64 rawSize, u64 chunkSize) {
+    ASSERT(codec < CODEC_MAX && chunkSize > 0 && chunkSize <= (u32)-1);
+    ocrCodecHeader_t *hdr = (ocrCodecHeader_t*)stream;
+    hdr->magic = CODEC_MAGIC;
+    hdr->codec = codec;
+    hdr->chunkCount = codecChunkCount(rawSize, chunkSize);
+    hdr->chunkSize = chunkSize;
+    hdr->rawSize = rawSize;
+    hdr->encodedSize = 0;
+}
+
+/****************************************************/
+/* ZERO-RUN ELISION                                 */
+/****************************************************/
+
+static void putU32(u8 *dst, u32 val) {
+    dst[0] = val & 0xFF; dst[1] = (val >> 8) & 0xFF;
+    dst[2] = (val >> 16) & 0xFF; dst[3] = (val >> 24) & 0xFF;
+}
+
+static u32 getU32(const u8 *src) {
+    return ((u32)src[0]) | ((u32)src[1] << 8) | ((u32)src[2] << 16) | ((u32)src[3] << 24);
+}
+
+// Returns the encoded size, or 0 if it would not be smaller than the input
+static u64 zrleEncode(const u8 *src, u64 size, u8 *dst) {
+    u64 in = 0, out = 0;
+    while (in < size) {
+        u64 litStart = in, zeroStart;
+        // Extend the literal up to the next long enough zero run
+        while (1) {
+            while (in < size && src[in] != 0) in++;
+            zeroStart = in;
+            while (in < size && src[in] == 0) in++;
+            if (in == size || (in - zeroStart) >= ZRLE_MIN_RUN)
+                break;
+        }
+        u64 litLen = zeroStart - litStart;
+        if ((out + ZRLE_TOKEN_SIZE + litLen) >= size)
+            return 0;
+        putU32(dst + out, (u32)litLen);
+        putU32(dst + out + sizeof(u32), (u32)(in - zeroStart));
+        out += ZRLE_TOKEN_SIZE;
+        hal_memCopy(dst + out, src + litStart, litLen, false);
+        out += litLen;
+    }
+    return out;
+}
+
+static u8 zrleDecode(const u8 *src, u64 size, u8 *dst, u64 rawSize) {
+    u64 in = 0, out = 0;
+    while (in < size) {
+        if ((size - in) < ZRLE_TOKEN_SIZE)
+            return OCR_EINVAL;
+        u64 litLen = getU32(src + in);
+        u64 zeroLen = getU32(src + in + sizeof(u32));
+        in += ZRLE_TOKEN_SIZE;
+        if (litLen > (size - in) || (litLen + zeroLen) > (rawSize - out))
+            return OCR_EINVAL;
+        hal_memCopy(dst + out, src + in, litLen, false);
+        in += litLen;
+        out += litLen;
+        u64 end = out + zeroLen;
+        for (; out < end; ++out)
+            dst[out] = 0;
+    }
+    return (out == rawSize) ? 0 : OCR_EINVAL;
+}
+
+/****************************************************/
+/* STREAMS                                          */
+/****************************************************/
+
+u64 codecEncodeChunk(u8 *stream, const u8 *src, u32 chunk, u8 *dst) {
+    ocrCodecHeader_t *hdr = (ocrCodecHeader_t*)stream;
+    ocrCodecChunk_t *desc = CODEC_CHUNK_TABLE(stream) + chunk;
+    ASSERT(chunk < hdr->chunkCount);
+    const u8 *raw = src + chunk * hdr->chunkSize;
+    u64 rawSize = chunkRawSize(hdr, chunk);
+    u64 size = 0;
+    if (hdr->codec == CODEC_ZRLE)
+        size = zrleEncode(raw, rawSize, dst);
+    desc->rawCrc = codecCrc32(0, raw, rawSize);
+    if (size == 0) {
+        hal_memCopy(dst, raw, rawSize, false);
+        size = rawSize;
+        desc->flags = CODEC_CHUNK_RAW;
+        desc->crc = desc->rawCrc;
+    } else {
+        desc->flags = 0;
+        desc->crc = codecCrc32(0, dst, size);
+    }
+    desc->size = (u32)size;
+    desc->offset = 0;
+    return size;
+}
+
+u64 codecLayoutStream(u8 *stream) {
+    ocrCodecHeader_t *hdr = (ocrCodecHeader_t*)stream;
+    ocrCodecChunk_t *table = CODEC_CHUNK_TABLE(stream);
+    u64 offset = codecHeaderSize(hdr->chunkCount);
+    u32 i;
+    for (i = 0; i < hdr->chunkCount; ++i) {
+        table[i].offset = offset;
+        offset += CODEC_ALIGN(table[i].size);
+    }
+    hdr->encodedSize = offset;
+    return offset;
+}
+
+u8 codecValidateStream(const u8 *stream, u64 size) {
+    const ocrCodecHeader_t *hdr = (const ocrCodecHeader_t*)stream;
+    if (size < sizeof(ocrCodecHeader_t) || hdr->magic != CODEC_MAGIC || hdr->codec >= CODEC_MAX ||
+        hdr->chunkSize == 0 || hdr->chunkCount != codecChunkCount(hdr->rawSize, hdr->chunkSize) ||
+        codecHeaderSize(hdr->chunkCount) > size || hdr->encodedSize > size) {
+        DPRINTF(DEBUG_LVL_WARN, "Malformed codec stream header\n");
+        return OCR_EINVAL;
+    }
+    const ocrCodecChunk_t *table = CODEC_CHUNK_TABLE(stream);
+    u64 offset = codecHeaderSize(hdr->chunkCount);
+    u32 i;
+    for (i = 0; i < hdr->chunkCount; ++i) {
+        u64 rawSize = chunkRawSize(hdr, i);
+        if (table[i].offset != offset || table[i].size > rawSize ||
+            ((table[i].flags & CODEC_CHUNK_RAW) && table[i].size != rawSize) ||
+            (offset + table[i].size) > hdr->encodedSize) {
+            DPRINTF(DEBUG_LVL_WARN, "Malformed codec stream chunk %"PRIu32"\n", i);
+            return OCR_EINVAL;
+        }
+        offset += CODEC_ALIGN(table[i].size);
+    }
+    return 0;
+}
+
+u8 codecDecodeChunk(const u8 *stream, u32 chunk, u8 *dst) {
+    const ocrCodecHeader_t *hdr = (const ocrCodecHeader_t*)stream;
+    const ocrCodecChunk_t *desc = CODEC_CHUNK_TABLE(stream) + chunk;
+    const u8 *src = stream + desc->offset;
+    u8 *raw = dst + chunk * hdr->chunkSize;
+    u64 rawSize = chunkRawSize(hdr, chunk);
+    if (codecCrc32(0, src, desc->size) != desc->crc) {
+        DPRINTF(DEBUG_LVL_WARN, "CRC mismatch in stored codec chunk %"PRIu32"\n", chunk);
+        return OCR_EINVAL;
+    }
+    if (desc->flags & CODEC_CHUNK_RAW) {
+        hal_memCopy(raw, src, rawSize, false);
+        return 0;
+    }
+    if (hdr->codec != CODEC_ZRLE || zrleDecode(src, desc->size, raw, rawSize) != 0 ||
+        codecCrc32(0, raw, rawSize) != desc->rawCrc) {
+        DPRINTF(DEBUG_LVL_WARN, "Failed to decode codec chunk %"PRIu32"\n", chunk);
+        return OCR_EINVAL;
+    }
+    return 0;
+}
+
+u64 codecEncode(ocrCodecKind_t codec, const u8 *src, u64 rawSize, u8 *stream) {
+    codecInitStream(stream, codec, rawSize, CODEC_CHUNK_SIZE);
+    u32 count = ((ocrCodecHeader_t*)stream)->chunkCount;
+    u64 offset = codecHeaderSize(count);
+    u32 i;
+    for (i = 0; i < count; ++i)
+        offset += CODEC_ALIGN(codecEncodeChunk(stream, src, i, stream + offset));
+    return codecLayoutStream(stream);
+}
+
+u8 codecDecode(const u8 *stream, u64 size, u8 *dst) {
+    if (codecValidateStream(stream, size) != 0)
+        return OCR_EINVAL;
+    u32 i;
+    for (i = 0; i < ((ocrCodecHeader_t*)stream)->chunkCount; ++i) {
+        if (codecDecodeChunk(stream, i, dst) != 0)
+            return OCR_EINVAL;
+    }
+    return 0;
+}
@@ -83,6 +83,7 @@ static void baseDequeInit(deque_t* self, ocrPolicyDomain_t *pd, void * initValue
     self->size = nonSyncDequeSize;
     // Set by derived implementation
     self->pushAtTail = NULL;
+    self->pushBatchAtTail = NULL;
     self->popFromTail = NULL;
     self->pushAtHead = NULL;
     self->popFromHead = NULL;
@@ -156,6 +157,19 @@ void nonConcDequePushTail(deque_t* self, void* entry, u8 doTry) {
     ++(self->tail);
 }
 
+/*
+ * push 'count' entries onto the tail of the deque
+ */
+void nonConcDequePushBatchTail(deque_t* self, void** entries, u32 count, u8 doTry) {
+    u32 head = self->head;
+    u32 tail = self->tail;
+    ASSERT_CRITICAL("DEQUE full, increase deque's size" && !(tail + count > INIT_DEQUE_CAPACITY + head));
+    u32 i;
+    for (i = 0; i < count; i++)
+        self->data[(tail + i) % INIT_DEQUE_CAPACITY] = entries[i];
+    self->tail = tail + count;
+}
+
 /*
  * pop the task out of the deque from the tail
  */
@@ -200,6 +214,24 @@ void wstDequePushTail(deque_t* self, void* entry, u8 doTry) {
     ++(self->tail);
 }
 
+/*
+ * push 'count' entries onto the tail of the deque
+ * A single fence publishes the whole batch to thieves.
+ */
+void wstDequePushBatchTail(deque_t* self, void** entries, u32 count, u8 doTry) {
+    s32 head = self->head;
+    s32 tail = self->tail;
+    /* deque looks full - may not grow the deque if some interleaving steal occur */
+    ASSERT_CRITICAL("DEQUE full, increase deque's size" && !(tail + (s32)count > INIT_DEQUE_CAPACITY + head));
+    u32 i;
+    for (i = 0; i < count; i++)
+        self->data[(tail + i) % INIT_DEQUE_CAPACITY] = entries[i];
+    DPRINTF(DEBUG_LVL_VERB, "Pushing h:%"PRId32" t:%"PRId32" %"PRIu32" elts into conc deque @ 0x%p\n",
+            head, tail, count, self);
+    hal_fence();
+    self->tail = tail + count;
+}
+
 /*
  * pop the task out of the deque from the tail
  */
@@ -285,6 +317,23 @@ void lockedDequePushTail(deque_t* self, void* entry, u8 doTry) {
     hal_unlock(&dself->lock);
 }
 
+/*
+ * Push 'count' entries onto the tail of the deque
+ * This operation locks the whole deque once.
+ */
+void lockedDequePushBatchTail(deque_t* self, void** entries, u32 count, u8 doTry) {
+    dequeSingleLocked_t* dself = (dequeSingleLocked_t*)self;
+    hal_lock(&dself->lock);
+    u32 head = self->head;
+    u32 tail = self->tail;
+    ASSERT_CRITICAL("DEQUE full, increase deque's size" && !(tail + count > INIT_DEQUE_CAPACITY + head));
+    u32 i;
+    for (i = 0; i < count; i++)
+        self->data[(tail + i) % INIT_DEQUE_CAPACITY] = entries[i];
+    self->tail = tail + count;
+    hal_unlock(&dself->lock);
+}
+
 /*
  * Pop the task out of the deque from the tail
  * This operation locks the whole deque.
@@ -371,6 +420,29 @@ void lockedDequePushTailSemiConc(deque_t* self, void* entry, u8 doTry) {
     hal_unlock(&dself->lock);
 }
 
+/*
+ * Push 'count' entries onto the tail of the deque
+ * This operation locks the whole deque once and fences once.
+ */
+void lockedDequePushBatchTailSemiConc(deque_t* self, void** entries, u32 count, u8 doTry) {
+    dequeSingleLocked_t* dself = (dequeSingleLocked_t*)self;
+    hal_lock(&dself->lock);
+    u32 head = self->head;
+    u32 tail = ((u32)self->tail);
+    u32 i;
+    for (i = 0; i < count; i++) {
+        ASSERT(entries[i] != NULL);
+        u32 ptail = (tail == (INIT_DEQUE_CAPACITY-1)) ? 0 : tail+1;
+        ASSERT_CRITICAL("DEQUE full, increase deque's size" && !(ptail == head));
+        self->data[tail] = entries[i];
+        tail = ptail;
+    }
+    // See lockedDequePushTailSemiConc
+    hal_fence();
+    self->tail = tail;
+    hal_unlock(&dself->lock);
+}
+
 /*
  *  pop the task out of the deque from the head
  */
@@ -406,6 +478,7 @@ deque_t * newDeque(ocrPolicyDomain_t *pd, void * initValue, ocrDequeType_t type)
         // Specialize push/pop implementations
         self->size = wstDequeSize;
         self->pushAtTail = wstDequePushTail;
+        self->pushBatchAtTail = wstDequePushBatchTail;
         self->popFromTail = wstDequePopTail;
         self->pushAtHead = NULL;
         self->popFromHead = wstDequePopHead;
@@ -414,6 +487,7 @@ deque_t * newDeque(ocrPolicyDomain_t *pd, void * initValue, ocrDequeType_t type)
         self = newBaseDeque(pd, initValue, NO_LOCK_BASE_DEQUE);
         // Specialize push/pop implementations
         self->pushAtTail = nonConcDequePushTail;
+        self->pushBatchAtTail = nonConcDequePushBatchTail;
         self->popFromTail = nonConcDequePopTail;
         self->pushAtHead = NULL;
         self->popFromHead = nonConcDequePopHead;
@@ -431,6 +505,7 @@ deque_t * newDeque(ocrPolicyDomain_t *pd, void * initValue, ocrDequeType_t type)
         self->size = nonSyncCircularDequeSize;
         // Specialize push/pop implementations
         self->pushAtTail = lockedDequePushTailSemiConc;
+        self->pushBatchAtTail = lockedDequePushBatchTailSemiConc;
         self->popFromTail = NULL;
         self->pushAtHead = NULL;
         self->popFromHead = nonConcDequePopHeadSemiConc;
@@ -439,6 +514,7 @@ deque_t * newDeque(ocrPolicyDomain_t *pd, void * initValue, ocrDequeType_t type)
         self = newBaseDeque(pd, initValue, SINGLE_LOCK_BASE_DEQUE);
         // Specialize push/pop implementations
         self->pushAtTail =  lockedDequePushTail;
+        self->pushBatchAtTail = lockedDequePushBatchTail;
         self->popFromTail = lockedDequePopTail;
         self->pushAtHead = lockedDequePushHead;
         self->popFromHead = lockedDequePopHead;
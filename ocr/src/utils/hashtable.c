@@ -25,43 +25,106 @@ typedef struct _ocr_hashtable_entry_struct {
 /* CONCURRENT BUCKET LOCKED HASHTABLE                 */
 /******************************************************/
 
+/*
+ * Buckets store their first entries inline and chain the others in overflow
+ * entries. Buckets are protected by a fixed number of lock stripes, each on
+ * its own cache line. A stripe also holds a sequence number, odd while one of
+ * its buckets is modified, so that lookups can read the inline entries without
+ * writing to the stripe. The bucket array doubles when the load factor exceeds
+ * HASHTABLE_MAX_LOAD; previous arrays are retired, not freed, until the table
+ * is destroyed since optimistic readers may still be reading them.
+ *
+ * Inside a bucket, entries are kept from the most to the least recently
+ * inserted: inline slots first, then the overflow chain.
+ */
+
+#ifndef HASHTABLE_BUCKET_SLOTS
+#define HASHTABLE_BUCKET_SLOTS  3   /* Entries stored inline in a bucket (3 fill a 64B line) */
+#endif
+
+#ifndef HASHTABLE_LOCK_STRIPES
+#define HASHTABLE_LOCK_STRIPES  64  /* Number of lock stripes (power of 2) */
+#endif
+
+#ifndef HASHTABLE_MAX_LOAD
+#define HASHTABLE_MAX_LOAD      2   /* Average entries per bucket before the table grows */
+#endif
+
+#ifndef HASHTABLE_SEQ_RETRIES
+#define HASHTABLE_SEQ_RETRIES   4   /* Optimistic lookups attempted before locking */
+#endif
+
+#define HASHTABLE_MAX_BUCKETS   (1U << 30)
+
+typedef struct _hashtableSlot_t {
+    void * key;
+    void * value;
+} hashtableSlot_t;
+
+typedef struct _hashtableBucket_t {
+    u32 count;                                      /* inline + overflow entries */
+    hashtableSlot_t slots[HASHTABLE_BUCKET_SLOTS];
+    ocr_hashtable_entry * overflow;                 /* only used once the slots are full */
+} hashtableBucket_t;
+
+typedef struct _hashtableBuckets_t {
+    u32 nbBuckets;
+    hashtableBucket_t * buckets;
+    struct _hashtableBuckets_t * retired;           /* previous (smaller) bucket arrays */
+} hashtableBuckets_t;
+
 #ifdef STATS_HASHTABLE
 typedef struct _hashtableBucketLockedStats_t {
-    u64 watermark;
-    u64 current;
-#ifdef STATS_HASHTABLE_COLLIDE
+    u64 watermark;      /* Highest number of entries seen in a bucket */
     u64 get;
     u64 put;
     u64 del;
+    u64 getProbes;      /* Entries compared, summed over operations */
+    u64 putProbes;
+    u64 delProbes;
+    u64 maxProbes;      /* Longest probe sequence */
+#ifdef STATS_HASHTABLE_COLLIDE
+    u64 getCollide;     /* Operations that found the stripe locked */
+    u64 putCollide;
+    u64 delCollide;
 #endif
 } hashtableBucketLockedStats_t;
-
-static void hashtableBucketLockedStatsInit(hashtableBucketLockedStats_t * stats) {
-    stats->watermark = 0;
-    stats->current = 0;
-#ifdef STATS_HASHTABLE_COLLIDE
-    stats->get = 0;
-    stats->put = 0;
-    stats->del = 0;
 #endif
 
-}
+typedef struct _hashtableStripe_t {
+    lock_t lock;
+    volatile u32 seq;   /* odd while a bucket of the stripe is being modified */
+    u64 count;          /* entries in the buckets of the stripe */
+#ifdef STATS_HASHTABLE
+    hashtableBucketLockedStats_t stats;
 #endif
+} hashtableStripe_t;
 
-#ifdef HASHTABLE_LOCK_SPREAD
-#define GET_LOCK_IDX(id) (id * (CACHE_LINE_SZB/sizeof(lock_t)))
-#else
-#define GET_LOCK_IDX(id) (id)
-#endif
+#define HASHTABLE_STRIPE_SZB \
+    (((sizeof(hashtableStripe_t) + CACHE_LINE_SZB - 1) / CACHE_LINE_SZB) * CACHE_LINE_SZB)
+
+typedef union _hashtablePaddedStripe_t {
+    hashtableStripe_t stripe;
+    u8 padding[HASHTABLE_STRIPE_SZB];
+} hashtablePaddedStripe_t;
 
 typedef struct _hashtableBucketLocked_t {
-    hashtable_t base;
-    lock_t * bucketLock;
+    hashtable_t base;   /* base.nbBuckets follows resizes, base.table is NULL */
+    hashtableBuckets_t * volatile current;
+    hashtablePaddedStripe_t * stripes;
+    u32 stripeMask;
+    volatile u32 iterators; /* unlocked iterations in progress (resizes are deferred) */
 #ifdef STATS_HASHTABLE
-    hashtableBucketLockedStats_t * stats;
+    u32 resizes;
 #endif
 } hashtableBucketLocked_t;
 
+#define GET_STRIPE(rself, bucket) (&((rself)->stripes[(bucket) & (rself)->stripeMask].stripe))
+
+static void iterateHashtableBucketLockedRange(hashtable_t * hashtable, u32 firstBucket, u32 lastBucket,
+                                              hashtableIterateFct iterate, void * args);
+static void destructBucketLockedEntries(hashtable_t * hashtable, deallocFct entryDeallocator, void * deallocatorParam);
+
 /******************************************************/
 /* HASHTABLE COMMON FUNCTIONS                         */
 /******************************************************/
@@ -125,6 +188,11 @@ hashtable_t * newHashtable(ocrPolicyDomain_t * pd, u32 nbBuckets, hashFct hashin
  */
 void destructHashtable(hashtable_t * hashtable, deallocFct entryDeallocator, void * deallocatorParam) {
     ocrPolicyDomain_t * pd = hashtable->pd;
+    if (hashtable->table == NULL) {
+        destructBucketLockedEntries(hashtable, entryDeallocator, deallocatorParam);
+        pd->fcts.pdFree(pd, hashtable);
+        return;
+    }
     // go over each bucket and deallocate entries
     u32 i = 0;
     while(i < hashtable->nbBuckets) {
@@ -144,126 +212,29 @@ void destructHashtable(hashtable_t * hashtable, deallocFct entryDeallocator, voi
 }
 
 void iterateHashtable(hashtable_t * hashtable, hashtableIterateFct iterate, void * args) {
-    u32 i = 0;
-    while(i < hashtable->nbBuckets) {
-        ocr_hashtable_entry * entry = hashtable->table[i];
-        while (entry != NULL) {
-            ocr_hashtable_entry * next = entry->nxt;
-            iterate(entry->key, entry->value, args);
-            entry = next;
-        }
-        i++;
-    }
+    iterateHashtableRange(hashtable, 0, hashtable->nbBuckets, iterate, args);
 }
 
 /**
- * @brief Create a new hashtable bucket locked instance that uses the specified hashing function.
+ * @brief Iterate over the entries of buckets [firstBucket, lastBucket)
+ * Disjoint ranges can be iterated concurrently as long as the table is not modified
+ * other than by 'iterate' removing the entry it is called on.
  */
-hashtable_t * newHashtableBucketLocked(ocrPolicyDomain_t * pd, u32 nbBuckets, hashFct hashing) {
-    hashtable_t * hashtable = pd->fcts.pdMalloc(pd, sizeof(hashtableBucketLocked_t));
-    hashtableInit(pd, hashtable, nbBuckets, hashing);
-    hashtableBucketLocked_t * rhashtable = (hashtableBucketLocked_t *) hashtable;
-    u32 i;
-#ifdef HASHTABLE_LOCK_SPREAD
-    ASSERT(sizeof(lock_t)<(CACHE_LINE_SZB));
-    u64 bucketLockSz = nbBuckets*CACHE_LINE_SZB;
-#else
-    u64 bucketLockSz = nbBuckets*sizeof(lock_t);
-#endif
-    lock_t * bucketLock = pd->fcts.pdMalloc(pd, bucketLockSz);
-#ifdef STATS_HASHTABLE
-    hashtableBucketLockedStats_t * stats = pd->fcts.pdMalloc(pd, nbBuckets*sizeof(hashtableBucketLockedStats_t));
-#endif
-    for (i=0; i < nbBuckets; i++) {
-        bucketLock[GET_LOCK_IDX(i)] = INIT_LOCK;
-#ifdef STATS_HASHTABLE
-        hashtableBucketLockedStatsInit(&stats[i]);
-#endif
-    }
-    rhashtable->bucketLock = bucketLock;
-#ifdef STATS_HASHTABLE
-    rhashtable->stats = stats;
-#endif
-    return hashtable;
-}
-
-#ifdef STATS_HASHTABLE
-#define GET_STAT_OFFSET(name) ((u64) &(((hashtableBucketLockedStats_t*)0)->name))
-#define READ_STAT_VALUE(statEntry, offset) (*((u64*)((char *) statEntry)+offset))
-
-static void dumpStats(hashtable_t * self, char * name, u64 offset) {
-    hashtableBucketLocked_t * rself = (hashtableBucketLocked_t *) self;
-    u32 nbBuckets = self->nbBuckets;
-    if (nbBuckets > 0) {
-        PRINTF("[PD:0x%"PRIu64"] Hashtable@%p statistics\n", (u64) self->pd->myLocation, self);
-#ifdef STATS_HASHTABLE_VERB
-        u64 curWm = READ_STAT_VALUE(&rself->stats[0], offset);
-        u64 lb = 0;
-#endif
-        u64 hWm = READ_STAT_VALUE(&rself->stats[0], offset);
-        u32 i;
-        for (i=1; i < nbBuckets; i++) {
-            u64 wm = READ_STAT_VALUE(&rself->stats[i], offset);
-#ifdef STATS_HASHTABLE_VERB
-            if (wm == curWm) {
-                continue;
-            } else { // Print previous if any
-                if ((i-lb) == 1) {
-                    PRINTF("[PD:0x%"PRIu64"] Bucket[%"PRIu64"]: %s=%"PRIu64"\n", (u64) self->pd->myLocation, lb, name, curWm);
-                } else {
-                    PRINTF("[PD:0x%"PRIu64"] Bucket[%"PRIu64"-%"PRId32"]: %s=%"PRIu64"\n", (u64) self->pd->myLocation, lb, i-1, name, curWm);
-                }
-                lb = i;
-                curWm = wm;
-            }
-#endif
-            if (wm > hWm) {
-                hWm = wm;
-            }
-        }
-#ifdef STATS_HASHTABLE_VERB
-        if ((i-lb) == 1) {
-            PRINTF("[PD:0x%"PRIu64"] Bucket[%"PRIu64"]: %s=%"PRIu64"\n", (u64) self->pd->myLocation, lb, name, curWm);
-        } else {
-            PRINTF("[PD:0x%"PRIu64"] Bucket[%"PRIu64"-%"PRId32"]: %s=%"PRIu64"\n", (u64) self->pd->myLocation, lb, i-1, name, curWm);
-        }
-#endif
-        PRINTF("[PD:0x%"PRIu64"] High %s=%"PRIu64"\n", (u64) self->pd->myLocation, name, hWm);
+void iterateHashtableRange(hashtable_t * hashtable, u32 firstBucket, u32 lastBucket, hashtableIterateFct iterate, void * args) {
+    if (hashtable->table == NULL) {
+        iterateHashtableBucketLockedRange(hashtable, firstBucket, lastBucket, iterate, args);
+        return;
     }
-}
-#endif
-
-/**
- * @brief Destruct the hashtable and all its entries (do not deallocate keys and values pointers).
- */
-void destructHashtableBucketLocked(hashtable_t * hashtable, deallocFct entryDeallocator, void * deallocatorParam) {
-    ocrPolicyDomain_t * pd = hashtable->pd;
-    hashtableBucketLocked_t * rhashtable = (hashtableBucketLocked_t *) hashtable;
-    pd->fcts.pdFree(pd, (void*)(rhashtable->bucketLock));
-#ifdef STATS_HASHTABLE
-    dumpStats(hashtable,"watermark", GET_STAT_OFFSET(watermark));
-#ifdef STATS_HASHTABLE_COLLIDE
-    dumpStats(hashtable,"get", GET_STAT_OFFSET(get));
-    dumpStats(hashtable,"put", GET_STAT_OFFSET(put));
-    dumpStats(hashtable,"del", GET_STAT_OFFSET(del));
-#endif
-#endif
-    destructHashtable(hashtable, entryDeallocator, deallocatorParam);
-}
-
-void iterateHashtableBucketLocked(hashtable_t * hashtable, hashtableIterateFct iterate, void * args) {
-    u32 i;
-    u32 nbBuckets = hashtable->nbBuckets;
-    hashtableBucketLocked_t * rhashtable = (hashtableBucketLocked_t *) hashtable;
-    for (i = 0; i < nbBuckets; i++) {
-        hal_lock(&(rhashtable->bucketLock[i]));
+    u32 i = firstBucket;
+    ASSERT(lastBucket <= hashtable->nbBuckets);
+    while(i < lastBucket) {
         ocr_hashtable_entry * entry = hashtable->table[i];
         while (entry != NULL) {
             ocr_hashtable_entry * next = entry->nxt;
             iterate(entry->key, entry->value, args);
             entry = next;
         }
-        hal_unlock(&(rhashtable->bucketLock[i]));
+        i++;
     }
 }
 
@@ -338,32 +309,6 @@ bool hashtableNonConcRemove(hashtable_t * hashtable, void * key, void ** value)
     return false;
 }
 
-/**
- * @brief Removes a key from the table and return the bucket entry
- * If 'value' is not NULL, fill-in the pointer with the entry's value associated with 'key'.
- * If the hashtable implementation allows for NULL values entries, check the returned value to be NULL.
- * Returns entry.
- */
-static void * hashtableNonConcRemoveInternal(hashtable_t * hashtable, void * key, void ** value) {
-    ocr_hashtable_entry * prev;
-    ocr_hashtable_entry * entry = hashtableFindEntryAndPrev(hashtable, key, &prev);
-    if (entry != NULL) {
-        ASSERT(prev != NULL);
-        ASSERT(key == entry->key);
-        if (entry == prev) {
-            // entry is bucket's head
-            u32 bucket = hashtable->hashing(key, hashtable->nbBuckets);
-            hashtable->table[bucket] = entry->nxt;
-        } else {
-            prev->nxt = entry->nxt;
-        }
-        if (value != NULL) {
-            *value = entry->value;
-        }
-    }
-    return entry;
-}
-
 /******************************************************/
 /* CONCURRENT HASHTABLE FUNCTIONS                     */
 /******************************************************/
@@ -458,101 +403,619 @@ bool hashtableConcRemove(hashtable_t * hashtable, void * key, void ** value) {
 /* CONCURRENT BUCKET LOCKED HASHTABLE                 */
 /******************************************************/
 
-void * hashtableConcBucketLockedGet(hashtable_t * hashtable, void * key) {
-    u32 bucket = hashtable->hashing(key, hashtable->nbBuckets);
-    hashtableBucketLocked_t * rhashtable = (hashtableBucketLocked_t *) hashtable;
+static hashtableBuckets_t * newBucketArray(ocrPolicyDomain_t * pd, u32 nbBuckets) {
+    hashtableBuckets_t * desc = pd->fcts.pdMalloc(pd, sizeof(hashtableBuckets_t));
+    hashtableBucket_t * buckets = pd->fcts.pdMalloc(pd, nbBuckets*sizeof(hashtableBucket_t));
+    u32 i, j;
+    for (i=0; i < nbBuckets; i++) {
+        buckets[i].count = 0;
+        for (j=0; j < HASHTABLE_BUCKET_SLOTS; j++) {
+            buckets[i].slots[j].key = NULL;
+            buckets[i].slots[j].value = NULL;
+        }
+        buckets[i].overflow = NULL;
+    }
+    desc->nbBuckets = nbBuckets;
+    desc->buckets = buckets;
+    desc->retired = NULL;
+    return desc;
+}
+
+/**
+ * @brief Create a new hashtable bucket locked instance that uses the specified hashing function.
+ */
+hashtable_t * newHashtableBucketLocked(ocrPolicyDomain_t * pd, u32 nbBuckets, hashFct hashing) {
+    ASSERT(nbBuckets > 0);
+    hashtableBucketLocked_t * rhashtable = pd->fcts.pdMalloc(pd, sizeof(hashtableBucketLocked_t));
+    hashtable_t * hashtable = (hashtable_t *) rhashtable;
+    hashtable->pd = pd;
+    hashtable->nbBuckets = nbBuckets;
+    hashtable->table = NULL;
+    hashtable->hashing = hashing;
+    rhashtable->current = newBucketArray(pd, nbBuckets);
+    // Stripes are sized for the table to grow
+    u32 nbStripes = HASHTABLE_LOCK_STRIPES;
+    ASSERT((nbStripes & (nbStripes - 1)) == 0);
+    hashtablePaddedStripe_t * stripes = pd->fcts.pdMalloc(pd, nbStripes*sizeof(hashtablePaddedStripe_t));
+    u32 i;
+    for (i=0; i < nbStripes; i++) {
+        hashtableStripe_t * stripe = &stripes[i].stripe;
+        stripe->lock = INIT_LOCK;
+        stripe->seq = 0;
+        stripe->count = 0;
+#ifdef STATS_HASHTABLE
+        hashtableBucketLockedStats_t * stats = &stripe->stats;
+        stats->watermark = 0;
+        stats->get = 0;
+        stats->put = 0;
+        stats->del = 0;
+        stats->getProbes = 0;
+        stats->putProbes = 0;
+        stats->delProbes = 0;
+        stats->maxProbes = 0;
 #ifdef STATS_HASHTABLE_COLLIDE
-    bool isBusy = hal_islocked(&(rhashtable->bucketLock[GET_LOCK_IDX(bucket)]));
+        stats->getCollide = 0;
+        stats->putCollide = 0;
+        stats->delCollide = 0;
+#endif
+#endif
+    }
+    rhashtable->stripes = stripes;
+    rhashtable->stripeMask = nbStripes - 1;
+    rhashtable->iterators = 0;
+#ifdef STATS_HASHTABLE
+    rhashtable->resizes = 0;
 #endif
-    hal_lock(&(rhashtable->bucketLock[GET_LOCK_IDX(bucket)]));
+    return hashtable;
+}
+
 #ifdef STATS_HASHTABLE
+static void statsRecordProbes(hashtableBucketLockedStats_t * stats, u64 * counter, u64 * probeCounter, u64 probes) {
+    (*counter)++;
+    (*probeCounter) += probes;
+    if (probes > stats->maxProbes) {
+        stats->maxProbes = probes;
+    }
+}
+
+static void dumpStats(hashtable_t * self) {
+    hashtableBucketLocked_t * rself = (hashtableBucketLocked_t *) self;
+    u64 loc = (u64) self->pd->myLocation;
+    hashtableBucketLockedStats_t total = {0};
+    u64 entries = 0;
+    u32 i;
+    for (i=0; i <= rself->stripeMask; i++) {
+        hashtableStripe_t * stripe = &rself->stripes[i].stripe;
+        hashtableBucketLockedStats_t * stats = &stripe->stats;
+#ifdef STATS_HASHTABLE_VERB
+        PRINTF("[PD:0x%"PRIu64"] Stripe[%"PRIu32"]: entries=%"PRIu64" watermark=%"PRIu64" get=%"PRIu64" put=%"PRIu64" del=%"PRIu64"\n",
+               loc, i, stripe->count, stats->watermark, stats->get, stats->put, stats->del);
+#endif
+        entries += stripe->count;
+        total.get += stats->get;
+        total.put += stats->put;
+        total.del += stats->del;
+        total.getProbes += stats->getProbes;
+        total.putProbes += stats->putProbes;
+        total.delProbes += stats->delProbes;
+        total.watermark = (stats->watermark > total.watermark) ? stats->watermark : total.watermark;
+        total.maxProbes = (stats->maxProbes > total.maxProbes) ? stats->maxProbes : total.maxProbes;
 #ifdef STATS_HASHTABLE_COLLIDE
-    hashtableBucketLockedStats_t * stats = &rhashtable->stats[bucket];
-    if (isBusy) { stats->get++; }
+        total.getCollide += stats->getCollide;
+        total.putCollide += stats->putCollide;
+        total.delCollide += stats->delCollide;
 #endif
+    }
+    PRINTF("[PD:0x%"PRIu64"] Hashtable@%p statistics\n", loc, self);
+    PRINTF("[PD:0x%"PRIu64"] buckets=%"PRIu32" stripes=%"PRIu32" entries=%"PRIu64" resizes=%"PRIu32" High watermark=%"PRIu64"\n",
+           loc, self->nbBuckets, rself->stripeMask+1, entries, rself->resizes, total.watermark);
+    PRINTF("[PD:0x%"PRIu64"] get=%"PRIu64" put=%"PRIu64" del=%"PRIu64" avg probes get=%"PRIu64" put=%"PRIu64" del=%"PRIu64" max probes=%"PRIu64"\n",
+           loc, total.get, total.put, total.del,
+           (total.get ? total.getProbes/total.get : 0), (total.put ? total.putProbes/total.put : 0),
+           (total.del ? total.delProbes/total.del : 0), total.maxProbes);
+#ifdef STATS_HASHTABLE_COLLIDE
+    PRINTF("[PD:0x%"PRIu64"] collisions get=%"PRIu64" put=%"PRIu64" del=%"PRIu64"\n",
+           loc, total.getCollide, total.putCollide, total.delCollide);
 #endif
-    ocr_hashtable_entry * entry = hashtableFindEntry(hashtable, key);
-    //DPRINTF(DEBUG_LVL_WARN, "ht=%p For get key=%p: bucket=%"PRIu32" found entry=%p value=%p\n", hashtable, key, bucket, entry, (entry) ? entry->value : NULL);
-    hal_unlock(&(rhashtable->bucketLock[GET_LOCK_IDX(bucket)]));
-    return (entry == NULL) ? 0x0 : entry->value;
 }
+#endif
 
-bool hashtableConcBucketLockedPut(hashtable_t * hashtable, void * key, void * value) {
-    u32 bucket = hashtable->hashing(key, hashtable->nbBuckets);
-    hashtableBucketLocked_t * rhashtable = (hashtableBucketLocked_t *) hashtable;
-    ocr_hashtable_entry * newHead = hashtable->pd->fcts.pdMalloc(hashtable->pd, sizeof(ocr_hashtable_entry));
-    newHead->key = key;
-    newHead->value = value;
-    //DPRINTF(DEBUG_LVL_WARN, "ht=%p For put key=%p: bucket=%"PRIu32" found entry=%p value=%p\n", hashtable, key, bucket, newHead, newHead->value);
+/**
+ * @brief Lock the stripe of the bucket 'key' hashes to in the current bucket array.
+ * Returns the bucket array, which does not change until the stripe is unlocked.
+ */
+static hashtableBuckets_t * lockBucket(hashtableBucketLocked_t * rself, void * key, u32 * bucketOut, bool * collide) {
+    hashtable_t * self = (hashtable_t *) rself;
+    while (true) {
+        hashtableBuckets_t * desc = rself->current;
+        u32 bucket = self->hashing(key, desc->nbBuckets);
+        hashtableStripe_t * stripe = GET_STRIPE(rself, bucket);
 #ifdef STATS_HASHTABLE_COLLIDE
-    bool isBusy = hal_islocked(&(rhashtable->bucketLock[GET_LOCK_IDX(bucket)]));
+        if (hal_islocked(&stripe->lock)) {
+            *collide = true;
+        }
 #endif
-    hal_lock(&(rhashtable->bucketLock[GET_LOCK_IDX(bucket)]));
-    ocr_hashtable_entry * oldHead = hashtable->table[bucket];
-    newHead->nxt = oldHead;
-    hashtable->table[bucket] = newHead;
+        hal_lock(&stripe->lock);
+        if (desc == rself->current) {
+            *bucketOut = bucket;
+            return desc;
+        }
+        // The table grew in between, the key may hash to another stripe
+        hal_unlock(&stripe->lock);
+    }
+}
+
+static inline void writeBegin(hashtableStripe_t * stripe) {
+    stripe->seq++;
+    hal_fence();
+}
+
+static inline void writeEnd(hashtableStripe_t * stripe) {
+    hal_fence();
+    stripe->seq++;
+}
+
+/**
+ * @brief Insert an entry at the head of a bucket. The stripe must be locked.
+ * 'spill' is used if the last inline entry must move to the overflow chain.
+ */
+static void bucketInsert(hashtableBucket_t * bucket, void * key, void * value, ocr_hashtable_entry * spill) {
+    u32 inlined = (bucket->count < HASHTABLE_BUCKET_SLOTS) ? bucket->count : HASHTABLE_BUCKET_SLOTS;
+    if (inlined == HASHTABLE_BUCKET_SLOTS) {
+        ASSERT(spill != NULL);
+        spill->key = bucket->slots[HASHTABLE_BUCKET_SLOTS-1].key;
+        spill->value = bucket->slots[HASHTABLE_BUCKET_SLOTS-1].value;
+        spill->nxt = bucket->overflow;
+        bucket->overflow = spill;
+        inlined--;
+    }
+    u32 i;
+    for (i=inlined; i > 0; i--) {
+        bucket->slots[i] = bucket->slots[i-1];
+    }
+    bucket->slots[0].key = key;
+    bucket->slots[0].value = value;
+    bucket->count++;
+}
+
+/**
+ * @brief Append an entry at the tail of a bucket while rehashing.
+ * 'node' is reused if the entry goes to the overflow chain, else it is returned.
+ */
+static ocr_hashtable_entry * bucketAppend(ocrPolicyDomain_t * pd, hashtableBucket_t * bucket, void * key, void * value, ocr_hashtable_entry * node) {
+    if (bucket->count < HASHTABLE_BUCKET_SLOTS) {
+        bucket->slots[bucket->count].key = key;
+        bucket->slots[bucket->count].value = value;
+        bucket->count++;
+        return node;
+    }
+    if (node == NULL) {
+        node = pd->fcts.pdMalloc(pd, sizeof(ocr_hashtable_entry));
+    }
+    node->key = key;
+    node->value = value;
+    node->nxt = NULL;
+    ocr_hashtable_entry ** tail = &bucket->overflow;
+    while (*tail != NULL) {
+        tail = &((*tail)->nxt);
+    }
+    *tail = node;
+    bucket->count++;
+    return NULL;
+}
+
+/**
+ * @brief Double the number of buckets of 'from' if it is still current and
+ * over the load factor. All the stripes are held while rehashing.
+ *
+ * Inserts call this when their own stripe is over the load factor, which
+ * happens often on small or skewed tables. The stripe counts are first
+ * summed without locking so that these calls return without taking every
+ * stripe lock unless the whole table is likely over the load factor.
+ */
+static void hashtableBucketLockedGrow(hashtableBucketLocked_t * rself, hashtableBuckets_t * from) {
+    hashtable_t * self = (hashtable_t *) rself;
+    ocrPolicyDomain_t * pd = self->pd;
+    u32 nbStripes = rself->stripeMask + 1;
+    if ((rself->iterators != 0) || (from->nbBuckets >= HASHTABLE_MAX_BUCKETS)) {
+        return;
+    }
+    u32 i;
+    u64 estimate = 0;
+    for (i=0; i < nbStripes; i++) {
+        estimate += ((volatile hashtableStripe_t *) &rself->stripes[i].stripe)->count;
+    }
+    if (estimate <= ((u64) from->nbBuckets) * HASHTABLE_MAX_LOAD) {
+        return;
+    }
+    for (i=0; i < nbStripes; i++) {
+        hal_lock(&rself->stripes[i].stripe.lock);
+    }
+    u64 total = 0;
+    for (i=0; i < nbStripes; i++) {
+        total += rself->stripes[i].stripe.count;
+    }
+    if ((rself->current == from) && (rself->iterators == 0) &&
+        (total > ((u64) from->nbBuckets) * HASHTABLE_MAX_LOAD)) {
+        u32 nbBuckets = from->nbBuckets << 1;
+        hashtableBuckets_t * to = newBucketArray(pd, nbBuckets);
+        for (i=0; i < nbStripes; i++) {
+            rself->stripes[i].stripe.count = 0;
+        }
+        u32 b, s;
+        for (b=0; b < from->nbBuckets; b++) {
+            hashtableBucket_t * bucket = &from->buckets[b];
+            u32 inlined = (bucket->count < HASHTABLE_BUCKET_SLOTS) ? bucket->count : HASHTABLE_BUCKET_SLOTS;
+            // Visit entries from the most recent so that their order is kept
+            for (s=0; s < inlined; s++) {
+                void * key = bucket->slots[s].key;
+                u32 dst = self->hashing(key, nbBuckets);
+                bucketAppend(pd, &to->buckets[dst], key, bucket->slots[s].value, NULL);
+                GET_STRIPE(rself, dst)->count++;
+            }
+            // The previous array stays readable: overflow entries are moved, not copied
+            ocr_hashtable_entry * entry = bucket->overflow;
+            while (entry != NULL) {
+                ocr_hashtable_entry * next = entry->nxt;
+                u32 dst = self->hashing(entry->key, nbBuckets);
+                ocr_hashtable_entry * unused = bucketAppend(pd, &to->buckets[dst], entry->key, entry->value, entry);
+                if (unused != NULL) {
+                    pd->fcts.pdFree(pd, unused);
+                }
+                GET_STRIPE(rself, dst)->count++;
+                entry = next;
+            }
+        }
+#ifdef STATS_HASHTABLE
+        for (b=0; b < nbBuckets; b++) {
+            hashtableStripe_t * stripe = GET_STRIPE(rself, b);
+            if (to->buckets[b].count > stripe->stats.watermark) {
+                stripe->stats.watermark = to->buckets[b].count;
+            }
+        }
+        rself->resizes++;
+#endif
+        to->retired = from;
+        hal_fence();
+        rself->current = to;
+        self->nbBuckets = nbBuckets;
+        DPRINTF(DEBUG_LVL_VVERB, "Hashtable@%p grew to %"PRIu32" buckets for %"PRIu64" entries\n", self, nbBuckets, total);
+    }
+    for (i=nbStripes; i > 0; i--) {
+        hal_unlock(&rself->stripes[i-1].stripe.lock);
+    }
+}
+
+/**
+ * @brief Optimistic lookup in the inline entries of a bucket.
+ * Returns true if the result in 'value' is valid.
+ */
+static bool hashtableBucketLockedGetOptimistic(hashtableBucketLocked_t * rself, void * key, void ** value) {
+    hashtable_t * self = (hashtable_t *) rself;
+    u32 retries;
+    for (retries=0; retries < HASHTABLE_SEQ_RETRIES; retries++) {
+        hashtableBuckets_t * desc = rself->current;
+        u32 bucketIdx = self->hashing(key, desc->nbBuckets);
+        hashtableStripe_t * stripe = GET_STRIPE(rself, bucketIdx);
+        u32 seq = stripe->seq;
+        if (seq & 1) {
+            continue;
+        }
+        hal_fence();
+        hashtableBucket_t * bucket = &desc->buckets[bucketIdx];
+        u32 count = bucket->count;
+        u32 inlined = (count < HASHTABLE_BUCKET_SLOTS) ? count : HASHTABLE_BUCKET_SLOTS;
+        void * res = NULL;
+        bool found = false;
+        u32 s;
+        for (s=0; s < inlined; s++) {
+            if (bucket->slots[s].key == key) {
+                res = bucket->slots[s].value;
+                found = true;
+                break;
+            }
+        }
+        hal_fence();
+        if ((stripe->seq != seq) || (rself->current != desc)) {
+            continue;
+        }
+        if (!found && (count > HASHTABLE_BUCKET_SLOTS)) {
+            return false; // Must look in the overflow chain
+        }
 #ifdef STATS_HASHTABLE
-    hashtableBucketLockedStats_t * stats = &rhashtable->stats[bucket];
-    stats->current++;
-    if (stats->current > stats->watermark) {
-        ASSERT((stats->current-1) == stats->watermark);
-        stats->watermark++;
+        hal_xadd64(&stripe->stats.get, 1);
+        hal_xadd64(&stripe->stats.getProbes, (found ? s+1 : inlined));
+#endif
+        *value = res;
+        return true;
+    }
+    return false;
+}
+
+void * hashtableConcBucketLockedGet(hashtable_t * hashtable, void * key) {
+    hashtableBucketLocked_t * rhashtable = (hashtableBucketLocked_t *) hashtable;
+    void * value = NULL;
+    if (hashtableBucketLockedGetOptimistic(rhashtable, key, &value)) {
+        return value;
     }
+    u32 bucketIdx;
+    bool isBusy = false;
+    hashtableBuckets_t * desc = lockBucket(rhashtable, key, &bucketIdx, &isBusy);
+    hashtableStripe_t * stripe = GET_STRIPE(rhashtable, bucketIdx);
+    hashtableBucket_t * bucket = &desc->buckets[bucketIdx];
+    u32 inlined = (bucket->count < HASHTABLE_BUCKET_SLOTS) ? bucket->count : HASHTABLE_BUCKET_SLOTS;
+    u64 probes = 0;
+    u32 s;
+    for (s=0; s < inlined; s++) {
+        probes++;
+        if (bucket->slots[s].key == key) {
+            value = bucket->slots[s].value;
+            break;
+        }
+    }
+    if (s == inlined) {
+        ocr_hashtable_entry * entry = bucket->overflow;
+        while ((entry != NULL) && (entry->key != key)) {
+            probes++;
+            entry = entry->nxt;
+        }
+        if (entry != NULL) {
+            probes++;
+            value = entry->value;
+        }
+    }
+#ifdef STATS_HASHTABLE
+    statsRecordProbes(&stripe->stats, &stripe->stats.get, &stripe->stats.getProbes, probes);
 #ifdef STATS_HASHTABLE_COLLIDE
-    if (isBusy) { stats->put++; }
+    if (isBusy) { stripe->stats.getCollide++; }
 #endif
 #endif
-    hal_unlock(&(rhashtable->bucketLock[GET_LOCK_IDX(bucket)]));
-    return true;
+    hal_unlock(&stripe->lock);
+    return value;
 }
 
-void * hashtableConcBucketLockedTryPut(hashtable_t * hashtable, void * key, void * value) {
-    u32 bucket = hashtable->hashing(key, hashtable->nbBuckets);
+/**
+ * @brief Insert 'key' unless 'unique' is set and the key is already present.
+ * Returns the value associated with 'key' after the operation.
+ */
+static void * hashtableBucketLockedInsert(hashtable_t * hashtable, void * key, void * value, bool unique) {
     hashtableBucketLocked_t * rhashtable = (hashtableBucketLocked_t *) hashtable;
-    hal_lock(&(rhashtable->bucketLock[GET_LOCK_IDX(bucket)]));
-    ocr_hashtable_entry * entry = hashtableFindEntry(hashtable, key);
-    if (entry == NULL) {
-        hashtableNonConcPut(hashtable, key, value); // we already own the lock
-#ifdef STATS_HASHTABLE
-        hashtableBucketLockedStats_t * stats = &rhashtable->stats[bucket];
-        stats->current++;
-        if (stats->current > stats->watermark) {
-            stats->watermark++;
+    ocrPolicyDomain_t * pd = hashtable->pd;
+    u32 bucketIdx;
+    bool isBusy = false;
+    hashtableBuckets_t * desc = lockBucket(rhashtable, key, &bucketIdx, &isBusy);
+    hashtableStripe_t * stripe = GET_STRIPE(rhashtable, bucketIdx);
+    hashtableBucket_t * bucket = &desc->buckets[bucketIdx];
+    u64 probes = 0;
+    if (unique) {
+        u32 inlined = (bucket->count < HASHTABLE_BUCKET_SLOTS) ? bucket->count : HASHTABLE_BUCKET_SLOTS;
+        u32 s;
+        for (s=0; s < inlined; s++) {
+            probes++;
+            if (bucket->slots[s].key == key) {
+                void * existing = bucket->slots[s].value;
+                hal_unlock(&stripe->lock);
+                return existing;
+            }
+        }
+        ocr_hashtable_entry * entry = bucket->overflow;
+        while (entry != NULL) {
+            probes++;
+            if (entry->key == key) {
+                void * existing = entry->value;
+                hal_unlock(&stripe->lock);
+                return existing;
+            }
+            entry = entry->nxt;
         }
+    }
+    ocr_hashtable_entry * spill = NULL;
+    if (bucket->count >= HASHTABLE_BUCKET_SLOTS) {
+        spill = pd->fcts.pdMalloc(pd, sizeof(ocr_hashtable_entry));
+    }
+    writeBegin(stripe);
+    bucketInsert(bucket, key, value, spill);
+    writeEnd(stripe);
+    stripe->count++;
+    bool grow = ((stripe->count * (rhashtable->stripeMask+1)) > (((u64) desc->nbBuckets) * HASHTABLE_MAX_LOAD));
+#ifdef STATS_HASHTABLE
+    statsRecordProbes(&stripe->stats, &stripe->stats.put, &stripe->stats.putProbes, probes);
+    if (bucket->count > stripe->stats.watermark) {
+        stripe->stats.watermark = bucket->count;
+    }
+#ifdef STATS_HASHTABLE_COLLIDE
+    if (isBusy) { stripe->stats.putCollide++; }
 #endif
-        hal_unlock(&(rhashtable->bucketLock[GET_LOCK_IDX(bucket)]));
-        return value;
-    } else {
-        hal_unlock(&(rhashtable->bucketLock[GET_LOCK_IDX(bucket)]));
-        return entry->value;
+#endif
+    hal_unlock(&stripe->lock);
+    if (grow) {
+        hashtableBucketLockedGrow(rhashtable, desc);
     }
+    return value;
+}
+
+bool hashtableConcBucketLockedPut(hashtable_t * hashtable, void * key, void * value) {
+    hashtableBucketLockedInsert(hashtable, key, value, false);
+    return true;
+}
+
+void * hashtableConcBucketLockedTryPut(hashtable_t * hashtable, void * key, void * value) {
+    return hashtableBucketLockedInsert(hashtable, key, value, true);
 }
 
 bool hashtableConcBucketLockedRemove(hashtable_t * hashtable, void * key, void ** value) {
     hashtableBucketLocked_t * rhashtable = (hashtableBucketLocked_t *) hashtable;
-    u32 bucket = hashtable->hashing(key, hashtable->nbBuckets);
-#ifdef STATS_HASHTABLE_COLLIDE
-    bool isBusy = hal_islocked(&(rhashtable->bucketLock[GET_LOCK_IDX(bucket)]));
-#endif
-    hal_lock(&(rhashtable->bucketLock[GET_LOCK_IDX(bucket)]));
+    u32 bucketIdx;
+    bool isBusy = false;
+    hashtableBuckets_t * desc = lockBucket(rhashtable, key, &bucketIdx, &isBusy);
+    hashtableStripe_t * stripe = GET_STRIPE(rhashtable, bucketIdx);
+    hashtableBucket_t * bucket = &desc->buckets[bucketIdx];
+    u32 inlined = (bucket->count < HASHTABLE_BUCKET_SLOTS) ? bucket->count : HASHTABLE_BUCKET_SLOTS;
+    ocr_hashtable_entry * freed = NULL;
+    bool removed = false;
+    u64 probes = 0;
+    u32 s;
+    for (s=0; s < inlined; s++) {
+        probes++;
+        if (bucket->slots[s].key == key) {
+            break;
+        }
+    }
+    if (s < inlined) {
+        if (value != NULL) {
+            *value = bucket->slots[s].value;
+        }
+        writeBegin(stripe);
+        for (; s < (inlined-1); s++) {
+            bucket->slots[s] = bucket->slots[s+1];
+        }
+        freed = bucket->overflow;
+        if (freed != NULL) {
+            // Pull the most recent overflow entry inline
+            bucket->slots[inlined-1].key = freed->key;
+            bucket->slots[inlined-1].value = freed->value;
+            bucket->overflow = freed->nxt;
+        } else {
+            bucket->slots[inlined-1].key = NULL;
+            bucket->slots[inlined-1].value = NULL;
+        }
+        bucket->count--;
+        writeEnd(stripe);
+        removed = true;
+    } else {
+        // Overflow entries are never read optimistically
+        ocr_hashtable_entry ** prev = &bucket->overflow;
+        while ((*prev != NULL) && ((*prev)->key != key)) {
+            probes++;
+            prev = &((*prev)->nxt);
+        }
+        if (*prev != NULL) {
+            probes++;
+            freed = *prev;
+            if (value != NULL) {
+                *value = freed->value;
+            }
+            *prev = freed->nxt;
+            bucket->count--;
+            removed = true;
+        }
+    }
+    if (removed) {
+        ASSERT(stripe->count >= 1);
+        stripe->count--;
+    }
 #ifdef STATS_HASHTABLE
-    hashtableBucketLockedStats_t * stats = &rhashtable->stats[bucket];
-    ASSERT(stats->current >= 1);
-    stats->current--;
+    statsRecordProbes(&stripe->stats, &stripe->stats.del, &stripe->stats.delProbes, probes);
 #ifdef STATS_HASHTABLE_COLLIDE
-        if (isBusy) { stats->del++; }
+    if (isBusy) { stripe->stats.delCollide++; }
 #endif
 #endif
-    void * res = hashtableNonConcRemoveInternal(hashtable, key, value);
-    bool removed = (res != NULL);
-    hal_unlock(&(rhashtable->bucketLock[GET_LOCK_IDX(bucket)]));
-    if (removed) {
-        hashtable->pd->fcts.pdFree(hashtable->pd, res);
+    hal_unlock(&stripe->lock);
+    if (freed != NULL) {
+        hashtable->pd->fcts.pdFree(hashtable->pd, freed);
     }
-    //DPRINTF(DEBUG_LVL_WARN, "ht=%p For del key=%p: bucket=%"PRIu32" found value=%p *value=%p\n", hashtable, key, bucket, value, ((value) ? *value : NULL));
+    //DPRINTF(DEBUG_LVL_WARN, "ht=%p For del key=%p: bucket=%"PRIu32" found value=%p *value=%p\n", hashtable, key, bucketIdx, value, ((value) ? *value : NULL));
     return removed;
 }
 
+static void destructBucketLockedEntries(hashtable_t * hashtable, deallocFct entryDeallocator, void * deallocatorParam) {
+    ocrPolicyDomain_t * pd = hashtable->pd;
+    hashtableBucketLocked_t * rhashtable = (hashtableBucketLocked_t *) hashtable;
+    hashtableBuckets_t * desc = rhashtable->current;
+    u32 b, s;
+    for (b=0; b < desc->nbBuckets; b++) {
+        hashtableBucket_t * bucket = &desc->buckets[b];
+        u32 inlined = (bucket->count < HASHTABLE_BUCKET_SLOTS) ? bucket->count : HASHTABLE_BUCKET_SLOTS;
+        if (entryDeallocator != NULL) {
+            for (s=0; s < inlined; s++) {
+                entryDeallocator(bucket->slots[s].key, bucket->slots[s].value, deallocatorParam);
+            }
+        }
+        ocr_hashtable_entry * entry = bucket->overflow;
+        while (entry != NULL) {
+            ocr_hashtable_entry * next = entry->nxt;
+            if (entryDeallocator != NULL) {
+                entryDeallocator(entry->key, entry->value, deallocatorParam);
+            }
+            pd->fcts.pdFree(pd, entry);
+            entry = next;
+        }
+    }
+    // Overflow entries of retired arrays were moved to the current one
+    while (desc != NULL) {
+        hashtableBuckets_t * retired = desc->retired;
+        pd->fcts.pdFree(pd, desc->buckets);
+        pd->fcts.pdFree(pd, desc);
+        desc = retired;
+    }
+    pd->fcts.pdFree(pd, rhashtable->stripes);
+}
+
+/**
+ * @brief Destruct the hashtable and all its entries (do not deallocate keys and values pointers).
+ */
+void destructHashtableBucketLocked(hashtable_t * hashtable, deallocFct entryDeallocator, void * deallocatorParam) {
+#ifdef STATS_HASHTABLE
+    dumpStats(hashtable);
+#endif
+    destructHashtable(hashtable, entryDeallocator, deallocatorParam);
+}
+
+/**
+ * @brief Iterate without locking. Entries are visited from the overflow chain
+ * to the first inline slot so that 'iterate' may remove the entry it is called on.
+ */
+static void iterateHashtableBucketLockedRange(hashtable_t * hashtable, u32 firstBucket, u32 lastBucket,
+                                              hashtableIterateFct iterate, void * args) {
+    hashtableBucketLocked_t * rhashtable = (hashtableBucketLocked_t *) hashtable;
+    hal_xadd32(&rhashtable->iterators, 1);
+    hashtableBuckets_t * desc = rhashtable->current;
+    ASSERT(lastBucket <= desc->nbBuckets);
+    u32 b;
+    for (b=firstBucket; b < lastBucket; b++) {
+        hashtableBucket_t * bucket = &desc->buckets[b];
+        ocr_hashtable_entry * entry = bucket->overflow;
+        while (entry != NULL) {
+            ocr_hashtable_entry * next = entry->nxt;
+            iterate(entry->key, entry->value, args);
+            entry = next;
+        }
+        u32 s = (bucket->count < HASHTABLE_BUCKET_SLOTS) ? bucket->count : HASHTABLE_BUCKET_SLOTS;
+        while (s > 0) {
+            s--;
+            iterate(bucket->slots[s].key, bucket->slots[s].value, args);
+        }
+    }
+    hal_xadd32(&rhashtable->iterators, -1);
+}
+
+void iterateHashtableBucketLocked(hashtable_t * hashtable, hashtableIterateFct iterate, void * args) {
+    hashtableBucketLocked_t * rhashtable = (hashtableBucketLocked_t *) hashtable;
+    // Block resizes, then wait for one in progress to complete
+    hal_xadd32(&rhashtable->iterators, 1);
+    hashtableStripe_t * stripe = GET_STRIPE(rhashtable, 0);
+    hal_lock(&stripe->lock);
+    hal_unlock(&stripe->lock);
+    hashtableBuckets_t * desc = rhashtable->current;
+    u32 b, s;
+    for (b=0; b < desc->nbBuckets; b++) {
+        stripe = GET_STRIPE(rhashtable, b);
+        hal_lock(&stripe->lock);
+        hashtableBucket_t * bucket = &desc->buckets[b];
+        u32 inlined = (bucket->count < HASHTABLE_BUCKET_SLOTS) ? bucket->count : HASHTABLE_BUCKET_SLOTS;
+        for (s=0; s < inlined; s++) {
+            iterate(bucket->slots[s].key, bucket->slots[s].value, args);
+        }
+        ocr_hashtable_entry * entry = bucket->overflow;
+        while (entry != NULL) {
+            ocr_hashtable_entry * next = entry->nxt;
+            iterate(entry->key, entry->value, args);
+            entry = next;
+        }
+        hal_unlock(&stripe->lock);
+    }
+    hal_xadd32(&rhashtable->iterators, -1);
+}
 
 //
 // Variants of the generic hashtable through hashing function specialization
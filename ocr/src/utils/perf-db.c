@@ -0,0 +1,244 @@
+/*
+ * This file is subject to the license agreement located in the file LICENSE
+ * and cannot be distributed without it. This notice cannot be
+ * removed or modified.
+ *
+ * Per-EDT performance database. Entries are created when an EDT template
+ * is created and updated by the workers after each monitored execution.
+ */
+
+#include "ocr-config.h"
+#ifdef ENABLE_EXTENSION_PERF
+
+#include "debug.h"
+#include "ocr-errors.h"
+#include "ocr-policy-domain.h"
+#include "ocr-sal.h"
+#include "ocr-types.h"
+#include "utils/hashtable.h"
+#include "utils/ocr-utils.h"
+#include "utils/perf-db.h"
+
+#define DEBUG_TYPE UTIL
+
+// Function pointers are aligned so the low bits carry no information
+static u32 hashPerfDbKey(void *key, u32 nbBuckets) {
+    u64 k = ((u64)key) * 0x9E3779B97F4A7C15ULL;
+    return (u32)(k >> 32) % nbBuckets;
+}
+
+// FNV-1a hash of an EDT name, used as key of the loaded records
+static void *hashPerfDbName(const char *name) {
+    u64 h = 0xcbf29ce484222325ULL;
+    u32 i;
+    for (i = 0; (i < PERF_DB_NAME_SIZE) && (name[i] != '\0'); i++) {
+        h ^= (u8)name[i];
+        h *= 0x100000001b3ULL;
+    }
+    return (void *)(h | 1);
+}
+
+static void perfDbCopyName(char *dst, const char *src) {
+    u32 i;
+    for (i = 0; (i < PERF_DB_NAME_SIZE-1) && (src[i] != '\0'); i++)
+        dst[i] = src[i];
+    dst[i] = '\0';
+}
+
+static void perfDbLoad(ocrPerfDb_t *db) {
+#ifdef SAL_LINUX
+    ocrPolicyDomain_t *pd = db->pd;
+    u64 size = salPerfDbSize();
+    u64 i;
+    if (size < sizeof(ocrPerfDbHeader_t))
+        return;
+    u8 *buffer = pd->fcts.pdMalloc(pd, size);
+    ocrPerfDbHeader_t *header = (ocrPerfDbHeader_t *)buffer;
+    if ((salPerfDbRead(buffer, size) != size) || (header->magic != PERF_DB_MAGIC) ||
+        (header->version != PERF_DB_VERSION) || (header->counterCount != PERF_MAX) ||
+        (size != sizeof(ocrPerfDbHeader_t) + header->recordCount * sizeof(ocrPerfDbRecord_t))) {
+        DPRINTF(DEBUG_LVL_WARN, "Ignoring invalid performance database\n");
+        pd->fcts.pdFree(pd, buffer);
+        return;
+    }
+    db->records = (ocrPerfDbRecord_t *)(buffer + sizeof(ocrPerfDbHeader_t));
+    db->recordCount = header->recordCount;
+    db->claimed = pd->fcts.pdMalloc(pd, db->recordCount + 1);
+    db->persisted = newHashtable(pd, PERF_DB_BUCKETS, hashPerfDbKey);
+    for (i = 0; i < db->recordCount; i++) {
+        db->records[i].name[PERF_DB_NAME_SIZE-1] = '\0';
+        db->claimed[i] = 0;
+        ocrPerfDbRecord_t *existing = hashtableNonConcTryPut(db->persisted, hashPerfDbName(db->records[i].name), &db->records[i]);
+        // The record is not warm-started from but is saved again
+        if (existing != &db->records[i]) {
+            DPRINTF(DEBUG_LVL_WARN, "Performance database records %s and %s have the same hash, ignoring %s\n",
+                    existing->name, db->records[i].name, db->records[i].name);
+        }
+    }
+    DPRINTF(DEBUG_LVL_INFO, "Loaded %"PRIu64" EDT statistics\n", db->recordCount);
+#endif
+}
+
+ocrPerfDb_t *newPerfDb(ocrPolicyDomain_t *pd) {
+    ocrPerfDb_t *db = pd->fcts.pdMalloc(pd, sizeof(ocrPerfDb_t));
+    db->pd = pd;
+    db->entries = newHashtableBucketLocked(pd, PERF_DB_BUCKETS, hashPerfDbKey);
+    db->persisted = NULL;
+    db->records = NULL;
+    db->claimed = NULL;
+    db->recordCount = 0;
+    perfDbLoad(db);
+    return db;
+}
+
+// Starts an entry from the statistics of a previous run, if any
+static void perfDbWarmStart(ocrPerfDb_t *db, ocrPerfCounters_t *ctrs) {
+    ocrPerfDbRecord_t *rec;
+    u32 i;
+    if (db->persisted == NULL)
+        return;
+    // Records are not modified once loaded, concurrent lookups are safe
+    rec = hashtableNonConcGet(db->persisted, hashPerfDbName(ctrs->name));
+    if ((rec == NULL) || ocrStrcmp((u8 *)rec->name, (u8 *)ctrs->name))
+        return;
+    db->claimed[rec - db->records] = 1;
+    ctrs->count = rec->count;
+    ctrs->steadyStateMask = rec->steadyStateMask;
+    ctrs->bottomLevel = rec->bottomLevel;
+    for (i = 0; i < PERF_MAX; i++) {
+        ctrs->stats[i].var.var_m = rec->stats[i].mean;
+        ctrs->stats[i].var.var_s = rec->stats[i].m2;
+        ctrs->stats[i].average = (u64)rec->stats[i].mean;
+    }
+    DPRINTF(DEBUG_LVL_VERB, "Warm-started %s from %"PRIu32" samples\n", ctrs->name, ctrs->count);
+}
+
+ocrPerfCounters_t *perfDbGet(ocrPerfDb_t *db, void *edt, const char *name) {
+    ocrPolicyDomain_t *pd = db->pd;
+    ocrPerfCounters_t *ctrs = hashtableConcBucketLockedGet(db->entries, edt);
+    ocrPerfCounters_t *existing;
+    u32 i;
+    if (ctrs != NULL)
+        return ctrs;
+
+    ctrs = pd->fcts.pdMalloc(pd, sizeof(ocrPerfCounters_t));
+    for (i = 0; i < PERF_MAX; i++) {
+        ctrs->stats[i].average = 0;
+        ctrs->stats[i].current = 0;
+        ctrs->stats[i].var.var_m = 0.0;
+        ctrs->stats[i].var.var_s = 0.0;
+    }
+    ctrs->count = 0;
+    ctrs->steadyStateMask = ((1 << PERF_MAX) - 1); // Steady state not reached
+    ctrs->bottomLevel = 0;
+    ctrs->edt = edt;
+    if ((name != NULL) && (name[0] != '\0')) {
+        perfDbCopyName(ctrs->name, name);
+    } else {
+#ifdef SAL_LINUX
+        salSymbolName(edt, ctrs->name, PERF_DB_NAME_SIZE);
+#else
+        SNPRINTF(ctrs->name, PERF_DB_NAME_SIZE, "%p", edt);
+#endif
+    }
+    perfDbWarmStart(db, ctrs);
+
+    // Another template of the same function may have raced us
+    existing = hashtableConcBucketLockedTryPut(db->entries, edt, ctrs);
+    if (existing != ctrs)
+        pd->fcts.pdFree(pd, ctrs);
+    return existing;
+}
+
+static void perfDbDumpEntry(void *key, void *value, void *args) {
+    ocrPerfCounters_t *ctrs = (ocrPerfCounters_t *)value;
+    u32 i;
+    PRINTF("%p\t%s\t%"PRIu32"\t", ctrs->edt, ctrs->name, ctrs->count);
+    for (i = 0; i < PERF_MAX; i++) PRINTF("%"PRId64"\t", ctrs->stats[i].average);
+    PRINTF("%"PRIu64"\t%"PRIu64"\t0x%"PRIx32"\n", (u64)perfStatVariance(&ctrs->stats[PERF_HW_CYCLES], ctrs->count),
+           ctrs->bottomLevel, ctrs->steadyStateMask);
+}
+
+void perfDbDump(ocrPerfDb_t *db) {
+    PRINTF("EDT\tName\tCount\tHW_CYCLES\tL1_HITS\tL1_MISS\tFLOAT_OPS\tINSTRUCTIONS\tSTALLED_CYCLES\tEDT_CREATES\tDB_TOTAL\tDB_CREATES\tDB_DESTROYS\tEVT_SATISFIES\tEDT_SUCCESSORS\tHW_CYCLES_VAR\tBOTTOM_LEVEL\tMask\n");
+    iterateHashtableBucketLocked(db->entries, perfDbDumpEntry, NULL);
+}
+
+#ifdef SAL_LINUX
+typedef struct {
+    ocrPerfDbRecord_t *records;
+    u64 count;
+} perfDbSaveArgs_t;
+
+static void perfDbCountEntry(void *key, void *value, void *args) {
+    ((perfDbSaveArgs_t *)args)->count++;
+}
+
+static void perfDbSaveEntry(void *key, void *value, void *args) {
+    perfDbSaveArgs_t *save = (perfDbSaveArgs_t *)args;
+    ocrPerfCounters_t *ctrs = (ocrPerfCounters_t *)value;
+    ocrPerfDbRecord_t *rec = &save->records[save->count++];
+    u32 i;
+    perfDbCopyName(rec->name, ctrs->name);
+    rec->count = ctrs->count;
+    rec->steadyStateMask = ctrs->steadyStateMask;
+    rec->bottomLevel = ctrs->bottomLevel;
+    for (i = 0; i < PERF_MAX; i++) {
+        rec->stats[i].mean = ctrs->stats[i].var.var_m;
+        rec->stats[i].m2 = ctrs->stats[i].var.var_s;
+    }
+}
+
+static void perfDbSave(ocrPerfDb_t *db) {
+    ocrPolicyDomain_t *pd = db->pd;
+    perfDbSaveArgs_t save;
+    u64 i, size;
+    save.count = 0;
+    iterateHashtableBucketLocked(db->entries, perfDbCountEntry, &save);
+    for (i = 0; i < db->recordCount; i++)
+        save.count += !db->claimed[i];
+    if (save.count == 0)
+        return;
+
+    size = sizeof(ocrPerfDbHeader_t) + save.count * sizeof(ocrPerfDbRecord_t);
+    u8 *buffer = pd->fcts.pdMalloc(pd, size);
+    ocrPerfDbHeader_t *header = (ocrPerfDbHeader_t *)buffer;
+    header->magic = PERF_DB_MAGIC;
+    header->version = PERF_DB_VERSION;
+    header->counterCount = PERF_MAX;
+    header->recordCount = save.count;
+    save.records = (ocrPerfDbRecord_t *)(buffer + sizeof(ocrPerfDbHeader_t));
+    save.count = 0;
+    iterateHashtableBucketLocked(db->entries, perfDbSaveEntry, &save);
+    for (i = 0; i < db->recordCount; i++) {
+        if (!db->claimed[i])
+            save.records[save.count++] = db->records[i];
+    }
+    ASSERT(save.count == header->recordCount);
+    if (salPerfDbWrite(buffer, size) == 0)
+        DPRINTF(DEBUG_LVL_INFO, "Saved %"PRIu64" EDT statistics\n", save.count);
+    pd->fcts.pdFree(pd, buffer);
+}
+#endif
+
+static void perfDbFreeEntry(void *key, void *value, void *deallocParam) {
+    ocrPolicyDomain_t *pd = (ocrPolicyDomain_t *)deallocParam;
+    pd->fcts.pdFree(pd, value);
+}
+
+void destructPerfDb(ocrPerfDb_t *db) {
+    ocrPolicyDomain_t *pd = db->pd;
+#ifdef SAL_LINUX
+    perfDbSave(db);
+#endif
+    destructHashtableBucketLocked(db->entries, perfDbFreeEntry, pd);
+    if (db->persisted != NULL) {
+        destructHashtable(db->persisted, NULL, NULL);
+        // The records follow the header in the loaded buffer
+        pd->fcts.pdFree(pd, ((u8 *)db->records) - sizeof(ocrPerfDbHeader_t));
+        pd->fcts.pdFree(pd, db->claimed);
+    }
+    pd->fcts.pdFree(pd, db);
+}
+
+#endif /* ENABLE_EXTENSION_PERF */
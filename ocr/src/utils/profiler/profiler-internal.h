@@ -56,6 +56,38 @@
 #define PROFILER_KHZ 3400000
 #endif
 
+// Initial number of child slots of a parent event (power of 2). Tables
+// double when they are more than half full
+#ifndef PROFILER_CHILD_SLOTS
+#define PROFILER_CHILD_SLOTS 8
+#endif
+
+#ifdef PROFILER_SNAPSHOT
+// Period at which the self counters of all threads are sampled
+#ifndef PROFILER_SNAPSHOT_MS
+#define PROFILER_SNAPSHOT_MS 1000
+#endif
+
+// Maximum number of profiled threads
+#ifndef PROFILER_SNAPSHOT_MAX_THREADS
+#define PROFILER_SNAPSHOT_MAX_THREADS 256
+#endif
+
+// Size at which the snapshot file is rolled over to <name>.1
+#ifndef PROFILER_SNAPSHOT_MAX_BYTES
+#define PROFILER_SNAPSHOT_MAX_BYTES (64*1024*1024)
+#endif
+
+// Number of times a torn copy is retried before a thread is skipped
+#ifndef PROFILER_SNAPSHOT_RETRIES
+#define PROFILER_SNAPSHOT_RETRIES 16
+#endif
+
+#define PROFILER_SNAPSHOT_MAGIC "OCRPLIVE"
+#define PROFILER_SNAPSHOT_VERSION 1
+#define PROFILER_SNAPSHOT_TAG 0x50414e53 /* "SNAP" */
+#endif /* PROFILER_SNAPSHOT */
+
 //timeMs = a/PROFILER_KHZ;
 //timeNs = (unsigned int)(1000000.0*((double)a/PROFILER_KHZ - (double)timeMs));
 
@@ -74,6 +106,16 @@ typedef struct __profilerSelfEntry {
 } _profilerSelfEntry;
 
 
+/* Children of a parent event, in a small open-addressed table keyed by the
+ * child event. Only the (parent, child) pairs that actually occur are
+ * allocated, so the footprint no longer grows with MAX_EVENTS^2 */
+typedef struct __profilerChildTable {
+    u32 *keys;                  /**< Child event + 1; 0 for an empty slot */
+    _profilerChildEntry *entries;
+    u32 size;                   /**< Number of slots (0 or a power of 2) */
+    u32 count;                  /**< Number of occupied slots */
+} _profilerChildTable;
+
 typedef struct __profilerData {
     _profiler* stack[MAX_PROFILER_LEVEL];
     FILE *output;
@@ -81,14 +123,49 @@ typedef struct __profilerData {
     u32 level;                  /**< Current level in the profiler */
 
     _profilerSelfEntry selfEvents[MAX_EVENTS];
-    _profilerChildEntry childrenEvents[MAX_EVENTS][MAX_EVENTS-1]; // We already have the self entry
+    _profilerChildTable childrenEvents[MAX_EVENTS]; // Indexed by parent event; we already have the self entry
     u32 stackPosition[MAX_EVENTS]; // Contains either 0 or the level at which the most recent
                                    // entry for the event is made (+1: level 0 is encoded as 1)
+#ifdef PROFILER_SNAPSHOT
+    volatile u64 seq;           /**< Odd while the owning thread updates its entries */
+    u32 snapshotId;             /**< Slot of this thread in the snapshot registry */
+    _profilerSelfEntry snapshotEvents[MAX_EVENTS]; // Self entries at the last snapshot
+                                                   // (only used by the snapshot thread)
+#endif
 } _profilerData;
 
 /* Non-inline profilerData functions */
 void _profilerDataInit(_profilerData *self);
 void _profilerDataDestroy(void * self);
+_profilerChildEntry* _profilerChildTableInsert(_profilerChildTable *self, u32 child);
+
+#ifdef PROFILER_SNAPSHOT
+/**
+ * @brief Make the counters of a thread visible to the snapshot thread
+ *
+ * The snapshot thread is started on the first registration and periodically
+ * appends the change of each thread's self entries to 'live_profiler_<location>'.
+ */
+void _profilerSnapshotRegister(_profilerData *self, u64 location);
+
+/* The owning thread brackets its updates of selfEvents/childrenEvents so
+ * that the snapshot thread can detect torn copies (seqlock). Stores are not
+ * reordered on x86 so only the compiler needs to be held back. */
+static inline void _profilerDataWriteBegin(_profilerData *self) __attribute__((always_inline));
+static inline void _profilerDataWriteBegin(_profilerData *self) {
+    ++self->seq;
+    __asm__ __volatile__ ("" ::: "memory");
+}
+
+static inline void _profilerDataWriteEnd(_profilerData *self) __attribute__((always_inline));
+static inline void _profilerDataWriteEnd(_profilerData *self) {
+    __asm__ __volatile__ ("" ::: "memory");
+    ++self->seq;
+}
+#else
+#define _profilerDataWriteBegin(self)
+#define _profilerDataWriteEnd(self)
+#endif /* PROFILER_SNAPSHOT */
 
 /* _profilerChildEntry functions */
 static inline void _profilerChildEntryReset(_profilerChildEntry *self) {
@@ -152,6 +229,29 @@ static inline void _profilerChildEntryAddRecurseTime(_profilerChildEntry *self,
     self->sumSqRecurseMs += timeMs*timeMs;
 }
 
+/* _profilerChildTable functions */
+static inline u32 _profilerChildTableHash(u32 child, u32 size) {
+    return (child * 0x9E3779B1U) & (size - 1);
+}
+
+// Returns NULL if the child never ran under this parent
+static inline _profilerChildEntry* _profilerChildTableFind(_profilerChildTable *self, u32 child) {
+    if(self->size == 0) return NULL;
+    u32 i = _profilerChildTableHash(child, self->size);
+    while(self->keys[i] != 0) {
+        if(self->keys[i] == child + 1)
+            return &(self->entries[i]);
+        i = (i + 1) & (self->size - 1);
+    }
+    return NULL;
+}
+
+static inline _profilerChildEntry* _profilerChildTableGet(_profilerChildTable *self, u32 child) __attribute__((always_inline));
+static inline _profilerChildEntry* _profilerChildTableGet(_profilerChildTable *self, u32 child) {
+    _profilerChildEntry *entry = _profilerChildTableFind(self, child);
+    return entry ? entry : _profilerChildTableInsert(self, child);
+}
+
 /* _profilerSelfEntry functions */
 static inline void _profilerSelfEntryReset(_profilerSelfEntry *self) {
     self->count = self->sumMs = self->sumSqMs = self->sumSqNs = 0UL;
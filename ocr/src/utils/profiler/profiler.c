@@ -32,11 +32,18 @@
 
 #include "profiler-internal.h"
 #include "debug.h"
+#include "ocr-sysboot.h"
+#include "utils/ocr-utils.h"
 
 #ifdef OCR_RUNTIME_PROFILER
 
 #include <stdio.h>
 #include <pthread.h>
+#ifdef PROFILER_SNAPSHOT
+#include <sched.h>
+#include <string.h>
+#include <time.h>
+#endif
 
 // BUG #591: Make this more platform independent
 extern pthread_key_t _profilerThreadData;
@@ -191,6 +198,7 @@ _profiler* _profilerDestroy(_profiler *self, u64 end) {
     u32 accumulatorNs = (u32)(1000000.0*((double)self->accumulatorTicks/PROFILER_KHZ - (double)accumulatorMs));
 
     if(removedFromStack) {
+        _profilerDataWriteBegin(self->myData);
         // First the self counter
         if(0 && self->recurseAccumulate) {
             // Remove the time from our self-entry. We only do this for our own entry because
@@ -212,16 +220,15 @@ _profiler* _profilerDestroy(_profiler *self, u64 end) {
             _profiler *parentEventPtr = self->myData->stack[self->myData->level-1];
             u32 parentEvent = parentEventPtr->myEvent;
             //ASSERT(parentEvent != self->myEvent);
-            _profilerChildEntryAddTime(
-                &(self->myData->childrenEvents[parentEvent][self->myEvent<parentEvent?self->myEvent:(self->myEvent-1)]),
-                accumulatorMs, accumulatorNs);
+            _profilerChildEntry *childEntry =
+                _profilerChildTableGet(&(self->myData->childrenEvents[parentEvent]), self->myEvent);
+            _profilerChildEntryAddTime(childEntry, accumulatorMs, accumulatorNs);
 
             if(parentEventPtr->currentRecurseAccumulate != 0.0) {
                 u64 t = parentEventPtr->currentRecurseAccumulate;
                 u64 tt = t/PROFILER_KHZ;
                 _profilerChildEntryAddRecurseTime(
-                    &(self->myData->childrenEvents[parentEvent][self->myEvent<parentEvent?self->myEvent:(self->myEvent-1)]),
-                    tt, (u32)(1000000.0*((double)t/PROFILER_KHZ - tt)));
+                    childEntry, tt, (u32)(1000000.0*((double)t/PROFILER_KHZ - tt)));
                 _profilerSwapRecurse(parentEventPtr);
             }
 
@@ -238,7 +245,7 @@ _profiler* _profilerDestroy(_profiler *self, u64 end) {
                 u32 grandParentEvent = grandParentEventPtr->myEvent;
                 //ASSERT(grandParentEvent != parentEvent);
                 _profilerChildEntryAddChildTime(
-                    &(self->myData->childrenEvents[grandParentEvent][parentEvent<grandParentEvent?parentEvent:(parentEvent-1)]),
+                    _profilerChildTableGet(&(self->myData->childrenEvents[grandParentEvent]), parentEvent),
                     accumulatorMs, accumulatorNs);
             }
             // Deal with recursion. We are going to remove our time from the entry of our
@@ -251,10 +258,12 @@ _profiler* _profilerDestroy(_profiler *self, u64 end) {
             }
             // Set the stack information properly for recursion
             self->myData->stackPosition[self->myEvent] = self->previousLastLevel;
+            _profilerDataWriteEnd(self->myData);
             return parentEventPtr;
         } else {
             // Still set the recurse info properly (resets it)
             self->myData->stackPosition[self->myEvent] = self->previousLastLevel;
+            _profilerDataWriteEnd(self->myData);
         }
     } else {
         // Not removed from stack which means that this is a collapsed call
@@ -294,6 +303,241 @@ void _profilerPauseInternal(_profiler *self) {
     } \
     res = (end.tv_sec-start.tv_sec)*1000000L + (end.tv_nsec - start.tv_nsec)/1000;
 
+#ifdef PROFILER_SNAPSHOT
+/* Live snapshots
+ *
+ * The snapshot file starts with a header:
+ *   [char magic[8]][u32 version][u32 eventCount]([u32 length][name]) x eventCount
+ * followed by one record per thread and snapshot holding the change of the
+ * self entries that moved since the previous snapshot:
+ *   [u32 tag][u32 thread][u32 entryCount][u32 reserved][u64 timestamp (ns)]
+ *   ([u32 event][u32 reserved][u64 count][u64 time (ns)]) x entryCount
+ * The header is written again each time the file rolls over.
+ */
+
+typedef struct {
+    u32 tag;
+    u32 thread;
+    u32 entryCount;
+    u32 reserved;
+    u64 timestamp;
+} _profilerSnapshotRecord;
+
+typedef struct {
+    u32 event;
+    u32 reserved;
+    u64 count;
+    u64 timeNs;
+} _profilerSnapshotDelta;
+
+static pthread_mutex_t _profilerSnapshotLock = PTHREAD_MUTEX_INITIALIZER;
+static _profilerData *_profilerSnapshotThreads[PROFILER_SNAPSHOT_MAX_THREADS];
+static u32 _profilerSnapshotThreadCount = 0; // Slots handed out
+static u32 _profilerSnapshotActive = 0;      // Threads still registered
+static bool _profilerSnapshotRunning = false;
+static FILE *_profilerSnapshotFile = NULL;
+static char _profilerSnapshotName[64];
+static u64 _profilerSnapshotBytes = 0;
+// Only used with _profilerSnapshotLock held
+static _profilerSelfEntry _profilerSnapshotCurrent[MAX_EVENTS];
+static _profilerSnapshotDelta _profilerSnapshotDeltas[MAX_EVENTS];
+
+static void _profilerSnapshotWrite(const void *buf, u64 size) {
+    if(fwrite(buf, 1, size, _profilerSnapshotFile) != size) {
+        fprintf(stderr, "Profiler: failed to write %s\n", _profilerSnapshotName);
+    }
+    _profilerSnapshotBytes += size;
+}
+
+static void _profilerSnapshotOpen() {
+    _profilerSnapshotFile = fopen(_profilerSnapshotName, "w");
+    ASSERT(_profilerSnapshotFile);
+    _profilerSnapshotBytes = 0;
+    u32 header[2] = {PROFILER_SNAPSHOT_VERSION, (u32)MAX_EVENTS};
+    _profilerSnapshotWrite(PROFILER_SNAPSHOT_MAGIC, 8);
+    _profilerSnapshotWrite(header, sizeof(header));
+    u32 i;
+    for(i=0; i<(u32)MAX_EVENTS; ++i) {
+        u32 length = strlen(_profilerEventNames[i]);
+        _profilerSnapshotWrite(&length, sizeof(u32));
+        _profilerSnapshotWrite(_profilerEventNames[i], length);
+    }
+    fflush(_profilerSnapshotFile);
+}
+
+static void _profilerSnapshotRoll() {
+    char rolled[sizeof(_profilerSnapshotName) + 2];
+    fclose(_profilerSnapshotFile);
+    snprintf(rolled, sizeof(rolled), "%s.1", _profilerSnapshotName);
+    rename(_profilerSnapshotName, rolled);
+    _profilerSnapshotOpen();
+}
+
+/**
+ * @brief Copy the self entries of a thread without stopping it
+ *
+ * Returns false if the thread kept updating its entries while they were copied.
+ */
+static bool _profilerSnapshotCopy(_profilerData *self, _profilerSelfEntry *dst) {
+    u32 tries;
+    for(tries = 0; tries < PROFILER_SNAPSHOT_RETRIES; ++tries) {
+        u64 seq = self->seq;
+        __asm__ __volatile__ ("" ::: "memory");
+        if((seq & 1) == 0) {
+            memcpy(dst, &(self->selfEvents[0]), sizeof(_profilerSelfEntry)*MAX_EVENTS);
+            __asm__ __volatile__ ("" ::: "memory");
+            if(self->seq == seq)
+                return true;
+        }
+        sched_yield();
+    }
+    return false;
+}
+
+// Called with _profilerSnapshotLock held
+static void _profilerSnapshotThread(_profilerData *self, u64 timestamp) {
+    if(!_profilerSnapshotCopy(self, _profilerSnapshotCurrent))
+        return; // Caught up with at the next snapshot
+
+    _profilerSnapshotRecord record = {PROFILER_SNAPSHOT_TAG, self->snapshotId, 0, 0, timestamp};
+    u32 i;
+    for(i=0; i<(u32)MAX_EVENTS; ++i) {
+        _profilerSelfEntry *cur = &(_profilerSnapshotCurrent[i]);
+        _profilerSelfEntry *prev = &(self->snapshotEvents[i]);
+        if(cur->count == prev->count) continue;
+        _profilerSnapshotDelta *delta = &(_profilerSnapshotDeltas[record.entryCount++]);
+        delta->event = i;
+        delta->reserved = 0;
+        delta->count = cur->count - prev->count;
+        delta->timeNs = (cur->sumMs*1000000UL + cur->sumNs) - (prev->sumMs*1000000UL + prev->sumNs);
+        *prev = *cur;
+    }
+    if(record.entryCount == 0) return;
+
+    if(_profilerSnapshotBytes >= PROFILER_SNAPSHOT_MAX_BYTES)
+        _profilerSnapshotRoll();
+    _profilerSnapshotWrite(&record, sizeof(record));
+    _profilerSnapshotWrite(_profilerSnapshotDeltas, sizeof(_profilerSnapshotDelta)*record.entryCount);
+}
+
+static u64 _profilerSnapshotTime() {
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return ((u64)ts.tv_sec)*1000000000UL + ts.tv_nsec;
+}
+
+static void* _profilerSnapshotRun(void *arg) {
+    struct timespec period = {PROFILER_SNAPSHOT_MS/1000, (PROFILER_SNAPSHOT_MS%1000)*1000000L};
+    while(true) {
+        nanosleep(&period, NULL);
+        pthread_mutex_lock(&_profilerSnapshotLock);
+        if(_profilerSnapshotActive == 0) {
+            // All profiled threads are gone
+            fclose(_profilerSnapshotFile);
+            _profilerSnapshotFile = NULL;
+            _profilerSnapshotRunning = false;
+            pthread_mutex_unlock(&_profilerSnapshotLock);
+            break;
+        }
+        u64 timestamp = _profilerSnapshotTime();
+        u32 i;
+        for(i=0; i<_profilerSnapshotThreadCount; ++i) {
+            if(_profilerSnapshotThreads[i])
+                _profilerSnapshotThread(_profilerSnapshotThreads[i], timestamp);
+        }
+        fflush(_profilerSnapshotFile);
+        pthread_mutex_unlock(&_profilerSnapshotLock);
+    }
+    return NULL;
+}
+
+void _profilerSnapshotRegister(_profilerData *self, u64 location) {
+    pthread_mutex_lock(&_profilerSnapshotLock);
+    if(_profilerSnapshotThreadCount == PROFILER_SNAPSHOT_MAX_THREADS) {
+        fprintf(stderr, "Profiler: more than %"PRIu32" threads, not taking live snapshots of the others\n",
+                (u32)PROFILER_SNAPSHOT_MAX_THREADS);
+        pthread_mutex_unlock(&_profilerSnapshotLock);
+        return;
+    }
+    if(!_profilerSnapshotRunning) {
+        pthread_t snapshotThread;
+        snprintf(_profilerSnapshotName, sizeof(_profilerSnapshotName), "live_profiler_%"PRIx64"", location);
+        _profilerSnapshotOpen();
+        RESULT_ASSERT(pthread_create(&snapshotThread, NULL, &_profilerSnapshotRun, NULL), ==, 0);
+        RESULT_ASSERT(pthread_detach(snapshotThread), ==, 0);
+        _profilerSnapshotRunning = true;
+    }
+    self->snapshotId = _profilerSnapshotThreadCount++;
+    _profilerSnapshotThreads[self->snapshotId] = self;
+    ++_profilerSnapshotActive;
+    pthread_mutex_unlock(&_profilerSnapshotLock);
+}
+
+// Flushes the last changes of an exiting thread
+static void _profilerSnapshotUnregister(_profilerData *self) {
+    if(self->snapshotId == (u32)-1) return;
+    pthread_mutex_lock(&_profilerSnapshotLock);
+    ASSERT(_profilerSnapshotThreads[self->snapshotId] == self);
+    if(_profilerSnapshotFile) {
+        _profilerSnapshotThread(self, _profilerSnapshotTime());
+        fflush(_profilerSnapshotFile);
+    }
+    _profilerSnapshotThreads[self->snapshotId] = NULL;
+    self->snapshotId = (u32)-1;
+    --_profilerSnapshotActive;
+    pthread_mutex_unlock(&_profilerSnapshotLock);
+}
+#endif /* PROFILER_SNAPSHOT */
+
+/* _profilerChildTable functions */
+
+static void _profilerChildTableAlloc(_profilerChildTable *self, u32 size) {
+    self->keys = (u32*)runtimeChunkAlloc(sizeof(u32)*size, PERSISTENT_CHUNK);
+    self->entries = (_profilerChildEntry*)runtimeChunkAlloc(sizeof(_profilerChildEntry)*size, PERSISTENT_CHUNK);
+    ASSERT(self->keys && self->entries);
+    memset(self->keys, 0, sizeof(u32)*size);
+    self->size = size;
+    self->count = 0;
+}
+
+static void _profilerChildTableDestroy(_profilerChildTable *self) {
+    if(self->size) {
+        runtimeChunkFree((u64)self->keys, PERSISTENT_CHUNK);
+        runtimeChunkFree((u64)self->entries, PERSISTENT_CHUNK);
+    }
+    self->keys = NULL;
+    self->entries = NULL;
+    self->size = self->count = 0;
+}
+
+// Only called by the thread owning the table, the first time a child runs under this parent
+_profilerChildEntry* _profilerChildTableInsert(_profilerChildTable *self, u32 child) {
+    if(self->size == 0) {
+        _profilerChildTableAlloc(self, PROFILER_CHILD_SLOTS);
+    } else if(2*(self->count + 1) > self->size) {
+        _profilerChildTable old = *self;
+        u32 i;
+        _profilerChildTableAlloc(self, old.size*2);
+        for(i=0; i<old.size; ++i) {
+            if(old.keys[i] == 0) continue;
+            u32 j = _profilerChildTableHash(old.keys[i] - 1, self->size);
+            while(self->keys[j] != 0)
+                j = (j + 1) & (self->size - 1);
+            self->keys[j] = old.keys[i];
+            self->entries[j] = old.entries[i];
+            ++self->count;
+        }
+        _profilerChildTableDestroy(&old);
+    }
+    u32 i = _profilerChildTableHash(child, self->size);
+    while(self->keys[i] != 0)
+        i = (i + 1) & (self->size - 1);
+    self->keys[i] = child + 1;
+    _profilerChildEntryReset(&(self->entries[i]));
+    ++self->count;
+    return &(self->entries[i]);
+}
+
 /* _profilerData functions */
 
 void _profilerDataInit(_profilerData *self) {
@@ -317,14 +561,22 @@ void _profilerDataInit(_profilerData *self) {
     //fprintf(stderr, "Got RDTSCP overhead of %"PRIu64" ticks\n", self->overheadTimer);
 
     memset(&(self->selfEvents[0]), 0, sizeof(_profilerSelfEntry)*MAX_EVENTS);
-    memset(&(self->childrenEvents[0][0]), 0, sizeof(_profilerChildEntry)*(MAX_EVENTS)*(MAX_EVENTS-1));
+    memset(&(self->childrenEvents[0]), 0, sizeof(_profilerChildTable)*MAX_EVENTS);
     memset(&(self->stackPosition[0]), 0, sizeof(u32)*MAX_EVENTS);
+#ifdef PROFILER_SNAPSHOT
+    self->seq = 0;
+    self->snapshotId = (u32)-1;
+    memset(&(self->snapshotEvents[0]), 0, sizeof(_profilerSelfEntry)*MAX_EVENTS);
+#endif
 }
 
 void _profilerDataDestroy(void* _self) {
     _profilerData *self = (_profilerData*)_self;
 
     if(self) {
+#ifdef PROFILER_SNAPSHOT
+        _profilerSnapshotUnregister(self);
+#endif
         // This will dump the profile and delete everything. This can be called
         // when the thread is exiting (and the TLS is destroyed)
         u32 i;
@@ -343,8 +595,8 @@ void _profilerDataDestroy(void* _self) {
                             i, j, entry->count, entry->sumMs, entry->sumNs, entry->sumSqMs, entry->sumSqNs);
                 } else {
                     // Child entry
-                    _profilerChildEntry *entry = &(self->childrenEvents[i][j<i?j:(j-1)]);
-                    if(entry->count == 0) continue;
+                    _profilerChildEntry *entry = _profilerChildTableFind(&(self->childrenEvents[i]), j);
+                    if(entry == NULL || entry->count == 0) continue;
                     fprintf(self->output,
                             "ENTRY %"PRIu32":%"PRIu32" = count(%"PRIu64"), sum(%"PRIu64".%06"PRIu32"), sumSq(%"PRIu64".%012"PRIu64"), sumChild(%"PRIu64".%06"PRIu32"), sumSqChild(%"PRIu64".%012"PRIu64"), sumRecurse(%"PRIu64".%06"PRIu32"), sumSqRecurse(%"PRIu64".%012"PRIu64")\n",
                             i, j, entry->count, entry->sumMs, entry->sumNs, entry->sumSqMs,
@@ -356,6 +608,10 @@ void _profilerDataDestroy(void* _self) {
             }
         }
         fclose(self->output);
+
+        for(i=0; i<(u32)MAX_EVENTS; ++i) {
+            _profilerChildTableDestroy(&(self->childrenEvents[i]));
+        }
     }
 }
 
@@ -10,15 +10,106 @@
 #include "worker/hc/hc-worker.h"
 
 
-bool isDequeFull(deque_t *deq){
-    if(deq == NULL) return false;
-    s32 head = deq->head;
-    s32 tail = deq->tail;
-    if(tail == (INIT_DEQUE_CAPACITY + head)){
-        return true;
-    }else{
+/******************************************************/
+/* PER-WORKER TRACE BUFFERS                           */
+/******************************************************/
+
+#if (TRACE_PAGE_SIZE % TRACE_PAGE_ALIGN) != 0
+#error TRACE_PAGE_SIZE must be a multiple of TRACE_PAGE_ALIGN
+#endif
+
+static void traceBufferInitPage(ocrTraceBuffer_t *buf, u64 location, u64 workerId){
+    ocrTracePageHeader_t *header = (ocrTracePageHeader_t *)TRACE_BUFFER_PAGE(buf, buf->tail);
+    header->magic = TRACE_PAGE_MAGIC;
+    header->location = location;
+    header->workerId = workerId;
+    header->baseTime = buf->lastTime;
+    header->pageSize = TRACE_PAGE_SIZE;
+    header->used = 0;
+    header->count = 0;
+    header->dropped = buf->pendingDropped;
+    buf->pendingDropped = 0;
+}
+
+ocrTraceBuffer_t *newTraceBuffer(ocrPolicyDomain_t *pd, u64 workerId){
+    ocrTraceBuffer_t *buf = pd->fcts.pdMalloc(pd, sizeof(ocrTraceBuffer_t));
+    // Pages are aligned so that the system worker can write them with direct I/O
+    buf->alloc = pd->fcts.pdMalloc(pd, ((u64)TRACE_BUFFER_PAGES) * TRACE_PAGE_SIZE + TRACE_PAGE_ALIGN);
+    buf->pages = (u8 *)((((u64)buf->alloc) + TRACE_PAGE_ALIGN - 1) & ~((u64)TRACE_PAGE_ALIGN - 1));
+    buf->head = 0;
+    buf->tail = 0;
+    buf->lastTime = 0;
+    buf->pendingDropped = 0;
+    buf->dropped = 0;
+    traceBufferInitPage(buf, (u64)pd->myLocation, workerId);
+    return buf;
+}
+
+void destructTraceBuffer(ocrPolicyDomain_t *pd, ocrTraceBuffer_t *buf){
+    pd->fcts.pdFree(pd, buf->alloc);
+    pd->fcts.pdFree(pd, buf);
+}
+
+/**
+ * @brief Hand the tail page over to the system worker and start the next one.
+ * Returns false if the ring is full and records are dropped rather than waited on.
+ */
+static bool traceBufferAdvance(ocrTraceBuffer_t *buf){
+    while((buf->tail - buf->head) >= (TRACE_BUFFER_PAGES - 1)){
+#ifdef OCR_TRACE_BUFFER_BLOCK
+        hal_pause();
+#else
         return false;
+#endif
+    }
+    ocrTracePageHeader_t *header = (ocrTracePageHeader_t *)TRACE_BUFFER_PAGE(buf, buf->tail);
+    u64 location = header->location;
+    u64 workerId = header->workerId;
+    hal_fence(); // Page content must be visible before it is published
+    buf->tail++;
+    traceBufferInitPage(buf, location, workerId);
+    return true;
+}
+
+//Pack the fields the trace object's action uses at the end of the worker's page.
+void traceBufferPush(ocrTraceBuffer_t *buf, ocrTraceObj_t *tr){
+    if(buf == NULL) return;
+    u8 record[TRACE_RECORD_MAX_SIZE];
+    ocrTraceField_t fields[TRACE_MAX_FIELDS];
+    u32 fieldCount = traceObjectFields(tr, fields);
+    ASSERT(fieldCount <= TRACE_MAX_FIELDS);
+
+    // A page's base time is the time of the record preceding it
+    u32 size = TRACE_RECORD_HEADER_SIZE;
+    size += traceVarintEncode(&record[size], (s64)(tr->time - buf->lastTime));
+    hal_memCopy(&record[size], &(tr->parent), sizeof(ocrGuid_t), false);
+    size += sizeof(ocrGuid_t);
+    u32 i;
+    for(i = 0; i < fieldCount; i++){
+        u32 fieldSize = traceFieldSize(&fields[i]);
+        ASSERT((size + fieldSize) <= TRACE_RECORD_MAX_SIZE);
+        hal_memCopy(&record[size], fields[i].addr, fieldSize, false);
+        size += fieldSize;
     }
+
+    ocrTracePageHeader_t *header = (ocrTracePageHeader_t *)TRACE_BUFFER_PAGE(buf, buf->tail);
+    if((sizeof(ocrTracePageHeader_t) + header->used + size) > TRACE_PAGE_SIZE){
+        if(!traceBufferAdvance(buf)){
+            buf->pendingDropped++;
+            buf->dropped++;
+            return;
+        }
+        header = (ocrTracePageHeader_t *)TRACE_BUFFER_PAGE(buf, buf->tail);
+    }
+    record[0] = (u8)(size & 0xff);
+    record[1] = (u8)(size >> 8);
+    record[2] = (u8)(tr->typeSwitch - OCR_TRACE_TYPE_EDT);
+    record[3] = (u8)(tr->actionSwitch);
+    record[4] = (u8)(tr->eventType);
+    hal_memCopy(((u8 *)header) + sizeof(ocrTracePageHeader_t) + header->used, record, size, false);
+    header->used += size;
+    header->count++;
+    buf->lastTime = tr->time;
 }
 
 bool isSystem(ocrPolicyDomain_t *pd){
@@ -39,7 +130,7 @@ bool isSupportedTraceType(bool evtType, ocrTraceType_t ttype, ocrTraceAction_t a
             (evtType == true || evtType == false));
 }
 
-//Create a trace object subject to trace type, and push to HC worker's deque, to be processed by system worker.
+//Create a trace object subject to trace type, and pack it in the HC worker's trace buffer, to be written out by system worker.
 
 void populateTraceObject(u64 location, bool evtType, ocrTraceType_t objType, ocrTraceAction_t actionType,
                                 u64 workerId, u64 timestamp, ocrGuid_t parent, va_list ap){
@@ -73,7 +164,7 @@ void populateTraceObject(u64 location, bool evtType, ocrTraceType_t objType, ocr
                 TRACE_FIELD(TASK, taskCreate, tr, depc) = depc;
                 TRACE_FIELD(TASK, taskCreate, tr, paramc) = paramc;
                 memcpy(TRACE_FIELD(TASK, taskCreate, tr, paramv), paramvOut, sizeof(paramvOut));
-                PUSH_TO_TRACE_DEQUE();
+                PUSH_TO_TRACE_BUFFER();
 #endif
                 break;
             }
@@ -84,7 +175,7 @@ void populateTraceObject(u64 location, bool evtType, ocrTraceType_t objType, ocr
                 ocrEdt_t funcPtr = va_arg(ap, ocrEdt_t);
                 TRACE_FIELD(TASK, taskTemplateCreate, tr, templateGuid) = guid;
                 TRACE_FIELD(TASK, taskTemplateCreate, tr, funcPtr) = funcPtr;
-                PUSH_TO_TRACE_DEQUE();
+                PUSH_TO_TRACE_BUFFER();
                 break;
             }
 
@@ -115,7 +206,7 @@ void populateTraceObject(u64 location, bool evtType, ocrTraceType_t objType, ocr
 
                 TRACE_FIELD(TASK, taskScheduled, tr, taskGuid) = curTask;
                 TRACE_FIELD(TASK, taskScheduled, tr, deq) = deq;
-                PUSH_TO_TRACE_DEQUE();
+                PUSH_TO_TRACE_BUFFER();
                 break;
             }
             case OCR_ACTION_SATISFY:
@@ -164,13 +255,13 @@ void populateTraceObject(u64 location, bool evtType, ocrTraceType_t objType, ocr
                 TRACE_FIELD(TASK, taskExeBegin, tr, depc) = depc;
                 TRACE_FIELD(TASK, taskExeBegin, tr, paramc) = paramc;
                 memcpy(TRACE_FIELD(TASK, taskExeBegin, tr, paramv), paramvOut, sizeof(paramvOut));
-                PUSH_TO_TRACE_DEQUE();
+                PUSH_TO_TRACE_BUFFER();
 #endif
                 break;
             }
             case OCR_ACTION_FINISH:
             {
-#if !defined(OCR_ENABLE_SIMULATOR)
+#if !defined(OCR_ENABLE_SIMULATOR) && !defined(ENABLE_EXTENSION_PERF)
                 //Get var args
                 void (*traceFunc)() = va_arg(ap, void *);
                 ocrGuid_t taskGuid = va_arg(ap, ocrGuid_t);
@@ -186,17 +277,22 @@ void populateTraceObject(u64 location, bool evtType, ocrTraceType_t objType, ocr
                 ocrPerfStat_t *stats = va_arg(ap, ocrPerfStat_t *);
                 TRACE_FIELD(TASK, taskExeEnd, tr, taskGuid) = taskGuid;
                 TRACE_FIELD(TASK, taskExeEnd, tr, count) = count;
+                //Counters are only available for EDTs that were measured
+                static ocrPerfStat_t noStats[PERF_MAX];
+                if(stats == NULL) stats = noStats;
                 TRACE_FIELD(TASK, taskExeEnd, tr, hwCycles) = stats[PERF_HW_CYCLES].current;
                 TRACE_FIELD(TASK, taskExeEnd, tr, hwCacheRefs) = stats[PERF_L1_HITS].current;
                 TRACE_FIELD(TASK, taskExeEnd, tr, hwCacheMisses) = stats[PERF_L1_MISSES].current;
                 TRACE_FIELD(TASK, taskExeEnd, tr, hwFpOps) = stats[PERF_FLOAT_OPS].current;
+                TRACE_FIELD(TASK, taskExeEnd, tr, hwInstructions) = stats[PERF_INSTRUCTIONS].current;
+                TRACE_FIELD(TASK, taskExeEnd, tr, hwStalledCycles) = stats[PERF_STALLED_CYCLES].current;
                 TRACE_FIELD(TASK, taskExeEnd, tr, swEdtCreates) = stats[PERF_EDT_CREATES].current;
                 TRACE_FIELD(TASK, taskExeEnd, tr, swDbTotal) = stats[PERF_DB_TOTAL].current;
                 TRACE_FIELD(TASK, taskExeEnd, tr, swDbCreates) = stats[PERF_DB_CREATES].current;
                 TRACE_FIELD(TASK, taskExeEnd, tr, swDbDestroys) = stats[PERF_DB_DESTROYS].current;
                 TRACE_FIELD(TASK, taskExeEnd, tr, swEvtSats) = stats[PERF_EVT_SATISFIES].current;
                 TRACE_FIELD(TASK, taskExeEnd, tr, edt) = edt;
-                PUSH_TO_TRACE_DEQUE();
+                PUSH_TO_TRACE_BUFFER();
 #endif
                 break;
             }
@@ -302,7 +398,7 @@ void populateTraceObject(u64 location, bool evtType, ocrTraceType_t objType, ocr
                 TRACE_FIELD(MESSAGE, msgEndToEnd, tr, rcvTime) = rcvTime;
                 TRACE_FIELD(MESSAGE, msgEndToEnd, tr, unMarshTime) = unMarshTime;
                 TRACE_FIELD(MESSAGE, msgEndToEnd, tr, type) = type;
-                PUSH_TO_TRACE_DEQUE();
+                PUSH_TO_TRACE_BUFFER();
                 break;
             }
 
@@ -350,7 +446,7 @@ void populateTraceObject(u64 location, bool evtType, ocrTraceType_t objType, ocr
                 //Handle trace object manually.  No callback for this trace event.
                 INIT_TRACE_OBJECT();
                 TRACE_FIELD(EXECUTION_UNIT, exeWorkRequest, tr, placeHolder) = NULL;
-                PUSH_TO_TRACE_DEQUE();
+                PUSH_TO_TRACE_BUFFER();
                 break;
             }
             case OCR_ACTION_WORK_TAKEN:
@@ -362,7 +458,7 @@ void populateTraceObject(u64 location, bool evtType, ocrTraceType_t objType, ocr
 
                 TRACE_FIELD(EXECUTION_UNIT, exeWorkTaken, tr, foundGuid) = curTask;
                 TRACE_FIELD(EXECUTION_UNIT, exeWorkTaken, tr, deq) = deq;
-                PUSH_TO_TRACE_DEQUE();
+                PUSH_TO_TRACE_BUFFER();
                 break;
             }
 
@@ -383,7 +479,7 @@ void populateTraceObject(u64 location, bool evtType, ocrTraceType_t objType, ocr
                 INIT_TRACE_OBJECT();
                 ocrGuid_t curTask = va_arg(ap, ocrGuid_t);
                 TRACE_FIELD(SCHEDULER, schedMsgSend, tr, taskGuid) = curTask;
-                PUSH_TO_TRACE_DEQUE();
+                PUSH_TO_TRACE_BUFFER();
                 break;
             }
 
@@ -393,7 +489,7 @@ void populateTraceObject(u64 location, bool evtType, ocrTraceType_t objType, ocr
                 INIT_TRACE_OBJECT();
                 ocrGuid_t curTask = va_arg(ap, ocrGuid_t);
                 TRACE_FIELD(SCHEDULER, schedMsgRcv, tr, taskGuid) = curTask;
-                PUSH_TO_TRACE_DEQUE();
+                PUSH_TO_TRACE_BUFFER();
                 break;
             }
 
@@ -403,7 +499,7 @@ void populateTraceObject(u64 location, bool evtType, ocrTraceType_t objType, ocr
                 INIT_TRACE_OBJECT();
                 ocrGuid_t curTask = va_arg(ap, ocrGuid_t);
                 TRACE_FIELD(SCHEDULER, schedInvoke, tr, taskGuid) = curTask;
-                PUSH_TO_TRACE_DEQUE();
+                PUSH_TO_TRACE_BUFFER();
                 break;
             }
 
@@ -434,7 +530,7 @@ void populateTraceObject(u64 location, bool evtType, ocrTraceType_t objType, ocr
                 TRACE_FIELD(API_EDT, simEdtCreate, tr, paramc) = paramc;
                 memcpy(TRACE_FIELD(API_EDT, simEdtCreate, tr, paramv), paramvOut, sizeof(paramvOut));
                 TRACE_FIELD(API_EDT, simEdtCreate, tr, depc) = depc;
-                PUSH_TO_TRACE_DEQUE();
+                PUSH_TO_TRACE_BUFFER();
                 break;
             }
             case OCR_ACTION_TEMPLATE_CREATE:
@@ -446,7 +542,7 @@ void populateTraceObject(u64 location, bool evtType, ocrTraceType_t objType, ocr
                 TRACE_FIELD(API_EDT, simEdtTemplateCreate, tr, funcPtr) = funcPtr;
                 TRACE_FIELD(API_EDT, simEdtTemplateCreate, tr, paramc) = paramc;
                 TRACE_FIELD(API_EDT, simEdtTemplateCreate, tr, depc) = depc;
-                PUSH_TO_TRACE_DEQUE();
+                PUSH_TO_TRACE_BUFFER();
                 break;
             }
             default:
@@ -463,7 +559,7 @@ void populateTraceObject(u64 location, bool evtType, ocrTraceType_t objType, ocr
                 INIT_TRACE_OBJECT();
                 ocrEventTypes_t eventType = va_arg(ap, ocrEventTypes_t);
                 TRACE_FIELD(API_EVENT, simEventCreate, tr, eventType) = eventType;
-                PUSH_TO_TRACE_DEQUE();
+                PUSH_TO_TRACE_BUFFER();
                 break;
             }
             case OCR_ACTION_SATISFY:
@@ -473,7 +569,7 @@ void populateTraceObject(u64 location, bool evtType, ocrTraceType_t objType, ocr
                 ocrGuid_t dataGuid = va_arg(ap, ocrGuid_t);
                 TRACE_FIELD(API_EVENT, simEventSatisfy, tr, eventGuid) = eventGuid;
                 TRACE_FIELD(API_EVENT, simEventSatisfy, tr, dataGuid) = dataGuid;
-                PUSH_TO_TRACE_DEQUE();
+                PUSH_TO_TRACE_BUFFER();
                 break;
             }
             case OCR_ACTION_ADD_DEP:
@@ -487,7 +583,7 @@ void populateTraceObject(u64 location, bool evtType, ocrTraceType_t objType, ocr
                 TRACE_FIELD(API_EVENT, simEventAddDep, tr, destination) = dest;
                 TRACE_FIELD(API_EVENT, simEventAddDep, tr, slot) = slot;
                 TRACE_FIELD(API_EVENT, simEventAddDep, tr, accessMode) = accessMode;
-                PUSH_TO_TRACE_DEQUE();
+                PUSH_TO_TRACE_BUFFER();
                 break;
             }
             case OCR_ACTION_DESTROY:
@@ -495,7 +591,7 @@ void populateTraceObject(u64 location, bool evtType, ocrTraceType_t objType, ocr
                 INIT_TRACE_OBJECT();
                 ocrGuid_t eventGuid = va_arg(ap, ocrGuid_t);
                 TRACE_FIELD(API_EVENT, simEventDestroy, tr, eventGuid) = eventGuid;
-                PUSH_TO_TRACE_DEQUE();
+                PUSH_TO_TRACE_BUFFER();
                 break;
             }
             default:
@@ -511,7 +607,7 @@ void populateTraceObject(u64 location, bool evtType, ocrTraceType_t objType, ocr
                 INIT_TRACE_OBJECT();
                 u64 len = va_arg(ap, u64);
                 TRACE_FIELD(API_DATABLOCK, simDbCreate, tr, len) = len;
-                PUSH_TO_TRACE_DEQUE();
+                PUSH_TO_TRACE_BUFFER();
                 break;
             }
             case OCR_ACTION_DATA_RELEASE:
@@ -519,7 +615,7 @@ void populateTraceObject(u64 location, bool evtType, ocrTraceType_t objType, ocr
                 INIT_TRACE_OBJECT();
                 ocrGuid_t guid = va_arg(ap, ocrGuid_t);
                 TRACE_FIELD(API_DATABLOCK, simDbRelease, tr, guid) = guid;
-                PUSH_TO_TRACE_DEQUE();
+                PUSH_TO_TRACE_BUFFER();
                 break;
             }
             case OCR_ACTION_DESTROY:
@@ -527,7 +623,7 @@ void populateTraceObject(u64 location, bool evtType, ocrTraceType_t objType, ocr
                 INIT_TRACE_OBJECT();
                 ocrGuid_t guid = va_arg(ap, ocrGuid_t);
                 TRACE_FIELD(API_DATABLOCK, simDbDestroy, tr, guid) = guid;
-                PUSH_TO_TRACE_DEQUE();
+                PUSH_TO_TRACE_BUFFER();
                 break;
             }
 
@@ -542,25 +638,25 @@ void populateTraceObject(u64 location, bool evtType, ocrTraceType_t objType, ocr
             case OCR_ACTION_GET_CURRENT:
             {
                 INIT_TRACE_OBJECT();
-                PUSH_TO_TRACE_DEQUE();
+                PUSH_TO_TRACE_BUFFER();
                 break;
             }
             case OCR_ACTION_GET_AT:
             {
                 INIT_TRACE_OBJECT();
-                PUSH_TO_TRACE_DEQUE();
+                PUSH_TO_TRACE_BUFFER();
                 break;
             }
             case OCR_ACTION_GET_COUNT:
             {
                 INIT_TRACE_OBJECT();
-                PUSH_TO_TRACE_DEQUE();
+                PUSH_TO_TRACE_BUFFER();
                 break;
             }
             case OCR_ACTION_QUERY:
             {
                 INIT_TRACE_OBJECT();
-                PUSH_TO_TRACE_DEQUE();
+                PUSH_TO_TRACE_BUFFER();
                 break;
             }
             default:
@@ -574,13 +670,13 @@ void populateTraceObject(u64 location, bool evtType, ocrTraceType_t objType, ocr
             case OCR_ACTION_INIT:
             {
                 INIT_TRACE_OBJECT();
-                PUSH_TO_TRACE_DEQUE();
+                PUSH_TO_TRACE_BUFFER();
                 break;
             }
             case OCR_ACTION_SET_VAL:
             {
                 INIT_TRACE_OBJECT();
-                PUSH_TO_TRACE_DEQUE();
+                PUSH_TO_TRACE_BUFFER();
                 break;
             }
 
@@ -24,7 +24,6 @@
 #define MAX_DEPS 32
 #endif
 
-bool isDequeFull(deque_t *deq);
 bool isSystem(ocrPolicyDomain_t *pd);
 bool isSupportedTraceType(bool evtType, ocrTraceType_t ttype, ocrTraceAction_t atype);
 void populateTraceObject(u64 location, bool evtType, ocrTraceType_t objType, ocrTraceAction_t actionType,
@@ -32,13 +31,15 @@ void populateTraceObject(u64 location, bool evtType, ocrTraceType_t objType, ocr
 
 
 
-/* Macros to condense and simplify the packing of trace objects */
+/* Macros to condense and simplify the packing of trace objects.
+ * The trace object only lives on the stack: PUSH_TO_TRACE_BUFFER packs
+ * the fields its action uses into the worker's trace buffer. */
 #define INIT_TRACE_OBJECT()                                                 \
                                                                             \
-    ocrPolicyDomain_t *pd = NULL;                                           \
     ocrWorker_t *worker = NULL;                                             \
-    getCurrentEnv(&pd, &worker, NULL, NULL);                                \
-    ocrTraceObj_t *tr = pd->fcts.pdMalloc(pd, sizeof(ocrTraceObj_t));       \
+    getCurrentEnv(NULL, &worker, NULL, NULL);                               \
+    ocrTraceObj_t traceObj;                                                 \
+    ocrTraceObj_t *tr = &traceObj;                                          \
                                                                             \
     tr->typeSwitch = objType;                                               \
     tr->actionSwitch = actionType;                                          \
@@ -48,15 +49,14 @@ void populateTraceObject(u64 location, bool evtType, ocrTraceType_t objType, ocr
     tr->parent = parent;                                                    \
     tr->eventType = evtType;
 
-#define PUSH_TO_TRACE_DEQUE()                                                                           \
+#define PUSH_TO_TRACE_BUFFER()                                                                          \
     if(worker != NULL){                                                                                 \
-        while(isDequeFull(((ocrWorkerHc_t*)worker)->sysDeque)){                                         \
-            hal_pause();                                                                                \
-        }                                                                                               \
-                                                                                                        \
-        ((ocrWorkerHc_t *)worker)->sysDeque->pushAtTail(((ocrWorkerHc_t *)worker)->sysDeque, tr, 0);    \
+        traceBufferPush(((ocrWorkerHc_t *)worker)->traceBuffer, tr);                                    \
     }
 
+/* Kept for user-provided trace callbacks */
+#define PUSH_TO_TRACE_DEQUE() PUSH_TO_TRACE_BUFFER()
+
 //TODO: Add comment descriptions for new trace fields
 
 /*
@@ -127,6 +127,8 @@ typedef struct {
                     u64 hwCacheRefs;                /* Perf counter: L1 hits */
                     u64 hwCacheMisses;              /* Perf counter: L1 misses */
                     u64 hwFpOps;                    /* Perf counter: Floating pointer operations */
+                    u64 hwInstructions;             /* Perf counter: Instructions retired */
+                    u64 hwStalledCycles;            /* Perf counter: Cycles stalled on memory */
                     u64 swEdtCreates;               /* Soft counter: Number of ocrEdtCreate calls */
                     u64 swDbTotal;                  /* Soft counter: Total memory footprint of datablocks */
                     u64 swDbCreates;                /* Soft counter: Number of ocrDbCreate calls */
@@ -411,6 +413,341 @@ typedef struct {
     }type;
 }ocrTraceObj_t;
 
+/******************************************************/
+/* BINARY TRACE FORMAT                                */
+/******************************************************/
+
+/*
+ * Each worker packs its trace records in a ring of fixed-size pages that the
+ * system worker writes out whole. A trace file is a sequence of pages:
+ *
+ *   [ocrTracePageHeader_t][record]...[record][padding up to pageSize]
+ *
+ * A record is a 5 byte header (u16 size, u8 type, u8 action, u8 eventType),
+ * the zigzag varint delta of its timestamp with the previous record of the
+ * page (the first one is relative to baseTime), the parent GUID and the
+ * fields described by traceObjectFields() for its type and action, packed
+ * without padding. Location and worker are those of the page.
+ */
+
+#ifndef TRACE_PAGE_SIZE
+#define TRACE_PAGE_SIZE         (32*1024)   /* Bytes per page (multiple of TRACE_PAGE_ALIGN) */
+#endif
+
+#ifndef TRACE_BUFFER_PAGES
+#define TRACE_BUFFER_PAGES      16          /* Pages in a worker's ring */
+#endif
+
+#define TRACE_PAGE_ALIGN        4096        /* Alignment of pages in memory and in the file (O_DIRECT) */
+#define TRACE_PAGE_MAGIC        0x3150474543415254ULL
+#define TRACE_RECORD_HEADER_SIZE 5
+#define TRACE_RECORD_MAX_SIZE   512
+#define TRACE_MAX_FIELDS        16
+
+typedef struct {
+    u64 magic;          /* TRACE_PAGE_MAGIC */
+    u64 location;       /* PD of the worker */
+    u64 workerId;       /* Worker the records were traced on */
+    u64 baseTime;       /* Timestamp the first record's delta is relative to */
+    u32 pageSize;       /* Bytes of the page in the file, header included */
+    u32 used;           /* Bytes of records following the header */
+    u32 count;          /* Number of records in the page */
+    u32 dropped;        /* Records dropped since the previous page because the ring was full */
+} ocrTracePageHeader_t;
+
+/* Describes a field of a trace object to pack */
+typedef struct {
+    void *addr;         /* Field in the trace object */
+    u32 size;           /* Size of the field, or of one element for arrays */
+    u32 max;            /* Capacity of an array field */
+    void *count;        /* For arrays, field holding the element count (packed before) */
+    u32 countSize;
+} ocrTraceField_t;
+
+#define _TRACE_DESC(fields, n, f)                                           \
+    do { fields[n].addr = &(f); fields[n].size = sizeof(f);                 \
+         fields[n].count = NULL; n++; } while(0)
+
+#define _TRACE_DESC_ARRAY(fields, n, a, c)                                  \
+    do { fields[n].addr = (a); fields[n].size = sizeof((a)[0]);             \
+         fields[n].max = sizeof(a)/sizeof((a)[0]);                          \
+         fields[n].count = &(c); fields[n].countSize = sizeof(c); n++; } while(0)
+
+#define TRACE_DESC(fields, n, type, action, traceObj, field)                \
+    _TRACE_DESC(fields, n, TRACE_FIELD(type, action, traceObj, field))
+
+#define TRACE_DESC_ARRAY(fields, n, type, action, traceObj, field, countField)  \
+    _TRACE_DESC_ARRAY(fields, n, TRACE_FIELD(type, action, traceObj, field),    \
+                      TRACE_FIELD(type, action, traceObj, countField))
+
+/**
+ * @brief Bytes a field occupies in a record
+ * Array sizes depend on their count field, which must be set (or unpacked) first.
+ */
+static inline u32 traceFieldSize(ocrTraceField_t *field){
+    if(field->count == NULL) return field->size;
+    u64 count = (field->countSize == sizeof(u32)) ? *((u32*)field->count) : *((u64*)field->count);
+    return ((count < field->max) ? count : field->max) * field->size;
+}
+
+/**
+ * @brief Lists the fields of the trace object its type and action use, in packing order
+ * @return the number of fields
+ */
+static inline u32 traceObjectFields(ocrTraceObj_t *tr, ocrTraceField_t *fields){
+    u32 n = 0;
+    switch(tr->typeSwitch){
+    case OCR_TRACE_TYPE_EDT:
+        switch(tr->actionSwitch){
+        case OCR_ACTION_CREATE:
+            TRACE_DESC(fields, n, TASK, taskCreate, tr, taskGuid);
+#ifdef OCR_ENABLE_SIMULATOR
+            TRACE_DESC(fields, n, TASK, taskCreate, tr, depc);
+            TRACE_DESC(fields, n, TASK, taskCreate, tr, paramc);
+            TRACE_DESC_ARRAY(fields, n, TASK, taskCreate, tr, paramv, paramc);
+#endif
+            break;
+        case OCR_ACTION_TEMPLATE_CREATE:
+            TRACE_DESC(fields, n, TASK, taskTemplateCreate, tr, templateGuid);
+            TRACE_DESC(fields, n, TASK, taskTemplateCreate, tr, funcPtr);
+            break;
+        case OCR_ACTION_DESTROY:
+            TRACE_DESC(fields, n, TASK, taskDestroy, tr, taskGuid);
+            break;
+        case OCR_ACTION_RUNNABLE:
+            TRACE_DESC(fields, n, TASK, taskReadyToRun, tr, taskGuid);
+            break;
+        case OCR_ACTION_SCHEDULED:
+            TRACE_DESC(fields, n, TASK, taskScheduled, tr, taskGuid);
+            TRACE_DESC(fields, n, TASK, taskScheduled, tr, deq);
+            break;
+        case OCR_ACTION_SATISFY:
+            TRACE_DESC(fields, n, TASK, taskDepSatisfy, tr, taskGuid);
+            TRACE_DESC(fields, n, TASK, taskDepSatisfy, tr, satisfyee);
+            break;
+        case OCR_ACTION_ADD_DEP:
+            TRACE_DESC(fields, n, TASK, taskDepReady, tr, src);
+            TRACE_DESC(fields, n, TASK, taskDepReady, tr, dest);
+            break;
+        case OCR_ACTION_EXECUTE:
+            TRACE_DESC(fields, n, TASK, taskExeBegin, tr, taskGuid);
+            TRACE_DESC(fields, n, TASK, taskExeBegin, tr, funcPtr);
+#ifdef OCR_ENABLE_SIMULATOR
+            TRACE_DESC(fields, n, TASK, taskExeBegin, tr, depc);
+            TRACE_DESC(fields, n, TASK, taskExeBegin, tr, paramc);
+            TRACE_DESC_ARRAY(fields, n, TASK, taskExeBegin, tr, paramv, paramc);
+#endif
+            break;
+        case OCR_ACTION_FINISH:
+            TRACE_DESC(fields, n, TASK, taskExeEnd, tr, taskGuid);
+#if defined(OCR_ENABLE_SIMULATOR) || defined(ENABLE_EXTENSION_PERF)
+            TRACE_DESC(fields, n, TASK, taskExeEnd, tr, edt);
+            TRACE_DESC(fields, n, TASK, taskExeEnd, tr, count);
+            TRACE_DESC(fields, n, TASK, taskExeEnd, tr, hwCycles);
+            TRACE_DESC(fields, n, TASK, taskExeEnd, tr, hwCacheRefs);
+            TRACE_DESC(fields, n, TASK, taskExeEnd, tr, hwCacheMisses);
+            TRACE_DESC(fields, n, TASK, taskExeEnd, tr, hwFpOps);
+            TRACE_DESC(fields, n, TASK, taskExeEnd, tr, hwInstructions);
+            TRACE_DESC(fields, n, TASK, taskExeEnd, tr, hwStalledCycles);
+            TRACE_DESC(fields, n, TASK, taskExeEnd, tr, swEdtCreates);
+            TRACE_DESC(fields, n, TASK, taskExeEnd, tr, swDbTotal);
+            TRACE_DESC(fields, n, TASK, taskExeEnd, tr, swDbCreates);
+            TRACE_DESC(fields, n, TASK, taskExeEnd, tr, swDbDestroys);
+            TRACE_DESC(fields, n, TASK, taskExeEnd, tr, swEvtSats);
+#endif
+            break;
+        case OCR_ACTION_DATA_ACQUIRE:
+            TRACE_DESC(fields, n, TASK, taskDataAcquire, tr, taskGuid);
+            TRACE_DESC(fields, n, TASK, taskDataAcquire, tr, dbGuid);
+            TRACE_DESC(fields, n, TASK, taskDataAcquire, tr, dbSize);
+            break;
+        case OCR_ACTION_DATA_RELEASE:
+            TRACE_DESC(fields, n, TASK, taskDataRelease, tr, taskGuid);
+            TRACE_DESC(fields, n, TASK, taskDataRelease, tr, dbGuid);
+            TRACE_DESC(fields, n, TASK, taskDataRelease, tr, dbSize);
+            break;
+        default:
+            break;
+        }
+        break;
+    case OCR_TRACE_TYPE_EVENT:
+        switch(tr->actionSwitch){
+        case OCR_ACTION_CREATE:
+            TRACE_DESC(fields, n, EVENT, eventCreate, tr, eventGuid);
+            break;
+        case OCR_ACTION_DESTROY:
+            TRACE_DESC(fields, n, EVENT, eventDestroy, tr, eventGuid);
+            break;
+        case OCR_ACTION_ADD_DEP:
+            TRACE_DESC(fields, n, EVENT, eventDepAdd, tr, src);
+            TRACE_DESC(fields, n, EVENT, eventDepAdd, tr, dest);
+            break;
+        case OCR_ACTION_SATISFY:
+            TRACE_DESC(fields, n, EVENT, eventDepSatisfy, tr, eventGuid);
+            TRACE_DESC(fields, n, EVENT, eventDepSatisfy, tr, satisfyee);
+            break;
+        default:
+            break;
+        }
+        break;
+    case OCR_TRACE_TYPE_MESSAGE:
+        if(tr->actionSwitch == OCR_ACTION_END_TO_END){
+            TRACE_DESC(fields, n, MESSAGE, msgEndToEnd, tr, src);
+            TRACE_DESC(fields, n, MESSAGE, msgEndToEnd, tr, dst);
+            TRACE_DESC(fields, n, MESSAGE, msgEndToEnd, tr, usefulSize);
+            TRACE_DESC(fields, n, MESSAGE, msgEndToEnd, tr, marshTime);
+            TRACE_DESC(fields, n, MESSAGE, msgEndToEnd, tr, sendTime);
+            TRACE_DESC(fields, n, MESSAGE, msgEndToEnd, tr, rcvTime);
+            TRACE_DESC(fields, n, MESSAGE, msgEndToEnd, tr, unMarshTime);
+            TRACE_DESC(fields, n, MESSAGE, msgEndToEnd, tr, type);
+        }
+        break;
+    case OCR_TRACE_TYPE_DATABLOCK:
+        switch(tr->actionSwitch){
+        case OCR_ACTION_CREATE:
+            TRACE_DESC(fields, n, DATA, dataCreate, tr, dbGuid);
+            TRACE_DESC(fields, n, DATA, dataCreate, tr, dbSize);
+            break;
+        case OCR_ACTION_DESTROY:
+            TRACE_DESC(fields, n, DATA, dataDestroy, tr, dbGuid);
+            break;
+        default:
+            break;
+        }
+        break;
+    case OCR_TRACE_TYPE_WORKER:
+        if(tr->actionSwitch == OCR_ACTION_WORK_TAKEN){
+            TRACE_DESC(fields, n, EXECUTION_UNIT, exeWorkTaken, tr, foundGuid);
+            TRACE_DESC(fields, n, EXECUTION_UNIT, exeWorkTaken, tr, deq);
+        }
+        break;
+    case OCR_TRACE_TYPE_SCHEDULER:
+        switch(tr->actionSwitch){
+        case OCR_ACTION_SCHED_MSG_SEND:
+            TRACE_DESC(fields, n, SCHEDULER, schedMsgSend, tr, taskGuid);
+            break;
+        case OCR_ACTION_SCHED_MSG_RCV:
+            TRACE_DESC(fields, n, SCHEDULER, schedMsgRcv, tr, taskGuid);
+            break;
+        case OCR_ACTION_SCHED_INVOKE:
+            TRACE_DESC(fields, n, SCHEDULER, schedInvoke, tr, taskGuid);
+            break;
+        default:
+            break;
+        }
+        break;
+#ifdef OCR_ENABLE_SIMULATOR
+    case OCR_TRACE_TYPE_API_EDT:
+        switch(tr->actionSwitch){
+        case OCR_ACTION_CREATE:
+            TRACE_DESC(fields, n, API_EDT, simEdtCreate, tr, templateGuid);
+            TRACE_DESC(fields, n, API_EDT, simEdtCreate, tr, paramc);
+            TRACE_DESC_ARRAY(fields, n, API_EDT, simEdtCreate, tr, paramv, paramc);
+            TRACE_DESC(fields, n, API_EDT, simEdtCreate, tr, depc);
+            break;
+        case OCR_ACTION_TEMPLATE_CREATE:
+            TRACE_DESC(fields, n, API_EDT, simEdtTemplateCreate, tr, funcPtr);
+            TRACE_DESC(fields, n, API_EDT, simEdtTemplateCreate, tr, paramc);
+            TRACE_DESC(fields, n, API_EDT, simEdtTemplateCreate, tr, depc);
+            break;
+        default:
+            break;
+        }
+        break;
+    case OCR_TRACE_TYPE_API_EVENT:
+        switch(tr->actionSwitch){
+        case OCR_ACTION_CREATE:
+            TRACE_DESC(fields, n, API_EVENT, simEventCreate, tr, eventType);
+            break;
+        case OCR_ACTION_SATISFY:
+            TRACE_DESC(fields, n, API_EVENT, simEventSatisfy, tr, eventGuid);
+            TRACE_DESC(fields, n, API_EVENT, simEventSatisfy, tr, dataGuid);
+            break;
+        case OCR_ACTION_ADD_DEP:
+            TRACE_DESC(fields, n, API_EVENT, simEventAddDep, tr, source);
+            TRACE_DESC(fields, n, API_EVENT, simEventAddDep, tr, destination);
+            TRACE_DESC(fields, n, API_EVENT, simEventAddDep, tr, slot);
+            TRACE_DESC(fields, n, API_EVENT, simEventAddDep, tr, accessMode);
+            break;
+        case OCR_ACTION_DESTROY:
+            TRACE_DESC(fields, n, API_EVENT, simEventDestroy, tr, eventGuid);
+            break;
+        default:
+            break;
+        }
+        break;
+    case OCR_TRACE_TYPE_API_DATABLOCK:
+        switch(tr->actionSwitch){
+        case OCR_ACTION_CREATE:
+            TRACE_DESC(fields, n, API_DATABLOCK, simDbCreate, tr, len);
+            break;
+        case OCR_ACTION_DATA_RELEASE:
+            TRACE_DESC(fields, n, API_DATABLOCK, simDbRelease, tr, guid);
+            break;
+        case OCR_ACTION_DESTROY:
+            TRACE_DESC(fields, n, API_DATABLOCK, simDbDestroy, tr, guid);
+            break;
+        default:
+            break;
+        }
+        break;
+#endif
+    default:
+        break;
+    }
+    return n;
+}
+
+/**
+ * @brief Zigzag varint encoding of timestamp deltas
+ * @return the number of bytes written (at most 10)
+ */
+static inline u32 traceVarintEncode(u8 *buf, s64 value){
+    u64 v = (((u64)value) << 1) ^ ((u64)(value >> 63));
+    u32 n = 0;
+    while(v >= 0x80){
+        buf[n++] = (u8)(v | 0x80);
+        v >>= 7;
+    }
+    buf[n++] = (u8)v;
+    return n;
+}
+
+static inline u32 traceVarintDecode(const u8 *buf, s64 *value){
+    u64 v = 0;
+    u32 n = 0;
+    u32 shift = 0;
+    do {
+        v |= ((u64)(buf[n] & 0x7f)) << shift;
+        shift += 7;
+    } while((buf[n++] & 0x80) && (n < 10));
+    *value = (s64)((v >> 1) ^ (~(v & 1) + 1));
+    return n;
+}
+
+/**
+ * @brief Single producer (a worker), single consumer (the system worker)
+ * ring of trace pages.
+ *
+ * Pages [head, tail) are full and wait to be written out; the worker packs
+ * records in page tail. Indices only grow, the page is index % TRACE_BUFFER_PAGES.
+ */
+typedef struct _ocrTraceBuffer_t {
+    u8 *pages;              /* TRACE_BUFFER_PAGES pages, TRACE_PAGE_ALIGN aligned */
+    void *alloc;            /* Allocation backing pages */
+    volatile u32 head;      /* Next page to write out (system worker) */
+    volatile u32 tail;      /* Page being filled (worker) */
+    u64 lastTime;           /* Timestamp of the last packed record */
+    u32 pendingDropped;     /* Records dropped since the tail page was started */
+    volatile u64 dropped;   /* Total records dropped */
+} ocrTraceBuffer_t;
+
+#define TRACE_BUFFER_PAGE(buf, idx) ((buf)->pages + ((u64)((idx) % TRACE_BUFFER_PAGES)) * TRACE_PAGE_SIZE)
+
+ocrTraceBuffer_t *newTraceBuffer(ocrPolicyDomain_t *pd, u64 workerId);
+void destructTraceBuffer(ocrPolicyDomain_t *pd, ocrTraceBuffer_t *buf);
+void traceBufferPush(ocrTraceBuffer_t *buf, ocrTraceObj_t *tr);
+
 #endif /* ENABLE_WORKER_SYSTEM */
 void doTrace(u64 location, u64 wrkr, ocrGuid_t taskGuid, ...);
 
@@ -432,6 +432,7 @@ void initializeWorkerHcCommMT(ocrWorkerFactory_t * factory, ocrWorker_t *self, o
     // Override base's default value
     ocrWorkerHc_t * workerHc = (ocrWorkerHc_t *) self;
     workerHc->hcType = HC_WORKER_COMM;
+    self->inlineDepthMax = 0; // Only compute workers run successors inline
     // Initialize comm worker's members
     ocrWorkerHcCommMT_t * workerHcComm = (ocrWorkerHcCommMT_t *) self;
     workerHcComm->baseSwitchRunlevel = derivedFactory->baseSwitchRunlevel;
@@ -825,6 +825,7 @@ void initializeWorkerHcComm(ocrWorkerFactory_t * factory, ocrWorker_t *self, ocr
     // Override base's default value
     ocrWorkerHc_t * workerHc = (ocrWorkerHc_t *) self;
     workerHc->hcType = HC_WORKER_COMM;
+    self->inlineDepthMax = 0; // Only compute workers run successors inline
     // Initialize comm worker's members
     ocrWorkerHcComm_t * workerHcComm = (ocrWorkerHcComm_t *) self;
     workerHcComm->baseSwitchRunlevel = derivedFactory->baseSwitchRunlevel;
@@ -37,8 +37,10 @@
 #include "ocr-policy-domain-tasks.h"
 #endif
 
-#ifdef ENABLE_EXTENSION_PERF
 #include "ocr-sal.h"
+
+#ifdef OCR_TRACE_BINARY
+#include "utils/tracer/tracer.h"
 #endif
 
 /******************************************************/
@@ -75,10 +77,24 @@ static void hcWorkShift(ocrWorker_t * worker) {
     RESULT_ASSERT(pdProcessStrands(pd, NP_WORK, 0), ==, 0);
 #endif
     u8 retCode = 0;
-    {
-    START_PROFILE(wo_hc_getWork);
 #define PD_MSG (&msg)
 #define PD_TYPE PD_MSG_SCHED_GET_WORK
+    if (!ocrGuidIsNull(worker->inlineNext.guid)) {
+        // The previous EDT made a single successor ready: run it without asking
+        // the scheduler, as GET_WORK would, until the depth bound is reached
+        PD_MSG_FIELD_IO(schedArgs).OCR_SCHED_ARG_FIELD(OCR_SCHED_WORK_EDT_USER).edt = worker->inlineNext;
+        PD_MSG_FIELD_O(factoryId) = 0; //taskHc_id;
+        worker->inlineNext.guid = NULL_GUID;
+        worker->inlineNext.metaDataPtr = NULL;
+        ++worker->inlineDepth;
+#ifdef OCR_MONITOR_SCHEDULER
+        // Not inserted in any scheduler object
+        OCR_TOOL_TRACE(false, OCR_TRACE_TYPE_EDT, OCR_ACTION_SCHEDULED,
+                       PD_MSG_FIELD_IO(schedArgs).OCR_SCHED_ARG_FIELD(OCR_SCHED_WORK_EDT_USER).edt.guid, NULL);
+#endif
+    } else {
+    START_PROFILE(wo_hc_getWork);
+    worker->inlineDepth = 0;
     msg.type = PD_MSG_SCHED_GET_WORK | PD_MSG_REQUEST | PD_MSG_REQ_RESPONSE;
     PD_MSG_FIELD_IO(schedArgs).kind = OCR_SCHED_WORK_EDT_USER;
     PD_MSG_FIELD_IO(schedArgs).OCR_SCHED_ARG_FIELD(OCR_SCHED_WORK_EDT_USER).edt.guid = NULL_GUID;
@@ -101,6 +117,10 @@ static void hcWorkShift(ocrWorker_t * worker) {
             worker->isIdle = 0;
 #endif
             ocrTask_t * curTask = (ocrTask_t*)taskGuid.metaDataPtr;
+            if (worker->counters.data.idleStart != 0) {
+                RT_WORKER_COUNTER_ADD(worker, RT_COUNTER_IDLE_NS, salGetTime() - worker->counters.data.idleStart);
+                worker->counters.data.idleStart = 0;
+            }
 #ifdef OCR_ASSERT
             if (GET_STATE_PHASE(worker->curState) < (RL_GET_PHASE_COUNT_DOWN(pd, RL_USER_OK)-1)) {
                 if (curTask->funcPtr != processRequestEdt) {
@@ -139,6 +159,7 @@ static void hcWorkShift(ocrWorker_t * worker) {
 #undef PD_MSG
 #undef PD_TYPE
                 RESULT_ASSERT(((ocrTaskFactory_t *)(pd->factories[factoryId]))->fcts.execute(curTask), ==, 0);
+                RT_WORKER_COUNTER_ADD(worker, RT_COUNTER_EDTS_EXECUTED, 1);
                 DPRINTF(DEBUG_LVL_VERB, "Worker done executing EDT GUID "GUIDF"\n", GUIDA(taskGuid.guid));
                 //TODO-DEFERRED: With MT, there can be multiple workers executing curTask.
                 // Not sure we thought about that and implications
@@ -157,8 +178,7 @@ static void hcWorkShift(ocrWorker_t * worker) {
                         u64 perfval = (i<PERF_HW_MAX) ? (hcWorker->perfCtrs[i].perfVal)
                                                       : (curTask->swPerfCtrs[i-PERF_HW_MAX]);
                         u64 oldaverage = ctrs->stats[i].average;
-                        ctrs->stats[i].average = (oldaverage + perfval)>>1;
-                        ctrs->stats[i].current = perfval;
+                        perfStatUpdate(&ctrs->stats[i], perfval, ctrs->count);
                         // Check for steady state
                         if(ctrs->count > STEADY_STATE_COUNT) {
                             s64 diff = ctrs->stats[i].average - oldaverage;
@@ -169,12 +189,7 @@ static void hcWorkShift(ocrWorker_t * worker) {
 #endif
                         }
                     }
-#ifdef OCR_ENABLE_SIMULATOR
-                    //The below trace should only happen in worker if we are doing a simulator trace run. otherwise trace in task
-                    OCR_TOOL_TRACE(true, OCR_TRACE_TYPE_EDT, OCR_ACTION_FINISH, traceTaskFinish, worker->curTask->guid , ctrs->edt, ctrs->count, ctrs->stats);
-#endif
-
-                } else {
+                } else if(ctrs != NULL) {
                     // If hints are specified, simply read them
                     u64 hintValue;
                     ocrHint_t hint = {0};
@@ -195,6 +210,14 @@ static void hcWorkShift(ocrWorker_t * worker) {
                         ctrs->steadyStateMask = 0;
                     }
                 }
+                // The successors this EDT made runnable are all known by now
+                if(ctrs != NULL)
+                    perfBottomLevelUpdate(ctrs, curTask->succBottomLevel);
+                // The finish record carries the counters of this execution, so it is traced
+                // here rather than in the task; EDTs that were not measured report zeros
+                OCR_TOOL_TRACE(true, OCR_TRACE_TYPE_EDT, OCR_ACTION_FINISH, traceTaskFinish, curTask->guid,
+                               (ctrs != NULL) ? ctrs->edt : NULL, (ctrs != NULL) ? ctrs->count : 0,
+                               ((ctrs != NULL) && (curTask->flags & OCR_TASK_FLAG_PERFMON_ME)) ? ctrs->stats : NULL);
 #endif
                 //Store state at worker level to report most recent state on pause.
                 hcWorker->edtGuid = curTask->guid;
@@ -223,6 +246,8 @@ static void hcWorkShift(ocrWorker_t * worker) {
             // Important for this to be the last
             worker->curTask = NULL;
         } else {
+            if (worker->counters.data.idleStart == 0)
+                worker->counters.data.idleStart = salGetTime();
 #ifdef ENABLE_RESILIENCY
             if (worker->isIdle == 0 && worker->edtDepth == 0) {
                 if (pd->schedulers[0]->fcts.count(pd->schedulers[0], SCHEDULER_OBJECT_COUNT_RUNTIME_EDT) == 0) {
@@ -293,6 +318,7 @@ static void hcWorkShiftResilient(ocrWorker_t * worker) {
         }
         worker->curTask = NULL;
         worker->waitloc = UNDEFINED_LOCATION;
+        worker->inlineCapture = false; // The aborted epilogue did not close its window
     }
 
     hal_fence(); //Fence ------------------
@@ -462,7 +488,7 @@ u8 hcWorkerSwitchRunlevel(ocrWorker_t *self, ocrPolicyDomain_t *PD, ocrRunlevel_
                           phase_t phase, u32 properties, void (*callback)(ocrPolicyDomain_t *, u64), u64 val) {
 
     u8 toReturn = 0;
-#ifdef ENABLE_EXTENSION_PERF
+#if defined(ENABLE_EXTENSION_PERF) || defined(OCR_TRACE_BINARY)
     ocrWorkerHc_t *hcWorker = (ocrWorkerHc_t *)self;
 #endif
 
@@ -518,20 +544,27 @@ u8 hcWorkerSwitchRunlevel(ocrWorker_t *self, ocrPolicyDomain_t *PD, ocrRunlevel_
         break;
     case RL_GUID_OK:
         if((properties & RL_BRING_UP) && (RL_IS_FIRST_PHASE_UP(PD, RL_GUID_OK, phase))) {
+#ifdef OCR_TRACE_BINARY
             //Check that OCR has been configured to utilize system worker.
-            //worker[n-1] by convention. If so initialize deques
-            //TODO: this check can be dropped without too much consequence (just some unused memory)
+            //worker[n-1] by convention. If so initialize trace buffers
             if(PD->workers[(PD->workerCount)-1]->type == SYSTEM_WORKERTYPE){
                 if(self->type == MASTER_WORKERTYPE || self->type == SLAVE_WORKERTYPE) {
-                    if(((ocrWorkerHc_t *)self)->sysDeque == NULL){
-                        ((ocrWorkerHc_t*)self)->sysDeque = newDeque(self->pd, NULL, NON_CONCURRENT_DEQUE);
+                    if(((ocrWorkerHc_t *)self)->traceBuffer == NULL){
+                        ((ocrWorkerHc_t*)self)->traceBuffer = newTraceBuffer(PD, self->id);
                     }
                 }
             }
+#endif
 #ifdef ENABLE_EXTENSION_PERF
             hcWorker->perfCtrs = PD->fcts.pdMalloc(PD, PERF_HW_MAX*sizeof(salPerfCounter));
 #endif
         } else if((properties & RL_TEAR_DOWN) && (RL_IS_LAST_PHASE_DOWN(PD, RL_GUID_OK, phase))) {
+#ifdef OCR_TRACE_BINARY
+            if(hcWorker->traceBuffer != NULL){
+                destructTraceBuffer(PD, hcWorker->traceBuffer);
+                hcWorker->traceBuffer = NULL;
+            }
+#endif
 #ifdef ENABLE_EXTENSION_PERF
             PD->fcts.pdFree(PD, hcWorker->perfCtrs);
 #endif
@@ -716,6 +749,7 @@ ocrWorker_t* newWorkerHc(ocrWorkerFactory_t * factory, ocrParamList_t * perInsta
 void initializeWorkerHc(ocrWorkerFactory_t * factory, ocrWorker_t* self, ocrParamList_t * perInstance) {
     initializeWorkerOcr(factory, self, perInstance);
     self->type = ((paramListWorkerHcInst_t*)perInstance)->workerType;
+    self->numaDomain = ((paramListWorkerHcInst_t*)perInstance)->numaDomain;
 #ifdef OCR_ASSERT
     u64 workerId = ((paramListWorkerInst_t*)perInstance)->workerId;
     //TODO: try to get away from SYSTEM_WORKERTYPE and remove this check.
@@ -729,8 +763,10 @@ void initializeWorkerHc(ocrWorkerFactory_t * factory, ocrWorker_t* self, ocrPara
         workerHc->hcType = HC_WORKER_SYSTEM;
     }else{
         workerHc->hcType = HC_WORKER_COMP;
+        self->inlineDepthMax = SCHED_INLINE_SUCCESSOR_DEPTH_MAX;
     }
     workerHc->legacySecondStart = false;
+    workerHc->traceBuffer = NULL;
 #ifdef ENABLE_EXTENSION_BLOCKING_SUPPORT
     workerHc->isHelping = 0;
     workerHc->stealFirst = 0;
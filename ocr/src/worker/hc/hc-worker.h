@@ -22,6 +22,7 @@ typedef struct {
 typedef struct _paramListWorkerHcInst_t {
     paramListWorkerInst_t base;
     ocrWorkerType_t workerType;
+    u32 numaDomain;
 } paramListWorkerHcInst_t;
 
 typedef enum {
@@ -41,7 +42,7 @@ typedef struct {
 #endif
     hcWorkerType_t hcType;
     u8 legacySecondStart;
-    deque_t *sysDeque;
+    struct _ocrTraceBuffer_t *traceBuffer; // Trace records for the system worker
 #ifdef ENABLE_EXTENSION_PERF
     salPerfCounter *perfCtrs;
 #endif
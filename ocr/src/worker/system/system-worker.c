@@ -15,7 +15,6 @@
 #include "ocr-sysboot.h"
 #include "worker/hc/hc-worker.h"
 #include "worker/system/system-worker.h"
-#include "utils/deque.h"
 #include "utils/tracer/tracer.h"
 #include "utils/tracer/trace-events.h"
 
@@ -31,64 +30,81 @@
 
 #define IDX_OFFSET OCR_TRACE_TYPE_EDT
 
-//Utility functions
-bool allDequesEmpty(ocrPolicyDomain_t *pd){
-    u32 i;
-    for(i = 0; i < ((pd->workerCount)-1); i++){
-        s32 head = ((ocrWorkerHc_t *)pd->workers[i])->sysDeque->head;
-        s32 tail = ((ocrWorkerHc_t *)pd->workers[i])->sysDeque->tail;
+#ifdef OCR_TRACE_BINARY
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
 
-        if(tail!=head)
-            return false;
+//Open the PD's trace file (one per policy domain). Pages are written whole and
+//aligned so direct I/O is used when the file system supports it.
+static int openTraceFile(u64 location){
+    char traceName[32];
+    SNPRINTF(traceName, 31, "trace_%lu.bin", location);
+    int fd = open(traceName, O_WRONLY | O_CREAT | O_TRUNC | O_DIRECT, 0644);
+    if((fd < 0) && (errno == EINVAL)){
+        fd = open(traceName, O_WRONLY | O_CREAT | O_TRUNC, 0644);
     }
-    return true;
+    if(fd < 0){
+        PRINTF("[PD:0x%"PRIx64"] Unable to open %s, trace records are discarded\n", location, traceName);
+    }
+    return fd;
 }
 
-//Do custom processing for trace objects if provided by DPRINTF.
-#ifdef OCR_TRACE_BINARY
-void processTraceObject(ocrTraceObj_t *trace, FILE *f){
-
-    fwrite(trace, sizeof(ocrTraceObj_t), 1, f);
-    return;
+static void writeTracePages(int fd, u64 *offset, u8 *pages, u64 size){
+    if(fd < 0) return;
+    u64 done = 0;
+    while(done < size){
+        ssize_t rc = pwrite(fd, pages + done, size - done, (off_t)(*offset + done));
+        if(rc < 0){
+            if(errno == EINTR) continue;
+            PRINTF("Trace write failed (errno=%"PRId32")\n", (s32)errno);
+            break;
+        }
+        done += rc;
+    }
+    *offset += size;
 }
 
-static void drainSysDeques(FILE *f){
-    ocrPolicyDomain_t *pd;
-    getCurrentEnv(&pd, NULL, NULL, NULL);
-    u32 i;
-    //Iterate over each worker's deque
-    for(i = 0; i < ((pd->workerCount)-1); i++){
-        deque_t *deq = ((ocrWorkerHc_t *)pd->workers[i])->sysDeque;
-        s32 head = deq->head;
-        s32 tail = deq->tail;
-        s32 remaining = tail-head;
-        u32 j;
-        for(j = 0; j < remaining; j++){
-            //Pop and process all remaining records
-            ocrTraceObj_t *tr = (ocrTraceObj_t *)(deq->popFromHead(deq,0));
-            ASSERT(tr != NULL);
-
-            processTraceObject(tr, f);
-            pd->fcts.pdFree(pd, tr);
+//Write out the full pages of a worker's trace buffer, as few writes as the ring allows.
+static void flushTraceBuffer(int fd, u64 *offset, ocrTraceBuffer_t *buf){
+    u32 head = buf->head;
+    u32 tail = buf->tail;
+    hal_fence(); // Read the pages after the worker published them
+    while(head != tail){
+        u32 first = head % TRACE_BUFFER_PAGES;
+        u32 count = tail - head;
+        if(count > (TRACE_BUFFER_PAGES - first)){
+            count = TRACE_BUFFER_PAGES - first;
         }
+        writeTracePages(fd, offset, TRACE_BUFFER_PAGE(buf, head), ((u64)count) * TRACE_PAGE_SIZE);
+        head += count;
+        hal_fence(); // Done reading before the worker reuses the pages
+        buf->head = head;
     }
 }
-#endif
 
-void drainCurrentDeque(ocrWorker_t *worker, FILE *f, s32 head, s32 tail, deque_t *deq){
-    s32 remaining = tail-head;
+//Write out everything left, including the page each worker was filling.
+//Workers are no longer tracing.
+static void drainTraceBuffers(ocrPolicyDomain_t *pd, int fd, u64 *offset){
     u32 i;
-    for(i = 0; i < remaining; i++){
-        ocrTraceObj_t *tr = (ocrTraceObj_t *)(deq->popFromHead(deq, 0));
-        ASSERT(tr != NULL);
-#ifdef OCR_TRACE_BINARY
-        processTraceObject(tr, f);
-#endif
-        worker->pd->fcts.pdFree(worker->pd, tr);
+    u64 dropped = 0;
+    for(i = 0; i < ((pd->workerCount)-1); i++){
+        ocrTraceBuffer_t *buf = ((ocrWorkerHc_t *)pd->workers[i])->traceBuffer;
+        if(buf == NULL) continue;
+        flushTraceBuffer(fd, offset, buf);
+        ocrTracePageHeader_t *header = (ocrTracePageHeader_t *)TRACE_BUFFER_PAGE(buf, buf->tail);
+        if((header->count != 0) || (header->dropped != 0)){
+            writeTracePages(fd, offset, (u8 *)header, TRACE_PAGE_SIZE);
+        }
+        dropped += buf->dropped;
+    }
+    if(dropped != 0){
+        PRINTF("[PD:0x%"PRIx64"] %"PRIu64" trace records dropped, trace buffers were full\n", (u64)pd->myLocation, dropped);
     }
 }
+#endif
 
-//workLoop for system worker: strictly responsible for querying/processing records in trace queues.
+//workLoop for system worker: strictly responsible for writing out the pages of the workers' trace buffers.
 void workerLoopSystem(ocrWorker_t *worker){
 
     ASSERT(worker->curState == GET_STATE(RL_USER_OK, (RL_GET_PHASE_COUNT_DOWN(worker->pd, RL_USER_OK))));
@@ -96,35 +112,26 @@ void workerLoopSystem(ocrWorker_t *worker){
 #ifdef OCR_TRACE_BINARY
     ocrPolicyDomain_t *pd;
     getCurrentEnv(&pd, NULL, NULL, NULL);
-    u64 location = pd->myLocation;
-
-    char traceName[32];
-    SNPRINTF(traceName, 31, "trace_%lu.bin", location);
-
-    //open file for binary writing. (One per policy domain)
-    FILE *f = fopen(traceName, "w");
+    int fd = openTraceFile((u64)pd->myLocation);
+    u64 offset = 0;
 #endif
 
     u8 continueLoop = true;
-    bool toDrain = false;
 
     do {
         while(worker->curState == worker->desiredState){
+#ifdef OCR_TRACE_BINARY
             u32 i;
-            //Iterate over all comp. workers trace deques and pop records if they exist.
+            //Iterate over all comp. workers trace buffers and write out full pages if any.
             for(i = 0; i < ((worker->pd->workerCount)-1); i++){
                 //WARNING:  Broken abstraction.  Currently only supported on x86 so system worker
                 //          looks directly into hc-worker. See bug #830
-                deque_t *deq = ((ocrWorkerHc_t *)worker->pd->workers[i])->sysDeque;
-                s32 head = deq->head;
-                s32 tail = deq->tail;
-                if(tail-head > 0){
-                    //Atleast one trace object on deque.  Drain.
-#ifdef OCR_TRACE_BINARY
-                    drainCurrentDeque(worker, f, head, tail, deq);
-#endif
+                ocrTraceBuffer_t *buf = ((ocrWorkerHc_t *)worker->pd->workers[i])->traceBuffer;
+                if((buf != NULL) && (buf->tail != buf->head)){
+                    flushTraceBuffer(fd, &offset, buf);
                 }
             }
+#endif
         }
 
         ((ocrWorkerSystem_t *)worker)->readyForShutdown = true;
@@ -145,11 +152,7 @@ void workerLoopSystem(ocrWorker_t *worker){
             if(RL_IS_FIRST_PHASE_DOWN(worker->pd, RL_COMPUTE_OK, phase)) {
                 worker->curState = worker->desiredState;
                 //We have succesfully shifted out of USER runlevel, and are breaking out of
-                //our workLoop... Check if deques still contain items.
-                if(!(allDequesEmpty(worker->pd))){
-                    toDrain = true;
-                }
-
+                //our workLoop... Remaining trace records are written out below.
                 if(worker->callback != NULL){
                     worker->callback(worker->pd, worker->callbackArg);
                 }
@@ -166,15 +169,12 @@ void workerLoopSystem(ocrWorker_t *worker){
         }
     } while(continueLoop);
 
-    if(toDrain){
-
 #ifdef OCR_TRACE_BINARY
-        drainSysDeques(f);
-        fclose(f);
-#endif
-
+    drainTraceBuffers(pd, fd, &offset);
+    if(fd >= 0){
+        close(fd);
     }
-
+#endif
 
 }
 
@@ -80,6 +80,7 @@ void initializeWorkerOcr(ocrWorkerFactory_t * factory, ocrWorker_t * self, ocrPa
     self->callback = NULL;
     self->callbackArg = 0ULL;
     self->id = ((paramListWorkerInst_t *) perInstance)->workerId;
+    self->numaDomain = 0;
 #ifdef OCR_MONITOR_SCHEDULER
     self->isSeeking = false;
 #endif
@@ -97,6 +98,19 @@ void initializeWorkerOcr(ocrWorkerFactory_t * factory, ocrWorker_t * self, ocrPa
     self->waitloc = UNDEFINED_LOCATION;
     self->blockedContexts = 0;
 #endif
+    {
+        u64 *ctr = (u64 *)&self->counters.data;
+        u32 i;
+        for (i = 0; i < sizeof(rtCountersData_t)/sizeof(u64); i++)
+            ctr[i] = 0;
+    }
+    self->readyBatchDepth = 0;
+    self->readyBatchCount = 0;
+    self->inlineDepthMax = 0;
+    self->inlineDepth = 0;
+    self->inlineCapture = false;
+    self->inlineNext.guid = NULL_GUID;
+    self->inlineNext.metaDataPtr = NULL;
 }
 
 #ifdef ENABLE_AMT_RESILIENCE
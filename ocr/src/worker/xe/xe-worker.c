@@ -29,6 +29,10 @@
 
 #include "policy-domain/xe/xe-policy.h"
 
+#ifdef OCR_TRACE_BINARY
+#include "utils/tracer/tracer.h"
+#endif
+
 #define DEBUG_TYPE WORKER
 
 /******************************************************/
@@ -85,6 +89,7 @@ static void workerLoop(ocrWorker_t * worker) {
 #endif
 
                 ((ocrTaskFactory_t*)(pd->factories[factoryId]))->fcts.execute(worker->curTask);
+                RT_WORKER_COUNTER_ADD(worker, RT_COUNTER_EDTS_EXECUTED, 1);
 
 #ifdef ENABLE_EXTENSION_PERF
                 if(worker->curTask->flags & OCR_TASK_FLAG_PERFMON_ME) {
@@ -101,7 +106,7 @@ static void workerLoop(ocrWorker_t * worker) {
                         u64 perfval = (i<PERF_HW_MAX) ? (xeWorker->perfCtrs[i].perfVal)
                                                       : (worker->curTask->swPerfCtrs[i-PERF_HW_MAX]);
                         u64 oldaverage = ctrs->stats[i].average;
-                        ctrs->stats[i].average = (oldaverage + perfval)>>1;
+                        perfStatUpdate(&ctrs->stats[i], perfval, ctrs->count);
                         // Check for steady state
                         if(ctrs->count > STEADY_STATE_COUNT) {
                             s64 diff = ctrs->stats[i].average - oldaverage;
@@ -111,7 +116,7 @@ static void workerLoop(ocrWorker_t * worker) {
                         }
                     }
                 }
-                else {
+                else if(ctrs != NULL) {
                     // If hints are specified, simply read them
                     u64 hintValue;
                     ocrHint_t hint;
@@ -132,6 +137,9 @@ static void workerLoop(ocrWorker_t * worker) {
                         ctrs->steadyStateMask = 0;
                     }
                 }
+                OCR_TOOL_TRACE(true, OCR_TRACE_TYPE_EDT, OCR_ACTION_FINISH, traceTaskFinish, worker->curTask->guid,
+                               (ctrs != NULL) ? ctrs->edt : NULL, (ctrs != NULL) ? ctrs->count : 0,
+                               ((ctrs != NULL) && (worker->curTask->flags & OCR_TASK_FLAG_PERFMON_ME)) ? ctrs->stats : NULL);
 #endif
 
 #undef PD_TYPE
@@ -0,0 +1,96 @@
+/*
+ * This file is subject to the license agreement located in the file LICENSE
+ * and cannot be distributed without it. This notice cannot be
+ * removed or modified.
+ */
+
+#include "ocr.h"
+
+/**
+ * DESC: Test ocrAddDependences with a fan-out from a sticky event, a fan-in on an EDT and mixed sources
+ */
+
+#define NB_CONS 40
+
+// Slots of the sink EDT after the fan-in
+#define SLOT_DB    (NB_CONS)
+#define SLOT_NULL  (NB_CONS + 1)
+#define SLOT_LATE  (NB_CONS + 2)
+#define SINK_DEPC  (NB_CONS + 3)
+
+ocrGuid_t sinkEdt(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[]) {
+    ocrGuid_t dbGuid = depv[SLOT_DB].guid;
+    u32 i;
+    ASSERT(depc == SINK_DEPC);
+    for (i = 0; i < NB_CONS; i++) {
+        ASSERT(ocrGuidIsEq(depv[i].guid, dbGuid));
+    }
+    ASSERT(*((u64*)depv[SLOT_DB].ptr) == 42);
+    ASSERT(ocrGuidIsNull(depv[SLOT_NULL].guid));
+    ASSERT(ocrGuidIsNull(depv[SLOT_LATE].guid));
+    PRINTF("Everything went OK\n");
+    ocrShutdown();
+    return NULL_GUID;
+}
+
+ocrGuid_t mainEdt(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[]) {
+    ocrGuid_t dbGuid;
+    u64 *value;
+    ocrDbCreate(&dbGuid, (void **)&value, sizeof(u64), DB_PROP_NONE, NULL_HINT, NO_ALLOC);
+    *value = 42;
+    ocrDbRelease(dbGuid);
+
+    ocrGuid_t sinkTemplGuid, sinkGuid;
+    ocrEdtTemplateCreate(&sinkTemplGuid, sinkEdt, 0, SINK_DEPC);
+    ocrEdtCreate(&sinkGuid, sinkTemplGuid, 0, NULL, SINK_DEPC, NULL, EDT_PROP_NONE, NULL_HINT, NULL);
+    ocrEdtTemplateDestroy(sinkTemplGuid);
+
+    ocrGuid_t prodGuid, consGuids[NB_CONS];
+    ocrEventCreate(&prodGuid, OCR_EVENT_STICKY_T, EVT_PROP_TAKES_ARG);
+    u32 i;
+    for (i = 0; i < NB_CONS; i++) {
+        ocrEventCreate(&consGuids[i], OCR_EVENT_STICKY_T, EVT_PROP_TAKES_ARG);
+    }
+
+    // Already satisfied source
+    ocrGuid_t earlyGuid, lateGuid;
+    ocrEventCreate(&earlyGuid, OCR_EVENT_STICKY_T, EVT_PROP_NONE);
+    ocrEventCreate(&lateGuid, OCR_EVENT_STICKY_T, EVT_PROP_NONE);
+    ocrEventSatisfy(earlyGuid, NULL_GUID);
+
+    ASSERT(ocrAddDependences(0, NULL) == 0);
+
+    // Fan-out and fan-in interleaved, over two calls so that the second one
+    // grows the waiter list of the producer
+    ocrDependence_t deps[NB_CONS + 2];
+    u32 n = 0;
+    for (i = 0; i < NB_CONS / 2; i++) {
+        ocrDependence_t out = {prodGuid, consGuids[i], 0, DB_MODE_RO};
+        ocrDependence_t in = {consGuids[i], sinkGuid, i, DB_MODE_RO};
+        deps[n++] = out;
+        deps[n++] = in;
+    }
+    ASSERT(ocrAddDependences(n, deps) == 0);
+    n = 0;
+    for (i = NB_CONS / 2; i < NB_CONS; i++) {
+        ocrDependence_t out = {prodGuid, consGuids[i], 0, DB_MODE_RO};
+        ocrDependence_t in = {consGuids[i], sinkGuid, i, DB_MODE_RO};
+        deps[n++] = out;
+        deps[n++] = in;
+        if (i == (NB_CONS * 3) / 4) {
+            ocrDependence_t db = {dbGuid, sinkGuid, SLOT_DB, DB_MODE_RO};
+            deps[n++] = db;
+        }
+    }
+    ocrDependence_t nullDep = {NULL_GUID, sinkGuid, SLOT_NULL, DB_MODE_NULL};
+    ocrDependence_t lateDep = {lateGuid, sinkGuid, SLOT_LATE, DB_MODE_NULL};
+    ocrDependence_t earlyDep = {earlyGuid, lateGuid, 0, DB_MODE_NULL};
+    deps[n++] = nullDep;
+    ASSERT(ocrAddDependences(n, deps) == 0);
+    deps[0] = lateDep;
+    deps[1] = earlyDep;
+    ASSERT(ocrAddDependences(2, deps) == 0);
+
+    ocrEventSatisfy(prodGuid, dbGuid);
+    return NULL_GUID;
+}
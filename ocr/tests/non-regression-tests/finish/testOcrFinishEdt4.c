@@ -0,0 +1,103 @@
+/*
+ * This file is subject to the license agreement located in the file LICENSE
+ * and cannot be distributed without it. This notice cannot be
+ * removed or modified.
+ */
+
+#include "ocr.h"
+#ifndef NB_FORKERS
+#define NB_FORKERS 16
+#endif
+#ifndef N
+#define N 64
+#endif
+
+/**
+ * DESC: Creates a top-level finish-edt which forks 'NB_FORKERS' edts, each
+ * forking 'N' edts writing in a shared data block. The finish scope counts
+ * all of them concurrently; the sink edt checks everybody wrote to the db
+ * before the scope was done.
+ */
+
+ocrGuid_t terminateEdt(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[]) {
+    ASSERT(!(ocrGuidIsNull(depv[0].guid)));
+    u64 * array = (u64*)depv[0].ptr;
+    u64 i = 0;
+    while (i < (NB_FORKERS * N)) {
+        ASSERT(array[i] == (i + 1));
+        i++;
+    }
+    PRINTF("Everything went OK\n");
+    ocrShutdown(); // This is the last EDT to execute, terminate
+    return NULL_GUID;
+}
+
+ocrGuid_t updaterEdt(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[]) {
+    ASSERT(paramc == 1);
+    u64 id = paramv[0];
+    ASSERT(id < (NB_FORKERS * N));
+    u64 * dbPtr = (u64 *) depv[0].ptr;
+    dbPtr[id] = id + 1;
+    return NULL_GUID;
+}
+
+ocrGuid_t forkerEdt(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[]) {
+    ASSERT(paramc == 1);
+    ocrGuid_t updaterEdtTemplateGuid;
+    ocrEdtTemplateCreate(&updaterEdtTemplateGuid, updaterEdt, 1 /*paramc*/, 1 /*depc*/);
+    u64 i = 0;
+    while (i < N) {
+        u64 nparamv = (paramv[0] * N) + i;
+        ocrGuid_t updaterEdtGuid;
+        ocrEdtCreate(&updaterEdtGuid, updaterEdtTemplateGuid, EDT_PARAM_DEF, &nparamv, EDT_PARAM_DEF, &(depv[0].guid),
+                     EDT_PROP_NONE, NULL_HINT, NULL);
+        i++;
+    }
+    ocrEdtTemplateDestroy(updaterEdtTemplateGuid);
+    return NULL_GUID;
+}
+
+ocrGuid_t computeEdt(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[]) {
+    ocrGuid_t forkerEdtTemplateGuid;
+    ocrEdtTemplateCreate(&forkerEdtTemplateGuid, forkerEdt, 1 /*paramc*/, 1 /*depc*/);
+    u64 i = 0;
+    while (i < NB_FORKERS) {
+        ocrGuid_t forkerEdtGuid;
+        ocrEdtCreate(&forkerEdtGuid, forkerEdtTemplateGuid, EDT_PARAM_DEF, &i, EDT_PARAM_DEF, &(depv[0].guid),
+                     EDT_PROP_NONE, NULL_HINT, NULL);
+        i++;
+    }
+    ocrEdtTemplateDestroy(forkerEdtTemplateGuid);
+    return NULL_GUID;
+}
+
+ocrGuid_t mainEdt(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[]) {
+    // Build a data-block to be shared with sub-edts
+    u64 * array;
+    ocrGuid_t dbGuid;
+    ocrDbCreate(&dbGuid,(void **) &array, sizeof(u64) * NB_FORKERS * N, DB_PROP_NONE, NULL_HINT, NO_ALLOC);
+    u64 i = 0;
+    while (i < (NB_FORKERS * N)) {
+        array[i] = 0;
+        i++;
+    }
+    ocrDbRelease(dbGuid);
+
+    ocrGuid_t finishEdtOutputEventGuid;
+    ocrGuid_t computeEdtGuid;
+    ocrGuid_t computeEdtTemplateGuid;
+    ocrEdtTemplateCreate(&computeEdtTemplateGuid, computeEdt, 0 /*paramc*/, 1 /*depc*/);
+    ocrEdtCreate(&computeEdtGuid, computeEdtTemplateGuid, EDT_PARAM_DEF, /*paramv=*/NULL, EDT_PARAM_DEF, &dbGuid,
+                 /*properties=*/ EDT_PROP_FINISH, NULL_HINT, /*outEvent=*/&finishEdtOutputEventGuid);
+    ocrEdtTemplateDestroy(computeEdtTemplateGuid);
+
+    ocrGuid_t terminateEdtGuid;
+    ocrGuid_t terminateEdtTemplateGuid;
+    ocrEdtTemplateCreate(&terminateEdtTemplateGuid, terminateEdt, 0 /*paramc*/, 2 /*depc*/);
+    ocrEdtCreate(&terminateEdtGuid, terminateEdtTemplateGuid, EDT_PARAM_DEF, /*paramv=*/NULL, EDT_PARAM_DEF, /*depv=*/NULL,
+                 /*properties=*/EDT_PROP_NONE, NULL_HINT, /*outEvent=*/NULL);
+    ocrEdtTemplateDestroy(terminateEdtTemplateGuid);
+    ocrAddDependence(dbGuid, terminateEdtGuid, 0, DB_MODE_CONST);
+    ocrAddDependence(finishEdtOutputEventGuid, terminateEdtGuid, 1, DB_MODE_CONST);
+    return NULL_GUID;
+}
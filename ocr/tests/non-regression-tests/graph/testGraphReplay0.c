@@ -0,0 +1,139 @@
+/*
+ * This file is subject to the license agreement located in the file LICENSE
+ * and cannot be distributed without it. This notice cannot be
+ * removed or modified.
+ */
+
+#include "ocr.h"
+
+/**
+ * DESC: Graph: capture a step sub-graph once, replay it at every iteration
+ */
+
+// Only tested when the graph extension is available
+#ifdef ENABLE_EXTENSION_GRAPH
+
+#include "extensions/ocr-graph.h"
+
+#define NB_ITERS 8
+
+// Nodes of the step graph
+#define NODE_START  0
+#define NODE_B_OUT  4
+
+typedef struct {
+    u64 iter;
+    ocrGraph_t *graph;
+    ocrGuid_t stepTemplGuid;
+} iterParams_t;
+
+#define ITER_PARAMC (sizeof(iterParams_t)/sizeof(u64))
+
+// Adds paramv[0] to the counter
+ocrGuid_t stepEdt(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[]) {
+    u64 *counter = (u64*)depv[0].ptr;
+    *counter += paramv[0];
+    return NULL_GUID;
+}
+
+static u64 stepIncrement(u64 iter) {
+    // Iterations 0 and 1 use the captured parameters
+    return (iter < 2) ? 11 : 11 * iter;
+}
+
+ocrGuid_t iterEdt(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[]) {
+    iterParams_t *params = (iterParams_t*)paramv;
+    u64 iter = params->iter;
+    ocrGuid_t stepTemplGuid = params->stepTemplGuid;
+    ocrGraph_t *graph = params->graph;
+    ocrGuid_t dbGuid = depv[0].guid;
+    u64 *counter = (u64*)depv[0].ptr;
+    u64 i, expected = 0;
+    for (i = 0; i < iter; i++)
+        expected += stepIncrement(i);
+    ASSERT(*counter == expected);
+
+    ocrGuid_t iterTemplGuid;
+    ocrEdtTemplateCreate(&iterTemplGuid, iterEdt, ITER_PARAMC, 2);
+    if (iter == NB_ITERS) {
+        ocrEdtTemplateDestroy(iterTemplGuid);
+        ocrEdtTemplateDestroy(stepTemplGuid);
+        ASSERT(ocrGraphDestroy(graph) == 0);
+        PRINTF("Everything went OK\n");
+        ocrShutdown();
+        return NULL_GUID;
+    }
+
+    ocrGuid_t nodes[NODE_B_OUT + 1];
+    if (iter == 0) {
+        ocrGuid_t startEvt, stepA, outA, stepB, outB;
+        u64 paramA = 1, paramB = 10;
+        ASSERT(ocrGraphCaptureBegin() == 0);
+        ASSERT(ocrGraphCaptureBegin() == OCR_EBUSY);
+        ocrEventCreate(&startEvt, OCR_EVENT_ONCE_T, EVT_PROP_NONE);
+        ocrEdtCreate(&stepA, stepTemplGuid, 1, &paramA, 2, NULL, EDT_PROP_NONE, NULL_HINT, &outA);
+        ocrAddDependence(dbGuid, stepA, 0, DB_DEFAULT_MODE);
+        ocrAddDependence(startEvt, stepA, 1, DB_MODE_NULL);
+        ocrGuid_t depvB[2] = {dbGuid, outA};
+        ocrEdtCreate(&stepB, stepTemplGuid, 1, &paramB, 2, depvB, EDT_PROP_NONE, NULL_HINT, &outB);
+        ocrGraph_t *noGraph;
+        ASSERT(ocrGraphCaptureEnd(&graph) == 0);
+        ASSERT(ocrGraphCaptureEnd(&noGraph) == OCR_EPERM);
+        ASSERT(noGraph == NULL);
+
+        ocrGraphInfo_t info;
+        ocrGuid_t inputs[1];
+        ASSERT(ocrGraphQuery(graph, &info, inputs) == 0);
+        ASSERT(info.nodeCount == NODE_B_OUT + 1);
+        ASSERT(info.edtCount == 2);
+        ASSERT(info.eventCount == 3);
+        ASSERT(info.inputCount == 1);
+        ASSERT(ocrGuidIsEq(inputs[0], dbGuid));
+        ASSERT(info.paramCount == 2);
+        ASSERT(info.depCount == 4);
+        nodes[NODE_START] = startEvt;
+        nodes[NODE_B_OUT] = outB;
+    } else if (iter == 1) {
+        // Captured parameters and inputs
+        ASSERT(ocrGraphReplay(graph, NULL, NULL, nodes) == 0);
+    } else {
+        u64 stepParams[2] = {iter, 10 * iter};
+        ocrGuid_t inputs[1] = {dbGuid};
+        ASSERT(ocrGraphReplay(graph, stepParams, inputs, nodes) == 0);
+    }
+
+    iterParams_t nextParams = {.iter = iter + 1, .graph = graph, .stepTemplGuid = stepTemplGuid};
+    ocrGuid_t nextGuid;
+    ocrEdtCreate(&nextGuid, iterTemplGuid, ITER_PARAMC, (u64*)&nextParams, 2, NULL, EDT_PROP_NONE, NULL_HINT, NULL);
+    ocrEdtTemplateDestroy(iterTemplGuid);
+    ocrAddDependence(dbGuid, nextGuid, 0, DB_MODE_RO);
+    ocrAddDependence(nodes[NODE_B_OUT], nextGuid, 1, DB_MODE_NULL);
+    ocrEventSatisfy(nodes[NODE_START], NULL_GUID);
+    return NULL_GUID;
+}
+
+ocrGuid_t mainEdt(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[]) {
+    ocrGuid_t stepTemplGuid, iterTemplGuid, iterGuid, dbGuid;
+    u64 *counter;
+    ocrEdtTemplateCreate(&stepTemplGuid, stepEdt, 1, 2);
+    ocrEdtTemplateCreate(&iterTemplGuid, iterEdt, ITER_PARAMC, 2);
+    iterParams_t iterParams = {.iter = 0, .graph = NULL, .stepTemplGuid = stepTemplGuid};
+    ocrEdtCreate(&iterGuid, iterTemplGuid, ITER_PARAMC, (u64*)&iterParams, 2, NULL, EDT_PROP_NONE, NULL_HINT, NULL);
+    ocrEdtTemplateDestroy(iterTemplGuid);
+    ocrDbCreate(&dbGuid, (void **)&counter, sizeof(u64), DB_PROP_NONE, NULL_HINT, NO_ALLOC);
+    *counter = 0;
+    ocrDbRelease(dbGuid);
+    ocrAddDependence(dbGuid, iterGuid, 0, DB_MODE_RO);
+    ocrAddDependence(NULL_GUID, iterGuid, 1, DB_MODE_NULL);
+    return NULL_GUID;
+}
+
+#else
+
+ocrGuid_t mainEdt(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[]) {
+    PRINTF("No graph API\n");
+    ocrShutdown();
+    return NULL_GUID;
+}
+
+#endif
@@ -0,0 +1,119 @@
+/*
+ * This file is subject to the license agreement located in the file LICENSE
+ * and cannot be distributed without it. This notice cannot be
+ * removed or modified.
+ */
+
+#include "ocr.h"
+
+/**
+ * DESC: Graph: capture a wide fan-out/fan-in graph, run it, then replay it
+ */
+
+// Only tested when the graph extension is available
+#ifdef ENABLE_EXTENSION_GRAPH
+
+#include "extensions/ocr-graph.h"
+
+#define NB_LEAVES 200
+
+// Nodes of the graph: the start event, each leaf and its output event, the sink
+#define NODE_START  0
+#define NODE_COUNT  (2 * NB_LEAVES + 2)
+
+typedef struct {
+    ocrGraph_t *graph;
+    ocrGuid_t leafTemplGuid;
+    ocrGuid_t sinkTemplGuid;
+    u64 values[NB_LEAVES];
+} graphDb_t;
+
+ocrGuid_t leafEdt(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[]) {
+    graphDb_t *db = (graphDb_t*)depv[0].ptr;
+    ASSERT(paramv[0] < NB_LEAVES);
+    db->values[paramv[0]] = paramv[0] + 1;
+    return NULL_GUID;
+}
+
+ocrGuid_t sinkEdt(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[]) {
+    graphDb_t *db = (graphDb_t*)depv[0].ptr;
+    ASSERT(depc == NB_LEAVES + 1);
+    u64 i;
+    for (i = 0; i < NB_LEAVES; i++) {
+        ASSERT(db->values[i] == i + 1);
+        db->values[i] = 0;
+    }
+    if (paramv[0] == 1) {
+        ASSERT(ocrGraphDestroy(db->graph) == 0);
+        ocrEdtTemplateDestroy(db->leafTemplGuid);
+        ocrEdtTemplateDestroy(db->sinkTemplGuid);
+        PRINTF("Everything went OK\n");
+        ocrShutdown();
+        return NULL_GUID;
+    }
+    // Replay with the sink of the new instance shutting down
+    u64 params[NB_LEAVES + 1];
+    for (i = 0; i < NB_LEAVES; i++)
+        params[i] = i;
+    params[NB_LEAVES] = 1;
+    ocrGuid_t nodes[NODE_COUNT];
+    ASSERT(ocrGraphReplay(db->graph, params, NULL, nodes) == 0);
+    ocrEventSatisfy(nodes[NODE_START], NULL_GUID);
+    return NULL_GUID;
+}
+
+ocrGuid_t mainEdt(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[]) {
+    ocrGuid_t leafTemplGuid, sinkTemplGuid, dbGuid;
+    graphDb_t *db;
+    ocrEdtTemplateCreate(&leafTemplGuid, leafEdt, 1, 2);
+    ocrEdtTemplateCreate(&sinkTemplGuid, sinkEdt, 1, NB_LEAVES + 1);
+    ocrDbCreate(&dbGuid, (void **)&db, sizeof(graphDb_t), DB_PROP_NONE, NULL_HINT, NO_ALLOC);
+
+    ocrGuid_t startEvt, sink;
+    ocrGuid_t outs[NB_LEAVES];
+    u64 i;
+    ASSERT(ocrGraphCaptureBegin() == 0);
+    ocrEventCreate(&startEvt, OCR_EVENT_ONCE_T, EVT_PROP_NONE);
+    for (i = 0; i < NB_LEAVES; i++) {
+        ocrGuid_t leaf;
+        ocrGuid_t leafDepv[2] = {dbGuid, startEvt};
+        ocrEdtCreate(&leaf, leafTemplGuid, 1, &i, 2, leafDepv, EDT_PROP_NONE, NULL_HINT, &outs[i]);
+    }
+    u64 instance = 0;
+    ocrEdtCreate(&sink, sinkTemplGuid, 1, &instance, NB_LEAVES + 1, NULL, EDT_PROP_NONE, NULL_HINT, NULL);
+    ocrAddDependence(dbGuid, sink, 0, DB_DEFAULT_MODE);
+    for (i = 0; i < NB_LEAVES; i++)
+        ocrAddDependence(outs[i], sink, i + 1, DB_DEFAULT_MODE);
+    ocrGraph_t *graph;
+    ASSERT(ocrGraphCaptureEnd(&graph) == 0);
+
+    ocrGraphInfo_t info;
+    ocrGuid_t inputs[1];
+    ASSERT(ocrGraphQuery(graph, &info, inputs) == 0);
+    ASSERT(info.nodeCount == NODE_COUNT);
+    ASSERT(info.edtCount == NB_LEAVES + 1);
+    ASSERT(info.eventCount == NB_LEAVES + 1);
+    ASSERT(info.inputCount == 1);
+    ASSERT(ocrGuidIsEq(inputs[0], dbGuid));
+    ASSERT(info.paramCount == NB_LEAVES + 1);
+    ASSERT(info.depCount == 3 * NB_LEAVES + 1);
+
+    for (i = 0; i < NB_LEAVES; i++)
+        db->values[i] = 0;
+    db->graph = graph;
+    db->leafTemplGuid = leafTemplGuid;
+    db->sinkTemplGuid = sinkTemplGuid;
+    ocrDbRelease(dbGuid);
+    ocrEventSatisfy(startEvt, NULL_GUID);
+    return NULL_GUID;
+}
+
+#else
+
+ocrGuid_t mainEdt(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[]) {
+    PRINTF("No graph API\n");
+    ocrShutdown();
+    return NULL_GUID;
+}
+
+#endif
@@ -0,0 +1,133 @@
+/*
+ * This file is subject to the license agreement located in the file LICENSE
+ * and cannot be distributed without it. This notice cannot be
+ * removed or modified.
+ */
+
+#include "ocr.h"
+
+// Only tested when OCR legacy interface is available
+#ifdef ENABLE_EXTENSION_LEGACY
+
+#include "extensions/ocr-legacy.h"
+
+/**
+ * DESC: Fan-out while the mainEdt is blocked in ocrLegacyBlockProgress.
+ *       A once event releases 'NB_FANS' edts at once, each releasing
+ *       'N' edts the same way. The blocked worker helps running them,
+ *       and the mainEdt checks all of them wrote to the db it gets back.
+ */
+
+#define NB_FANS 16
+#define N 16
+
+ocrGuid_t leafEdt(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[]) {
+    ASSERT(paramc == 1);
+    u64 id = paramv[0];
+    ASSERT(id < (NB_FANS * N));
+    u64 * array = (u64 *) depv[1].ptr;
+    array[id] = id + 1;
+    return NULL_GUID;
+}
+
+ocrGuid_t fanEdt(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[]) {
+    ASSERT(paramc == 1);
+    ocrGuid_t triggerGuid;
+    ocrEventCreate(&triggerGuid, OCR_EVENT_ONCE_T, EVT_PROP_NONE);
+    ocrGuid_t leafTemplateGuid;
+    ocrEdtTemplateCreate(&leafTemplateGuid, leafEdt, 1 /*paramc*/, 2 /*depc*/);
+    u64 i = 0;
+    while (i < N) {
+        u64 id = (paramv[0] * N) + i;
+        ocrGuid_t leafGuid;
+        ocrEdtCreate(&leafGuid, leafTemplateGuid, EDT_PARAM_DEF, &id, EDT_PARAM_DEF, NULL,
+                     EDT_PROP_NONE, NULL_HINT, NULL);
+        ocrAddDependence(depv[1].guid, leafGuid, 1, DB_MODE_RW);
+        ocrAddDependence(triggerGuid, leafGuid, 0, DB_MODE_CONST);
+        i++;
+    }
+    ocrEdtTemplateDestroy(leafTemplateGuid);
+    // Makes all the leaves ready at once
+    ocrEventSatisfy(triggerGuid, NULL_GUID);
+    return NULL_GUID;
+}
+
+ocrGuid_t rootEdt(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[]) {
+    ocrGuid_t triggerGuid;
+    ocrEventCreate(&triggerGuid, OCR_EVENT_ONCE_T, EVT_PROP_NONE);
+    ocrGuid_t fanTemplateGuid;
+    ocrEdtTemplateCreate(&fanTemplateGuid, fanEdt, 1 /*paramc*/, 2 /*depc*/);
+    u64 i = 0;
+    while (i < NB_FANS) {
+        ocrGuid_t fanGuid;
+        ocrEdtCreate(&fanGuid, fanTemplateGuid, EDT_PARAM_DEF, &i, EDT_PARAM_DEF, NULL,
+                     EDT_PROP_NONE, NULL_HINT, NULL);
+        ocrAddDependence(depv[0].guid, fanGuid, 1, DB_MODE_RW);
+        ocrAddDependence(triggerGuid, fanGuid, 0, DB_MODE_CONST);
+        i++;
+    }
+    ocrEdtTemplateDestroy(fanTemplateGuid);
+    ocrEventSatisfy(triggerGuid, NULL_GUID);
+    return NULL_GUID;
+}
+
+ocrGuid_t sinkEdt(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[]) {
+    return depv[0].guid;
+}
+
+ocrGuid_t mainEdt(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[]) {
+    u64 * array;
+    ocrGuid_t dbGuid;
+    ocrDbCreate(&dbGuid, (void **) &array, sizeof(u64) * NB_FANS * N, DB_PROP_NONE, NULL_HINT, NO_ALLOC);
+    u64 i = 0;
+    while (i < (NB_FANS * N)) {
+        array[i] = 0;
+        i++;
+    }
+    ocrDbRelease(dbGuid);
+
+    ocrGuid_t rootTemplateGuid;
+    ocrEdtTemplateCreate(&rootTemplateGuid, rootEdt, 0 /*paramc*/, 1 /*depc*/);
+    ocrGuid_t rootGuid, finishEventGuid;
+    ocrEdtCreate(&rootGuid, rootTemplateGuid, EDT_PARAM_DEF, NULL, EDT_PARAM_DEF, &dbGuid,
+                 EDT_PROP_FINISH, NULL_HINT, &finishEventGuid);
+    ocrEdtTemplateDestroy(rootTemplateGuid);
+
+    ocrGuid_t sinkTemplateGuid;
+    ocrEdtTemplateCreate(&sinkTemplateGuid, sinkEdt, 0 /*paramc*/, 2 /*depc*/);
+    ocrGuid_t sinkGuid, sinkEventGuid;
+    ocrEdtCreate(&sinkGuid, sinkTemplateGuid, EDT_PARAM_DEF, NULL, EDT_PARAM_DEF, NULL,
+                 EDT_PROP_NONE, NULL_HINT, &sinkEventGuid);
+    ocrEdtTemplateDestroy(sinkTemplateGuid);
+    ocrGuid_t stickyEvtGuid;
+    ocrEventCreate(&stickyEvtGuid, OCR_EVENT_STICKY_T, EVT_PROP_TAKES_ARG);
+    ocrAddDependence(sinkEventGuid, stickyEvtGuid, 0, DB_DEFAULT_MODE);
+    ocrAddDependence(dbGuid, sinkGuid, 0, DB_MODE_CONST);
+    ocrAddDependence(finishEventGuid, sinkGuid, 1, DB_MODE_CONST);
+
+    // Blocks this worker, which runs the fan-out in the meantime
+    ocrGuid_t resGuid;
+    void * result;
+    u64 size;
+    ocrLegacyBlockProgress(stickyEvtGuid, &resGuid, &result, &size, LEGACY_PROP_NONE);
+    ASSERT(ocrGuidIsEq(resGuid, dbGuid));
+    ASSERT(size == (sizeof(u64) * NB_FANS * N));
+    array = (u64 *) result;
+    i = 0;
+    while (i < (NB_FANS * N)) {
+        ASSERT(array[i] == (i + 1));
+        i++;
+    }
+    PRINTF("Everything went OK\n");
+    ocrShutdown();
+    return NULL_GUID;
+}
+
+#else
+
+ocrGuid_t mainEdt(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[]) {
+    ocrShutdown();
+    return NULL_GUID;
+}
+
+#endif
@@ -0,0 +1,84 @@
+/*
+ * This file is subject to the license agreement located in the file LICENSE
+ * and cannot be distributed without it. This notice cannot be
+ * removed or modified.
+ */
+
+#include "ocr.h"
+
+// Only tested when OCR legacy interface is available
+#ifdef ENABLE_EXTENSION_LEGACY
+
+#include "extensions/ocr-legacy.h"
+
+/**
+ * DESC: Single successor made ready while the mainEdt is blocked in
+ *       ocrLegacyBlockProgress. The worker helping runs 'firstEdt', which
+ *       unblocks the mainEdt and whose completion makes 'secondEdt' ready.
+ *       The mainEdt then blocks again until 'secondEdt' produced its db.
+ */
+
+#define MARK 999
+
+ocrGuid_t secondEdt(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[]) {
+    u64 * array;
+    ocrGuid_t dbGuid;
+    ocrDbCreate(&dbGuid,(void **) &array, sizeof(u64), DB_PROP_NONE, NULL_HINT, NO_ALLOC);
+    array[0] = MARK;
+    ocrDbRelease(dbGuid);
+    return dbGuid;
+}
+
+ocrGuid_t firstEdt(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[]) {
+    ocrGuid_t resumeEvtGuid = ((ocrGuid_t *) paramv)[0];
+    ocrEventSatisfy(resumeEvtGuid, NULL_GUID);
+    return NULL_GUID;
+}
+
+ocrGuid_t mainEdt(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[]) {
+    ocrGuid_t resumeEvtGuid, doneEvtGuid;
+    ocrEventCreate(&resumeEvtGuid, OCR_EVENT_STICKY_T, EVT_PROP_TAKES_ARG);
+    ocrEventCreate(&doneEvtGuid, OCR_EVENT_STICKY_T, EVT_PROP_TAKES_ARG);
+
+    ocrGuid_t firstTemplateGuid, firstGuid, firstOutGuid;
+    ocrEdtTemplateCreate(&firstTemplateGuid, firstEdt, sizeof(ocrGuid_t)/sizeof(u64), 1);
+    ocrEdtCreate(&firstGuid, firstTemplateGuid, EDT_PARAM_DEF, (u64 *) &resumeEvtGuid, EDT_PARAM_DEF, NULL,
+                 EDT_PROP_NONE, NULL_HINT, &firstOutGuid);
+    ocrEdtTemplateDestroy(firstTemplateGuid);
+
+    // Only successor of firstEdt
+    ocrGuid_t secondTemplateGuid, secondGuid, secondOutGuid;
+    ocrEdtTemplateCreate(&secondTemplateGuid, secondEdt, 0, 1);
+    ocrEdtCreate(&secondGuid, secondTemplateGuid, EDT_PARAM_DEF, NULL, EDT_PARAM_DEF, &firstOutGuid,
+                 EDT_PROP_NONE, NULL_HINT, &secondOutGuid);
+    ocrEdtTemplateDestroy(secondTemplateGuid);
+    ocrAddDependence(secondOutGuid, doneEvtGuid, 0, DB_DEFAULT_MODE);
+
+    // Schedule firstEdt
+    ocrAddDependence(NULL_GUID, firstGuid, 0, DB_DEFAULT_MODE);
+
+    ocrGuid_t dbGuid;
+    void * result;
+    u64 size;
+    // Helping runs firstEdt
+    ocrLegacyBlockProgress(resumeEvtGuid, &dbGuid, &result, &size, LEGACY_PROP_NONE);
+    ASSERT(ocrGuidIsNull(dbGuid));
+    // secondEdt must have been handed to the scheduler
+    ocrLegacyBlockProgress(doneEvtGuid, &dbGuid, &result, &size, LEGACY_PROP_NONE);
+    ASSERT(!(ocrGuidIsNull(dbGuid)));
+    ASSERT(result != NULL);
+    ASSERT(((u64 *) result)[0] == MARK);
+    ASSERT(size == sizeof(u64));
+    PRINTF("Everything went OK\n");
+    ocrShutdown();
+    return NULL_GUID;
+}
+
+#else
+
+ocrGuid_t mainEdt(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[]) {
+    ocrShutdown();
+    return NULL_GUID;
+}
+
+#endif
@@ -0,0 +1,72 @@
+/*
+ * This file is subject to the license agreement located in the file LICENSE
+ * and cannot be distributed without it. This notice cannot be
+ * removed or modified.
+ */
+
+#include "ocr.h"
+
+/**
+ * DESC: RT-API: Test 'ocrRuntimeQuery'
+ */
+
+// Only tested when the runtime query API is available
+#ifdef ENABLE_EXTENSION_RUNTIME_QUERY
+
+#include "extensions/ocr-runtime-query.h"
+
+#define NB_CHILDREN 16
+
+ocrGuid_t childEdt(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[]) {
+    return NULL_GUID;
+}
+
+ocrGuid_t checkEdt(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[]) {
+    ocrRuntimeCounters_t all, one;
+    ASSERT(ocrRuntimeQuery(OCR_RUNTIME_ALL_WORKERS, &all) == 0);
+    ASSERT(all.workerCount > 0);
+    // The children and mainEdt are done but the other workers may not
+    // have counted the last EDT they ran yet
+    ASSERT((s64)all.values[OCR_RUNTIME_EDTS_EXECUTED] >= (s64)(NB_CHILDREN + 1) - (s64)(all.workerCount - 1));
+    ASSERT(all.values[OCR_RUNTIME_STEALS_SUCCESSFUL] <= all.values[OCR_RUNTIME_STEALS_ATTEMPTED]);
+    ASSERT(all.values[OCR_RUNTIME_DB_BYTES_LOCAL] >= sizeof(u64));
+
+    ASSERT(ocrRuntimeQuery(0, &one) == 0);
+    ASSERT(one.workerCount == 1);
+    ASSERT(ocrRuntimeQuery(all.workerCount, &one) == OCR_EINVAL);
+    ASSERT(ocrRuntimeQuery(0, NULL) == OCR_EINVAL);
+    PRINTF("%"PRIu64" EDTs executed by %"PRIu64" workers\n",
+           all.values[OCR_RUNTIME_EDTS_EXECUTED], all.workerCount);
+    ocrShutdown();
+    return NULL_GUID;
+}
+
+ocrGuid_t mainEdt(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[]) {
+    ocrGuid_t childTemplGuid, checkTemplGuid, checkGuid, childGuid, outEvt, dbGuid;
+    u64 *data;
+    u32 i;
+    ocrEdtTemplateCreate(&childTemplGuid, childEdt, 0, 0);
+    ocrEdtTemplateCreate(&checkTemplGuid, checkEdt, 0, NB_CHILDREN + 1);
+    ocrEdtCreate(&checkGuid, checkTemplGuid, 0, NULL, NB_CHILDREN + 1, NULL,
+                 EDT_PROP_NONE, NULL_HINT, NULL);
+    for (i = 0; i < NB_CHILDREN; i++) {
+        ocrEdtCreate(&childGuid, childTemplGuid, 0, NULL, 0, NULL,
+                     EDT_PROP_NONE, NULL_HINT, &outEvt);
+        ocrAddDependence(outEvt, checkGuid, i, DB_MODE_NULL);
+    }
+    ocrDbCreate(&dbGuid, (void **)&data, sizeof(u64), DB_PROP_NONE, NULL_HINT, NO_ALLOC);
+    *data = 0;
+    ocrDbRelease(dbGuid);
+    ocrAddDependence(dbGuid, checkGuid, NB_CHILDREN, DB_MODE_RO);
+    return NULL_GUID;
+}
+
+#else
+
+ocrGuid_t mainEdt(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[]) {
+    PRINTF("No runtime query API\n");
+    ocrShutdown();
+    return NULL_GUID;
+}
+
+#endif
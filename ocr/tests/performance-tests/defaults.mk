@@ -32,15 +32,31 @@ NODE_FANOUT ?= 2
 LEAF_FANOUT ?= 10
 # Tree depth for hierarchial tests
 TREE_DEPTH ?= 8
+# Number of distinct priority levels given to EDTs through hints
+NB_PRIORITIES ?= 1024
 
 # When creating DBs, how many units should each be?
 DB_NB_ELT ?= 10
 # Size of each unit in the above
 DB_TYPE ?= u64
 
-C_DEFINES := -DENABLE_EXTENSION_AFFINITY -DENABLE_EXTENSION_RTITF -DENABLE_EXTENSION_PARAMS_EVT -DENABLE_EXTENSION_COUNTED_EVT \
+# Application kernels
+# Number of tiles (or blocks) along each dimension of the problem
+NB_TILES ?= 8
+# Number of elements along each dimension of a tile
+TILE_SZ ?= 64
+# Fibonacci number computed by the recursive spawn tree
+FIB_N ?= 22
+# Number of rows and of non-zeros per row of the sparse matrix
+SPMV_ROWS ?= 16384
+SPMV_NNZ ?= 8
+# Number of doubles in each block of the STREAM arrays
+STREAM_ELTS ?= 262144
+
+C_DEFINES := -DENABLE_EXTENSION_AFFINITY -DENABLE_EXTENSION_RTITF -DENABLE_EXTENSION_PARAMS_EVT -DENABLE_EXTENSION_COUNTED_EVT -DENABLE_EXTENSION_LABELING \
              -DDB_NBS=$(DB_NBS) -DNB_EVT_COUNTED_DEPS=$(NB_EVT_COUNTED_DEPS) -DNB_ITERS=$(NB_ITERS) -DNB_INSTANCES=$(NB_INSTANCES)\
              -DDEPV_SZ=$(DEPV_SZ) -DPARAMC_SZ=$(PARAMC_SZ) -DFAN_OUT=$(FAN_OUT)\
              -DDB_SZ=$(DB_SZ) -DNODE_FANOUT=$(NODE_FANOUT)\
-             -DLEAF_FANOUT=$(LEAF_FANOUT) -DTREE_DEPTH=$(TREE_DEPTH) -DDB_NB_ELT=$(DB_NB_ELT)\
-             -DDB_TYPE=$(DB_TYPE) -DNB_WORKERS=$(NB_WORKERS) -DNB_NODES=$(NB_NODES) -DOCR_TYPE_H=$(OCR_TYPE).h
+             -DLEAF_FANOUT=$(LEAF_FANOUT) -DTREE_DEPTH=$(TREE_DEPTH) -DNB_PRIORITIES=$(NB_PRIORITIES) -DDB_NB_ELT=$(DB_NB_ELT)\
+             -DDB_TYPE=$(DB_TYPE) -DNB_TILES=$(NB_TILES) -DTILE_SZ=$(TILE_SZ) -DFIB_N=$(FIB_N)\
+             -DSPMV_ROWS=$(SPMV_ROWS) -DSPMV_NNZ=$(SPMV_NNZ) -DSTREAM_ELTS=$(STREAM_ELTS) -DNB_WORKERS=$(NB_WORKERS) -DNB_NODES=$(NB_NODES) -DOCR_TYPE_H=$(OCR_TYPE).h
@@ -0,0 +1,68 @@
+#include "perfs.h"
+#include "ocr.h"
+
+// DESC: A pipeline of empty tasks: each task depends on the output
+//       event of the previous one, so a single task becomes ready
+//       when one completes. The sink EDT depends on the output event
+//       of the last task.
+// TIME: Execution of the whole pipeline (tasks are created beforehand)
+// FREQ: Run a chain of 'NB_INSTANCES' EDTs once
+//
+// VARIABLES:
+// - NB_INSTANCES
+
+ocrGuid_t terminateEdt(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[]) {
+    timestamp_t * timers = (timestamp_t *) depv[1].ptr;
+    get_time(&timers[1]);
+    summary_throughput_timer(&timers[0], &timers[1], NB_INSTANCES);
+    ocrShutdown(); // This is the last EDT to execute, terminate
+    return NULL_GUID;
+}
+
+ocrGuid_t workEdt(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[]) {
+    return NULL_GUID;
+}
+
+ocrGuid_t mainEdt(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[]) {
+    ocrGuid_t terminateEdtTemplateGuid;
+    // Output event of the last task + timer DB
+    ocrEdtTemplateCreate(&terminateEdtTemplateGuid, terminateEdt, 0, 2);
+
+    ocrGuid_t terminateEdtGuid;
+    ocrEdtCreate(&terminateEdtGuid, terminateEdtTemplateGuid,
+                 0, NULL, 2, NULL, EDT_PROP_NONE, NULL_HINT, NULL);
+
+    ocrGuid_t workEdtTemplateGuid;
+    ocrEdtTemplateCreate(&workEdtTemplateGuid, workEdt, 0, 1);
+
+    ocrGuid_t firstEdtGuid = NULL_GUID;
+    ocrGuid_t prevOutGuid = NULL_GUID;
+    int i = 0;
+    while (i < NB_INSTANCES) {
+        ocrGuid_t workEdtGuid, outGuid;
+        ocrEdtCreate(&workEdtGuid, workEdtTemplateGuid,
+                     0, NULL, 1, NULL, EDT_PROP_NONE, NULL_HINT, &outGuid);
+        if (i == 0) {
+            firstEdtGuid = workEdtGuid;
+        } else {
+            ocrAddDependence(prevOutGuid, workEdtGuid, 0, DB_MODE_NULL);
+        }
+        prevOutGuid = outGuid;
+        i++;
+    }
+    ocrEdtTemplateDestroy(workEdtTemplateGuid);
+    ocrAddDependence(prevOutGuid, terminateEdtGuid, 0, DB_MODE_NULL);
+
+    timestamp_t * dbPtr;
+    ocrGuid_t dbGuid;
+    ocrDbCreate(&dbGuid, (void **)&dbPtr, (sizeof(timestamp_t)*2), 0, NULL_HINT, NO_ALLOC);
+
+    get_time(&dbPtr[0]);
+
+    ocrDbRelease(dbGuid);
+    ocrAddDependence(dbGuid, terminateEdtGuid, 1, DB_MODE_CONST);
+
+    // Start the pipeline
+    ocrAddDependence(NULL_GUID, firstEdtGuid, 0, DB_MODE_NULL);
+    return NULL_GUID;
+}
@@ -0,0 +1,21 @@
+#include "perfs.h"
+#include "ocr.h"
+
+// DESC: Create FAN_OUT producer STICKY events and one consumer EDT depending on all of them
+// TIME: Setting up the dependences between the producer event and consumer EDTs with one ocrAddDependences call
+// FREQ: Done 'NB_ITERS' times
+// NOTE: The driver EDT is a finish EDT to collect created EDTs
+//
+// VARIABLES
+// - NB_ITERS
+// - FAN_OUT
+
+#define PRODUCER_EVENT_TYPE  OCR_EVENT_STICKY_T
+
+#define TIME_SATISFY 0
+#define TIME_CONSUMER_CREATE 0
+#define TIME_ADD_DEP 1
+#define CLEAN_UP_ITERATION 1
+#define ADD_DEP_BULK
+
+#include "event1FanInEdt.ctpl"
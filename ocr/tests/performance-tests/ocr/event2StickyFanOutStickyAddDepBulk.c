@@ -0,0 +1,22 @@
+#include "perfs.h"
+#include "ocr.h"
+
+// DESC: Create a producer event and 'FAN_OUT' consumer event depending on it.
+// TIME: Setting up the dependence between producer and consumer with one ocrAddDependences call
+// FREQ: 'FAN_OUT' dependences done NB_ITERS' times.
+//
+// VARIABLES
+// - NB_ITERS
+// - FAN_OUT
+
+#define PRODUCER_EVENT_TYPE  OCR_EVENT_STICKY_T
+#define CONSUMER_EVENT_TYPE  OCR_EVENT_STICKY_T
+#define CLEAN_UP_ITERATION   1
+#define ADD_DEP_BULK
+
+#define TIME_SATISFY 0
+#define TIME_ADD_DEP 1
+#define TIME_CONSUMER_CREATE 0
+#define TIME_CONSUMER_DESTRUCT 0
+
+#include "event2FanOutEvent.ctpl"
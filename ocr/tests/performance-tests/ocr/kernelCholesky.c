@@ -0,0 +1,220 @@
+#include "perfs.h"
+#include "ocr.h"
+#include <math.h>
+
+// DESC: Tiled Cholesky factorization of a symmetric positive definite
+//       matrix made of NB_TILES x NB_TILES tiles of TILE_SZ x TILE_SZ doubles.
+//       Each tile of the lower half is a DB. Each POTRF, TRSM, SYRK and GEMM
+//       task depends on the version of the tiles it uses through a sticky
+//       event satisfied with the tile's DB by the task that produced it.
+//       The factor is checked against the input matrix at the end.
+// TIME: From the creation of the task graph to the completion of all tasks
+// FREQ: The factorization is done once, throughput is in floating point operations
+//
+// VARIABLES:
+// - NB_TILES
+// - TILE_SZ
+
+#define MATRIX_SZ (NB_TILES * TILE_SZ)
+
+// Index of tile (i,j), j <= i, in the lower half
+#define TILE_IDX(i, j) (((i) * ((i) + 1)) / 2 + (j))
+#define NB_LOWER_TILES TILE_IDX(NB_TILES, 0)
+
+// Event satisfied with version 'v' of tile (i,j), 1 <= v <= j+1
+#define EVT_IDX(i, j, v) ((((i) * NB_TILES) + (j)) * (NB_TILES + 1) + (v))
+#define NB_EVTS (NB_TILES * NB_TILES * (NB_TILES + 1))
+
+static double matrixInit(u64 r, u64 c) {
+    // Symmetric and diagonally dominant
+    return (r == c) ? (double) MATRIX_SZ : 1.0 / (1.0 + (double) ((r > c) ? r - c : c - r));
+}
+
+ocrGuid_t potrfEdt(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[]) {
+    double * a = (double *) depv[0].ptr;
+    u64 r, c, p;
+    for (c = 0; c < TILE_SZ; c++) {
+        double d = a[c*TILE_SZ+c];
+        for (p = 0; p < c; p++)
+            d -= a[c*TILE_SZ+p] * a[c*TILE_SZ+p];
+        d = sqrt(d);
+        a[c*TILE_SZ+c] = d;
+        for (r = c + 1; r < TILE_SZ; r++) {
+            double v = a[r*TILE_SZ+c];
+            for (p = 0; p < c; p++)
+                v -= a[r*TILE_SZ+p] * a[c*TILE_SZ+p];
+            a[r*TILE_SZ+c] = v / d;
+        }
+    }
+    ocrDbRelease(depv[0].guid);
+    ocrEventSatisfy(*((ocrGuid_t *) paramv), depv[0].guid);
+    return NULL_GUID;
+}
+
+// A(i,k) = A(i,k) * L(k,k)^-T
+ocrGuid_t trsmEdt(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[]) {
+    double * a = (double *) depv[0].ptr;
+    double * l = (double *) depv[1].ptr;
+    u64 r, c, p;
+    for (r = 0; r < TILE_SZ; r++) {
+        for (c = 0; c < TILE_SZ; c++) {
+            double v = a[r*TILE_SZ+c];
+            for (p = 0; p < c; p++)
+                v -= a[r*TILE_SZ+p] * l[c*TILE_SZ+p];
+            a[r*TILE_SZ+c] = v / l[c*TILE_SZ+c];
+        }
+    }
+    ocrDbRelease(depv[0].guid);
+    ocrEventSatisfy(*((ocrGuid_t *) paramv), depv[0].guid);
+    return NULL_GUID;
+}
+
+// A(i,j) -= L(i,k) * L(j,k)^T, only the lower half when i == j
+ocrGuid_t gemmEdt(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[]) {
+    double * a = (double *) depv[0].ptr;
+    double * li = (double *) depv[1].ptr;
+    double * lj = (depc == 3) ? (double *) depv[2].ptr : li;
+    u64 r, c, p;
+    for (r = 0; r < TILE_SZ; r++) {
+        u64 cMax = (depc == 3) ? TILE_SZ : r + 1;
+        for (c = 0; c < cMax; c++) {
+            double v = 0;
+            for (p = 0; p < TILE_SZ; p++)
+                v += li[r*TILE_SZ+p] * lj[c*TILE_SZ+p];
+            a[r*TILE_SZ+c] -= v;
+        }
+    }
+    ocrDbRelease(depv[0].guid);
+    ocrEventSatisfy(*((ocrGuid_t *) paramv), depv[0].guid);
+    return NULL_GUID;
+}
+
+ocrGuid_t terminateEdt(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[]) {
+    timestamp_t * timers = (timestamp_t *) depv[NB_LOWER_TILES].ptr;
+    ocrGuid_t * evts = (ocrGuid_t *) depv[NB_LOWER_TILES+1].ptr;
+    get_time(&timers[1]);
+
+    // Check that L * L^T matches the input on the lower half
+    double maxErr = 0;
+    u64 r, c, p;
+    for (r = 0; r < MATRIX_SZ; r++) {
+        for (c = 0; c <= r; c++) {
+            double v = 0;
+            for (p = 0; p <= c; p++) {
+                double * tr = (double *) depv[TILE_IDX(r/TILE_SZ, p/TILE_SZ)].ptr;
+                double * tc = (double *) depv[TILE_IDX(c/TILE_SZ, p/TILE_SZ)].ptr;
+                v += tr[(r%TILE_SZ)*TILE_SZ+(p%TILE_SZ)] * tc[(c%TILE_SZ)*TILE_SZ+(p%TILE_SZ)];
+            }
+            v = fabs(v - matrixInit(r, c));
+            if (v > maxErr)
+                maxErr = v;
+        }
+    }
+    printf("Matrix size %"PRIu64" (%"PRIu64" tiles of %"PRIu64"), max error %e\n",
+           (u64) MATRIX_SZ, (u64) NB_TILES, (u64) TILE_SZ, maxErr);
+    if (maxErr > 1e-12 * MATRIX_SZ) {
+        PRINTF("ERROR: Cholesky verification failed\n");
+        ocrAbort(1);
+        return NULL_GUID;
+    }
+
+    u64 i, j, v;
+    for (i = 0; i < NB_TILES; i++)
+        for (j = 0; j <= i; j++)
+            for (v = 1; v <= j + 1; v++)
+                ocrEventDestroy(evts[EVT_IDX(i, j, v)]);
+    summary_throughput_timer(&timers[0], &timers[1],
+                             ((u64) MATRIX_SZ * MATRIX_SZ * MATRIX_SZ) / 3);
+    ocrShutdown();
+    return NULL_GUID;
+}
+
+ocrGuid_t mainEdt(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[]) {
+    ocrGuid_t tiles[NB_LOWER_TILES];
+    u64 i, j, k, r, c;
+
+    // Create and initialize the tiles of the lower half
+    for (i = 0; i < NB_TILES; i++) {
+        for (j = 0; j <= i; j++) {
+            double * a;
+            ocrDbCreate(&tiles[TILE_IDX(i, j)], (void **)&a, sizeof(double) * TILE_SZ * TILE_SZ,
+                        0, NULL_HINT, NO_ALLOC);
+            for (r = 0; r < TILE_SZ; r++)
+                for (c = 0; c < TILE_SZ; c++)
+                    a[r*TILE_SZ+c] = matrixInit(i*TILE_SZ+r, j*TILE_SZ+c);
+            ocrDbRelease(tiles[TILE_IDX(i, j)]);
+        }
+    }
+
+    ocrGuid_t * evts;
+    ocrGuid_t evtsGuid;
+    ocrDbCreate(&evtsGuid, (void **)&evts, sizeof(ocrGuid_t) * NB_EVTS, 0, NULL_HINT, NO_ALLOC);
+    for (i = 0; i < NB_TILES; i++)
+        for (j = 0; j <= i; j++)
+            for (k = 1; k <= j + 1; k++)
+                ocrEventCreate(&evts[EVT_IDX(i, j, k)], OCR_EVENT_STICKY_T, EVT_PROP_TAKES_ARG);
+
+    timestamp_t * timers;
+    ocrGuid_t timersGuid;
+    ocrDbCreate(&timersGuid, (void **)&timers, sizeof(timestamp_t) * 2, 0, NULL_HINT, NO_ALLOC);
+
+    ocrGuid_t terminateTemplGuid;
+    ocrEdtTemplateCreate(&terminateTemplGuid, terminateEdt, 0, NB_LOWER_TILES + 2);
+    ocrGuid_t terminateGuid;
+    ocrEdtCreate(&terminateGuid, terminateTemplGuid, 0, NULL, NB_LOWER_TILES + 2, NULL,
+                 EDT_PROP_NONE, NULL_HINT, NULL);
+    ocrEdtTemplateDestroy(terminateTemplGuid);
+
+    ocrGuid_t potrfTemplGuid, trsmTemplGuid, syrkTemplGuid, gemmTemplGuid;
+    u32 paramcGuid = sizeof(ocrGuid_t) / sizeof(u64);
+    ocrEdtTemplateCreate(&potrfTemplGuid, potrfEdt, paramcGuid, 1);
+    ocrEdtTemplateCreate(&trsmTemplGuid, trsmEdt, paramcGuid, 2);
+    ocrEdtTemplateCreate(&syrkTemplGuid, gemmEdt, paramcGuid, 2);
+    ocrEdtTemplateCreate(&gemmTemplGuid, gemmEdt, paramcGuid, 3);
+
+    // Version 'v' of tile (i,j) is produced by step v-1, version 0 is the DB itself
+#define TILE_VER(i, j, v) (((v) == 0) ? tiles[TILE_IDX(i, j)] : evts[EVT_IDX(i, j, v)])
+
+    get_time(&timers[0]);
+    for (k = 0; k < NB_TILES; k++) {
+        ocrGuid_t edtGuid;
+        ocrEdtCreate(&edtGuid, potrfTemplGuid, paramcGuid, (u64 *) &evts[EVT_IDX(k, k, k+1)],
+                     1, NULL, EDT_PROP_NONE, NULL_HINT, NULL);
+        ocrAddDependence(TILE_VER(k, k, k), edtGuid, 0, DB_MODE_RW);
+        for (i = k + 1; i < NB_TILES; i++) {
+            ocrEdtCreate(&edtGuid, trsmTemplGuid, paramcGuid, (u64 *) &evts[EVT_IDX(i, k, k+1)],
+                         2, NULL, EDT_PROP_NONE, NULL_HINT, NULL);
+            ocrAddDependence(TILE_VER(i, k, k), edtGuid, 0, DB_MODE_RW);
+            ocrAddDependence(TILE_VER(k, k, k+1), edtGuid, 1, DB_MODE_CONST);
+        }
+        for (i = k + 1; i < NB_TILES; i++) {
+            for (j = k + 1; j <= i; j++) {
+                if (i == j) {
+                    ocrEdtCreate(&edtGuid, syrkTemplGuid, paramcGuid, (u64 *) &evts[EVT_IDX(i, i, k+1)],
+                                 2, NULL, EDT_PROP_NONE, NULL_HINT, NULL);
+                } else {
+                    ocrEdtCreate(&edtGuid, gemmTemplGuid, paramcGuid, (u64 *) &evts[EVT_IDX(i, j, k+1)],
+                                 3, NULL, EDT_PROP_NONE, NULL_HINT, NULL);
+                    ocrAddDependence(TILE_VER(j, k, k+1), edtGuid, 2, DB_MODE_CONST);
+                }
+                ocrAddDependence(TILE_VER(i, k, k+1), edtGuid, 1, DB_MODE_CONST);
+                ocrAddDependence(TILE_VER(i, j, k), edtGuid, 0, DB_MODE_RW);
+            }
+        }
+    }
+
+    for (i = 0; i < NB_TILES; i++)
+        for (j = 0; j <= i; j++)
+            ocrAddDependence(TILE_VER(i, j, j+1), terminateGuid, TILE_IDX(i, j), DB_MODE_CONST);
+#undef TILE_VER
+
+    ocrEdtTemplateDestroy(potrfTemplGuid);
+    ocrEdtTemplateDestroy(trsmTemplGuid);
+    ocrEdtTemplateDestroy(syrkTemplGuid);
+    ocrEdtTemplateDestroy(gemmTemplGuid);
+    ocrDbRelease(evtsGuid);
+    ocrDbRelease(timersGuid);
+    ocrAddDependence(timersGuid, terminateGuid, NB_LOWER_TILES, DB_MODE_RW);
+    ocrAddDependence(evtsGuid, terminateGuid, NB_LOWER_TILES+1, DB_MODE_CONST);
+    return NULL_GUID;
+}
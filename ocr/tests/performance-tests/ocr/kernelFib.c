@@ -0,0 +1,130 @@
+#include "perfs.h"
+#include "ocr.h"
+
+// DESC: Recursive Fibonacci spawn tree. Each fib(n) EDT with n >= 2 spawns
+//       fib(n-1), fib(n-2) and a sum EDT; children hand their result to the
+//       sum EDT in a DB through a once event. The tree is unbalanced, which
+//       exercises work distribution on fine-grain tasks. The result is
+//       checked at the end.
+// TIME: Execution of the whole tree
+// FREQ: The tree is created once, throughput is in EDTs
+//
+// VARIABLES:
+// - FIB_N
+
+// Layout of the parameters of fibEdt: n, then the event to satisfy
+// with the result and the templates of the fib and sum EDTs
+#define PARAM_N 0
+#define PARAM_GUIDS 1
+#define GUID_EVT 0
+#define GUID_FIB_TEMPL 1
+#define GUID_SUM_TEMPL 2
+#define FIB_PARAMC (PARAM_GUIDS + 3 * sizeof(ocrGuid_t) / sizeof(u64))
+#define SUM_PARAMC (sizeof(ocrGuid_t) / sizeof(u64))
+
+static u64 fibSeq(u64 n) {
+    u64 a = 0, b = 1;
+    while (n--) {
+        u64 c = a + b;
+        a = b;
+        b = c;
+    }
+    return a;
+}
+
+// Number of EDTs executed to compute fib(n)
+static u64 fibEdtCount(u64 n) {
+    return (n < 2) ? 1 : (2 + fibEdtCount(n-1) + fibEdtCount(n-2));
+}
+
+static void satisfyWithValue(ocrGuid_t evtGuid, u64 value) {
+    u64 * result;
+    ocrGuid_t resultGuid;
+    ocrDbCreate(&resultGuid, (void **)&result, sizeof(u64), 0, NULL_HINT, NO_ALLOC);
+    *result = value;
+    ocrDbRelease(resultGuid);
+    ocrEventSatisfy(evtGuid, resultGuid);
+}
+
+ocrGuid_t sumEdt(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[]) {
+    u64 value = *((u64 *) depv[0].ptr) + *((u64 *) depv[1].ptr);
+    ocrDbDestroy(depv[0].guid);
+    ocrDbDestroy(depv[1].guid);
+    satisfyWithValue(*((ocrGuid_t *) paramv), value);
+    return NULL_GUID;
+}
+
+ocrGuid_t fibEdt(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[]) {
+    u64 n = paramv[PARAM_N];
+    ocrGuid_t * guids = (ocrGuid_t *) &paramv[PARAM_GUIDS];
+    if (n < 2) {
+        satisfyWithValue(guids[GUID_EVT], n);
+        return NULL_GUID;
+    }
+    ocrGuid_t sumGuid;
+    ocrEdtCreate(&sumGuid, guids[GUID_SUM_TEMPL], SUM_PARAMC, (u64 *) &guids[GUID_EVT],
+                 2, NULL, EDT_PROP_NONE, NULL_HINT, NULL);
+    u64 nparamv[FIB_PARAMC];
+    ocrGuid_t * nguids = (ocrGuid_t *) &nparamv[PARAM_GUIDS];
+    nguids[GUID_FIB_TEMPL] = guids[GUID_FIB_TEMPL];
+    nguids[GUID_SUM_TEMPL] = guids[GUID_SUM_TEMPL];
+    u32 i;
+    for (i = 0; i < 2; i++) {
+        ocrGuid_t childGuid;
+        ocrEventCreate(&nguids[GUID_EVT], OCR_EVENT_ONCE_T, EVT_PROP_TAKES_ARG);
+        ocrAddDependence(nguids[GUID_EVT], sumGuid, i, DB_MODE_CONST);
+        nparamv[PARAM_N] = n - 1 - i;
+        ocrEdtCreate(&childGuid, guids[GUID_FIB_TEMPL], FIB_PARAMC, nparamv,
+                     0, NULL, EDT_PROP_NONE, NULL_HINT, NULL);
+    }
+    return NULL_GUID;
+}
+
+ocrGuid_t terminateEdt(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[]) {
+    u64 value = *((u64 *) depv[0].ptr);
+    timestamp_t * timers = (timestamp_t *) depv[1].ptr;
+    ocrGuid_t * templs = (ocrGuid_t *) paramv;
+    get_time(&timers[1]);
+    PRINTF("fib(%"PRIu64") = %"PRIu64"\n", (u64) FIB_N, value);
+    if (value != fibSeq(FIB_N)) {
+        PRINTF("ERROR: Fibonacci verification failed, expected %"PRIu64"\n", fibSeq(FIB_N));
+        ocrAbort(1);
+        return NULL_GUID;
+    }
+    ocrEdtTemplateDestroy(templs[0]);
+    ocrEdtTemplateDestroy(templs[1]);
+    ocrDbDestroy(depv[0].guid);
+    summary_throughput_timer(&timers[0], &timers[1], fibEdtCount(FIB_N));
+    ocrShutdown();
+    return NULL_GUID;
+}
+
+ocrGuid_t mainEdt(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[]) {
+    u64 nparamv[FIB_PARAMC];
+    ocrGuid_t * nguids = (ocrGuid_t *) &nparamv[PARAM_GUIDS];
+    ocrEdtTemplateCreate(&nguids[GUID_FIB_TEMPL], fibEdt, FIB_PARAMC, 0);
+    ocrEdtTemplateCreate(&nguids[GUID_SUM_TEMPL], sumEdt, SUM_PARAMC, 2);
+
+    timestamp_t * timers;
+    ocrGuid_t timersGuid;
+    ocrDbCreate(&timersGuid, (void **)&timers, sizeof(timestamp_t) * 2, 0, NULL_HINT, NO_ALLOC);
+
+    // The terminate EDT destroys the two templates
+    ocrGuid_t terminateTemplGuid, terminateGuid;
+    ocrEdtTemplateCreate(&terminateTemplGuid, terminateEdt, 2 * SUM_PARAMC, 2);
+    ocrEdtCreate(&terminateGuid, terminateTemplGuid, 2 * SUM_PARAMC, (u64 *) &nguids[GUID_FIB_TEMPL],
+                 2, NULL, EDT_PROP_NONE, NULL_HINT, NULL);
+    ocrEdtTemplateDestroy(terminateTemplGuid);
+
+    ocrGuid_t rootGuid;
+    ocrEventCreate(&nguids[GUID_EVT], OCR_EVENT_ONCE_T, EVT_PROP_TAKES_ARG);
+    ocrAddDependence(nguids[GUID_EVT], terminateGuid, 0, DB_MODE_RW);
+
+    nparamv[PARAM_N] = FIB_N;
+    get_time(&timers[0]);
+    ocrEdtCreate(&rootGuid, nguids[GUID_FIB_TEMPL], FIB_PARAMC, nparamv,
+                 0, NULL, EDT_PROP_NONE, NULL_HINT, NULL);
+    ocrDbRelease(timersGuid);
+    ocrAddDependence(timersGuid, terminateGuid, 1, DB_MODE_RW);
+    return NULL_GUID;
+}
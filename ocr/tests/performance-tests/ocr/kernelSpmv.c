@@ -0,0 +1,215 @@
+#include "perfs.h"
+#include "ocr.h"
+
+// DESC: Repeated sparse matrix-vector products x(k+1) = A.x(k) on a banded
+//       matrix of SPMV_ROWS rows with SPMV_NNZ non-zeros each, split in
+//       NB_TILES row blocks. Each block of the matrix is a DB in CSR form and
+//       each block of x is double buffered. The product of a block only needs
+//       the neighboring blocks of the previous iteration, so iterations
+//       pipeline across blocks without any global synchronization. The vector
+//       is checked against a sequential computation at the end.
+// TIME: From the creation of the task graph to the completion of the last iteration
+// FREQ: Done once for 'NB_ITERS' iterations, throughput is in multiply-adds
+//
+// VARIABLES:
+// - SPMV_ROWS
+// - SPMV_NNZ
+// - NB_TILES
+// - NB_ITERS
+
+#define BLOCK_ROWS (SPMV_ROWS / NB_TILES)
+#define BLOCK_NNZ (BLOCK_ROWS * SPMV_NNZ)
+
+// Layout of the DB holding the GUIDs to clean up
+#define GUID_MAT(b) (b)
+#define GUID_BUF(b, p) (NB_TILES + (b) * 2 + (p))
+// Event satisfied with block 'b' of x(k), 1 <= k <= NB_ITERS
+#define GUID_EVT(k, b) (3 * NB_TILES + ((k) - 1) * NB_TILES + (b))
+#define NB_GUIDS GUID_EVT(NB_ITERS + 1, 0)
+
+// Slots of the block EDTs: the matrix block, the blocks b-1, b and b+1
+// of x(k) and the buffer for block b of x(k+1)
+#define SLOT_MAT 0
+#define SLOT_X 1
+#define SLOT_OUT 4
+#define BLOCK_DEPC 5
+
+// Fills row 'r' of the matrix: columns are within BLOCK_ROWS of the
+// diagonal and the values of a row sum to one
+static void spmvRow(u64 r, double * vals, u64 * cols) {
+    u64 p, sum = 0;
+    u64 w[SPMV_NNZ];
+    for (p = 0; p < SPMV_NNZ; p++) {
+        u64 h = (r * 2654435761ULL) ^ ((p + 1) * 40503ULL);
+        h ^= h >> 13;
+        h *= 0x5bd1e995ULL;
+        h ^= h >> 15;
+        s64 c = (s64) r + (s64) (h % (2 * BLOCK_ROWS + 1)) - (s64) BLOCK_ROWS;
+        cols[p] = (c < 0) ? 0 : ((c >= SPMV_ROWS) ? SPMV_ROWS - 1 : c);
+        w[p] = 1 + ((h >> 8) % 97);
+        sum += w[p];
+    }
+    for (p = 0; p < SPMV_NNZ; p++)
+        vals[p] = ((double) w[p]) / ((double) sum);
+}
+
+static double spmvInit(u64 r) {
+    return (double) (r % 7);
+}
+
+ocrGuid_t blockEdt(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[]) {
+    u64 b = paramv[0];
+    double * vals = (double *) depv[SLOT_MAT].ptr;
+    u64 * cols = (u64 *) (vals + BLOCK_NNZ);
+    double * out = (double *) depv[SLOT_OUT].ptr;
+    u64 r, p;
+    for (r = 0; r < BLOCK_ROWS; r++) {
+        double v = 0;
+        for (p = r * SPMV_NNZ; p < (r + 1) * SPMV_NNZ; p++) {
+            u64 c = cols[p];
+            // Offset of the block of the column, relative to b-1
+            double * x = (double *) depv[SLOT_X + (c / BLOCK_ROWS) + 1 - b].ptr;
+            v += vals[p] * x[c % BLOCK_ROWS];
+        }
+        out[r] = v;
+    }
+    ocrDbRelease(depv[SLOT_OUT].guid);
+    ocrEventSatisfy(*((ocrGuid_t *) &paramv[1]), depv[SLOT_OUT].guid);
+    return NULL_GUID;
+}
+
+ocrGuid_t terminateEdt(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[]) {
+    timestamp_t * timers = (timestamp_t *) depv[NB_TILES].ptr;
+    ocrGuid_t * guids = (ocrGuid_t *) depv[NB_TILES+1].ptr;
+    get_time(&timers[1]);
+
+    // Sequential reference with the same operation order
+    double * vals = (double *) malloc(sizeof(double) * SPMV_ROWS * SPMV_NNZ);
+    u64 * cols = (u64 *) malloc(sizeof(u64) * SPMV_ROWS * SPMV_NNZ);
+    double * x = (double *) malloc(sizeof(double) * 2 * SPMV_ROWS);
+    u64 r, p, k, b;
+    for (r = 0; r < SPMV_ROWS; r++) {
+        spmvRow(r, &vals[r * SPMV_NNZ], &cols[r * SPMV_NNZ]);
+        x[r] = spmvInit(r);
+    }
+    for (k = 0; k < NB_ITERS; k++) {
+        double * cur = x + (k % 2) * SPMV_ROWS;
+        double * next = x + ((k + 1) % 2) * SPMV_ROWS;
+        for (r = 0; r < SPMV_ROWS; r++) {
+            double v = 0;
+            for (p = r * SPMV_NNZ; p < (r + 1) * SPMV_NNZ; p++)
+                v += vals[p] * cur[cols[p]];
+            next[r] = v;
+        }
+    }
+
+    double maxErr = 0;
+    double * ref = x + (NB_ITERS % 2) * SPMV_ROWS;
+    for (b = 0; b < NB_TILES; b++) {
+        double * xb = (double *) depv[b].ptr;
+        for (r = 0; r < BLOCK_ROWS; r++) {
+            double v = xb[r] - ref[b * BLOCK_ROWS + r];
+            v = (v < 0) ? -v : v;
+            if (v > maxErr)
+                maxErr = v;
+        }
+    }
+    free(vals);
+    free(cols);
+    free(x);
+    printf("Matrix of %"PRIu64" rows (%"PRIu64" blocks), %"PRIu64" non-zeros per row, %"PRIu64" iterations, max error %e\n",
+           (u64) SPMV_ROWS, (u64) NB_TILES, (u64) SPMV_NNZ, (u64) NB_ITERS, maxErr);
+    if (maxErr > 1e-12) {
+        PRINTF("ERROR: SpMV verification failed\n");
+        ocrAbort(1);
+        return NULL_GUID;
+    }
+
+    for (b = 0; b < NB_TILES; b++) {
+        ocrDbDestroy(guids[GUID_MAT(b)]);
+        ocrDbDestroy(guids[GUID_BUF(b, 0)]);
+        ocrDbDestroy(guids[GUID_BUF(b, 1)]);
+        for (k = 1; k <= NB_ITERS; k++)
+            ocrEventDestroy(guids[GUID_EVT(k, b)]);
+    }
+    ocrDbDestroy(depv[NB_TILES+1].guid);
+    summary_throughput_timer(&timers[0], &timers[1], ((u64) SPMV_ROWS * SPMV_NNZ) * NB_ITERS);
+    ocrShutdown();
+    return NULL_GUID;
+}
+
+ocrGuid_t mainEdt(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[]) {
+    ASSERT((SPMV_ROWS % NB_TILES) == 0);
+    ocrGuid_t * guids;
+    ocrGuid_t guidsGuid;
+    ocrDbCreate(&guidsGuid, (void **)&guids, sizeof(ocrGuid_t) * NB_GUIDS, 0, NULL_HINT, NO_ALLOC);
+
+    u64 b, k, r;
+    for (b = 0; b < NB_TILES; b++) {
+        double * vals, * x;
+        ocrDbCreate(&guids[GUID_MAT(b)], (void **)&vals, (sizeof(double) + sizeof(u64)) * BLOCK_NNZ,
+                    0, NULL_HINT, NO_ALLOC);
+        u64 * cols = (u64 *) (vals + BLOCK_NNZ);
+        for (r = 0; r < BLOCK_ROWS; r++)
+            spmvRow(b * BLOCK_ROWS + r, &vals[r * SPMV_NNZ], &cols[r * SPMV_NNZ]);
+        ocrDbRelease(guids[GUID_MAT(b)]);
+        ocrDbCreate(&guids[GUID_BUF(b, 0)], (void **)&x, sizeof(double) * BLOCK_ROWS, 0, NULL_HINT, NO_ALLOC);
+        for (r = 0; r < BLOCK_ROWS; r++)
+            x[r] = spmvInit(b * BLOCK_ROWS + r);
+        ocrDbRelease(guids[GUID_BUF(b, 0)]);
+        ocrDbCreate(&guids[GUID_BUF(b, 1)], (void **)&x, sizeof(double) * BLOCK_ROWS, 0, NULL_HINT, NO_ALLOC);
+        ocrDbRelease(guids[GUID_BUF(b, 1)]);
+        for (k = 1; k <= NB_ITERS; k++)
+            ocrEventCreate(&guids[GUID_EVT(k, b)], OCR_EVENT_STICKY_T, EVT_PROP_TAKES_ARG);
+    }
+
+    timestamp_t * timers;
+    ocrGuid_t timersGuid;
+    ocrDbCreate(&timersGuid, (void **)&timers, sizeof(timestamp_t) * 2, 0, NULL_HINT, NO_ALLOC);
+
+    ocrGuid_t terminateTemplGuid, terminateGuid;
+    ocrEdtTemplateCreate(&terminateTemplGuid, terminateEdt, 0, NB_TILES + 2);
+    ocrEdtCreate(&terminateGuid, terminateTemplGuid, 0, NULL, NB_TILES + 2, NULL,
+                 EDT_PROP_NONE, NULL_HINT, NULL);
+    ocrEdtTemplateDestroy(terminateTemplGuid);
+
+    // Block b of x(k) is the initial buffer for k == 0, the event satisfied by iteration k-1 otherwise
+#define X_VER(k, b) (((k) == 0) ? guids[GUID_BUF(b, 0)] : guids[GUID_EVT(k, b)])
+
+    ocrGuid_t blockTemplGuid;
+    u64 nparamv[1 + sizeof(ocrGuid_t) / sizeof(u64)];
+    u32 blockParamc = 1 + sizeof(ocrGuid_t) / sizeof(u64);
+    ocrEdtTemplateCreate(&blockTemplGuid, blockEdt, blockParamc, BLOCK_DEPC);
+    get_time(&timers[0]);
+    // Each block depends on the three blocks of the previous iteration
+    // that last read the buffer it overwrites
+    for (k = 0; k < NB_ITERS; k++) {
+        for (b = 0; b < NB_TILES; b++) {
+            ocrGuid_t edtGuid;
+            s64 n;
+            nparamv[0] = b;
+            *((ocrGuid_t *) &nparamv[1]) = guids[GUID_EVT(k + 1, b)];
+            ocrEdtCreate(&edtGuid, blockTemplGuid, blockParamc, nparamv, BLOCK_DEPC, NULL,
+                         EDT_PROP_NONE, NULL_HINT, NULL);
+            ocrAddDependence(guids[GUID_MAT(b)], edtGuid, SLOT_MAT, DB_MODE_CONST);
+            ocrAddDependence(guids[GUID_BUF(b, (k + 1) % 2)], edtGuid, SLOT_OUT, DB_MODE_RW);
+            for (n = -1; n <= 1; n++) {
+                s64 nb = (s64) b + n;
+                if ((nb < 0) || (nb >= NB_TILES))
+                    ocrAddDependence(NULL_GUID, edtGuid, SLOT_X + 1 + n, DB_MODE_NULL);
+                else
+                    ocrAddDependence(X_VER(k, nb), edtGuid, SLOT_X + 1 + n, DB_MODE_CONST);
+            }
+        }
+    }
+#undef X_VER
+    ocrEdtTemplateDestroy(blockTemplGuid);
+
+    for (b = 0; b < NB_TILES; b++)
+        ocrAddDependence(guids[GUID_EVT(NB_ITERS, b)], terminateGuid, b, DB_MODE_CONST);
+    ocrDbRelease(timersGuid);
+    ocrDbRelease(guidsGuid);
+    ocrAddDependence(timersGuid, terminateGuid, NB_TILES, DB_MODE_RW);
+    ocrAddDependence(guidsGuid, terminateGuid, NB_TILES + 1, DB_MODE_CONST);
+    return NULL_GUID;
+}
@@ -0,0 +1,264 @@
+#include "perfs.h"
+#include "ocr.h"
+#include "extensions/ocr-labeling.h"
+
+// DESC: Jacobi iterations of a 5-point 2D stencil over a grid of
+//       NB_TILES x NB_TILES tiles of TILE_SZ x TILE_SZ doubles. Each tile is a DB
+//       updated by one EDT per iteration. Tiles exchange their edges through
+//       halo DBs satisfied on sticky events whose GUIDs are derived from
+//       (iteration, tile, side) with a labeled GUID range, so producers and
+//       consumers never exchange GUIDs. The grid is checked against a
+//       sequential computation at the end.
+// TIME: From the creation of the first iteration to the completion of the last one
+// FREQ: Done once for 'NB_ITERS' iterations, throughput is in cell updates
+//
+// VARIABLES:
+// - NB_TILES
+// - TILE_SZ
+// - NB_ITERS
+//
+// CONFIG: CFGARG_GUID=LABELED
+
+#define GRID_SZ (NB_TILES * TILE_SZ)
+
+// Value of the cells around the grid
+#define BOUNDARY_VALUE 1.0
+
+// Sides of a tile; a halo received on one side was sent from the opposite one
+#define SIDE_N 0
+#define SIDE_S 1
+#define SIDE_W 2
+#define SIDE_E 3
+#define NB_SIDES 4
+#define OPPOSITE(s) ((s) ^ 1)
+
+static const s64 sideDi[NB_SIDES] = { -1, 1, 0, 0 };
+static const s64 sideDj[NB_SIDES] = { 0, 0, -1, 1 };
+
+// Label of the halo event tile (i,j) receives on side 's' for iteration 't'.
+// Iteration NB_ITERS labels the events satisfied with the final tiles.
+#define EVT_IDX(t, i, j, s) (((((u64)(t)) * NB_TILES + (i)) * NB_TILES + (j)) * NB_SIDES + (s))
+#define NB_EVTS EVT_IDX(NB_ITERS + 1, 0, 0, 0)
+
+// Layout of the parameters of a tile EDT
+#define PARAM_T 0
+#define PARAM_I 1
+#define PARAM_J 2
+#define PARAM_RANGE 3
+#define TILE_PARAMC (PARAM_RANGE + sizeof(ocrGuid_t) / sizeof(u64))
+
+static ocrGuid_t haloEvent(ocrGuid_t rangeGuid, u64 idx, bool create) {
+    ocrGuid_t evtGuid;
+    ocrGuidFromIndex(&evtGuid, rangeGuid, idx);
+    if (create) {
+        // Whichever of the producer or the consumer gets here first creates the event
+        u8 ret = ocrEventCreate(&evtGuid, OCR_EVENT_STICKY_T, GUID_PROP_CHECK | EVT_PROP_TAKES_ARG);
+        ASSERT((ret == 0) || (ret == OCR_EGUIDEXISTS));
+    }
+    return evtGuid;
+}
+
+static bool hasNeighbor(s64 i, s64 j, u32 side) {
+    s64 ni = i + sideDi[side];
+    s64 nj = j + sideDj[side];
+    return (ni >= 0) && (ni < NB_TILES) && (nj >= 0) && (nj < NB_TILES);
+}
+
+static double stencilPoint(double c, double n, double s, double w, double e) {
+    return 0.2 * (c + n + s + w + e);
+}
+
+ocrGuid_t tileEdt(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[]) {
+    u64 t = paramv[PARAM_T];
+    s64 i = paramv[PARAM_I];
+    s64 j = paramv[PARAM_J];
+    ocrGuid_t rangeGuid = *((ocrGuid_t *) &paramv[PARAM_RANGE]);
+    double * cur = ((double *) depv[0].ptr) + (t % 2) * TILE_SZ * TILE_SZ;
+    double * next = ((double *) depv[0].ptr) + ((t + 1) % 2) * TILE_SZ * TILE_SZ;
+    double halos[NB_SIDES][TILE_SZ];
+    u64 r, c;
+    u32 s;
+
+    // Neighbors all start at zero, cells out of the grid keep the boundary value
+    for (s = 0; s < NB_SIDES; s++) {
+        if (!hasNeighbor(i, j, s) || (t == 0)) {
+            double v = hasNeighbor(i, j, s) ? 0.0 : BOUNDARY_VALUE;
+            for (r = 0; r < TILE_SZ; r++)
+                halos[s][r] = v;
+        } else {
+            double * halo = (double *) depv[1+s].ptr;
+            for (r = 0; r < TILE_SZ; r++)
+                halos[s][r] = halo[r];
+            ocrDbDestroy(depv[1+s].guid);
+            ocrEventDestroy(haloEvent(rangeGuid, EVT_IDX(t, i, j, s), false));
+        }
+    }
+
+    for (r = 0; r < TILE_SZ; r++) {
+        for (c = 0; c < TILE_SZ; c++) {
+            double n = (r == 0) ? halos[SIDE_N][c] : cur[(r-1)*TILE_SZ+c];
+            double so = (r == TILE_SZ-1) ? halos[SIDE_S][c] : cur[(r+1)*TILE_SZ+c];
+            double w = (c == 0) ? halos[SIDE_W][r] : cur[r*TILE_SZ+c-1];
+            double e = (c == TILE_SZ-1) ? halos[SIDE_E][r] : cur[r*TILE_SZ+c+1];
+            next[r*TILE_SZ+c] = stencilPoint(cur[r*TILE_SZ+c], n, so, w, e);
+        }
+    }
+
+    ocrDbRelease(depv[0].guid);
+    if ((t + 1) == NB_ITERS) {
+        ocrEventSatisfy(haloEvent(rangeGuid, EVT_IDX(NB_ITERS, i, j, 0), true), depv[0].guid);
+        return NULL_GUID;
+    }
+
+    // Send the edges of the new values to the neighbors
+    for (s = 0; s < NB_SIDES; s++) {
+        if (!hasNeighbor(i, j, s))
+            continue;
+        double * halo;
+        ocrGuid_t haloGuid;
+        ocrDbCreate(&haloGuid, (void **)&halo, sizeof(double) * TILE_SZ, 0, NULL_HINT, NO_ALLOC);
+        for (r = 0; r < TILE_SZ; r++) {
+            switch (s) {
+            case SIDE_N: halo[r] = next[r]; break;
+            case SIDE_S: halo[r] = next[(TILE_SZ-1)*TILE_SZ+r]; break;
+            case SIDE_W: halo[r] = next[r*TILE_SZ]; break;
+            default: halo[r] = next[r*TILE_SZ+TILE_SZ-1]; break;
+            }
+        }
+        ocrDbRelease(haloGuid);
+        ocrEventSatisfy(haloEvent(rangeGuid, EVT_IDX(t+1, i + sideDi[s], j + sideDj[s], OPPOSITE(s)), true),
+                        haloGuid);
+    }
+
+    // Chain the next iteration of this tile
+    u64 nparamv[TILE_PARAMC];
+    nparamv[PARAM_T] = t + 1;
+    nparamv[PARAM_I] = i;
+    nparamv[PARAM_J] = j;
+    *((ocrGuid_t *) &nparamv[PARAM_RANGE]) = rangeGuid;
+    ocrGuid_t templGuid, edtGuid;
+    ocrEdtTemplateCreate(&templGuid, tileEdt, TILE_PARAMC, 1 + NB_SIDES);
+    ocrEdtCreate(&edtGuid, templGuid, TILE_PARAMC, nparamv, 1 + NB_SIDES, NULL,
+                 EDT_PROP_NONE, NULL_HINT, NULL);
+    ocrEdtTemplateDestroy(templGuid);
+    for (s = 0; s < NB_SIDES; s++) {
+        if (hasNeighbor(i, j, s))
+            ocrAddDependence(haloEvent(rangeGuid, EVT_IDX(t+1, i, j, s), true), edtGuid, 1+s, DB_MODE_CONST);
+        else
+            ocrAddDependence(NULL_GUID, edtGuid, 1+s, DB_MODE_NULL);
+    }
+    ocrAddDependence(depv[0].guid, edtGuid, 0, DB_MODE_RW);
+    return NULL_GUID;
+}
+
+ocrGuid_t terminateEdt(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[]) {
+    ocrGuid_t rangeGuid = *((ocrGuid_t *) paramv);
+    timestamp_t * timers = (timestamp_t *) depv[NB_TILES*NB_TILES].ptr;
+    get_time(&timers[1]);
+
+    // Sequential reference with the same operation order
+    double * ref = (double *) malloc(sizeof(double) * 2 * GRID_SZ * GRID_SZ);
+    u64 r, c, t, i, j;
+    for (r = 0; r < 2 * GRID_SZ * GRID_SZ; r++)
+        ref[r] = 0.0;
+    for (t = 0; t < NB_ITERS; t++) {
+        double * cur = ref + (t % 2) * GRID_SZ * GRID_SZ;
+        double * next = ref + ((t + 1) % 2) * GRID_SZ * GRID_SZ;
+        for (r = 0; r < GRID_SZ; r++) {
+            for (c = 0; c < GRID_SZ; c++) {
+                double n = (r == 0) ? BOUNDARY_VALUE : cur[(r-1)*GRID_SZ+c];
+                double s = (r == GRID_SZ-1) ? BOUNDARY_VALUE : cur[(r+1)*GRID_SZ+c];
+                double w = (c == 0) ? BOUNDARY_VALUE : cur[r*GRID_SZ+c-1];
+                double e = (c == GRID_SZ-1) ? BOUNDARY_VALUE : cur[r*GRID_SZ+c+1];
+                next[r*GRID_SZ+c] = stencilPoint(cur[r*GRID_SZ+c], n, s, w, e);
+            }
+        }
+    }
+
+    double maxErr = 0;
+    double * refFinal = ref + (NB_ITERS % 2) * GRID_SZ * GRID_SZ;
+    for (i = 0; i < NB_TILES; i++) {
+        for (j = 0; j < NB_TILES; j++) {
+            double * tile = ((double *) depv[i*NB_TILES+j].ptr) + (NB_ITERS % 2) * TILE_SZ * TILE_SZ;
+            for (r = 0; r < TILE_SZ; r++) {
+                for (c = 0; c < TILE_SZ; c++) {
+                    double v = tile[r*TILE_SZ+c] - refFinal[(i*TILE_SZ+r)*GRID_SZ+j*TILE_SZ+c];
+                    v = (v < 0) ? -v : v;
+                    if (v > maxErr)
+                        maxErr = v;
+                }
+            }
+            ocrEventDestroy(haloEvent(rangeGuid, EVT_IDX(NB_ITERS, i, j, 0), false));
+            ocrDbDestroy(depv[i*NB_TILES+j].guid);
+        }
+    }
+    free(ref);
+    ocrGuidMapDestroy(rangeGuid);
+    printf("Grid size %"PRIu64" (%"PRIu64" tiles of %"PRIu64"), %"PRIu64" iterations, max error %e\n",
+           (u64) GRID_SZ, (u64) NB_TILES, (u64) TILE_SZ, (u64) NB_ITERS, maxErr);
+    if (maxErr > 1e-12) {
+        PRINTF("ERROR: Stencil verification failed\n");
+        ocrAbort(1);
+        return NULL_GUID;
+    }
+    summary_throughput_timer(&timers[0], &timers[1], ((u64) GRID_SZ * GRID_SZ) * NB_ITERS);
+    ocrShutdown();
+    return NULL_GUID;
+}
+
+ocrGuid_t mainEdt(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[]) {
+    ocrGuid_t rangeGuid;
+    u8 ret = ocrGuidRangeCreate(&rangeGuid, NB_EVTS, GUID_USER_EVENT_STICKY);
+    if (ret) {
+        PRINTF("ERROR: Stencil requires a labeled GUID provider\n");
+        ocrAbort(1);
+        return NULL_GUID;
+    }
+
+    timestamp_t * timers;
+    ocrGuid_t timersGuid;
+    ocrDbCreate(&timersGuid, (void **)&timers, sizeof(timestamp_t) * 2, 0, NULL_HINT, NO_ALLOC);
+
+    ocrGuid_t terminateTemplGuid, terminateGuid;
+    u32 paramcGuid = sizeof(ocrGuid_t) / sizeof(u64);
+    ocrEdtTemplateCreate(&terminateTemplGuid, terminateEdt, paramcGuid, NB_TILES*NB_TILES + 1);
+    ocrEdtCreate(&terminateGuid, terminateTemplGuid, paramcGuid, (u64 *) &rangeGuid,
+                 NB_TILES*NB_TILES + 1, NULL, EDT_PROP_NONE, NULL_HINT, NULL);
+    ocrEdtTemplateDestroy(terminateTemplGuid);
+
+    u64 i, j, r;
+    u32 s;
+    for (i = 0; i < NB_TILES; i++)
+        for (j = 0; j < NB_TILES; j++)
+            ocrAddDependence(haloEvent(rangeGuid, EVT_IDX(NB_ITERS, i, j, 0), true), terminateGuid,
+                             i*NB_TILES+j, DB_MODE_RW);
+
+    ocrGuid_t tileTemplGuid;
+    ocrEdtTemplateCreate(&tileTemplGuid, tileEdt, TILE_PARAMC, 1 + NB_SIDES);
+    u64 nparamv[TILE_PARAMC];
+    nparamv[PARAM_T] = 0;
+    *((ocrGuid_t *) &nparamv[PARAM_RANGE]) = rangeGuid;
+    get_time(&timers[0]);
+    for (i = 0; i < NB_TILES; i++) {
+        for (j = 0; j < NB_TILES; j++) {
+            double * tile;
+            ocrGuid_t tileGuid, edtGuid;
+            ocrDbCreate(&tileGuid, (void **)&tile, sizeof(double) * 2 * TILE_SZ * TILE_SZ,
+                        0, NULL_HINT, NO_ALLOC);
+            for (r = 0; r < TILE_SZ * TILE_SZ; r++)
+                tile[r] = 0.0;
+            ocrDbRelease(tileGuid);
+            nparamv[PARAM_I] = i;
+            nparamv[PARAM_J] = j;
+            ocrEdtCreate(&edtGuid, tileTemplGuid, TILE_PARAMC, nparamv, 1 + NB_SIDES, NULL,
+                         EDT_PROP_NONE, NULL_HINT, NULL);
+            for (s = 0; s < NB_SIDES; s++)
+                ocrAddDependence(NULL_GUID, edtGuid, 1+s, DB_MODE_NULL);
+            ocrAddDependence(tileGuid, edtGuid, 0, DB_MODE_RW);
+        }
+    }
+    ocrEdtTemplateDestroy(tileTemplGuid);
+    ocrDbRelease(timersGuid);
+    ocrAddDependence(timersGuid, terminateGuid, NB_TILES*NB_TILES, DB_MODE_RW);
+    return NULL_GUID;
+}
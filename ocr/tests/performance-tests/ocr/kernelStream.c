@@ -0,0 +1,176 @@
+#include "perfs.h"
+#include "ocr.h"
+
+// DESC: STREAM memory bandwidth kernels (copy, scale, add, triad) over three
+//       arrays split in NB_TILES blocks of STREAM_ELTS doubles. One EDT per
+//       block creates and first touches the DBs of its block, then one chain
+//       of EDTs per block runs the four kernels NB_ITERS times, each EDT
+//       creating the next one. Blocks never share data, so the throughput
+//       depends on DBs staying in the memory of the workers running their
+//       chain (see the numadomains option of the config generator). Each
+//       block is checked against the scalar recurrence at the end.
+// TIME: From the creation of the first block to the completion of the last iteration
+// FREQ: Done once for 'NB_ITERS' iterations, throughput is in bytes moved by the kernels
+//
+// VARIABLES:
+// - NB_TILES
+// - STREAM_ELTS
+// - NB_ITERS
+
+// An iteration multiplies 'a' by 2s + s^2: s = sqrt(2) - 1 keeps the
+// values bounded whatever the number of iterations
+#define STREAM_SCALAR 0.41421356237309504
+
+// Bytes read and written per element by one iteration of the four kernels
+#define STREAM_BYTES_PER_ELT (10 * sizeof(double))
+
+// Slots of the block EDTs
+#define SLOT_A 0
+#define SLOT_B 1
+#define SLOT_C 2
+#define BLOCK_DEPC 3
+
+// Layout of the parameters of a block EDT
+#define PARAM_T 0
+#define PARAM_B 1
+#define PARAM_EVT 2
+#define BLOCK_PARAMC (PARAM_EVT + sizeof(ocrGuid_t) / sizeof(u64))
+
+ocrGuid_t blockEdt(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[]);
+
+static void spawnIteration(u64 t, u64 * paramv, ocrGuid_t aGuid, ocrGuid_t bGuid, ocrGuid_t cGuid) {
+    u64 nparamv[BLOCK_PARAMC];
+    u32 p;
+    for (p = 0; p < BLOCK_PARAMC; p++)
+        nparamv[p] = paramv[p];
+    nparamv[PARAM_T] = t;
+    ocrGuid_t templGuid, edtGuid;
+    ocrEdtTemplateCreate(&templGuid, blockEdt, BLOCK_PARAMC, BLOCK_DEPC);
+    ocrEdtCreate(&edtGuid, templGuid, BLOCK_PARAMC, nparamv, BLOCK_DEPC, NULL,
+                 EDT_PROP_NONE, NULL_HINT, NULL);
+    ocrEdtTemplateDestroy(templGuid);
+    ocrAddDependence(aGuid, edtGuid, SLOT_A, DB_MODE_RW);
+    ocrAddDependence(bGuid, edtGuid, SLOT_B, DB_MODE_RW);
+    ocrAddDependence(cGuid, edtGuid, SLOT_C, DB_MODE_RW);
+}
+
+static bool checkBlock(u64 b, double * a, double * bb, double * c) {
+    double ea = 1.0, eb = 2.0, ec = 0.0;
+    u64 t, i;
+    for (t = 0; t < NB_ITERS; t++) {
+        ec = ea;
+        eb = STREAM_SCALAR * ec;
+        ec = ea + eb;
+        ea = eb + STREAM_SCALAR * ec;
+    }
+    for (i = 0; i < STREAM_ELTS; i++) {
+        double da = a[i] - ea, db = bb[i] - eb, dc = c[i] - ec;
+        da = (da < 0) ? -da : da;
+        db = (db < 0) ? -db : db;
+        dc = (dc < 0) ? -dc : dc;
+        if ((da > 1e-13 * ea) || (db > 1e-13 * eb) || (dc > 1e-13 * ec)) {
+            PRINTF("ERROR: STREAM block %"PRIu64" element %"PRIu64" is (%e, %e, %e) instead of (%e, %e, %e)\n",
+                   b, i, a[i], bb[i], c[i], ea, eb, ec);
+            return false;
+        }
+    }
+    return true;
+}
+
+ocrGuid_t blockEdt(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[]) {
+    u64 t = paramv[PARAM_T];
+    double * a = (double *) depv[SLOT_A].ptr;
+    double * b = (double *) depv[SLOT_B].ptr;
+    double * c = (double *) depv[SLOT_C].ptr;
+    u64 i;
+
+    for (i = 0; i < STREAM_ELTS; i++)
+        c[i] = a[i];
+    for (i = 0; i < STREAM_ELTS; i++)
+        b[i] = STREAM_SCALAR * c[i];
+    for (i = 0; i < STREAM_ELTS; i++)
+        c[i] = a[i] + b[i];
+    for (i = 0; i < STREAM_ELTS; i++)
+        a[i] = b[i] + STREAM_SCALAR * c[i];
+
+    if ((t + 1) < NB_ITERS) {
+        spawnIteration(t + 1, paramv, depv[SLOT_A].guid, depv[SLOT_B].guid, depv[SLOT_C].guid);
+        return NULL_GUID;
+    }
+
+    if (!checkBlock(paramv[PARAM_B], a, b, c)) {
+        ocrAbort(1);
+        return NULL_GUID;
+    }
+    ocrDbDestroy(depv[SLOT_A].guid);
+    ocrDbDestroy(depv[SLOT_B].guid);
+    ocrDbDestroy(depv[SLOT_C].guid);
+    ocrEventSatisfy(*((ocrGuid_t *) &paramv[PARAM_EVT]), NULL_GUID);
+    return NULL_GUID;
+}
+
+// Creates the DBs of a block so that they come from the memory of the
+// worker running it, and touches them before the first iteration
+ocrGuid_t initEdt(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[]) {
+    double * a, * b, * c;
+    ocrGuid_t aGuid, bGuid, cGuid;
+    u64 i;
+    ocrDbCreate(&aGuid, (void **)&a, sizeof(double) * STREAM_ELTS, 0, NULL_HINT, NO_ALLOC);
+    ocrDbCreate(&bGuid, (void **)&b, sizeof(double) * STREAM_ELTS, 0, NULL_HINT, NO_ALLOC);
+    ocrDbCreate(&cGuid, (void **)&c, sizeof(double) * STREAM_ELTS, 0, NULL_HINT, NO_ALLOC);
+    for (i = 0; i < STREAM_ELTS; i++) {
+        a[i] = 1.0;
+        b[i] = 2.0;
+        c[i] = 0.0;
+    }
+    ocrDbRelease(aGuid);
+    ocrDbRelease(bGuid);
+    ocrDbRelease(cGuid);
+    spawnIteration(0, paramv, aGuid, bGuid, cGuid);
+    return NULL_GUID;
+}
+
+ocrGuid_t terminateEdt(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[]) {
+    timestamp_t * timers = (timestamp_t *) depv[NB_TILES].ptr;
+    get_time(&timers[1]);
+    printf("STREAM arrays of %"PRIu64" doubles (%"PRIu64" blocks of %"PRIu64"), %"PRIu64" iterations\n",
+           (u64) NB_TILES * STREAM_ELTS, (u64) NB_TILES, (u64) STREAM_ELTS, (u64) NB_ITERS);
+    summary_throughput_timer(&timers[0], &timers[1],
+                             ((u64) NB_TILES * STREAM_ELTS) * STREAM_BYTES_PER_ELT * NB_ITERS);
+    ocrDbDestroy(depv[NB_TILES].guid);
+    ocrShutdown();
+    return NULL_GUID;
+}
+
+ocrGuid_t mainEdt(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[]) {
+    timestamp_t * timers;
+    ocrGuid_t timersGuid;
+    ocrDbCreate(&timersGuid, (void **)&timers, sizeof(timestamp_t) * 2, 0, NULL_HINT, NO_ALLOC);
+
+    ocrGuid_t terminateTemplGuid, terminateGuid;
+    ocrEdtTemplateCreate(&terminateTemplGuid, terminateEdt, 0, NB_TILES + 1);
+    ocrEdtCreate(&terminateGuid, terminateTemplGuid, 0, NULL, NB_TILES + 1, NULL,
+                 EDT_PROP_NONE, NULL_HINT, NULL);
+    ocrEdtTemplateDestroy(terminateTemplGuid);
+
+    ocrGuid_t initTemplGuid;
+    ocrEdtTemplateCreate(&initTemplGuid, initEdt, BLOCK_PARAMC, 0);
+    u64 nparamv[BLOCK_PARAMC];
+    nparamv[PARAM_T] = 0;
+    get_time(&timers[0]);
+    u64 b;
+    for (b = 0; b < NB_TILES; b++) {
+        ocrGuid_t evtGuid, edtGuid;
+        // The last EDT of the block's chain satisfies it, after checking the block
+        ocrEventCreate(&evtGuid, OCR_EVENT_ONCE_T, EVT_PROP_NONE);
+        ocrAddDependence(evtGuid, terminateGuid, b, DB_MODE_NULL);
+        nparamv[PARAM_B] = b;
+        *((ocrGuid_t *) &nparamv[PARAM_EVT]) = evtGuid;
+        ocrEdtCreate(&edtGuid, initTemplGuid, BLOCK_PARAMC, nparamv, 0, NULL,
+                     EDT_PROP_NONE, NULL_HINT, NULL);
+    }
+    ocrEdtTemplateDestroy(initTemplGuid);
+    ocrDbRelease(timersGuid);
+    ocrAddDependence(timersGuid, terminateGuid, NB_TILES, DB_MODE_RW);
+    return NULL_GUID;
+}
@@ -0,0 +1,90 @@
+#
+# NUMA Scaling Experiment driver
+#
+# Runs the STREAM kernel with a single allocator and no binding against
+# one numa_alloc allocator per NUMA domain with workers bound to the
+# CPUs of their domain (stealing stays within a domain first).
+#
+# TARGET: Single node runs on x86 with libnuma
+# PLATFORM: Calibrated for a foobar cluster node
+#
+
+#
+# Environment check
+#
+if [[ -z "$SCRIPT_ROOT" ]]; then
+    echo "SCRIPT_ROOT environment variable is not defined"
+    exit 1
+fi
+
+unset OCR_CONFIG
+
+. ${SCRIPT_ROOT}/drivers/utils.sh
+
+# Inherited by runProg
+if [[ -z "${LOGDIR}" ]]; then
+    export LOGDIR=`mktemp -d logs_scalingNuma.XXXXX`
+else
+    mkdir -p ${LOGDIR}
+fi
+
+function runAll() {
+    export NAME=kernelStream
+    export CUSTOM_BOUNDS="NB_TILES=${NB_TILES} STREAM_ELTS=${STREAM_ELTS} NB_ITERS=${NB_ITERS}"
+
+    #
+    # Single allocator, unbound workers
+    #
+    export CFGARG_NUMADOMAINS=1
+    export CFGARG_BINDING=none
+    export REPORT_FILENAME_EXT="-stream-flat${EXT}"
+    runProg
+
+    #
+    # One allocator per NUMA domain, workers bound in their domain
+    #
+    export CFGARG_NUMADOMAINS=${NB_NUMA_DOMAINS}
+    export CFGARG_BINDING=numa
+    export REPORT_FILENAME_EXT="-stream-numa${NB_NUMA_DOMAINS}${EXT}"
+    runProg
+
+    unset CFGARG_NUMADOMAINS
+    echo "${SCRIPT_ROOT}/plotCoreScalingMultiRun.sh ${LOGDIR}/report*${EXT}"
+    ${SCRIPT_ROOT}/plotCoreScalingMultiRun.sh ${LOGDIR}/report*${EXT}
+    mv comparison-graph.svg ${LOGDIR}/comparison-${NAME_EXP}${EXT}.svg
+}
+
+#
+# Common Driver Arguments
+#
+export NB_RUN=${NB_RUN-3}
+export NODE_SCALING=${NODE_SCALING-"1"}
+export CORE_SCALING=${CORE_SCALING-"2 4 8 16"}
+export NB_NUMA_DOMAINS=${NB_NUMA_DOMAINS-2}
+
+#
+# Common OCR Build arguments
+#
+export CFLAGS_USER="${CFLAGS_USER} -DENABLE_MEM_PLATFORM_NUMA_ALLOC"
+export LDFLAGS="${LDFLAGS} -lnuma"
+export OCR_LDFLAGS="${OCR_LDFLAGS} -lnuma"
+
+#
+# Common Benchmark Arguments
+#
+export NB_TILES=${NB_TILES-64}
+export STREAM_ELTS=${STREAM_ELTS-262144}
+export NB_ITERS=${NB_ITERS-100}
+# Each domain allocator holds all the arrays (in MB)
+export CFGARG_ALLOC=${CFGARG_ALLOC-$(( (NB_TILES * STREAM_ELTS * 24 / 1048576) + 64 ))}
+export CFGARG_ALLOCTYPE=${CFGARG_ALLOCTYPE-"tlsf"}
+
+#
+# Run section
+#
+export NAME_EXP="numaStream"
+
+export NO_DEBUG=yes
+buildOcr
+export EXT="-${OCR_TYPE}-mRun-assertOff"
+runAll
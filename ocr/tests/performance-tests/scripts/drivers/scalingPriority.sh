@@ -0,0 +1,82 @@
+#
+# Priority Scheduler Scaling Experiment driver
+#
+# Compares the PR_WSH (per-worker heaps with stealing) and PR_MQ
+# (relaxed multi-queue) root scheduler objects of the priority scheduler.
+#
+# TARGET: Single node runs on x86
+# PLATFORM: Calibrated for a foobar cluster node
+#
+
+#
+# Environment check
+#
+if [[ -z "$SCRIPT_ROOT" ]]; then
+    echo "SCRIPT_ROOT environment variable is not defined"
+    exit 1
+fi
+
+unset OCR_CONFIG
+
+. ${SCRIPT_ROOT}/drivers/utils.sh
+
+# Inherited by runProg
+if [[ -z "${LOGDIR}" ]]; then
+    export LOGDIR=`mktemp -d logs_scalingPriority.XXXXX`
+else
+    mkdir -p ${LOGDIR}
+fi
+
+function runAll() {
+    for sched in PRIORITY PRIORITY_MQ; do
+        export CFGARG_SCHEDULER=${sched}
+
+        #
+        # FLAT loop w/ FINISH-EDT, random priorities
+        #
+        export NAME=edtExecutePriorityFinishSync
+        export REPORT_FILENAME_EXT="-flat-finish-${sched}${EXT}"
+        export CUSTOM_BOUNDS="NB_INSTANCES=${NB_INSTANCES} NB_PRIORITIES=${NB_PRIORITIES}"
+        runProg
+
+        #
+        # Same with a single priority level (ties everywhere)
+        #
+        export REPORT_FILENAME_EXT="-flat-finish-1prio-${sched}${EXT}"
+        export CUSTOM_BOUNDS="NB_INSTANCES=${NB_INSTANCES} NB_PRIORITIES=1"
+        runProg
+    done
+    unset CFGARG_SCHEDULER
+    echo "${SCRIPT_ROOT}/plotCoreScalingMultiRun.sh ${LOGDIR}/report*${EXT}"
+    ${SCRIPT_ROOT}/plotCoreScalingMultiRun.sh ${LOGDIR}/report*${EXT}
+    mv comparison-graph.svg ${LOGDIR}/comparison-${NAME_EXP}${EXT}.svg
+}
+
+#
+# Common Driver Arguments
+#
+export CFGARG_BINDING=${CFGARG_BINDING-"seq"}
+export NB_RUN=${NB_RUN-3}
+export NODE_SCALING=${NODE_SCALING-"1"}
+export CORE_SCALING=${CORE_SCALING-"1 2 4 8 16"}
+
+#
+# Common OCR Build arguments
+#
+export CFLAGS_USER="${CFLAGS_USER} -DGUID_PROVIDER_NB_BUCKETS=2097152"
+
+#
+# Common Benchmark Arguments
+#
+export NB_INSTANCES=${NB_INSTANCES-1048576}
+export NB_PRIORITIES=${NB_PRIORITIES-1024}
+
+#
+# Run section
+#
+export NAME_EXP="priorityEDT"
+
+export NO_DEBUG=yes
+buildOcr
+export EXT="-${OCR_TYPE}-mRun-assertOff"
+runAll
@@ -0,0 +1,370 @@
+#!/usr/bin/env python
+
+#
+# Performance regression harness for the OCR micro-benchmarks
+#
+# Runs a set of micro-benchmarks several times over a sweep of
+# definitions and a core scaling, computes the median throughput of
+# each configuration with a confidence interval and compares it against
+# a baseline. A configuration regresses when its median dropped by more
+# than its threshold and the drop is statistically significant
+# (one-sided Mann-Whitney U test on the samples of both runs).
+#
+# For help invoke: ./perfRegression.py -h
+#
+# Exit status: 0 when no regression is found, 1 on regression,
+# 2 on error.
+#
+
+from __future__ import print_function
+
+import argparse
+import itertools
+import json
+import math
+import os
+import re
+import subprocess
+import sys
+import tempfile
+
+SCRIPT_ROOT = os.path.dirname(os.path.abspath(__file__))
+BENCH_ROOT = os.path.dirname(SCRIPT_ROOT)
+
+RESULTS_VERSION = 1
+
+# Default config generator arguments per target (see runner.sh)
+TARGET_CFGARGS = {
+    'x86':        {'guid': 'PTR', 'platform': 'X86', 'target': 'x86', 'binding': 'seq',
+                   'alloc': '32', 'alloctype': 'mallocproxy'},
+    'x86-mpi':    {'guid': 'COUNTED_MAP', 'platform': 'X86', 'target': 'mpi', 'binding': 'seq',
+                   'alloc': '32', 'alloctype': 'mallocproxy'},
+    'x86-gasnet': {'guid': 'COUNTED_MAP', 'platform': 'X86', 'target': 'gasnet', 'binding': 'seq',
+                   'alloc': '32', 'alloctype': 'mallocproxy'},
+}
+
+THROUGHPUT_RE = re.compile(r'^Throughput\s+\(op/s\):\s+([0-9.eE+-]+)')
+
+# Above this many permutations the U test uses the normal approximation
+EXACT_PERMUTATIONS_MAX = 20000
+
+
+def error(msg):
+    print('error: perfRegression: ' + msg, file=sys.stderr)
+    sys.exit(2)
+
+
+#
+# Statistics
+#
+
+def median(values):
+    s = sorted(values)
+    n = len(s)
+    if n % 2:
+        return s[n // 2]
+    return (s[n // 2 - 1] + s[n // 2]) / 2.0
+
+
+def binomCdf(k, n):
+    """P(X <= k) for X ~ Binomial(n, 1/2)"""
+    if k < 0:
+        return 0.0
+    return sum(math.factorial(n) // (math.factorial(i) * math.factorial(n - i))
+               for i in range(0, min(k, n) + 1)) / float(2 ** n)
+
+
+def medianCi(values, confidence):
+    """Distribution-free confidence interval of the median from order
+    statistics. With too few samples for the requested confidence the
+    interval is the range of the samples."""
+    s = sorted(values)
+    n = len(s)
+    alpha = (1.0 - confidence) / 2.0
+    # Largest rank r (1-based) such that P(X <= r-1) <= alpha
+    r = 0
+    while binomCdf(r, n) <= alpha:
+        r += 1
+    if r < 1:
+        return s[0], s[-1]
+    return s[r - 1], s[n - r]
+
+
+def mannWhitneyLess(current, baseline):
+    """p-value of the one-sided test that 'current' is stochastically
+    smaller than 'baseline'"""
+    def uStat(xs, ys):
+        u = 0.0
+        for x in xs:
+            for y in ys:
+                if x < y:
+                    u += 1.0
+                elif x == y:
+                    u += 0.5
+        return u
+
+    n, m = len(current), len(baseline)
+    observed = uStat(current, baseline)
+    pooled = list(current) + list(baseline)
+    total = math.factorial(n + m) // (math.factorial(n) * math.factorial(m))
+    if total <= EXACT_PERMUTATIONS_MAX:
+        count = 0
+        for idx in itertools.combinations(range(n + m), n):
+            chosen = set(idx)
+            xs = [pooled[i] for i in idx]
+            ys = [pooled[i] for i in range(n + m) if i not in chosen]
+            if uStat(xs, ys) >= observed:
+                count += 1
+        return count / float(total)
+    # Normal approximation with continuity correction (ties ignored)
+    mean = n * m / 2.0
+    sd = math.sqrt(n * m * (n + m + 1) / 12.0)
+    z = (observed - mean - 0.5) / sd
+    return 0.5 * math.erfc(z / math.sqrt(2.0))
+
+
+#
+# Running the benchmarks
+#
+
+def readSweep(path):
+    lines = []
+    with open(path) as f:
+        for line in f:
+            line = line.strip()
+            if line and not line.startswith('#'):
+                lines.append(line)
+    return lines
+
+
+def sweepEnv(defines):
+    """Sweep lines are either make variable assignments (NB_INSTANCES=100)
+    or compiler definitions (-DNB_INSTANCES=100). Assignments override
+    the defaults.mk values and other definitions are passed as is."""
+    env = {}
+    flags = []
+    for token in defines.split():
+        name = token[2:] if token.startswith('-D') else token
+        if '=' in name:
+            key, value = name.split('=', 1)
+            env[key] = value
+        else:
+            flags.append(token if token.startswith('-D') else '-D' + token)
+    return env, ' '.join(flags)
+
+
+def programCfgArgs(prog):
+    """Config generator arguments a benchmark requires, declared in its
+    header as '// CONFIG: CFGARG_NAME=value'."""
+    env = {}
+    with open(os.path.join(BENCH_ROOT, 'ocr', prog + '.c')) as f:
+        for line in f:
+            if line.startswith('// CONFIG:'):
+                for token in line[len('// CONFIG:'):].split():
+                    key, value = token.split('=', 1)
+                    env[key] = value
+    return env
+
+
+def generateCfg(args, prog, cores, output, log):
+    cfgArgs = dict(TARGET_CFGARGS[args.target])
+    env = dict(os.environ)
+    env.update(programCfgArgs(prog))
+    for key, value in env.items():
+        if key.startswith('CFGARG_') and key not in ('CFGARG_THREADS', 'CFGARG_OUTPUT'):
+            cfgArgs[key[len('CFGARG_'):].lower()] = value
+    cfgArgs['threads'] = str(cores)
+    cfgArgs['output'] = output
+    generator = os.path.join(args.ocrInstall, 'share', 'ocr', 'scripts', 'Configs', 'config-generator.py')
+    cmd = [generator, '--remove-destination']
+    for key in sorted(cfgArgs):
+        cmd += ['--' + key, cfgArgs[key]]
+    log.write('>>> ' + ' '.join(cmd) + '\n')
+    log.flush()
+    return subprocess.call(cmd, stdout=log, stderr=subprocess.STDOUT)
+
+
+def runMake(env, targets, log):
+    cmd = ['make', '-f', 'Makefile'] + targets
+    log.write('>>> ' + ' '.join(cmd) + '\n')
+    proc = subprocess.Popen(cmd, cwd=BENCH_ROOT, env=env, stdout=subprocess.PIPE,
+                            stderr=subprocess.STDOUT, universal_newlines=True)
+    output = proc.communicate()[0]
+    log.write(output)
+    return proc.returncode, output
+
+
+def runBenchmarks(args):
+    results = {}
+    tmpdir = tempfile.mkdtemp(prefix='perfRegression.')
+    logPath = os.path.join(tmpdir, 'run.log')
+    log = open(logPath, 'w')
+    print('Logging runs to ' + logPath)
+    sweeps = readSweep(args.sweepfile) if args.sweepfile else ['']
+    for prog in args.programs:
+        for sweepIdx, defines in enumerate(sweeps):
+            defEnv, flags = sweepEnv(defines)
+            for cores in args.cores:
+                env = dict(os.environ)
+                env.update(defEnv)
+                env['OCR_INSTALL'] = args.ocrInstall
+                env['OCR_TYPE'] = args.target
+                env['NB_WORKERS'] = str(cores)
+                env['BENCH_FLAGS'] = flags
+                exe = 'build/' + prog
+                rc, _ = runMake(env, ['benchmark', exe, 'PROG=ocr/' + prog + '.c'], log)
+                if rc != 0:
+                    error('cannot build %s (see %s)' % (prog, logPath))
+                cfg = os.path.join(tmpdir, '%s-%dc.cfg' % (prog, cores))
+                if generateCfg(args, prog, cores, cfg, log) != 0:
+                    error('cannot generate the configuration file %s (see %s)' % (cfg, logPath))
+                samples = []
+                for run in range(args.nbrun):
+                    rc, output = runMake(env, ['OCR_CONFIG=' + cfg, 'run', exe], log)
+                    if rc != 0:
+                        error('run of %s failed (see %s)' % (prog, logPath))
+                    values = [float(m.group(1)) for m in
+                              (THROUGHPUT_RE.match(l.strip()) for l in output.splitlines()) if m]
+                    if not values:
+                        error('no throughput reported by %s (see %s)' % (prog, logPath))
+                    samples.append(values)
+                # A benchmark may report several timers
+                for timer in range(len(samples[0])):
+                    key = '%s/sweep%d/%dc' % (prog, sweepIdx, cores)
+                    if timer:
+                        key += '/timer%d' % timer
+                    values = [s[timer] for s in samples if timer < len(s)]
+                    low, high = medianCi(values, args.confidence)
+                    results[key] = {
+                        'program': prog,
+                        'defines': defines,
+                        'cores': cores,
+                        'samples': values,
+                        'median': median(values),
+                        'ciLow': low,
+                        'ciHigh': high,
+                    }
+                    print('%-48s median %14.3f op/s  [%.3f, %.3f]' % (key, results[key]['median'], low, high))
+    log.close()
+    return {'version': RESULTS_VERSION, 'metric': 'throughput (op/s)',
+            'confidence': args.confidence, 'benchmarks': results}
+
+
+#
+# Comparison against the baseline
+#
+
+def loadJson(path):
+    try:
+        with open(path) as f:
+            return json.load(f)
+    except (IOError, ValueError) as e:
+        error('cannot read %s: %s' % (path, e))
+
+
+def thresholdOf(thresholds, key, entry):
+    """Most specific threshold: full key, then program, then default"""
+    perBench = thresholds.get('benchmarks', {})
+    for name in (key, entry['program']):
+        if name in perBench:
+            return float(perBench[name])
+    return float(thresholds.get('default', 0.05))
+
+
+def compare(current, baseline, thresholds):
+    alpha = float(thresholds.get('alpha', 0.05))
+    regressions = 0
+    curBench = current['benchmarks']
+    baseBench = baseline['benchmarks']
+    print('%-48s %14s %14s %8s %7s %6s  %s' % ('Benchmark', 'Baseline', 'Current', 'Change', 'p', 'Thr', 'Status'))
+    for key in sorted(set(curBench) | set(baseBench)):
+        if key not in baseBench:
+            print('%-48s %14s %14.3f %8s %7s %6s  NEW' % (key, '-', curBench[key]['median'], '-', '-', '-'))
+            continue
+        if key not in curBench:
+            print('%-48s %14.3f %14s %8s %7s %6s  MISSING' % (key, baseBench[key]['median'], '-', '-', '-', '-'))
+            continue
+        cur, base = curBench[key], baseBench[key]
+        threshold = thresholdOf(thresholds, key, cur)
+        change = (cur['median'] - base['median']) / float(base['median'])
+        pLess = mannWhitneyLess(cur['samples'], base['samples'])
+        pMore = mannWhitneyLess(base['samples'], cur['samples'])
+        status = 'OK'
+        if (change < -threshold) and (pLess < alpha):
+            status = 'REGRESSED'
+            regressions += 1
+        elif (change > threshold) and (pMore < alpha):
+            status = 'IMPROVED'
+        elif abs(change) > threshold:
+            # Beyond the threshold but not significant with these samples
+            status = 'NOISY'
+        print('%-48s %14.3f %14.3f %+7.1f%% %7.3f %5.1f%%  %s' %
+              (key, base['median'], cur['median'], change * 100.0,
+               pLess if change < 0 else pMore, threshold * 100.0, status))
+    return regressions
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Run OCR micro-benchmarks and detect performance regressions.')
+    parser.add_argument('programs', nargs='*', help='micro-benchmarks to run (names under ocr/)')
+    parser.add_argument('-sweepfile', dest='sweepfile', help='sweep file (ex: configSweep/default.sweep), defaults.mk otherwise')
+    parser.add_argument('-nbrun', dest='nbrun', type=int, default=int(os.environ.get('NB_RUN', '5')),
+                        help='number of runs per configuration (default: NB_RUN or 5)')
+    parser.add_argument('-cores', dest='cores', default=os.environ.get('CORE_SCALING', '1'),
+                        help='core scaling, ex: "1 2 4" (default: CORE_SCALING or 1)')
+    parser.add_argument('-target', dest='target', default='x86', choices=sorted(TARGET_CFGARGS),
+                        help='OCR target (default: x86)')
+    parser.add_argument('-confidence', dest='confidence', type=float, default=0.95,
+                        help='confidence level of the median intervals (default: 0.95)')
+    parser.add_argument('-results', dest='results', help='compare this results file instead of running')
+    parser.add_argument('-save', dest='save', help='write the results to this file')
+    parser.add_argument('-baseline', dest='baseline', help='baseline results to compare against')
+    parser.add_argument('-update-baseline', dest='updateBaseline', action='store_true',
+                        help='overwrite the baseline with the results instead of comparing')
+    parser.add_argument('-thresholds', dest='thresholds', default=os.path.join(SCRIPT_ROOT, 'perfThresholds.json'),
+                        help='per-benchmark thresholds (default: scripts/perfThresholds.json)')
+    args = parser.parse_args()
+
+    args.ocrInstall = os.path.abspath(os.environ.get('OCR_INSTALL', os.path.join(BENCH_ROOT, '..', '..', 'install')))
+    try:
+        args.cores = [int(c) for c in args.cores.split()]
+    except ValueError:
+        error('invalid core scaling "%s"' % args.cores)
+    if args.updateBaseline and not args.baseline:
+        error('-update-baseline requires -baseline')
+
+    if args.results:
+        current = loadJson(args.results)
+    else:
+        if not args.programs:
+            error('no micro-benchmark to run')
+        if args.nbrun < 1:
+            error('-nbrun must be positive')
+        if args.sweepfile and not os.path.isfile(args.sweepfile):
+            error('cannot find sweep file %s' % args.sweepfile)
+        current = runBenchmarks(args)
+
+    if args.save:
+        with open(args.save, 'w') as f:
+            json.dump(current, f, indent=2, sort_keys=True)
+    if not args.baseline:
+        return 0
+    if args.updateBaseline or not os.path.isfile(args.baseline):
+        with open(args.baseline, 'w') as f:
+            json.dump(current, f, indent=2, sort_keys=True)
+        print('Baseline written to ' + args.baseline)
+        return 0
+
+    baseline = loadJson(args.baseline)
+    if baseline.get('version') != RESULTS_VERSION:
+        error('unsupported baseline version in %s' % args.baseline)
+    thresholds = loadJson(args.thresholds) if os.path.isfile(args.thresholds) else {}
+    regressions = compare(current, baseline, thresholds)
+    if regressions:
+        print('%d configuration(s) regressed' % regressions)
+        return 1
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
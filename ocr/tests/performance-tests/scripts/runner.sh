@@ -190,6 +190,18 @@ function defaultConfigTarget() {
     esac
 }
 
+# Export the config generator arguments a micro-benchmark
+# requires, declared in its header as '// CONFIG: CFGARG_NAME=value'
+function programConfigTarget() {
+    local prog=$1
+    if [[ -f ocr/${prog}.c ]]; then
+        for cfgarg in `sed -n 's|^// CONFIG:||p' ocr/${prog}.c`; do
+            echo "programConfigTarget ${prog} requires ${cfgarg}"
+            export ${cfgarg}
+        done
+    fi
+}
+
 function generateMachineFile {
     local  __resultvar=$1
 
@@ -454,6 +466,7 @@ echo "Running core scaling for ${PROG_ARG}"
 
 # Setting up env variables for the cfg file generator
 defaultConfigTarget ${TARGET_ARG}
+programConfigTarget ${PROG_ARG}
 
 if [[ "$SWEEPFILE_OPT" = "yes" ]]; then
     # use sweep file